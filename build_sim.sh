@@ -16,11 +16,16 @@ gcc -o mp3_rewind_sim \
     -I../src \
     -I../src/storage \
     -I../src/utils \
+    -I../src/sim \
+    -include ../src/sim/sim_autoconf.h \
     -DUSE_SIMULATION=1 \
     ../test/sim_main.c \
     ../src/storage/sim_fs.c \
+    ../src/storage/media_index.c \
+    ../src/storage/wav_file_reader.c \
+    ../src/audio/wav_decoder.c \
     ../src/utils/sim_error_handling.c \
-    -std=c99
+    -std=gnu11
 
 if [ $? -eq 0 ]; then
     echo "Build successful! Run with: ./build_sim/mp3_rewind_sim"
@@ -29,3 +34,95 @@ else
     echo "Build failed!"
     exit 1
 fi
+
+# Pipeline benchmark: the real buffer, ring and decoder modules on the
+# POSIX kernel shims in src/sim, sized from the board's prj.conf
+rm -f mp3_rewind_bench
+
+SIM_CONFIG=$(sed -n 's/^\(CONFIG_APP_AUDIO_BUFFER_COUNT\|CONFIG_APP_AUDIO_BUFFER_SIZE\|CONFIG_APP_AUDIO_POOL_LATENCY_MS\|CONFIG_APP_SD_READAHEAD_DEPTH\|CONFIG_BT_L2CAP_TX_MTU\)=\([0-9]*\)$/-D\1=\2/p' ../zephyr/prj.conf)
+
+gcc -o mp3_rewind_bench \
+    -O2 \
+    -I../src \
+    -I../src/sim \
+    -include ../src/sim/sim_autoconf.h \
+    -DUSE_SIMULATION=1 \
+    $SIM_CONFIG \
+    ../test/sim_bench.c \
+    ../src/sim/sim_kernel.c \
+    ../src/utils/circular_buffers.c \
+    ../src/audio/audio_buffers.c \
+    ../src/audio/wav_decoder.c \
+    ../src/audio/pcm_dsp.c \
+    ../src/audio/resampler.c \
+    -std=gnu11 \
+    -pthread
+
+if [ $? -eq 0 ]; then
+    echo "Benchmark built! Run with: ./build_sim/mp3_rewind_bench --baseline test/bench_baseline.txt"
+    echo "For timing, write a baseline on this machine with --write-baseline, then rerun"
+    echo "against it with --check-timing."
+else
+    echo "Benchmark build failed!"
+    exit 1
+fi
+
+# Module checks on the same shims. Each one runs from the project root
+# (for test_data/) right after it is built, and a failed check fails
+# the build
+SIM_CHECK_FLAGS="-O2 -I../src -I../src/sim -include ../src/sim/sim_autoconf.h -DUSE_SIMULATION=1 $SIM_CONFIG -std=gnu11 -pthread"
+
+sim_check() {
+    name=$1
+    shift
+    rm -f "$name"
+    if ! gcc -o "$name" $SIM_CHECK_FLAGS "$@"; then
+        echo "$name build failed!"
+        exit 1
+    fi
+    if ! (cd .. && "./build_sim/$name"); then
+        echo "$name failed!"
+        exit 1
+    fi
+}
+
+sim_check sim_readahead_test \
+    ../test/sim_readahead_test.c \
+    ../src/sim/sim_kernel.c \
+    ../src/storage/sim_fs.c \
+    ../src/storage/readahead.c \
+    ../src/utils/circular_buffers.c \
+    ../src/audio/audio_buffers.c
+
+sim_check sim_media_index_test \
+    ../test/sim_media_index_test.c \
+    ../src/storage/sim_fs.c \
+    ../src/storage/media_index.c \
+    ../src/storage/wav_file_reader.c \
+    ../src/audio/wav_decoder.c
+
+# Refusing malformed headers is part of the check, so their errors are
+# not logged
+sim_check sim_wav_reader_test \
+    -DSIM_LOG_LEVEL=LOG_LEVEL_NONE \
+    ../test/sim_wav_reader_test.c \
+    ../src/storage/sim_fs.c \
+    ../src/storage/wav_file_reader.c \
+    ../src/audio/wav_decoder.c
+
+sim_check sim_pcm_dsp_test \
+    ../test/sim_pcm_dsp_test.c \
+    ../src/audio/pcm_dsp.c
+
+sim_check sim_resampler_test \
+    ../test/sim_resampler_test.c \
+    ../src/audio/resampler.c
+
+# Pool allocation counts are the same on every host; timings are only
+# checked when asked for (--check-timing) against a local baseline
+if ! (cd .. && ./build_sim/mp3_rewind_bench --runs 1 --baseline test/bench_baseline.txt); then
+    echo "Benchmark allocation check failed!"
+    exit 1
+fi
+
+echo "All module checks passed"
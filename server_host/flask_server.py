@@ -10,7 +10,7 @@ This Flask server provides the same API as the original BaseHTTPServer but with:
 5. Better timing characteristics for Zephyr HTTP client
 
 Usage:
-    python3 flask_server.py [--host HOST] [--port PORT] [--audio-dir AUDIO_DIR]
+    python3 flask_server.py [--host HOST] [--port PORT] [--audio-dir AUDIO_DIR] [--backend async|flask]
 
 Example:
     python3 flask_server.py --host 0.0.0.0 --port 8000 --audio-dir ../test_data
@@ -36,8 +36,12 @@ import threading
 import logging
 from pathlib import Path
 from flask import Flask, jsonify, request, Response, render_template_string
+from werkzeug.serving import WSGIRequestHandler
 from urllib.parse import parse_qs
 from typing import Optional, Dict, Any
+from wav_framing import FRAME_CONTENT_TYPE, FramePlan, RangeNotSatisfiable, parse_byte_range
+from transcode_cache import TargetFormat, TranscodeCache, TranscodeError, needs_transcode
+import stream_backend
 
 class AudioStreamServer:
     """Manages audio streaming state and control.
@@ -53,10 +57,14 @@ class AudioStreamServer:
     - chunk_size: Size of audio chunks for streaming (default 1024 bytes)
     - lock: Thread lock for synchronizing access to shared state
     - available_tracks: List of available audio tracks in the audio directory
+    - transcode_cache: Decoded WAV files of the MP3/FLAC tracks
+    - device_metrics: Last metrics report of each board, by address
     """
     
-    def __init__(self, audio_dir: str):
+    def __init__(self, audio_dir: str, cache_dir: Optional[str] = None):
         self.audio_dir = Path(audio_dir)
+        self.transcode_cache = TranscodeCache(Path(cache_dir) if cache_dir else
+                                              Path(__file__).parent / 'transcode_cache')
         self.current_track: Optional[str] = None
         self.is_playing = False
         self.is_paused = False
@@ -64,6 +72,7 @@ class AudioStreamServer:
         self.position = 0  # Current position in bytes
         self.chunk_size = 1024  # Bytes per chunk for streaming
         self.lock = threading.Lock()
+        self.device_metrics: Dict[str, Dict[str, Any]] = {}
         
         # Discover available audio files
         self.available_tracks = self._discover_audio_files()
@@ -146,11 +155,44 @@ class AudioStreamServer:
             else:
                 return {"status": "error", "message": "Volume must be between 0 and 100"}
     
+    def record_metrics(self, device: str, report: Dict[str, Any]):
+        """Keep the latest metrics report pushed by a board"""
+        with self.lock:
+            self.device_metrics[device] = {"received": time.time(), **report}
+    
+    def get_metrics(self) -> Dict[str, Dict[str, Any]]:
+        with self.lock:
+            return dict(self.device_metrics)
+    
     def get_track_path(self, track_name: str) -> Optional[Path]:
         """Get full path for a track"""
         if track_name in self.available_tracks:
             return self.audio_dir / track_name
         return None
+    
+    def resolve_track(self, track_name: Optional[str], args=None):
+        """Track to stream for a request: the named one, else the current or first
+
+        MP3 and FLAC tracks resolve to their cached WAV in the format given by
+        the rate/channels/bits entries of args, decoded on their first play.
+
+        Returns (track_name, track_path, error, http_status); track_path is
+        None when the request has to be refused with error/http_status.
+        """
+        if not track_name:
+            status = self.get_status()
+            track_name = status.get('track') or (status['available_tracks'][0] if status['available_tracks'] else None)
+        if not track_name:
+            return None, None, "No track specified and none available", 400
+        track_path = self.get_track_path(track_name)
+        if not track_path or not track_path.exists():
+            return track_name, None, f"Track '{track_name}' not found", 404
+        if needs_transcode(track_path):
+            try:
+                track_path = self.transcode_cache.get(track_path, TargetFormat.from_args(args or {}))
+            except TranscodeError as e:
+                return track_name, None, str(e), 415
+        return track_name, track_path, None, 200
 
 # Global audio server instance
 audio_server = None
@@ -204,10 +246,22 @@ def index():
             <div class="method">POST /api/volume</div>
             <p>Set volume. JSON body: {"volume": 75}</p>
         </div>
+        <div class="endpoint">
+            <div class="method">GET /api/metrics</div>
+            <p>Latest pipeline metrics pushed by each board (POST /api/metrics)</p>
+        </div>
         <div class="endpoint">
             <div class="method">GET /audio/stream</div>
             <p>Stream audio data with chunked encoding</p>
         </div>
+        <div class="endpoint">
+            <div class="method">GET /audio/frames</div>
+            <p>Stream PCM in binary frames. Query: track, frame_size</p>
+        </div>
+        <div class="endpoint">
+            <p>MP3 and FLAC tracks on either stream are decoded once and cached as WAV.
+               Query: rate, channels, bits (default 44100, 2, 16)</p>
+        </div>
     </body>
     </html>
     '''
@@ -297,6 +351,27 @@ def api_volume():
     except Exception as e:
         return jsonify({"status": "error", "message": str(e)}), 500
 
+@app.route('/api/metrics', methods=['POST'])
+def api_metrics_push():
+    """Store a board's pipeline metrics report (see src/utils/metrics.h)"""
+    try:
+        report = request.get_json(silent=True)
+        if not isinstance(report, dict):
+            return jsonify({"status": "error", "message": "JSON object required"}), 400
+        # No sleep here: reports are pipelined and nobody waits for the reply
+        audio_server.record_metrics(request.remote_addr or 'unknown', report)
+        return jsonify({"status": "ok"}), 200
+    except Exception as e:
+        return jsonify({"status": "error", "message": str(e)}), 500
+
+@app.route('/api/metrics', methods=['GET'])
+def api_metrics():
+    """Latest metrics report of every board"""
+    try:
+        return jsonify({"devices": audio_server.get_metrics()}), 200
+    except Exception as e:
+        return jsonify({"status": "error", "message": str(e)}), 500
+
 @app.route('/api/tracks', methods=['GET'])
 def api_tracks():
     """Get list of available tracks"""
@@ -311,41 +386,51 @@ def audio_stream():
     """Stream audio data with packet-based chunked encoding for memory-efficient streaming"""
     try:
         # Get track parameter from query string
-        track_name = request.args.get('track')
         chunk_size = int(request.args.get('chunk_size', 256))  # Reduced from 1024 to 256 bytes for embedded clients
         
-        if not track_name:
-            # Use current playing track or first available
-            status = audio_server.get_status()
-            track_name = status.get('track') or (status['available_tracks'][0] if status['available_tracks'] else None)
-        
-        if not track_name:
-            return jsonify({"status": "error", "message": "No track specified and none available"}), 400
+        # Use current playing track or first available if none is named
+        track_name, track_path, error, code = audio_server.resolve_track(request.args.get('track'), request.args)
+        if not track_path:
+            return jsonify({"status": "error", "message": error}), code
         
-        track_path = audio_server.get_track_path(track_name)
-        if not track_path or not track_path.exists():
-            return jsonify({"status": "error", "message": f"Track '{track_name}' not found"}), 404
+        # Byte range for seeking ("Range: bytes=start-[end]"), whole file otherwise
+        file_size = track_path.stat().st_size
+        range_header = request.headers.get('Range')
+        try:
+            range_start, range_end = parse_byte_range(range_header, file_size)
+        except RangeNotSatisfiable as e:
+            return Response(status=416, headers={'Content-Range': f'bytes */{e.limit}'})
         
-        print(f"Starting packet-based streaming of: {track_path} (chunk size: {chunk_size} bytes)")
+        print(f"Starting packet-based streaming of: {track_path} (chunk size: {chunk_size} bytes, "
+              f"bytes {range_start}-{range_end})")
         
         def generate_audio_packets():
             """Generator function for streaming audio in small packets"""
             try:
                 with open(track_path, 'rb') as audio_file:
-                    # Read and send WAV header first
-                    wav_header = audio_file.read(44)  # Standard WAV header size
-                    if len(wav_header) >= 44:
-                        yield wav_header
-                        print(f"Sent WAV header ({len(wav_header)} bytes)")
+                    total_sent = 0
+                    remaining = range_end - range_start + 1
+                    
+                    if range_start == 0:
+                        # Read and send WAV header first
+                        wav_header = audio_file.read(min(44, remaining))  # Standard WAV header size
+                        if len(wav_header) >= 44:
+                            yield wav_header
+                            print(f"Sent WAV header ({len(wav_header)} bytes)")
+                        total_sent = len(wav_header) if len(wav_header) >= 44 else 0
+                        remaining -= len(wav_header)
+                    else:
+                        # Seek: the client already has the header, resume mid-file
+                        audio_file.seek(range_start)
                     
                     # Stream audio data in chunks
                     chunk_count = 0
-                    total_sent = len(wav_header) if len(wav_header) >= 44 else 0
                     
-                    while True:
-                        chunk = audio_file.read(chunk_size)
+                    while remaining > 0:
+                        chunk = audio_file.read(min(chunk_size, remaining))
                         if not chunk:
                             break
+                        remaining -= len(chunk)
                         
                         yield chunk
                         chunk_count += 1
@@ -364,16 +449,24 @@ def audio_stream():
                 print(f"Error during streaming: {e}")
                 yield b''  # Send empty chunk to indicate end
         
+        # Playlist clients keep the connection for the next track; the chunked
+        # framing that makes that possible is added by the HTTP/1.1 handler
+        keep_alive = request.headers.get('Connection', '').lower() == 'keep-alive'
+        headers = {
+            'Cache-Control': 'no-cache',
+            'Connection': 'keep-alive' if keep_alive else 'close',
+            'Accept-Ranges': 'bytes',
+            'X-Chunk-Size': str(chunk_size)
+        }
+        if range_header:
+            headers['Content-Range'] = f'bytes {range_start}-{range_end}/{file_size}'
+        
         # Return streaming response with chunked encoding
         response = Response(
             generate_audio_packets(),
+            status=206 if range_header else 200,
             mimetype='audio/wav',
-            headers={
-                'Cache-Control': 'no-cache',
-                'Connection': 'close',
-                'Transfer-Encoding': 'chunked',
-                'X-Chunk-Size': str(chunk_size)
-            }
+            headers=headers
         )
         
         print(f"Starting chunked streaming response for {track_name}")
@@ -383,6 +476,50 @@ def audio_stream():
         print(f"Error in packet-based audio_stream: {e}")
         return jsonify({"status": "error", "message": str(e)}), 500
 
+@app.route('/audio/frames', methods=['GET'])
+def audio_frames():
+    """Stream the PCM of a WAV file as binary frames with a known Content-Length"""
+    try:
+        track_name, track_path, error, code = audio_server.resolve_track(request.args.get('track'), request.args)
+        if not track_path:
+            return jsonify({"status": "error", "message": error}), code
+
+        range_header = request.headers.get('Range')
+        try:
+            plan = FramePlan(track_path, int(request.args.get('frame_size', 512)), range_header)
+        except RangeNotSatisfiable as e:
+            return Response(status=416, headers={'Content-Range': f'bytes */{e.limit}'})
+        except ValueError as e:
+            return jsonify({"status": "error", "message": f"Can't frame '{track_name}': {e}"}), 415
+
+        print(f"Starting framed streaming of: {track_path} ({plan.frame_size}-byte frames, "
+              f"PCM bytes {plan.pcm_start}-{plan.data_end - 1})")
+
+        def generate_frames():
+            # Frames are produced as fast as TCP takes them; the client's free
+            # pool buffers are what pace the stream
+            yield plan.format_frame()
+            with open(track_path, 'rb') as audio_file:
+                for header, offset, length in plan.pcm_frames_layout():
+                    audio_file.seek(offset)
+                    # A file that shrank under us still ends with the promised length
+                    yield header + audio_file.read(length).ljust(length, b'\0')
+            print(f"Framed streaming completed: {plan.pcm_frames} frames, {plan.pcm_len} PCM bytes")
+
+        keep_alive = request.headers.get('Connection', '').lower() == 'keep-alive'
+        headers = {
+            'Cache-Control': 'no-cache',
+            'Connection': 'keep-alive' if keep_alive else 'close',
+            'Content-Length': str(plan.content_length),
+            'Accept-Ranges': 'bytes',
+        }
+        return Response(generate_frames(), status=206 if range_header else 200,
+                        content_type=FRAME_CONTENT_TYPE, headers=headers)
+
+    except Exception as e:
+        print(f"Error in audio_frames: {e}")
+        return jsonify({"status": "error", "message": str(e)}), 500
+
 def main():
     global audio_server
     
@@ -394,17 +531,22 @@ def main():
     parser.add_argument('--port', type=int, default=8000, help='Port to bind to (default: 8000)')
     parser.add_argument('--audio-dir', default='../test_data', help='Directory containing audio files')
     parser.add_argument('--debug', action='store_true', help='Enable Flask debug mode')
+    parser.add_argument('--cache-dir', help='Where decoded MP3/FLAC tracks are kept (default: ./transcode_cache)')
+    parser.add_argument('--backend', choices=['async', 'flask'], default='async',
+                        help='async: one event loop with sendfile streaming for many boards; '
+                             'flask: the Flask development server (default: async)')
     
     args = parser.parse_args()
     
     # Initialize audio server
-    audio_server = AudioStreamServer(args.audio_dir)
+    audio_server = AudioStreamServer(args.audio_dir, args.cache_dir)
     
     print("\n" + "="*60)
     print("MP3 Rewind Flask Audio Server Starting")
     print("="*60)
     print(f"Server URL: http://{args.host}:{args.port}")
     print(f"Audio Directory: {Path(args.audio_dir).resolve()}")
+    print(f"Transcode Cache: {audio_server.transcode_cache.cache_dir.resolve()}")
     print("Available at:")
     print(f"  - Local: http://127.0.0.1:{args.port}")
     if args.host != '127.0.0.1':
@@ -414,7 +556,17 @@ def main():
     print("Press Ctrl+C to stop the server")
     print()
     
+    # HTTP/1.1 so streamed responses are chunk-framed and connections can
+    # stay open between playlist tracks
+    WSGIRequestHandler.protocol_version = "HTTP/1.1"
+    
     try:
+        if args.backend == 'async':
+            # Streams on an event loop, the API routes still served by the Flask app
+            print("Backend: asyncio streaming, real-time paced")
+            stream_backend.serve(app, audio_server, args.host, args.port)
+            return
+        
         # Run Flask server with embedded-friendly configuration
         app.run(
             host=args.host,
@@ -0,0 +1,364 @@
+"""
+Asynchronous streaming backend for flask_server.py
+
+The Flask development server gives every stream a thread running a Python
+generator, so a lab full of boards means a thread per board copying small
+chunks through the interpreter. This backend serves the same API from one
+asyncio event loop:
+
+- /audio/stream and /audio/frames are answered directly. WAV data goes out
+  with loop.sendfile() (os.sendfile on Linux, no copy through Python) in
+  large chunks, and each connection is paced to real time with a small lead,
+  so a slow board only waits on its own socket.
+- Every other route runs in the Flask app on the default thread pool, so
+  the control API has one implementation.
+
+Connections are HTTP/1.1 and stay open between requests, which is what the
+playlist and control connections of the board expect.
+"""
+
+import asyncio
+import io
+import itertools
+import json
+import os
+import sys
+from http import HTTPStatus
+from urllib.parse import urlsplit, parse_qs, unquote
+
+from wav_framing import (FRAME_CONTENT_TYPE, FramePlan, RangeNotSatisfiable,
+                         parse_byte_range, read_wav_layout)
+
+IDLE_TIMEOUT = 30.0         # Seconds a kept-alive connection may sit unused
+HEADER_LIMIT = 8192         # Largest request header block
+STREAM_LEAD = 2.0           # Seconds of audio sent ahead of real time
+CHUNK_MIN = 4096            # Smaller chunk_size requests are rounded up to this
+CHUNK_MAX = 64 * 1024
+FRAME_BATCH = 64 * 1024     # PCM read from the file per batch of frames
+
+# Headers the backend sets itself when relaying a Flask response
+HOP_HEADERS = {'connection', 'content-length', 'transfer-encoding', 'keep-alive'}
+
+
+class Pacer:
+    """Holds a stream to real time, STREAM_LEAD seconds ahead of the clock"""
+
+    def __init__(self, bytes_per_sec):
+        self.loop = asyncio.get_running_loop()
+        self.bytes_per_sec = bytes_per_sec
+        self.start = self.loop.time()
+        self.sent = 0
+
+    async def wait(self, nbytes: int):
+        """Sleep until the next nbytes may be sent"""
+        if self.bytes_per_sec:
+            delay = self.start + self.sent / self.bytes_per_sec - STREAM_LEAD - self.loop.time()
+            if delay > 0:
+                await asyncio.sleep(delay)
+        self.sent += nbytes
+
+
+class Request:
+    """One parsed request of a connection"""
+
+    def __init__(self, method, target, version, headers, body=b''):
+        self.method = method
+        self.version = version
+        self.headers = headers          # Lower-case names
+        self.body = body
+        url = urlsplit(target)
+        self.path = unquote(url.path)
+        self.query_string = url.query
+        self.args = {k: v[0] for k, v in parse_qs(url.query).items()}
+
+    @property
+    def keep_alive(self) -> bool:
+        connection = self.headers.get('connection', '').lower()
+        if self.version == 'HTTP/1.0':
+            return connection == 'keep-alive'
+        return connection != 'close'
+
+
+class StreamBackend:
+    """asyncio HTTP/1.1 server in front of the Flask app"""
+
+    def __init__(self, app, audio_server, host: str, port: int):
+        self.app = app
+        self.audio_server = audio_server
+        self.host = host
+        self.port = port
+        self.active_streams = 0
+
+    async def run(self):
+        server = await asyncio.start_server(self.handle_connection, self.host, self.port,
+                                            limit=HEADER_LIMIT)
+        async with server:
+            await server.serve_forever()
+
+    async def handle_connection(self, reader, writer):
+        peer = writer.get_extra_info('peername')
+        try:
+            while True:
+                request = await self.read_request(reader, writer)
+                if request is None:
+                    break
+                if request.path == '/audio/stream' and request.method == 'GET':
+                    await self.audio_stream(request, writer)
+                elif request.path == '/audio/frames' and request.method == 'GET':
+                    await self.audio_frames(request, writer)
+                else:
+                    await self.relay_to_flask(request, writer, peer)
+                if not request.keep_alive:
+                    break
+        except (ConnectionError, asyncio.IncompleteReadError):
+            pass
+        except Exception as e:
+            print(f"Error on connection from {peer}: {e}")
+        finally:
+            writer.close()
+
+    async def read_request(self, reader, writer):
+        """Next request of the connection, None once it should be closed"""
+        try:
+            head = await asyncio.wait_for(reader.readuntil(b'\r\n\r\n'), IDLE_TIMEOUT)
+        except asyncio.LimitOverrunError:
+            await self.send_simple(writer, 431, keep_alive=False)
+            return None
+        except (asyncio.TimeoutError, asyncio.IncompleteReadError):
+            return None
+
+        lines = head.decode('latin-1').split('\r\n')
+        try:
+            method, target, version = lines[0].split(' ', 2)
+        except ValueError:
+            await self.send_simple(writer, 400, keep_alive=False)
+            return None
+        headers = {}
+        for line in lines[1:]:
+            if ':' in line:
+                name, value = line.split(':', 1)
+                headers[name.strip().lower()] = value.strip()
+
+        body = b''
+        length = int(headers.get('content-length', 0) or 0)
+        if length:
+            body = await reader.readexactly(length)
+        return Request(method, target, version, headers, body)
+
+    def send_head(self, writer, status: int, headers: dict, keep_alive: bool):
+        lines = [f'HTTP/1.1 {status} {HTTPStatus(status).phrase}']
+        lines += [f'{name}: {value}' for name, value in headers.items()]
+        lines.append(f'Connection: {"keep-alive" if keep_alive else "close"}')
+        writer.write(('\r\n'.join(lines) + '\r\n\r\n').encode('latin-1'))
+
+    async def send_simple(self, writer, status: int, headers=None, body=b'',
+                          content_type='application/json', keep_alive=True):
+        headers = dict(headers or {})
+        if body:
+            headers['Content-Type'] = content_type
+        headers['Content-Length'] = str(len(body))
+        self.send_head(writer, status, headers, keep_alive)
+        writer.write(body)
+        await writer.drain()
+
+    async def send_error(self, request, writer, status: int, message: str):
+        body = json.dumps({"status": "error", "message": message}).encode()
+        await self.send_simple(writer, status, body=body, keep_alive=request.keep_alive)
+
+    def stream_started(self, kind: str, track_path, detail: str):
+        self.active_streams += 1
+        print(f"Starting {kind} streaming of: {track_path} ({detail}, "
+              f"{self.active_streams} active)")
+
+    def stream_finished(self, kind: str, sent: int, complete: bool):
+        self.active_streams -= 1
+        state = "completed" if complete else "aborted by client"
+        print(f"{kind.capitalize()} streaming {state}: {sent} bytes "
+              f"({self.active_streams} active)")
+
+    async def resolve_track(self, request):
+        """AudioStreamServer.resolve_track() off the loop, a first play may transcode"""
+        loop = asyncio.get_running_loop()
+        return await loop.run_in_executor(None, self.audio_server.resolve_track,
+                                          request.args.get('track'), request.args)
+
+    async def audio_stream(self, request, writer):
+        """WAV bytes with chunked encoding, as /audio/stream of the Flask app"""
+        track_name, track_path, error, code = await self.resolve_track(request)
+        if not track_path:
+            await self.send_error(request, writer, code, error)
+            return
+
+        file_size = track_path.stat().st_size
+        range_header = request.headers.get('range')
+        try:
+            range_start, range_end = parse_byte_range(range_header, file_size)
+        except RangeNotSatisfiable as e:
+            await self.send_simple(writer, 416, {'Content-Range': f'bytes */{e.limit}'},
+                                   keep_alive=request.keep_alive)
+            return
+
+        # Anything that isn't a readable WAV file is still served, just unpaced
+        try:
+            (rate, _, _, block_align), _, _ = read_wav_layout(track_path)
+            bytes_per_sec = rate * block_align
+        except ValueError:
+            bytes_per_sec = 0
+
+        # The board's chunk parser takes any chunk size, and sendfile wants
+        # big ones; the 128-byte requests of older firmware are rounded up
+        chunk_size = int(request.args.get('chunk_size', 256))
+        chunk_size = max(CHUNK_MIN, min(chunk_size, CHUNK_MAX))
+
+        headers = {
+            'Content-Type': 'audio/wav',
+            'Cache-Control': 'no-cache',
+            'Accept-Ranges': 'bytes',
+            'X-Chunk-Size': str(chunk_size),
+            'Transfer-Encoding': 'chunked',
+        }
+        if range_header:
+            headers['Content-Range'] = f'bytes {range_start}-{range_end}/{file_size}'
+        self.send_head(writer, 206 if range_header else 200, headers, request.keep_alive)
+
+        loop = asyncio.get_running_loop()
+        pacer = Pacer(bytes_per_sec)
+        offset, remaining = range_start, range_end - range_start + 1
+        self.stream_started('chunked', track_path, f'bytes {range_start}-{range_end}, '
+                            f'{chunk_size}-byte chunks')
+        complete = False
+        try:
+            with open(track_path, 'rb') as audio_file:
+                while remaining > 0:
+                    n = min(chunk_size, remaining)
+                    await pacer.wait(n)
+                    writer.write(b'%x\r\n' % n)
+                    sent = await loop.sendfile(writer.transport, audio_file, offset, n)
+                    # A file that shrank under us still fills the chunk it announced
+                    if sent < n:
+                        writer.write(bytes(n - sent))
+                    writer.write(b'\r\n')
+                    offset += n
+                    remaining -= n
+            writer.write(b'0\r\n\r\n')
+            await writer.drain()
+            complete = True
+        finally:
+            self.stream_finished('chunked', offset - range_start, complete)
+
+    async def audio_frames(self, request, writer):
+        """Binary frames with a Content-Length, as /audio/frames of the Flask app"""
+        track_name, track_path, error, code = await self.resolve_track(request)
+        if not track_path:
+            await self.send_error(request, writer, code, error)
+            return
+
+        range_header = request.headers.get('range')
+        try:
+            plan = FramePlan(track_path, int(request.args.get('frame_size', 512)), range_header)
+        except RangeNotSatisfiable as e:
+            await self.send_simple(writer, 416, {'Content-Range': f'bytes */{e.limit}'},
+                                   keep_alive=request.keep_alive)
+            return
+        except ValueError as e:
+            await self.send_error(request, writer, 415, f"Can't frame '{track_name}': {e}")
+            return
+
+        headers = {
+            'Content-Type': FRAME_CONTENT_TYPE,
+            'Cache-Control': 'no-cache',
+            'Accept-Ranges': 'bytes',
+            'Content-Length': str(plan.content_length),
+        }
+        self.send_head(writer, 206 if range_header else 200, headers, request.keep_alive)
+        writer.write(plan.format_frame())
+
+        # Headers sit between the payloads, so sendfile doesn't fit here;
+        # one large read feeds a whole batch of frames instead, and the
+        # payloads are handed to the transport as views into it
+        loop = asyncio.get_running_loop()
+        pacer = Pacer(plan.bytes_per_sec)
+        frames_per_batch = max(1, FRAME_BATCH // plan.frame_size)
+        layout = plan.pcm_frames_layout()
+        sent = 0
+        self.stream_started('framed', track_path, f'{plan.frame_size}-byte frames, '
+                            f'PCM bytes {plan.pcm_start}-{plan.data_end - 1}')
+        complete = False
+        try:
+            fd = os.open(track_path, os.O_RDONLY)
+            try:
+                while batch := list(itertools.islice(layout, frames_per_batch)):
+                    start = batch[0][1]
+                    size = batch[-1][1] + batch[-1][2] - start
+                    await pacer.wait(size)
+                    data = await loop.run_in_executor(None, os.pread, fd, size, start)
+                    # A file that shrank under us still ends with the promised length
+                    view = memoryview(data.ljust(size, b'\0'))
+                    parts = []
+                    for header, offset, length in batch:
+                        parts.append(header)
+                        parts.append(view[offset - start:offset - start + length])
+                    writer.writelines(parts)
+                    await writer.drain()
+                    sent += size
+            finally:
+                os.close(fd)
+            complete = True
+        finally:
+            self.stream_finished('framed', sent, complete)
+
+    async def relay_to_flask(self, request, writer, peer):
+        """Answer a control or page request with the Flask app"""
+        environ = {
+            'REQUEST_METHOD': request.method,
+            'SCRIPT_NAME': '',
+            'PATH_INFO': request.path,
+            'QUERY_STRING': request.query_string,
+            'SERVER_NAME': self.host,
+            'SERVER_PORT': str(self.port),
+            'SERVER_PROTOCOL': request.version,
+            'REMOTE_ADDR': peer[0] if peer else '',
+            'CONTENT_TYPE': request.headers.get('content-type', ''),
+            'CONTENT_LENGTH': str(len(request.body)),
+            'wsgi.version': (1, 0),
+            'wsgi.url_scheme': 'http',
+            'wsgi.input': io.BytesIO(request.body),
+            'wsgi.errors': sys.stderr,
+            'wsgi.multithread': True,
+            'wsgi.multiprocess': False,
+            'wsgi.run_once': False,
+        }
+        for name, value in request.headers.items():
+            if name not in ('content-type', 'content-length'):
+                environ['HTTP_' + name.upper().replace('-', '_')] = value
+
+        def call_app():
+            response = {}
+
+            def start_response(status, headers, exc_info=None):
+                response['status'] = int(status.split(' ', 1)[0])
+                response['headers'] = headers
+
+            result = self.app(environ, start_response)
+            try:
+                body = b''.join(result)
+            finally:
+                if hasattr(result, 'close'):
+                    result.close()
+            return response['status'], response['headers'], body
+
+        loop = asyncio.get_running_loop()
+        status, app_headers, body = await loop.run_in_executor(None, call_app)
+
+        headers = {name: value for name, value in app_headers
+                   if name.lower() not in HOP_HEADERS}
+        headers['Content-Length'] = str(len(body))
+        self.send_head(writer, status, headers, request.keep_alive)
+        if request.method != 'HEAD':
+            writer.write(body)
+        await writer.drain()
+
+
+def serve(app, audio_server, host: str, port: int):
+    """Run the backend until interrupted"""
+    asyncio.run(StreamBackend(app, audio_server, host, port).run())
@@ -0,0 +1,127 @@
+"""
+Transcoding cache for compressed sources (MP3, FLAC)
+
+The board only plays PCM WAV; decoding MP3 or FLAC on the STM32L4 is out
+of the question. A compressed track is decoded once with ffmpeg into the
+PCM format the board asks for, and the WAV file is kept in an on-disk
+cache addressed by the SHA-256 of the source and the target format. Every
+later play, seek or frame request streams that file like any other WAV.
+
+Cache entries are written to a temporary name and renamed into place, so
+a reader never sees a half-written file and concurrent first plays of the
+same track decode it only once.
+"""
+
+import hashlib
+import os
+import shutil
+import subprocess
+import threading
+from pathlib import Path
+from typing import NamedTuple
+
+COMPRESSED_EXTENSIONS = {'.mp3', '.flac'}
+HASH_BLOCK = 1024 * 1024
+SUPPORTED_BITS = {16: 'pcm_s16le', 24: 'pcm_s24le', 32: 'pcm_s32le'}
+
+
+class TranscodeError(Exception):
+    """The source can't be decoded to the requested format"""
+
+
+class TargetFormat(NamedTuple):
+    """PCM format a client wants to receive"""
+    sample_rate: int = 44100
+    channels: int = 2
+    bits_per_sample: int = 16
+
+    @classmethod
+    def from_args(cls, args):
+        """Format from the rate/channels/bits query parameters, defaults for missing ones"""
+        default = cls()
+        try:
+            fmt = cls(int(args.get('rate', default.sample_rate)),
+                      int(args.get('channels', default.channels)),
+                      int(args.get('bits', default.bits_per_sample)))
+        except ValueError:
+            raise TranscodeError('rate, channels and bits must be integers')
+        if not 8000 <= fmt.sample_rate <= 96000 or fmt.channels not in (1, 2) or \
+                fmt.bits_per_sample not in SUPPORTED_BITS:
+            raise TranscodeError(f'unsupported target format {fmt.sample_rate} Hz, '
+                                 f'{fmt.channels}ch, {fmt.bits_per_sample} bits')
+        return fmt
+
+    @property
+    def tag(self) -> str:
+        return f'pcm_s{self.bits_per_sample}le-{self.sample_rate}-{self.channels}ch'
+
+
+def needs_transcode(track_path: Path) -> bool:
+    return track_path.suffix.lower() in COMPRESSED_EXTENSIONS
+
+
+class TranscodeCache:
+    """Decoded WAV files for compressed sources, keyed by content and format"""
+
+    def __init__(self, cache_dir: Path, ffmpeg: str = 'ffmpeg'):
+        self.cache_dir = Path(cache_dir)
+        self.ffmpeg = ffmpeg
+        self.lock = threading.Lock()
+        self.key_locks = {}         # Cache entry -> lock held while it's decoded
+        self.hashes = {}            # (path, size, mtime) -> source hash
+
+    def source_hash(self, source: Path) -> str:
+        """SHA-256 of a source, hashed again only when the file changes"""
+        st = source.stat()
+        stamp = (str(source), st.st_size, st.st_mtime_ns)
+        with self.lock:
+            digest = self.hashes.get(stamp)
+        if digest:
+            return digest
+
+        h = hashlib.sha256()
+        with open(source, 'rb') as f:
+            while block := f.read(HASH_BLOCK):
+                h.update(block)
+        digest = h.hexdigest()
+        with self.lock:
+            self.hashes[stamp] = digest
+        return digest
+
+    def get(self, source: Path, fmt: TargetFormat) -> Path:
+        """Cached WAV for source in fmt, decoded now if this is its first play"""
+        entry = self.cache_dir / f'{self.source_hash(source)}-{fmt.tag}.wav'
+        if entry.exists():
+            return entry
+
+        with self.lock:
+            key_lock = self.key_locks.setdefault(entry, threading.Lock())
+        with key_lock:
+            # Someone else may have finished it while we waited
+            if not entry.exists():
+                self._decode(source, fmt, entry)
+        with self.lock:
+            self.key_locks.pop(entry, None)
+        return entry
+
+    def _decode(self, source: Path, fmt: TargetFormat, entry: Path):
+        if not shutil.which(self.ffmpeg):
+            raise TranscodeError(f"'{self.ffmpeg}' not found, can't decode {source.name}")
+
+        self.cache_dir.mkdir(parents=True, exist_ok=True)
+        tmp = entry.with_name(f'.{entry.name}.{os.getpid()}.{threading.get_ident()}.tmp')
+        # Bit-exact output without metadata: a plain 44-byte header and the
+        # same bytes on every run
+        cmd = [self.ffmpeg, '-nostdin', '-v', 'error', '-i', str(source),
+               '-vn', '-map_metadata', '-1', '-fflags', '+bitexact', '-flags:a', '+bitexact',
+               '-ar', str(fmt.sample_rate), '-ac', str(fmt.channels),
+               '-c:a', SUPPORTED_BITS[fmt.bits_per_sample], '-f', 'wav', str(tmp)]
+        print(f"Transcoding {source.name} to {fmt.tag}")
+        try:
+            result = subprocess.run(cmd, capture_output=True, text=True)
+            if result.returncode != 0:
+                raise TranscodeError(f"ffmpeg failed on {source.name}: {result.stderr.strip()}")
+            os.replace(tmp, entry)
+        finally:
+            tmp.unlink(missing_ok=True)
+        print(f"Cached {source.name} as {entry.name} ({entry.stat().st_size} bytes)")
@@ -0,0 +1,132 @@
+"""
+WAV layout and binary frame helpers shared by the streaming endpoints
+
+Used by the Flask routes in flask_server.py and by the asyncio streaming
+backend in stream_backend.py, so both send byte-identical responses.
+
+The frame layout must match src/server_client/stream_frame.h.
+"""
+
+import re
+import struct
+from pathlib import Path
+
+FRAME_CONTENT_TYPE = 'application/x-audio-frames'
+FRAME_HEADER = struct.Struct('<HBBIIHH')   # magic, version, flags, sequence, timestamp_ms, length, reserved
+FRAME_FORMAT = struct.Struct('<IHHHHII')   # rate, channels, bits, block_align, reserved, data_offset, data_size
+FRAME_MAGIC = 0x5246
+FRAME_VERSION = 1
+FRAME_FLAG_END_OF_STREAM = 0x01
+FRAME_FLAG_DISCONTINUITY = 0x02
+FRAME_FLAG_FORMAT = 0x80
+FRAME_MAX_PAYLOAD = 0xFFFF
+
+
+class RangeNotSatisfiable(ValueError):
+    """Range header outside the resource; `limit` goes into the 416 Content-Range"""
+
+    def __init__(self, limit: int):
+        super().__init__(f'range not satisfiable (size {limit})')
+        self.limit = limit
+
+
+def parse_byte_range(range_header, size: int):
+    """Parse "bytes=start-[end]" against a resource of `size` bytes
+
+    Returns (start, end) inclusive, the whole resource if there is no header.
+    """
+    if not range_header:
+        return 0, size - 1
+    match = re.match(r'bytes=(\d+)-(\d*)$', range_header.strip())
+    if not match or int(match.group(1)) >= size:
+        raise RangeNotSatisfiable(size)
+    end = size - 1
+    if match.group(2):
+        end = min(int(match.group(2)), size - 1)
+    return int(match.group(1)), end
+
+
+def read_wav_layout(track_path: Path):
+    """Find the format fields and the data chunk of a WAV file
+
+    Returns ((sample_rate, channels, bits_per_sample, block_align), data_offset, data_size)
+    """
+    file_size = track_path.stat().st_size
+    with open(track_path, 'rb') as f:
+        riff = f.read(12)
+        if len(riff) < 12 or riff[0:4] != b'RIFF' or riff[8:12] != b'WAVE':
+            raise ValueError('not a WAV file')
+        fmt = None
+        while True:
+            chunk = f.read(8)
+            if len(chunk) < 8:
+                raise ValueError('no data chunk')
+            chunk_id, chunk_size = struct.unpack('<4sI', chunk)
+            if chunk_id == b'fmt ':
+                body = f.read(chunk_size + (chunk_size & 1))
+                if len(body) < 16:
+                    raise ValueError('short fmt chunk')
+                _, channels, rate, _, block_align, bits = struct.unpack('<HHIIHH', body[:16])
+                fmt = (rate, channels, bits, block_align)
+            elif chunk_id == b'data':
+                if fmt is None:
+                    raise ValueError('data chunk before fmt chunk')
+                data_offset = f.tell()
+                return fmt, data_offset, min(chunk_size, file_size - data_offset)
+            else:
+                f.seek(chunk_size + (chunk_size & 1), 1)
+
+
+class FramePlan:
+    """Layout of one /audio/frames response
+
+    Raises ValueError for files that can't be framed and RangeNotSatisfiable
+    for a Range past the audio data.
+    """
+
+    def __init__(self, track_path: Path, frame_size: int, range_header=None):
+        fmt, self.data_offset, self.data_size = read_wav_layout(track_path)
+        self.rate, self.channels, self.bits, self.block_align = fmt
+        if self.block_align == 0 or self.rate == 0:
+            raise ValueError('bad format')
+        self.bytes_per_sec = self.rate * self.block_align
+
+        # Whole sample frames per payload so the client never splits a sample
+        frame_size = max(self.block_align, min(frame_size, FRAME_MAX_PAYLOAD))
+        self.frame_size = frame_size - frame_size % self.block_align
+
+        # Range is a file offset as for /audio/stream, rounded down to a sample frame
+        self.data_end = self.data_offset + self.data_size
+        self.pcm_start = self.data_offset
+        if range_header:
+            match = re.match(r'bytes=(\d+)-$', range_header.strip())
+            if not match or int(match.group(1)) >= self.data_end:
+                raise RangeNotSatisfiable(self.data_end)
+            self.pcm_start = max(int(match.group(1)), self.data_offset)
+            self.pcm_start -= (self.pcm_start - self.data_offset) % self.block_align
+
+        self.pcm_len = self.data_end - self.pcm_start
+        self.pcm_frames = max(1, -(-self.pcm_len // self.frame_size))
+        self.content_length = (FRAME_HEADER.size + FRAME_FORMAT.size +
+                               self.pcm_frames * FRAME_HEADER.size + self.pcm_len)
+
+    def _timestamp_ms(self, file_offset: int) -> int:
+        return ((file_offset - self.data_offset) * 1000 // self.bytes_per_sec) & 0xFFFFFFFF
+
+    def format_frame(self) -> bytes:
+        """The track description that opens every response"""
+        return (FRAME_HEADER.pack(FRAME_MAGIC, FRAME_VERSION, FRAME_FLAG_FORMAT, 0,
+                                  self._timestamp_ms(self.pcm_start), FRAME_FORMAT.size, 0) +
+                FRAME_FORMAT.pack(self.rate, self.channels, self.bits, self.block_align, 0,
+                                  self.data_offset, self.data_size))
+
+    def pcm_frames_layout(self):
+        """Yield (header bytes, file offset, payload length) for every PCM frame"""
+        position = self.pcm_start
+        for sequence in range(1, self.pcm_frames + 1):
+            length = min(self.frame_size, self.data_end - position)
+            flags = FRAME_FLAG_END_OF_STREAM if sequence == self.pcm_frames else 0
+            header = FRAME_HEADER.pack(FRAME_MAGIC, FRAME_VERSION, flags, sequence,
+                                       self._timestamp_ms(position), length, 0)
+            yield header, position, length
+            position += length
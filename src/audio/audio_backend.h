@@ -0,0 +1,72 @@
+/**
+ * @file audio_backend.h
+ * @brief Operations table implemented by each audio output
+ *
+ * audiosys.c keeps one registered backend per audio_output_type_t and
+ * drives the primary output and any mirrors (audio_config_t.mirror_outputs)
+ * through these operations. Every operation is required unless noted.
+ */
+
+#ifndef AUDIO_BACKEND_H
+#define AUDIO_BACKEND_H
+
+#include "audiosys.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Audio output backend
+ */
+struct audio_backend {
+    const char *name;
+
+    /** Submitted audio goes through the adaptive jitter buffer first */
+    bool jitter_buffer;
+
+    /** submit() links buffers through their node and offset fields.
+     *  Only one such output can take part in a fan-out */
+    bool queues_by_node;
+
+    int (*init)(const audio_format_t *format);
+    int (*start)(void);
+    int (*stop)(void);
+
+    /** Hold playback with everything queued kept; resume() carries on from
+     *  the next sample. Submits while paused queue up as usual */
+    int (*pause)(void);
+    int (*resume)(void);
+
+    int (*write)(const uint8_t *data, size_t len);
+    int (*write_timeout)(const uint8_t *data, size_t len, k_timeout_t timeout);
+
+    /**
+     * Take over one reference to @p buffer. Shared buffers must be left
+     * unmodified. Wait at most @p timeout for room - mirrors are fed with
+     * K_NO_WAIT so a slow one drops audio instead of holding up the rest.
+     * On failure the reference stays with the caller. An empty buffer
+     * (audio_buffer_is_end_marker()) carries no audio, only the end of
+     * the stream.
+     */
+    int (*submit)(struct audio_buffer *buffer, k_timeout_t timeout);
+
+    int (*flush)(void);
+    int (*set_volume)(uint8_t volume);
+    size_t (*get_free_space)(void);
+
+    /** Bytes submitted but not yet played (optional) */
+    size_t (*get_queued)(void);
+
+    int (*cleanup)(void);
+};
+
+/* Registered backends, see audiosys.c */
+extern const struct audio_backend bluetooth_audio_backend;
+extern const struct audio_backend buzzer_audio_backend;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUDIO_BACKEND_H */
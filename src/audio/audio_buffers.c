@@ -14,36 +14,58 @@
 
 #include "audio_buffers.h"
 #include "../utils/circular_buffers.h"
+#include "../utils/mem_plan.h"
+#include "../utils/trace.h"
 #include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/logging/log.h>
 #include <string.h>
 
-LOG_MODULE_REGISTER(audio_buffers, LOG_LEVEL_DBG);
+LOG_MODULE_REGISTER(audio_buffers, LOG_LEVEL_INF);
 
-/* Buffer pool configuration */
-#define MAX_AUDIO_BUFFERS 4
-#define BUFFER_SIZE_BYTES (2048)  // 2KB per buffer
+/* Buffer pool configuration - set through Kconfig, checked in utils/mem_plan.c */
+#define MAX_AUDIO_BUFFERS MEM_PLAN_POOL_COUNT
+#define BUFFER_SIZE_BYTES MEM_PLAN_POOL_BUFFER_SIZE
+
+/* Slab backing store; block i always belongs to descriptor i. Never read
+ * before it is written, so it can live in the uncleared SRAM2 region */
+static uint8_t MEM_PLAN_AUDIO_SECTION __aligned(4)
+    buffer_memory[MAX_AUDIO_BUFFERS][BUFFER_SIZE_BYTES];
 
 /* Audio buffer pool */
 static struct {
     /* Buffer pool */
     struct audio_buffer buffers[MAX_AUDIO_BUFFERS];
-    uint8_t buffer_memory[MAX_AUDIO_BUFFERS][BUFFER_SIZE_BYTES];
     
     /* Free buffer management */
     struct k_mem_slab buffer_slab;
-    struct k_mutex pool_mutex;
     
-    /* Statistics */
-    uint32_t buffers_allocated;
-    uint32_t buffers_freed;
-    uint32_t allocation_failures;
+    /* Statistics - atomics so alloc/free never take a lock */
+    atomic_t buffers_allocated;
+    atomic_t buffers_freed;
+    atomic_t allocation_failures;
     
     bool initialized;
 } buffer_pool = {
     .initialized = false
 };
 
+/**
+ * @brief Map a slab block back to its descriptor index, -1 if not ours
+ */
+static inline int buffer_index_from_mem(const void *mem)
+{
+    uintptr_t base = (uintptr_t)&buffer_memory[0][0];
+    uintptr_t addr = (uintptr_t)mem;
+    
+    if (addr < base || addr >= base + sizeof(buffer_memory) ||
+        ((addr - base) % BUFFER_SIZE_BYTES) != 0) {
+        return -1;
+    }
+    
+    return (int)((addr - base) / BUFFER_SIZE_BYTES);
+}
+
 int audio_buffer_pool_init(void)
 {
     if (buffer_pool.initialized) {
@@ -53,27 +75,26 @@ int audio_buffer_pool_init(void)
 
     /* Initialize memory slab for buffer allocation */
     k_mem_slab_init(&buffer_pool.buffer_slab, 
-                    buffer_pool.buffer_memory,
+                    buffer_memory,
                     BUFFER_SIZE_BYTES, 
                     MAX_AUDIO_BUFFERS);
 
-    /* Initialize mutex */
-    k_mutex_init(&buffer_pool.pool_mutex);
-
     /* Initialize all buffers */
     for (int i = 0; i < MAX_AUDIO_BUFFERS; i++) {
         struct audio_buffer *buf = &buffer_pool.buffers[i];
-        buf->data = buffer_pool.buffer_memory[i];
+        buf->data = buffer_memory[i];
         buf->size = BUFFER_SIZE_BYTES;
         buf->used = 0;
+        buf->offset = 0;
         buf->sequence = 0;
         buf->timestamp = 0;
         buf->flags = 0;
+        atomic_clear(&buf->refs);
     }
 
-    buffer_pool.buffers_allocated = 0;
-    buffer_pool.buffers_freed = 0;
-    buffer_pool.allocation_failures = 0;
+    atomic_clear(&buffer_pool.buffers_allocated);
+    atomic_clear(&buffer_pool.buffers_freed);
+    atomic_clear(&buffer_pool.allocation_failures);
     buffer_pool.initialized = true;
 
     LOG_INF("Audio buffer pool initialized: %d buffers x %d bytes", 
@@ -92,40 +113,33 @@ struct audio_buffer *audio_buffer_alloc(k_timeout_t timeout)
     void *mem;
     int ret = k_mem_slab_alloc(&buffer_pool.buffer_slab, &mem, timeout);
     if (ret != 0) {
-        k_mutex_lock(&buffer_pool.pool_mutex, K_FOREVER);
-        buffer_pool.allocation_failures++;
-        k_mutex_unlock(&buffer_pool.pool_mutex);
+        atomic_inc(&buffer_pool.allocation_failures);
         
-        LOG_WRN("Buffer allocation failed: %d", ret);
+        /* Timing out is the normal backpressure signal, not a fault */
+        trace_event(TRACE_POOL_ALLOC_FAILED, ret, 0);
         return NULL;
     }
 
-    /* Find the corresponding buffer structure */
-    struct audio_buffer *buf = NULL;
-    for (int i = 0; i < MAX_AUDIO_BUFFERS; i++) {
-        if (buffer_pool.buffers[i].data == mem) {
-            buf = &buffer_pool.buffers[i];
-            break;
-        }
-    }
-
-    if (!buf) {
+    /* Slab blocks and descriptors share an index */
+    int idx = buffer_index_from_mem(mem);
+    if (idx < 0) {
         LOG_ERR("Failed to find buffer structure");
         k_mem_slab_free(&buffer_pool.buffer_slab, mem);
         return NULL;
     }
+    struct audio_buffer *buf = &buffer_pool.buffers[idx];
 
     /* Reset buffer */
     buf->used = 0;
+    buf->offset = 0;
     buf->sequence = 0;
     buf->timestamp = k_uptime_get();
     buf->flags = 0;
+    atomic_set(&buf->refs, 1);
 
-    k_mutex_lock(&buffer_pool.pool_mutex, K_FOREVER);
-    buffer_pool.buffers_allocated++;
-    k_mutex_unlock(&buffer_pool.pool_mutex);
+    atomic_inc(&buffer_pool.buffers_allocated);
 
-    LOG_DBG("Buffer allocated: %p", buf);
+    trace_event(TRACE_POOL_ALLOC, idx, 0);
     return buf;
 }
 
@@ -136,35 +150,60 @@ int audio_buffer_free(struct audio_buffer *buffer)
     }
 
     /* Verify this is a valid buffer from our pool */
-    bool valid = false;
-    for (int i = 0; i < MAX_AUDIO_BUFFERS; i++) {
-        if (&buffer_pool.buffers[i] == buffer) {
-            valid = true;
-            break;
-        }
-    }
-
-    if (!valid) {
+    uintptr_t offset = (uintptr_t)buffer - (uintptr_t)&buffer_pool.buffers[0];
+    if ((uintptr_t)buffer < (uintptr_t)&buffer_pool.buffers[0] ||
+        offset >= sizeof(buffer_pool.buffers) ||
+        (offset % sizeof(struct audio_buffer)) != 0) {
         LOG_ERR("Attempting to free invalid buffer: %p", buffer);
         return -EINVAL;
     }
 
-    /* Clear buffer content for security */
+    /* Other holders still have it */
+    atomic_val_t refs = atomic_dec(&buffer->refs);
+    if (refs > 1) {
+        return 0;
+    }
+    if (refs < 1) {
+        atomic_inc(&buffer->refs);
+        LOG_ERR("Buffer %p freed twice", buffer);
+        return -EALREADY;
+    }
+
+#ifdef CONFIG_APP_AUDIO_BUFFER_SCRUB
+    /* Clear buffer content */
     memset(buffer->data, 0, buffer->size);
+#endif
     buffer->used = 0;
+    buffer->offset = 0;
     buffer->flags = 0;
 
     /* Free the memory */
     k_mem_slab_free(&buffer_pool.buffer_slab, buffer->data);
 
-    k_mutex_lock(&buffer_pool.pool_mutex, K_FOREVER);
-    buffer_pool.buffers_freed++;
-    k_mutex_unlock(&buffer_pool.pool_mutex);
+    atomic_inc(&buffer_pool.buffers_freed);
 
-    LOG_DBG("Buffer freed: %p", buffer);
+    trace_event(TRACE_POOL_FREE, offset / sizeof(struct audio_buffer), 0);
     return 0;
 }
 
+struct audio_buffer *audio_buffer_ref(struct audio_buffer *buffer)
+{
+    if (buffer) {
+        atomic_inc(&buffer->refs);
+    }
+    return buffer;
+}
+
+bool audio_buffer_is_shared(struct audio_buffer *buffer)
+{
+    return buffer && atomic_get(&buffer->refs) > 1;
+}
+
+bool audio_buffer_is_end_marker(struct audio_buffer *buffer)
+{
+    return buffer && buffer->used == 0 && (buffer->flags & AUDIO_BUFFER_FLAG_END_OF_STREAM);
+}
+
 size_t audio_buffer_write(struct audio_buffer *buffer, const uint8_t *data, size_t len)
 {
     if (!buffer || !data || len == 0) {
@@ -250,6 +289,7 @@ void audio_buffer_clear(struct audio_buffer *buffer)
     }
 
     buffer->used = 0;
+    buffer->offset = 0;
     buffer->flags = 0;
     LOG_DBG("Buffer cleared: %p", buffer);
 }
@@ -260,18 +300,16 @@ int audio_buffer_pool_get_stats(struct audio_buffer_stats *stats)
         return -EINVAL;
     }
 
-    k_mutex_lock(&buffer_pool.pool_mutex, K_FOREVER);
-    
+    /* Counters are read independently; the slab is the source of truth
+     * for occupancy so in_use/free stay consistent with each other */
     stats->total_buffers = MAX_AUDIO_BUFFERS;
-    stats->buffers_allocated = buffer_pool.buffers_allocated;
-    stats->buffers_freed = buffer_pool.buffers_freed;
-    stats->allocation_failures = buffer_pool.allocation_failures;
-    stats->buffers_in_use = buffer_pool.buffers_allocated - buffer_pool.buffers_freed;
+    stats->buffers_allocated = atomic_get(&buffer_pool.buffers_allocated);
+    stats->buffers_freed = atomic_get(&buffer_pool.buffers_freed);
+    stats->allocation_failures = atomic_get(&buffer_pool.allocation_failures);
+    stats->buffers_in_use = k_mem_slab_num_used_get(&buffer_pool.buffer_slab);
     
     /* Calculate free buffers */
     stats->free_buffers = MAX_AUDIO_BUFFERS - stats->buffers_in_use;
-    
-    k_mutex_unlock(&buffer_pool.pool_mutex);
 
     return 0;
 }
@@ -20,6 +20,7 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/sys/slist.h>
+#include <zephyr/sys/atomic.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
@@ -40,15 +41,21 @@ typedef enum {
 
 /**
  * @brief Audio buffer structure
+ * 
+ * A buffer can be held by several outputs at once (audio_buffer_ref()).
+ * While it is shared its data is read-only, and node and offset belong
+ * to at most one holder - the one that queues it intrusively.
  */
 struct audio_buffer {
     sys_snode_t node;          ///< List node for buffer management
     uint8_t *data;             ///< Buffer data pointer
     size_t size;               ///< Total buffer size
     size_t used;               ///< Currently used bytes
+    size_t offset;             ///< Bytes already taken by the consumer
     uint32_t sequence;         ///< Sequence number for ordering
-    int64_t timestamp;         ///< Timestamp for synchronization
+    int64_t timestamp;         ///< Uptime (ms) when the buffer started filling
     audio_buffer_flags_t flags;///< Buffer flags
+    atomic_t refs;             ///< Holders; the buffer returns to the pool at zero
 };
 
 /**
@@ -79,13 +86,44 @@ int audio_buffer_pool_init(void);
 struct audio_buffer *audio_buffer_alloc(k_timeout_t timeout);
 
 /**
- * @brief Free an audio buffer back to the pool
+ * @brief Release a reference to an audio buffer
+ * 
+ * The buffer goes back to the pool when its last holder releases it.
  * 
  * @param buffer Buffer to free
  * @return 0 on success, negative error code on failure
  */
 int audio_buffer_free(struct audio_buffer *buffer);
 
+/**
+ * @brief Take another reference to an allocated buffer
+ * 
+ * Each reference is released with its own audio_buffer_free().
+ * 
+ * @param buffer Buffer already held by the caller
+ * @return @p buffer
+ */
+struct audio_buffer *audio_buffer_ref(struct audio_buffer *buffer);
+
+/**
+ * @brief Check whether more than one holder has the buffer
+ * 
+ * @param buffer Buffer to check
+ * @return true if the data must be treated as read-only
+ */
+bool audio_buffer_is_shared(struct audio_buffer *buffer);
+
+/**
+ * @brief Check whether the buffer is an empty end-of-stream marker
+ * 
+ * Producers send one when the stream ends without a buffer left to carry
+ * AUDIO_BUFFER_FLAG_END_OF_STREAM; it holds no audio.
+ * 
+ * @param buffer Buffer to check
+ * @return true if the buffer only marks the end of the stream
+ */
+bool audio_buffer_is_end_marker(struct audio_buffer *buffer);
+
 /**
  * @brief Write data to an audio buffer
  * 
@@ -0,0 +1,189 @@
+/**
+ * @file audio_codec.c
+ * @brief Encoder stage for audio sent over the GATT audio service
+ * 
+ * Please refer to audio_codec.h for more documentation.
+ */
+
+#include "audio_codec.h"
+#include <errno.h>
+#include <string.h>
+
+#define IMA_HEADER_SIZE 4   /* Per channel */
+#define IMA_MAX_INDEX 88
+
+static const int16_t ima_step_table[IMA_MAX_INDEX + 1] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int8_t ima_index_table[8] = {
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static inline int16_t pcm_sample(const uint8_t *pcm, size_t index)
+{
+    return (int16_t)(pcm[2 * index] | (pcm[2 * index + 1] << 8));
+}
+
+/* Quantise one sample against the running predictor */
+static uint8_t ima_encode_sample(int32_t *predictor, uint8_t *index, int16_t sample)
+{
+    int32_t step = ima_step_table[*index];
+    int32_t diff = sample - *predictor;
+    int32_t delta = step >> 3;
+    uint8_t code = 0;
+    
+    if (diff < 0) {
+        code = 8;
+        diff = -diff;
+    }
+    if (diff >= step) {
+        code |= 4;
+        diff -= step;
+        delta += step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+        code |= 2;
+        diff -= step;
+        delta += step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+        code |= 1;
+        delta += step;
+    }
+    
+    *predictor += (code & 8) ? -delta : delta;
+    if (*predictor > INT16_MAX) {
+        *predictor = INT16_MAX;
+    } else if (*predictor < INT16_MIN) {
+        *predictor = INT16_MIN;
+    }
+    
+    int idx = *index + ima_index_table[code & 7];
+    *index = (idx < 0) ? 0 : (idx > IMA_MAX_INDEX) ? IMA_MAX_INDEX : idx;
+    
+    return code;
+}
+
+static size_t ima_samples_per_frame(const struct audio_codec_state *state, size_t frame_size)
+{
+    size_t header = IMA_HEADER_SIZE * state->channels;
+    
+    if (frame_size <= header) {
+        return 0;
+    }
+    /* First sample rides in the header, the rest take a nibble each */
+    return 1 + ((frame_size - header) * 2) / state->channels;
+}
+
+static size_t ima_encode(struct audio_codec_state *state, const uint8_t *pcm, size_t pcm_len,
+                         uint8_t *frame, size_t frame_size, size_t *pcm_used)
+{
+    uint16_t channels = state->channels;
+    size_t samples = pcm_len / (2 * channels);
+    size_t max_samples = ima_samples_per_frame(state, frame_size);
+    int32_t predictor[AUDIO_CODEC_MAX_CHANNELS];
+    uint8_t *out = frame;
+    
+    *pcm_used = 0;
+    
+    if (samples > max_samples) {
+        samples = max_samples;
+    }
+    if (channels == 1 && samples > 1 && (samples - 1) % 2) {
+        /* Mono codes come in pairs - leave the odd sample for the next frame */
+        samples--;
+    }
+    if (samples == 0) {
+        return 0;
+    }
+    
+    for (uint16_t ch = 0; ch < channels; ch++) {
+        int16_t first = pcm_sample(pcm, ch);
+        
+        predictor[ch] = first;
+        *out++ = (uint8_t)(first & 0xFF);
+        *out++ = (uint8_t)((uint16_t)first >> 8);
+        *out++ = state->step_index[ch];
+        *out++ = 0;
+    }
+    
+    if (channels == 1) {
+        for (size_t i = 1; i < samples; i += 2) {
+            uint8_t lo = ima_encode_sample(&predictor[0], &state->step_index[0], pcm_sample(pcm, i));
+            uint8_t hi = ima_encode_sample(&predictor[0], &state->step_index[0], pcm_sample(pcm, i + 1));
+            *out++ = lo | (hi << 4);
+        }
+    } else {
+        for (size_t i = 1; i < samples; i++) {
+            uint8_t left = ima_encode_sample(&predictor[0], &state->step_index[0],
+                                             pcm_sample(pcm, 2 * i));
+            uint8_t right = ima_encode_sample(&predictor[1], &state->step_index[1],
+                                              pcm_sample(pcm, 2 * i + 1));
+            *out++ = left | (right << 4);
+        }
+    }
+    
+    *pcm_used = samples * 2 * channels;
+    return out - frame;
+}
+
+static const struct audio_codec codec_pcm = {
+    .id = AUDIO_CODEC_PCM,
+    .name = "PCM",
+    .samples_per_frame = NULL,
+    .encode = NULL,
+};
+
+static const struct audio_codec codec_ima_adpcm = {
+    .id = AUDIO_CODEC_IMA_ADPCM,
+    .name = "IMA-ADPCM",
+    .samples_per_frame = ima_samples_per_frame,
+    .encode = ima_encode,
+};
+
+const struct audio_codec *audio_codec_get(audio_codec_id_t id)
+{
+    switch (id) {
+    case AUDIO_CODEC_PCM:
+        return &codec_pcm;
+    case AUDIO_CODEC_IMA_ADPCM:
+        return &codec_ima_adpcm;
+    default:
+        return NULL;
+    }
+}
+
+int audio_codec_reset(struct audio_codec_state *state, uint16_t channels)
+{
+    if (!state || channels == 0 || channels > AUDIO_CODEC_MAX_CHANNELS) {
+        return -EINVAL;
+    }
+    
+    memset(state, 0, sizeof(*state));
+    state->channels = channels;
+    return 0;
+}
+
+size_t audio_codec_pcm_bytes(const struct audio_codec *codec,
+                             const struct audio_codec_state *state, size_t frame_size)
+{
+    if (!codec || !state) {
+        return 0;
+    }
+    
+    if (!codec->samples_per_frame) {
+        return frame_size - (frame_size % (2 * state->channels));
+    }
+    return codec->samples_per_frame(state, frame_size) * 2 * state->channels;
+}
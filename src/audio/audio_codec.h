@@ -0,0 +1,113 @@
+/**
+ * @file audio_codec.h
+ * @brief Encoder stage for audio sent over the GATT audio service
+ * 
+ * Raw 16-bit PCM needs far more bandwidth than a BLE 4.1 link carries, so
+ * the Bluetooth sender can compress each notification with one of the
+ * codecs registered here. Every codec frame fills at most one notification
+ * and decodes on its own, so a dropped notification costs one frame and
+ * never desynchronises the decoder.
+ * 
+ * IMA-ADPCM frame layout (little endian):
+ *   per channel: int16 first sample, uint8 step index, uint8 reserved
+ *   then 4-bit codes for the remaining samples:
+ *     mono   - two samples per byte, earlier sample in the low nibble
+ *     stereo - one sample frame per byte, left in the low nibble
+ * The number of samples follows from the notification length.
+ * 
+ * SBC and LC3 have reserved ids; adding one means providing its
+ * struct audio_codec and listing it in audio_codec_get().
+ */
+
+#ifndef AUDIO_CODEC_H
+#define AUDIO_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Codec identifiers, as advertised on the audio info characteristic
+ */
+typedef enum {
+    AUDIO_CODEC_PCM = 0,         ///< Uncompressed 16-bit PCM
+    AUDIO_CODEC_IMA_ADPCM = 1,   ///< IMA-ADPCM, 4 bits per sample (4:1)
+    AUDIO_CODEC_SBC = 2,         ///< Reserved
+    AUDIO_CODEC_LC3 = 3          ///< Reserved
+} audio_codec_id_t;
+
+#define AUDIO_CODEC_MAX_CHANNELS 2
+
+/**
+ * @brief Encoder state carried from one frame to the next
+ */
+struct audio_codec_state {
+    uint16_t channels;
+    uint8_t step_index[AUDIO_CODEC_MAX_CHANNELS];  ///< IMA-ADPCM quantiser step
+};
+
+/**
+ * @brief Codec descriptor
+ */
+struct audio_codec {
+    audio_codec_id_t id;
+    const char *name;
+    
+    /**
+     * @brief PCM sample frames that fill one codec frame of @p frame_size bytes
+     */
+    size_t (*samples_per_frame)(const struct audio_codec_state *state, size_t frame_size);
+    
+    /**
+     * @brief Encode one frame
+     * 
+     * @param state Encoder state, updated on return
+     * @param pcm Interleaved 16-bit PCM
+     * @param pcm_len PCM bytes available (whole sample frames)
+     * @param frame Output buffer
+     * @param frame_size Output capacity, one notification
+     * @param pcm_used Set to the PCM bytes consumed
+     * @return Encoded bytes, 0 if @p pcm_len is too short for a frame
+     *         (NULL for PCM, which is sent as is)
+     */
+    size_t (*encode)(struct audio_codec_state *state, const uint8_t *pcm, size_t pcm_len,
+                     uint8_t *frame, size_t frame_size, size_t *pcm_used);
+};
+
+/**
+ * @brief Look up a codec
+ * 
+ * @param id Codec identifier
+ * @return Codec descriptor, or NULL if it is not built in
+ */
+const struct audio_codec *audio_codec_get(audio_codec_id_t id);
+
+/**
+ * @brief Reset encoder state for a new stream
+ * 
+ * @param state State to reset
+ * @param channels Channel count (1 or 2)
+ * @return 0 on success, -EINVAL for unsupported channel counts
+ */
+int audio_codec_reset(struct audio_codec_state *state, uint16_t channels);
+
+/**
+ * @brief PCM bytes that fill one codec frame
+ * 
+ * @param codec Codec descriptor
+ * @param state Encoder state
+ * @param frame_size Output capacity, one notification
+ * @return PCM bytes per full frame
+ */
+size_t audio_codec_pcm_bytes(const struct audio_codec *codec,
+                             const struct audio_codec_state *state, size_t frame_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUDIO_CODEC_H */
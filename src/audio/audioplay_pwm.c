@@ -0,0 +1,489 @@
+/**
+ * @file audioplay_pwm.c
+ * @brief DMA-driven PWM output for the buzzer backend
+ *
+ * TIM2 runs the pwm-audio channel with one PWM period per sample. Each
+ * timer update raises a DMA request that copies the next duty cycle into
+ * CCR1, so samples reach the pin without the CPU. The DMA channel loops
+ * over a buffer of two halves: the half-transfer and transfer-complete
+ * interrupts refill the half just played from a ring of duty values.
+ *
+ * The ring is filled from PCM in thread context: directly by writes, and
+ * for submitted pool buffers by a work item that converts from a small
+ * queue of buffer references whenever the interrupt frees up ring space.
+ * A submitted buffer is only read, so it can be shared with other outputs.
+ *
+ * Playback is 16-bit PCM, folded down to the one pin. When the ring runs
+ * dry the output holds mid-scale (silence) and counts an underrun.
+ */
+
+#include "audiosys.h"
+#include "audio_backend.h"
+#include "pcm_dsp.h"
+#include "../utils/circular_buffers.h"
+#include "../utils/mem_plan.h"
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/dma.h>
+#include <zephyr/drivers/pwm.h>
+#include <zephyr/logging/log.h>
+#include <soc.h>
+#include <stm32_ll_tim.h>
+
+LOG_MODULE_REGISTER(audioplay_pwm, LOG_LEVEL_INF);
+
+#define PWM_AUDIO_NODE        DT_ALIAS(pwm_audio)
+#define PWM_AUDIO_TIMER       ((TIM_TypeDef *)DT_REG_ADDR(DT_PARENT(PWM_AUDIO_NODE)))
+#define PWM_AUDIO_CHANNEL     1     /* TIM2_CH1 on PA15, see app.overlay */
+#define PWM_DMA_NODE          DT_NODELABEL(dma1)
+
+#define PWM_RING_SIZE         MEM_PLAN_PWM_RING_SIZE
+#define PWM_HALF_SAMPLES      MEM_PLAN_PWM_DMA_HALF_SAMPLES
+#define PWM_CONVERT_CHUNK     64    /* Duty values converted per ring span */
+#define PWM_SUBMIT_DEPTH      4     /* Pool buffers queued ahead of the ring */
+
+/* PWM state, shared with the DMA interrupt */
+static struct {
+    const struct device *pwm;
+    const struct device *dma;
+    bool initialized;
+    bool running;
+    bool paused;                  ///< DMA armed mid-buffer, timer requests held off
+    audio_format_t format;
+    uint32_t period;              ///< Timer cycles per sample
+    int16_t gain;                 ///< Q15 volume gain
+    spsc_buffer_t ring;           ///< Duty values, written by threads, read by the DMA ISR
+    uint16_t idle_duty;           ///< Mid-scale, played while the ring is empty
+    bool starved;                 ///< The last refill ran out of duty values
+    uint32_t underruns;
+    struct k_mutex feed_lock;     ///< Serialises the ring's producers: writes and the feeder
+    struct k_work feed_work;      ///< Converts submitted buffers as ring space frees up
+    struct audio_buffer *feeding; ///< Submitted buffer being converted
+    size_t feed_offset;           ///< Bytes of @c feeding already converted
+    struct dma_config dma_cfg;
+    struct dma_block_config dma_block;
+} pwm_audio;
+
+/* Duty values live in the audio section with the other pools */
+static uint8_t MEM_PLAN_AUDIO_SECTION __aligned(4) pwm_ring_data[PWM_RING_SIZE];
+static uint16_t MEM_PLAN_AUDIO_SECTION pwm_dma_buffer[2][PWM_HALF_SAMPLES];
+
+/* References to submitted pool buffers, oldest first */
+K_MSGQ_DEFINE(pwm_submit_queue, sizeof(struct audio_buffer *), PWM_SUBMIT_DEPTH, 4);
+
+static int audioplay_buzzer_resume(void);
+
+/**
+ * @brief Refill one half of the DMA buffer from the ring (ISR context)
+ */
+static void pwm_refill_half(uint16_t *half)
+{
+    size_t got = spsc_buffer_read(&pwm_audio.ring, (uint8_t *)half,
+                                  PWM_HALF_SAMPLES * sizeof(uint16_t)) / sizeof(uint16_t);
+
+    if (got < PWM_HALF_SAMPLES) {
+        for (size_t i = got; i < PWM_HALF_SAMPLES; i++) {
+            half[i] = pwm_audio.idle_duty;
+        }
+        if (pwm_audio.running && !pwm_audio.starved) {
+            pwm_audio.underruns++;
+        }
+    }
+    pwm_audio.starved = (got < PWM_HALF_SAMPLES);
+}
+
+static void pwm_dma_callback(const struct device *dev, void *user_data,
+                             uint32_t channel, int status)
+{
+    if (status < 0) {
+        LOG_ERR("PWM audio DMA error: %d", status);
+        return;
+    }
+
+    /* Half transfer: the first half has been played, refill it while the second plays */
+    pwm_refill_half(status == DMA_STATUS_BLOCK ? pwm_dma_buffer[0] : pwm_dma_buffer[1]);
+
+    /* Ring space was freed - let the feeder top it up from submitted buffers */
+    k_work_submit(&pwm_audio.feed_work);
+}
+
+/**
+ * @brief Convert PCM frames into duty values in the ring
+ *
+ * @return Bytes of PCM consumed (whole frames)
+ */
+static size_t pwm_convert(const uint8_t *data, size_t len)
+{
+    const uint16_t channels = pwm_audio.format.channels;
+    const size_t frame_bytes = channels * sizeof(int16_t);
+    const int16_t *pcm = (const int16_t *)data;
+    size_t frames = len / frame_bytes;
+    size_t done = 0;
+
+    while (done < frames) {
+        uint8_t *span;
+        size_t count = spsc_buffer_reserve(&pwm_audio.ring, &span,
+                                           MIN(frames - done, PWM_CONVERT_CHUNK) *
+                                           sizeof(uint16_t)) / sizeof(uint16_t);
+        uint16_t *duty = (uint16_t *)span;
+
+        if (count == 0) {
+            break;
+        }
+
+        for (size_t i = 0; i < count; i++, pcm += channels) {
+            int32_t sample = (channels == 2) ? ((int32_t)pcm[0] + pcm[1]) / 2 : pcm[0];
+            uint32_t level = (uint32_t)(((sample * pwm_audio.gain) >> 15) + 32768);
+
+            duty[i] = (uint16_t)((level * pwm_audio.period) >> 16);
+        }
+
+        spsc_buffer_commit(&pwm_audio.ring, count * sizeof(uint16_t));
+        done += count;
+    }
+
+    return done * frame_bytes;
+}
+
+/**
+ * @brief Feeder - converts queued pool buffers into the ring until it fills
+ */
+static void pwm_feed_work_handler(struct k_work *work)
+{
+    const size_t frame_bytes = pwm_audio.format.channels * sizeof(int16_t);
+
+    k_mutex_lock(&pwm_audio.feed_lock, K_FOREVER);
+    while (true) {
+        struct audio_buffer *buf = pwm_audio.feeding;
+
+        if (!buf) {
+            if (k_msgq_get(&pwm_submit_queue, &buf, K_NO_WAIT) != 0) {
+                break;
+            }
+            pwm_audio.feeding = buf;
+            pwm_audio.feed_offset = 0;
+        }
+
+        pwm_audio.feed_offset += pwm_convert(&buf->data[pwm_audio.feed_offset],
+                                             buf->used - pwm_audio.feed_offset);
+        if (buf->used - pwm_audio.feed_offset >= frame_bytes) {
+            break;  /* Ring full, the next DMA interrupt resubmits us */
+        }
+
+        pwm_audio.feeding = NULL;
+        audio_buffer_free(buf);
+    }
+    k_mutex_unlock(&pwm_audio.feed_lock);
+}
+
+/**
+ * @brief Release every submitted buffer not yet converted
+ */
+static void pwm_drop_submitted(void)
+{
+    struct audio_buffer *buf;
+
+    k_mutex_lock(&pwm_audio.feed_lock, K_FOREVER);
+    while (k_msgq_get(&pwm_submit_queue, &buf, K_NO_WAIT) == 0) {
+        audio_buffer_free(buf);
+    }
+    if (pwm_audio.feeding) {
+        audio_buffer_free(pwm_audio.feeding);
+        pwm_audio.feeding = NULL;
+    }
+    k_mutex_unlock(&pwm_audio.feed_lock);
+}
+
+static int audioplay_buzzer_init(const audio_format_t *format)
+{
+    uint64_t cycles_per_sec;
+    int ret;
+
+    if (pwm_audio.initialized) {
+        return 0;
+    }
+
+    if (!format || format->bits_per_sample != 16 || format->sample_rate == 0 ||
+        (format->channels != 1 && format->channels != 2)) {
+        LOG_ERR("PWM audio needs 16-bit mono or stereo PCM");
+        return -EINVAL;
+    }
+
+    pwm_audio.pwm = DEVICE_DT_GET(PWM_AUDIO_NODE);
+    pwm_audio.dma = DEVICE_DT_GET(PWM_DMA_NODE);
+    if (!device_is_ready(pwm_audio.pwm) || !device_is_ready(pwm_audio.dma)) {
+        LOG_ERR("PWM audio timer or DMA controller not ready");
+        return -ENODEV;
+    }
+
+    ret = pwm_get_cycles_per_sec(pwm_audio.pwm, PWM_AUDIO_CHANNEL, &cycles_per_sec);
+    if (ret < 0) {
+        return ret;
+    }
+
+    pwm_audio.format = *format;
+    pwm_audio.period = (uint32_t)(cycles_per_sec / format->sample_rate);
+    pwm_audio.idle_duty = (uint16_t)(pwm_audio.period / 2);
+    pwm_audio.gain = pcm_volume_to_q15(100);
+    pwm_audio.underruns = 0;
+    pwm_audio.starved = false;
+    if (pwm_audio.period < 256 || pwm_audio.period > UINT16_MAX) {
+        LOG_ERR("PWM audio: %u timer cycles per sample out of range", pwm_audio.period);
+        return -ERANGE;
+    }
+
+    ret = spsc_buffer_init(&pwm_audio.ring, pwm_ring_data, sizeof(pwm_ring_data));
+    if (ret < 0) {
+        return ret;
+    }
+    k_mutex_init(&pwm_audio.feed_lock);
+    k_work_init(&pwm_audio.feed_work, pwm_feed_work_handler);
+    pwm_audio.feeding = NULL;
+
+    /* Circular memory-to-peripheral transfer into CCR1, one halfword per update */
+    pwm_audio.dma_block = (struct dma_block_config){
+        .source_address = (uint32_t)pwm_dma_buffer,
+        .dest_address = (uint32_t)&PWM_AUDIO_TIMER->CCR1,
+        .block_size = sizeof(pwm_dma_buffer),
+        .source_addr_adj = DMA_ADDR_ADJ_INCREMENT,
+        .dest_addr_adj = DMA_ADDR_ADJ_NO_CHANGE,
+    };
+    pwm_audio.dma_cfg = (struct dma_config){
+        .dma_slot = CONFIG_APP_AUDIO_PWM_DMA_REQUEST,
+        .channel_direction = MEMORY_TO_PERIPHERAL,
+        .cyclic = 1,
+        .source_data_size = sizeof(uint16_t),
+        .dest_data_size = sizeof(uint16_t),
+        .source_burst_length = 1,
+        .dest_burst_length = 1,
+        .block_count = 1,
+        .head_block = &pwm_audio.dma_block,
+        .dma_callback = pwm_dma_callback,
+    };
+
+    pwm_audio.initialized = true;
+    LOG_INF("🔈 PWM audio ready: %u Hz, %u timer cycles per sample (%u-sample DMA halves)",
+            format->sample_rate, pwm_audio.period, PWM_HALF_SAMPLES);
+    return 0;
+}
+
+static int audioplay_buzzer_start(void)
+{
+    int ret;
+
+    if (!pwm_audio.initialized) {
+        return -EINVAL;
+    }
+    if (pwm_audio.running) {
+        return 0;
+    }
+    if (pwm_audio.paused) {
+        return audioplay_buzzer_resume();
+    }
+
+    /* Prime both halves with whatever is queued so the first requests have data */
+    pwm_refill_half(pwm_dma_buffer[0]);
+    pwm_refill_half(pwm_dma_buffer[1]);
+
+    ret = pwm_set_cycles(pwm_audio.pwm, PWM_AUDIO_CHANNEL, pwm_audio.period,
+                         pwm_audio.idle_duty, PWM_POLARITY_NORMAL);
+    if (ret < 0) {
+        LOG_ERR("PWM audio: failed to start the timer: %d", ret);
+        return ret;
+    }
+
+    ret = dma_config(pwm_audio.dma, CONFIG_APP_AUDIO_PWM_DMA_CHANNEL, &pwm_audio.dma_cfg);
+    if (ret == 0) {
+        ret = dma_start(pwm_audio.dma, CONFIG_APP_AUDIO_PWM_DMA_CHANNEL);
+    }
+    if (ret < 0) {
+        LOG_ERR("PWM audio: failed to start DMA: %d", ret);
+        pwm_set_cycles(pwm_audio.pwm, PWM_AUDIO_CHANNEL, pwm_audio.period, 0,
+                       PWM_POLARITY_NORMAL);
+        return ret;
+    }
+
+    /* From here on every timer update moves one sample without the CPU */
+    LL_TIM_EnableDMAReq_UPDATE(PWM_AUDIO_TIMER);
+    pwm_audio.running = true;
+
+    LOG_INF("🔈 PWM audio started");
+    return 0;
+}
+
+static int audioplay_buzzer_stop(void)
+{
+    if (!pwm_audio.running && !pwm_audio.paused) {
+        return 0;
+    }
+
+    pwm_audio.running = false;
+    pwm_audio.paused = false;
+    LL_TIM_DisableDMAReq_UPDATE(PWM_AUDIO_TIMER);
+    dma_stop(pwm_audio.dma, CONFIG_APP_AUDIO_PWM_DMA_CHANNEL);
+    pwm_set_cycles(pwm_audio.pwm, PWM_AUDIO_CHANNEL, pwm_audio.period, 0, PWM_POLARITY_NORMAL);
+
+    LOG_INF("PWM audio stopped (%u underruns)", pwm_audio.underruns);
+    return 0;
+}
+
+static int audioplay_buzzer_pause(void)
+{
+    if (!pwm_audio.running) {
+        return -EINVAL;
+    }
+
+    /* The DMA channel keeps its place in the buffer; only the requests stop */
+    LL_TIM_DisableDMAReq_UPDATE(PWM_AUDIO_TIMER);
+    PWM_AUDIO_TIMER->CCR1 = pwm_audio.idle_duty;
+    pwm_audio.running = false;
+    pwm_audio.paused = true;
+    return 0;
+}
+
+static int audioplay_buzzer_resume(void)
+{
+    if (!pwm_audio.paused) {
+        return pwm_audio.running ? 0 : -EINVAL;
+    }
+
+    pwm_audio.starved = false;
+    pwm_audio.paused = false;
+    pwm_audio.running = true;
+    LL_TIM_EnableDMAReq_UPDATE(PWM_AUDIO_TIMER);
+    return 0;
+}
+
+static int audioplay_buzzer_write(const uint8_t *data, size_t len)
+{
+    if (!pwm_audio.initialized) {
+        return -EINVAL;
+    }
+    if (!data) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&pwm_audio.feed_lock, K_FOREVER);
+    size_t written = pwm_convert(data, len);
+    k_mutex_unlock(&pwm_audio.feed_lock);
+
+    return (int)written;
+}
+
+static int audioplay_buzzer_write_timeout(const uint8_t *data, size_t len, k_timeout_t timeout)
+{
+    size_t written = 0;
+
+    if (!pwm_audio.initialized || !data) {
+        return -EINVAL;
+    }
+
+    while (true) {
+        k_mutex_lock(&pwm_audio.feed_lock, K_FOREVER);
+        written += pwm_convert(&data[written], len - written);
+        k_mutex_unlock(&pwm_audio.feed_lock);
+        if (len - written < pwm_audio.format.channels * sizeof(int16_t)) {
+            break;
+        }
+        /* The DMA interrupt gives space_available each time it drains a half */
+        if (k_sem_take(&pwm_audio.ring.space_available, timeout) != 0) {
+            break;
+        }
+    }
+
+    return (int)written;
+}
+
+static int audioplay_buzzer_flush(void)
+{
+    if (!pwm_audio.initialized) {
+        return -EINVAL;
+    }
+
+    /* Up to two DMA halves already copied out still play */
+    pwm_drop_submitted();
+
+    /* The DMA interrupt is the ring's consumer, keep it out while clearing */
+    unsigned int key = irq_lock();
+    spsc_buffer_clear(&pwm_audio.ring);
+    irq_unlock(key);
+    return 0;
+}
+
+static int audioplay_buzzer_submit(struct audio_buffer *buffer, k_timeout_t timeout)
+{
+    if (!pwm_audio.initialized) {
+        return -EINVAL;
+    }
+    if (audio_buffer_is_end_marker(buffer)) {
+        /* Nothing to play, and an idle ring already plays silence */
+        audio_buffer_free(buffer);
+        return 0;
+    }
+    if (!buffer || buffer->used == 0) {
+        return -EINVAL;
+    }
+
+    if (k_msgq_put(&pwm_submit_queue, &buffer, timeout) != 0) {
+        return -ENOBUFS;
+    }
+    k_work_submit(&pwm_audio.feed_work);
+    return 0;
+}
+
+static size_t audioplay_buzzer_get_queued(void)
+{
+    if (!pwm_audio.initialized) {
+        return 0;
+    }
+
+    return (spsc_buffer_size_get(&pwm_audio.ring) / sizeof(uint16_t)) *
+           pwm_audio.format.channels * sizeof(int16_t);
+}
+
+static int audioplay_buzzer_set_volume(uint8_t volume)
+{
+    /* Takes effect from the next write; queued duty values keep their level */
+    pwm_audio.gain = pcm_volume_to_q15(volume);
+    return 0;
+}
+
+static size_t audioplay_buzzer_get_free_space(void)
+{
+    if (!pwm_audio.initialized) {
+        return 0;
+    }
+
+    return (spsc_buffer_space_get(&pwm_audio.ring) / sizeof(uint16_t)) *
+           pwm_audio.format.channels * sizeof(int16_t);
+}
+
+static int audioplay_buzzer_cleanup(void)
+{
+    audioplay_buzzer_stop();
+
+    if (pwm_audio.initialized) {
+        k_work_cancel(&pwm_audio.feed_work);
+        pwm_drop_submitted();
+        spsc_buffer_cleanup(&pwm_audio.ring);
+        pwm_audio.initialized = false;
+    }
+    return 0;
+}
+
+const struct audio_backend buzzer_audio_backend = {
+    .name = "PWM",
+    .init = audioplay_buzzer_init,
+    .start = audioplay_buzzer_start,
+    .stop = audioplay_buzzer_stop,
+    .pause = audioplay_buzzer_pause,
+    .resume = audioplay_buzzer_resume,
+    .write = audioplay_buzzer_write,
+    .write_timeout = audioplay_buzzer_write_timeout,
+    .submit = audioplay_buzzer_submit,
+    .flush = audioplay_buzzer_flush,
+    .set_volume = audioplay_buzzer_set_volume,
+    .get_free_space = audioplay_buzzer_get_free_space,
+    .get_queued = audioplay_buzzer_get_queued,
+    .cleanup = audioplay_buzzer_cleanup,
+};
@@ -4,54 +4,99 @@
  * 
  * These are minimal stub implementations to satisfy the linker when
  * the main focus is Bluetooth audio testing. The audiosys.c expects
- * these functions to exist as backend implementations.
+ * these functions to exist as backend implementations. Built only when
+ * CONFIG_APP_AUDIO_PWM is off; audioplay_pwm.c is the real backend.
  */
 
 #include "audiosys.h"
+#include "audio_backend.h"
 #include <zephyr/logging/log.h>
 
 LOG_MODULE_REGISTER(audioplay_stubs, LOG_LEVEL_DBG);
 
 /* Stub implementations for PWM/buzzer backend */
 
-int audioplay_buzzer_init(const audio_format_t *format)
+static int audioplay_buzzer_init(const audio_format_t *format)
 {
     LOG_WRN("PWM/buzzer audio not implemented - using stub");
     return 0; // Return success for now
 }
 
-int audioplay_buzzer_start(void)
+static int audioplay_buzzer_start(void)
 {
     LOG_WRN("PWM/buzzer start not implemented - using stub");
     return 0;
 }
 
-int audioplay_buzzer_stop(void)
+static int audioplay_buzzer_stop(void)
 {
     LOG_WRN("PWM/buzzer stop not implemented - using stub");
     return 0;
 }
 
-int audioplay_buzzer_write(const uint8_t *data, size_t len)
+static int audioplay_buzzer_pause(void)
+{
+    return 0;
+}
+
+static int audioplay_buzzer_resume(void)
+{
+    return 0;
+}
+
+static int audioplay_buzzer_write(const uint8_t *data, size_t len)
 {
     LOG_WRN("PWM/buzzer write not implemented - using stub (ignoring %zu bytes)", len);
     return len; // Pretend we wrote all the data
 }
 
-int audioplay_buzzer_set_volume(uint8_t volume)
+static int audioplay_buzzer_write_timeout(const uint8_t *data, size_t len, k_timeout_t timeout)
+{
+    return audioplay_buzzer_write(data, len);
+}
+
+static int audioplay_buzzer_flush(void)
+{
+    return 0;
+}
+
+static int audioplay_buzzer_submit(struct audio_buffer *buffer, k_timeout_t timeout)
+{
+    /* Nothing to play it on - drop it as if it had been played */
+    audio_buffer_free(buffer);
+    return 0;
+}
+
+static int audioplay_buzzer_set_volume(uint8_t volume)
 {
     LOG_WRN("PWM/buzzer volume control not implemented - using stub (volume=%d)", volume);
     return 0;
 }
 
-size_t audioplay_buzzer_get_free_space(void)
+static size_t audioplay_buzzer_get_free_space(void)
 {
     LOG_WRN("PWM/buzzer free space not implemented - using stub");
     return 1024; // Return some reasonable buffer size
 }
 
-int audioplay_buzzer_cleanup(void)
+static int audioplay_buzzer_cleanup(void)
 {
     LOG_WRN("PWM/buzzer cleanup not implemented - using stub");
     return 0;
 }
+
+const struct audio_backend buzzer_audio_backend = {
+    .name = "Buzzer (stub)",
+    .init = audioplay_buzzer_init,
+    .start = audioplay_buzzer_start,
+    .stop = audioplay_buzzer_stop,
+    .pause = audioplay_buzzer_pause,
+    .resume = audioplay_buzzer_resume,
+    .write = audioplay_buzzer_write,
+    .write_timeout = audioplay_buzzer_write_timeout,
+    .submit = audioplay_buzzer_submit,
+    .flush = audioplay_buzzer_flush,
+    .set_volume = audioplay_buzzer_set_volume,
+    .get_free_space = audioplay_buzzer_get_free_space,
+    .cleanup = audioplay_buzzer_cleanup,
+};
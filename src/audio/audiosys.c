@@ -4,33 +4,385 @@
  * 
  * This implements the unified audio interface that routes calls to the
  * appropriate backend (Bluetooth A2DP or PWM buzzer) based on configuration.
+ * Backends are registered as operation tables (audio_backend.h); besides
+ * the main output any others can be fed the same buffers as mirrors.
  */
 
 #include "audiosys.h"
-#include "bluetooth.h"
+#include "audio_backend.h"
+#include "pcm_dsp.h"
 #include "../utils/error_handling.h"
+#include "../utils/metrics.h"
+#include "../utils/trace.h"
 #include <zephyr/logging/log.h>
 
 LOG_MODULE_REGISTER(audiosys, LOG_LEVEL_DBG);
 
+/* Adaptive jitter buffer, used in front of queued (Bluetooth) output */
+#define JB_DEFAULT_TARGET_MS 100       // When buffer_size_ms is 0
+#define JB_MIN_TARGET_MS 20
+#define JB_GROW_STEP_MS 20             // Added to the target after each underrun
+#define JB_SHRINK_INTERVAL_MS 10000    // Underrun-free time before one step is given back
+#define JB_JITTER_MULTIPLIER 4         // Target covers this many mean arrival deviations
+#define JB_FADE_MS 5                   // Fade-in when playback resumes after rebuffering
+
+#define AUDIO_SUBMIT_TIMEOUT_MS 500    // Longest the main output may hold up a submit
+
+struct jitter_buffer {
+    struct k_mutex lock;
+    sys_slist_t held;                  /* Buffers waiting for the prefill watermark */
+    size_t held_bytes;
+    bool prefilling;
+    bool fade_next;                    /* Fade in the next buffer released */
+    bool end_of_stream;                /* Running dry from here on is not an underrun */
+    atomic_t resets;                   /* Bumped by jb_reset(), see jb_submit_released() */
+    uint32_t bytes_per_sec;
+    uint32_t base_ms;                  /* buffer_size_ms, limited to what the pool holds */
+    uint32_t max_ms;
+    uint32_t boost_ms;                 /* Grown on underruns, decays while playback is clean */
+    uint32_t target_ms;
+    uint32_t jitter_q4;                /* Mean inter-arrival deviation, 1/16 ms */
+    int64_t last_arrival;
+    uint32_t last_duration_ms;         /* Audio carried by the previous buffer */
+    int64_t last_adjust;
+    uint32_t underruns;
+};
+
+/* Registered backends, indexed by audio_output_type_t */
+static const struct audio_backend *const audio_backends[AUDIO_OUTPUT_COUNT] = {
+    [AUDIO_OUTPUT_BUZZER] = &buzzer_audio_backend,
+    [AUDIO_OUTPUT_BLUETOOTH] = &bluetooth_audio_backend,
+};
+
 /* Global audio system state */
 static struct {
     bool initialized;
     audio_config_t config;
     audio_state_t state;
+    struct jitter_buffer jb;
+    const struct audio_backend *output;        /* Main output */
+    uint32_t mirrors;                          /* BIT(type) of mirrors that initialized */
+    int16_t gain;                              /* Q15 volume, applied here while mirroring */
+    atomic_t mirror_drops[AUDIO_OUTPUT_COUNT];
 } audio_system = {
     .initialized = false,
     .state = AUDIO_STATE_UNINITIALIZED
 };
 
-/* External function prototypes for buzzer implementation */
-extern int audioplay_buzzer_init(const audio_format_t *format);
-extern int audioplay_buzzer_start(void);
-extern int audioplay_buzzer_stop(void);
-extern int audioplay_buzzer_write(const uint8_t *data, size_t len);
-extern int audioplay_buzzer_set_volume(uint8_t volume);
-extern size_t audioplay_buzzer_get_free_space(void);
-extern int audioplay_buzzer_cleanup(void);
+/**
+ * @brief Backend of a running mirror output, NULL if @p type is not one
+ */
+static const struct audio_backend *mirror_backend(int type)
+{
+    return (audio_system.mirrors & BIT(type)) ? audio_backends[type] : NULL;
+}
+
+/**
+ * @brief Bytes the main output has been handed but not yet played
+ */
+static size_t output_queued(void)
+{
+    const struct audio_backend *output = audio_system.output;
+    
+    return (output && output->get_queued) ? output->get_queued() : 0;
+}
+
+static uint32_t jb_bytes_to_ms(size_t bytes)
+{
+    struct jitter_buffer *jb = &audio_system.jb;
+    
+    if (jb->bytes_per_sec == 0) {
+        return 0;
+    }
+    return (uint32_t)(((uint64_t)bytes * 1000) / jb->bytes_per_sec);
+}
+
+/**
+ * @brief Drop held audio and wait for the watermark again
+ * 
+ * Caller holds the lock (or the jitter buffer is not in use yet).
+ * 
+ * @param fade Fade in when playback resumes, for cuts into running audio
+ */
+static void jb_reset(bool fade)
+{
+    struct jitter_buffer *jb = &audio_system.jb;
+    sys_snode_t *node;
+    
+    while ((node = sys_slist_get(&jb->held)) != NULL) {
+        audio_buffer_free(CONTAINER_OF(node, struct audio_buffer, node));
+    }
+    jb->held_bytes = 0;
+    jb->prefilling = true;
+    jb->fade_next = fade;
+    jb->end_of_stream = false;
+    jb->last_arrival = 0;
+    atomic_inc(&jb->resets);
+}
+
+static void jb_init(const audio_config_t *config)
+{
+    struct jitter_buffer *jb = &audio_system.jb;
+    const audio_format_t *format = &config->format;
+    /* One buffer always stays with the producer */
+    size_t pool_bytes = (size_t)(CONFIG_APP_AUDIO_BUFFER_COUNT - 1) * CONFIG_APP_AUDIO_BUFFER_SIZE;
+    
+    k_mutex_init(&jb->lock);
+    sys_slist_init(&jb->held);
+    jb->bytes_per_sec = format->sample_rate * format->channels * (format->bits_per_sample / 8);
+    jb->max_ms = jb_bytes_to_ms(pool_bytes);
+    jb->base_ms = config->buffer_size_ms ? config->buffer_size_ms : JB_DEFAULT_TARGET_MS;
+    if (jb->base_ms > jb->max_ms) {
+        LOG_WRN("Buffer target %u ms capped to the %u ms the audio pool holds",
+                jb->base_ms, jb->max_ms);
+        jb->base_ms = jb->max_ms;
+    }
+    jb->boost_ms = 0;
+    jb->target_ms = jb->base_ms;
+    jb->jitter_q4 = 0;
+    jb->underruns = 0;
+    jb_reset(false);
+}
+
+/* RFC 3550 style running mean of how far arrivals stray from the audio clock */
+static void jb_track_arrival(const struct audio_buffer *buffer, int64_t now)
+{
+    struct jitter_buffer *jb = &audio_system.jb;
+    
+    if (jb->last_arrival) {
+        int32_t deviation = (int32_t)(now - jb->last_arrival) - (int32_t)jb->last_duration_ms;
+        int32_t dev_q4 = ((deviation < 0) ? -deviation : deviation) * 16;
+        
+        jb->jitter_q4 += (dev_q4 - (int32_t)jb->jitter_q4) / 16;
+    }
+    jb->last_arrival = now;
+    jb->last_duration_ms = jb_bytes_to_ms(buffer->used);
+}
+
+static void jb_update_target(int64_t now)
+{
+    struct jitter_buffer *jb = &audio_system.jb;
+    uint32_t target;
+    
+    if (jb->boost_ms > 0 && now - jb->last_adjust >= JB_SHRINK_INTERVAL_MS) {
+        jb->boost_ms -= MIN(jb->boost_ms, JB_GROW_STEP_MS);
+        jb->last_adjust = now;
+    }
+    
+    target = MAX(jb->base_ms, (JB_JITTER_MULTIPLIER * jb->jitter_q4) / 16) + jb->boost_ms;
+    jb->target_ms = MAX(MIN(target, jb->max_ms), MIN(JB_MIN_TARGET_MS, jb->max_ms));
+}
+
+/**
+ * @brief Hand a buffer to every mirror by reference, then to the main output
+ */
+static int backend_submit(struct audio_buffer *buffer)
+{
+    if (audio_system.mirrors) {
+        /* Shared from here on, so apply the volume once for all outputs */
+        pcm_gain_q15((int16_t *)buffer->data, buffer->used / sizeof(int16_t),
+                     audio_system.gain);
+        
+        for (int type = 0; type < AUDIO_OUTPUT_COUNT; type++) {
+            const struct audio_backend *mirror = mirror_backend(type);
+            
+            /* A mirror with a full queue skips this buffer instead of stalling the rest */
+            if (mirror && mirror->submit(audio_buffer_ref(buffer), K_NO_WAIT) < 0) {
+                audio_buffer_free(buffer);
+                atomic_inc(&audio_system.mirror_drops[type]);
+            }
+        }
+    }
+    
+    return audio_system.output->submit(buffer, K_MSEC(AUDIO_SUBMIT_TIMEOUT_MS));
+}
+
+/**
+ * @brief Take every held buffer off the jitter buffer, oldest first
+ * 
+ * Caller holds the lock. The buffers go to the output through
+ * jb_submit_released() once the lock is dropped, so a full output never
+ * holds up flush, pause or stats callers.
+ * 
+ * @param released Initialised list the held buffers are moved to
+ */
+static void jb_release(sys_slist_t *released)
+{
+    struct jitter_buffer *jb = &audio_system.jb;
+    const audio_format_t *format = &audio_system.config.format;
+    sys_snode_t *node;
+    
+    while ((node = sys_slist_get(&jb->held)) != NULL) {
+        struct audio_buffer *buf = CONTAINER_OF(node, struct audio_buffer, node);
+        
+        /* Resuming mid-stream: ramp up rather than jump back in */
+        if (jb->fade_next && format->bits_per_sample == 16 && format->channels > 0) {
+            size_t frames = buf->used / (format->channels * sizeof(int16_t));
+            size_t fade = (format->sample_rate * JB_FADE_MS) / 1000;
+            
+            pcm_fade_in((int16_t *)buf->data, MIN(frames, fade), format->channels);
+            jb->fade_next = false;
+        }
+        sys_slist_append(released, node);
+    }
+    
+    jb->held_bytes = 0;
+    jb->prefilling = false;
+}
+
+/**
+ * @brief Submit buffers taken by jb_release(), without the lock held
+ * 
+ * @param released Buffers to pass on, emptied on return
+ * @param resets jb->resets when they were taken; a flush or stop since
+ *               makes them stale, and they are dropped instead
+ */
+static void jb_submit_released(sys_slist_t *released, atomic_val_t resets)
+{
+    struct jitter_buffer *jb = &audio_system.jb;
+    sys_snode_t *node;
+    int ret = 0;
+    
+    while ((node = sys_slist_get(released)) != NULL) {
+        struct audio_buffer *buf = CONTAINER_OF(node, struct audio_buffer, node);
+        
+        if (ret == 0 && atomic_get(&jb->resets) != resets) {
+            ret = -ECANCELED;
+        }
+        /* Buffers left after a failure are dropped, they are ours by now */
+        if (ret == 0) {
+            ret = backend_submit(buf);
+        }
+        if (ret < 0) {
+            audio_buffer_free(buf);
+        }
+    }
+    
+    if (ret < 0 && ret != -ECANCELED) {
+        LOG_WRN("Output rejected buffered audio: %d", ret);
+    }
+}
+
+/**
+ * @brief Queue a buffer through the jitter buffer
+ * 
+ * Audio is held until target_ms is buffered between here and the output,
+ * then flows straight through. Finding the output empty on arrival is an
+ * underrun: the target grows and the buffer refills before playing on.
+ */
+static int jb_submit(struct audio_buffer *buffer)
+{
+    struct jitter_buffer *jb = &audio_system.jb;
+    struct audio_buffer_stats pool;
+    int64_t now = k_uptime_get();
+    sys_slist_t released;
+    atomic_val_t resets;
+    size_t queued;
+    
+    k_mutex_lock(&jb->lock, K_FOREVER);
+    
+    /* Anything after the end of a stream starts the next one */
+    if (jb->end_of_stream) {
+        jb_reset(false);
+    }
+    
+    /* An end marker arriving after the last audio has played is no underrun */
+    queued = output_queued();
+    if (!jb->prefilling && queued == 0 && !audio_buffer_is_end_marker(buffer)) {
+        jb->underruns++;
+        metrics_inc(METRICS_UNDERRUNS);
+        jb->boost_ms = MIN(jb->boost_ms + JB_GROW_STEP_MS, jb->max_ms);
+        jb->last_adjust = now;
+        jb->prefilling = true;
+        jb->fade_next = true;
+        LOG_WRN("Audio underrun #%u, rebuffering", jb->underruns);
+    }
+    
+    if (!audio_buffer_is_end_marker(buffer)) {
+        jb_track_arrival(buffer, now);
+        jb_update_target(now);
+    }
+    if (buffer->flags & AUDIO_BUFFER_FLAG_END_OF_STREAM) {
+        jb->end_of_stream = true;
+    }
+    
+    /* The output may block for a while, so it is fed after unlocking */
+    resets = atomic_get(&jb->resets);
+    if (!jb->prefilling) {
+        metrics_gauge_set(METRICS_JITTER_BUFFERED_MS, jb_bytes_to_ms(queued + buffer->used));
+        k_mutex_unlock(&jb->lock);
+        
+        if (atomic_get(&jb->resets) != resets) {
+            /* Flushed meanwhile, same as if it had been held */
+            audio_buffer_free(buffer);
+            return 0;
+        }
+        return backend_submit(buffer);
+    }
+    
+    sys_slist_append(&jb->held, &buffer->node);
+    jb->held_bytes += buffer->used;
+    metrics_gauge_set(METRICS_JITTER_BUFFERED_MS, jb_bytes_to_ms(jb->held_bytes + queued));
+    
+    /* Holding on once the pool is empty would stall the producer for good */
+    sys_slist_init(&released);
+    audio_buffer_pool_get_stats(&pool);
+    if (jb_bytes_to_ms(jb->held_bytes + queued) >= jb->target_ms ||
+        jb->end_of_stream || pool.free_buffers == 0) {
+        trace_event(TRACE_JB_PREFILLED, jb_bytes_to_ms(jb->held_bytes + queued), jb->target_ms);
+        jb_release(&released);
+    }
+    
+    k_mutex_unlock(&jb->lock);
+    jb_submit_released(&released, resets);
+    return 0;
+}
+
+/**
+ * @brief Bring up the mirror outputs; any that fail are left out
+ */
+static void mirrors_init(const audio_config_t *config)
+{
+    bool by_node = audio_system.output->queues_by_node;
+    
+    audio_system.mirrors = 0;
+    audio_system.gain = pcm_volume_to_q15(100);
+    
+    for (int type = 0; type < AUDIO_OUTPUT_COUNT; type++) {
+        const struct audio_backend *mirror = audio_backends[type];
+        int ret;
+        
+        if (!(config->mirror_outputs & BIT(type)) || type == (int)config->output_type) {
+            continue;
+        }
+        if (!mirror || (by_node && mirror->queues_by_node)) {
+            /* Buffers have one node, so only one output may queue them by it */
+            LOG_WRN("Output %d can't mirror %s", type, audio_system.output->name);
+            continue;
+        }
+        
+        ret = mirror->init(&config->format);
+        if (ret < 0) {
+            LOG_WRN("Mirror output %s failed to initialize: %d", mirror->name, ret);
+            continue;
+        }
+        
+        by_node |= mirror->queues_by_node;
+        atomic_clear(&audio_system.mirror_drops[type]);
+        audio_system.mirrors |= BIT(type);
+        LOG_INF("Mirroring audio to %s output", mirror->name);
+    }
+    
+    /* Buffers are shared, so volume is applied once here instead of per output */
+    if (audio_system.mirrors) {
+        audio_system.output->set_volume(100);
+        for (int type = 0; type < AUDIO_OUTPUT_COUNT; type++) {
+            if (mirror_backend(type)) {
+                mirror_backend(type)->set_volume(100);
+            }
+        }
+    }
+}
 
 int audio_system_init(const audio_config_t *config)
 {
@@ -48,31 +400,34 @@ int audio_system_init(const audio_config_t *config)
     
     /* Store configuration */
     audio_system.config = *config;
+    jb_init(config);
     
-    LOG_INF("Initializing audio system with %s output", 
-            (config->output_type == AUDIO_OUTPUT_BLUETOOTH) ? "Bluetooth" : "Buzzer");
+    /* Pool buffers carry received audio through to the output */
+    ret = audio_buffer_pool_init();
+    if (ret < 0 && ret != -EALREADY) {
+        LOG_ERR("Audio buffer pool initialization failed: %d", ret);
+        return ret;
+    }
     
-    /* Initialize the selected audio backend */
-    switch (config->output_type) {
-        case AUDIO_OUTPUT_BLUETOOTH:
-            ret = bluetooth_audio_init(&config->format);
-            break;
-            
-        case AUDIO_OUTPUT_BUZZER:
-            ret = audioplay_buzzer_init(&config->format);
-            break;
-            
-        default:
-            LOG_ERR("Unsupported audio output type: %d", config->output_type);
-            return -ENOTSUP;
+    if ((unsigned int)config->output_type >= AUDIO_OUTPUT_COUNT ||
+        !audio_backends[config->output_type]) {
+        LOG_ERR("Unsupported audio output type: %d", config->output_type);
+        return -ENOTSUP;
     }
+    audio_system.output = audio_backends[config->output_type];
+    
+    LOG_INF("Initializing audio system with %s output", audio_system.output->name);
     
+    /* Initialize the selected audio backend */
+    ret = audio_system.output->init(&config->format);
     if (ret < 0) {
         LOG_ERR("Audio backend initialization failed: %d", ret);
         audio_system.state = AUDIO_STATE_ERROR;
         return ret;
     }
     
+    mirrors_init(config);
+    
     audio_system.initialized = true;
     audio_system.state = AUDIO_STATE_INITIALIZED;
     
@@ -92,20 +447,22 @@ int audio_system_start(void)
         return 0;
     }
     
+    /* Starting over would throw away what the pause kept */
+    if (audio_system.state == AUDIO_STATE_PAUSED) {
+        return audio_system_resume();
+    }
+    
     int ret;
     
-    switch (audio_system.config.output_type) {
-        case AUDIO_OUTPUT_BLUETOOTH:
-            ret = bluetooth_audio_start();
-            break;
-            
-        case AUDIO_OUTPUT_BUZZER:
-            ret = audioplay_buzzer_start();
-            break;
-            
-        default:
-            LOG_ERR("Unsupported audio output type");
-            return -ENOTSUP;
+    k_mutex_lock(&audio_system.jb.lock, K_FOREVER);
+    jb_reset(false);
+    k_mutex_unlock(&audio_system.jb.lock);
+    
+    ret = audio_system.output->start();
+    for (int type = 0; type < AUDIO_OUTPUT_COUNT; type++) {
+        if (mirror_backend(type) && mirror_backend(type)->start() < 0) {
+            LOG_WRN("Mirror output %s failed to start", mirror_backend(type)->name);
+        }
     }
     
     if (ret < 0) {
@@ -127,17 +484,15 @@ int audio_system_stop(void)
     
     int ret;
     
-    switch (audio_system.config.output_type) {
-        case AUDIO_OUTPUT_BLUETOOTH:
-            ret = bluetooth_audio_stop();
-            break;
-            
-        case AUDIO_OUTPUT_BUZZER:
-            ret = audioplay_buzzer_stop();
-            break;
-            
-        default:
-            return -ENOTSUP;
+    k_mutex_lock(&audio_system.jb.lock, K_FOREVER);
+    jb_reset(false);
+    k_mutex_unlock(&audio_system.jb.lock);
+    
+    ret = audio_system.output->stop();
+    for (int type = 0; type < AUDIO_OUTPUT_COUNT; type++) {
+        if (mirror_backend(type)) {
+            mirror_backend(type)->stop();
+        }
     }
     
     if (ret >= 0) {
@@ -150,14 +505,64 @@ int audio_system_stop(void)
 
 int audio_system_pause(void)
 {
-    /* For now, just stop - can be enhanced later */
-    return audio_system_stop();
+    if (!audio_system.initialized) {
+        return -EINVAL;
+    }
+    
+    if (audio_system.state == AUDIO_STATE_PAUSED) {
+        return 0;
+    }
+    if (audio_system.state != AUDIO_STATE_PLAYING) {
+        return -EINVAL;
+    }
+    
+    /* Everything buffered stays where it is - held buffers, queues and rings */
+    int ret = audio_system.output->pause();
+    if (ret < 0) {
+        LOG_ERR("Failed to pause audio playback: %d", ret);
+        return ret;
+    }
+    for (int type = 0; type < AUDIO_OUTPUT_COUNT; type++) {
+        if (mirror_backend(type)) {
+            mirror_backend(type)->pause();
+        }
+    }
+    
+    audio_system.state = AUDIO_STATE_PAUSED;
+    LOG_INF("Audio playback paused");
+    return 0;
 }
 
 int audio_system_resume(void)
 {
-    /* For now, just start - can be enhanced later */
-    return audio_system_start();
+    if (!audio_system.initialized) {
+        return -EINVAL;
+    }
+    
+    if (audio_system.state != AUDIO_STATE_PAUSED) {
+        return audio_system_start();
+    }
+    
+    /* The gap while paused says nothing about network jitter */
+    k_mutex_lock(&audio_system.jb.lock, K_FOREVER);
+    audio_system.jb.last_arrival = 0;
+    k_mutex_unlock(&audio_system.jb.lock);
+    
+    int ret = audio_system.output->resume();
+    if (ret < 0) {
+        LOG_ERR("Failed to resume audio playback: %d", ret);
+        audio_system.state = AUDIO_STATE_ERROR;
+        return ret;
+    }
+    for (int type = 0; type < AUDIO_OUTPUT_COUNT; type++) {
+        if (mirror_backend(type)) {
+            mirror_backend(type)->resume();
+        }
+    }
+    
+    audio_system.state = AUDIO_STATE_PLAYING;
+    LOG_INF("Audio playback resumed");
+    return 0;
 }
 
 int audio_system_write(const uint8_t *data, size_t len)
@@ -170,16 +575,58 @@ int audio_system_write(const uint8_t *data, size_t len)
         return -EINVAL;
     }
     
-    switch (audio_system.config.output_type) {
-        case AUDIO_OUTPUT_BLUETOOTH:
-            return bluetooth_audio_write(data, len);
-            
-        case AUDIO_OUTPUT_BUZZER:
-            return audioplay_buzzer_write(data, len);
-            
-        default:
-            return -ENOTSUP;
+    /* Copied writes go to the main output only */
+    return audio_system.output->write(data, len);
+}
+
+int audio_system_write_timeout(const uint8_t *data, size_t len, k_timeout_t timeout)
+{
+    if (!audio_system.initialized) {
+        return -EINVAL;
+    }
+    
+    if (!data || len == 0) {
+        return -EINVAL;
     }
+    
+    return audio_system.output->write_timeout(data, len, timeout);
+}
+
+int audio_system_submit(struct audio_buffer *buffer)
+{
+    if (!audio_system.initialized) {
+        return -EINVAL;
+    }
+    
+    if (!buffer || (buffer->used == 0 && !audio_buffer_is_end_marker(buffer))) {
+        return -EINVAL;
+    }
+    
+    /* Outputs that pace themselves off their own ring need no jitter buffer */
+    if (!audio_system.output->jitter_buffer) {
+        return backend_submit(buffer);
+    }
+    
+    return jb_submit(buffer);
+}
+
+int audio_system_flush(void)
+{
+    if (!audio_system.initialized) {
+        return -EINVAL;
+    }
+    
+    /* Refill before playing from the new position, fading in over the cut */
+    k_mutex_lock(&audio_system.jb.lock, K_FOREVER);
+    jb_reset(true);
+    k_mutex_unlock(&audio_system.jb.lock);
+    
+    for (int type = 0; type < AUDIO_OUTPUT_COUNT; type++) {
+        if (mirror_backend(type)) {
+            mirror_backend(type)->flush();
+        }
+    }
+    return audio_system.output->flush();
 }
 
 int audio_system_set_volume(uint8_t volume)
@@ -192,16 +639,47 @@ int audio_system_set_volume(uint8_t volume)
         return -EINVAL;
     }
     
-    switch (audio_system.config.output_type) {
-        case AUDIO_OUTPUT_BLUETOOTH:
-            return bluetooth_audio_set_volume(volume);
-            
-        case AUDIO_OUTPUT_BUZZER:
-            return audioplay_buzzer_set_volume(volume);
-            
-        default:
-            return -ENOTSUP;
+    /* Mirrored buffers are shared, their volume is applied before fan-out */
+    if (audio_system.mirrors) {
+        audio_system.gain = pcm_volume_to_q15(volume);
+        return 0;
+    }
+    
+    return audio_system.output->set_volume(volume);
+}
+
+bool audio_system_is_mirroring(void)
+{
+    return audio_system.mirrors != 0;
+}
+
+int audio_system_get_jitter_stats(struct audio_jitter_stats *stats)
+{
+    struct jitter_buffer *jb = &audio_system.jb;
+    
+    if (!audio_system.initialized || !stats) {
+        return -EINVAL;
     }
+    
+    k_mutex_lock(&jb->lock, K_FOREVER);
+    stats->target_ms = jb->target_ms;
+    stats->max_ms = jb->max_ms;
+    stats->buffered_ms = jb_bytes_to_ms(jb->held_bytes + output_queued());
+    stats->jitter_ms = jb->jitter_q4 / 16;
+    stats->underruns = jb->underruns;
+    stats->prefilling = jb->prefilling;
+    k_mutex_unlock(&jb->lock);
+    
+    return 0;
+}
+
+uint32_t audio_system_get_mirror_drops(audio_output_type_t type)
+{
+    if ((unsigned int)type >= AUDIO_OUTPUT_COUNT) {
+        return 0;
+    }
+    
+    return (uint32_t)atomic_get(&audio_system.mirror_drops[type]);
 }
 
 audio_state_t audio_system_get_state(void)
@@ -215,16 +693,7 @@ size_t audio_system_get_free_space(void)
         return 0;
     }
     
-    switch (audio_system.config.output_type) {
-        case AUDIO_OUTPUT_BLUETOOTH:
-            return bluetooth_audio_get_free_space();
-            
-        case AUDIO_OUTPUT_BUZZER:
-            return audioplay_buzzer_get_free_space();
-            
-        default:
-            return 0;
-    }
+    return audio_system.output->get_free_space();
 }
 
 int audio_system_cleanup(void)
@@ -235,19 +704,18 @@ int audio_system_cleanup(void)
     
     int ret;
     
-    switch (audio_system.config.output_type) {
-        case AUDIO_OUTPUT_BLUETOOTH:
-            ret = bluetooth_audio_cleanup();
-            break;
-            
-        case AUDIO_OUTPUT_BUZZER:
-            ret = audioplay_buzzer_cleanup();
-            break;
-            
-        default:
-            ret = 0;
+    k_mutex_lock(&audio_system.jb.lock, K_FOREVER);
+    jb_reset(false);
+    k_mutex_unlock(&audio_system.jb.lock);
+    
+    for (int type = 0; type < AUDIO_OUTPUT_COUNT; type++) {
+        if (mirror_backend(type)) {
+            mirror_backend(type)->cleanup();
+        }
     }
+    ret = audio_system.output->cleanup();
     
+    audio_system.mirrors = 0;
     audio_system.initialized = false;
     audio_system.state = AUDIO_STATE_UNINITIALIZED;
     
@@ -14,6 +14,7 @@
 #define AUDIOSYS_H
 
 #include <zephyr/kernel.h>
+#include "audio_buffers.h"
 #include <stdint.h>
 #include <stddef.h>
 
@@ -26,7 +27,8 @@ extern "C" {
  */
 typedef enum {
     AUDIO_OUTPUT_BUZZER,     ///< PWM-based buzzer output
-    AUDIO_OUTPUT_BLUETOOTH   ///< Bluetooth A2DP output
+    AUDIO_OUTPUT_BLUETOOTH,  ///< Bluetooth A2DP output
+    AUDIO_OUTPUT_COUNT
 } audio_output_type_t;
 
 /**
@@ -44,7 +46,8 @@ typedef struct {
 typedef struct {
     audio_output_type_t output_type;
     audio_format_t format;
-    uint32_t buffer_size_ms;  ///< Buffer size in milliseconds
+    uint32_t buffer_size_ms;  ///< Jitter buffer target in milliseconds (0 = default)
+    uint32_t mirror_outputs;  ///< BIT(audio_output_type_t) of outputs also fed every submitted buffer
 } audio_config_t;
 
 /**
@@ -58,6 +61,18 @@ typedef enum {
     AUDIO_STATE_ERROR
 } audio_state_t;
 
+/**
+ * @brief Jitter buffer state, see audio_system_get_jitter_stats()
+ */
+struct audio_jitter_stats {
+    uint32_t target_ms;      ///< Current prefill target
+    uint32_t max_ms;         ///< Largest target the buffer pool allows
+    uint32_t buffered_ms;    ///< Audio held or queued for output
+    uint32_t jitter_ms;      ///< Mean deviation of buffer arrival times
+    uint32_t underruns;      ///< Times the output ran dry mid-stream
+    bool prefilling;         ///< Holding audio back until the target is reached
+};
+
 /**
  * @brief Initialize the audio system
  * 
@@ -83,13 +98,20 @@ int audio_system_stop(void);
 /**
  * @brief Pause audio playback
  * 
- * @return 0 on success, negative error code on failure
+ * Outputs stop playing but keep everything buffered, so nothing has to
+ * be fetched again on resume. Buffers submitted while paused queue up
+ * until the pool runs out, which holds up the producer.
+ * 
+ * @return 0 on success, -EINVAL if not playing, negative error code on failure
  */
 int audio_system_pause(void);
 
 /**
  * @brief Resume audio playback
  * 
+ * Carries on from the first sample not yet played. Starts playback if
+ * it was not paused.
+ * 
  * @return 0 on success, negative error code on failure
  */
 int audio_system_resume(void);
@@ -103,14 +125,74 @@ int audio_system_resume(void);
  */
 int audio_system_write(const uint8_t *data, size_t len);
 
+/**
+ * @brief Write audio data to the output, waiting for buffer space
+ * 
+ * Outputs without a bounded buffer behave like audio_system_write().
+ * 
+ * @param data Pointer to audio data buffer
+ * @param len Length of audio data in bytes
+ * @param timeout Maximum time to wait for space
+ * @return Number of bytes written (0 on timeout), negative error code on failure
+ */
+int audio_system_write_timeout(const uint8_t *data, size_t len, k_timeout_t timeout);
+
+/**
+ * @brief Queue a filled pool buffer for output without copying it
+ * 
+ * On success the output owns the buffer and returns it to the pool once
+ * its contents have been sent. On failure the caller still owns it.
+ * 
+ * With mirror outputs configured the same buffer is handed to each of
+ * them by reference. Every mirror has its own bounded queue: one that is
+ * full skips the buffer (see audio_system_get_mirror_drops()) rather
+ * than holding up the others. Only the main output applies backpressure.
+ * 
+ * Bluetooth output goes through an adaptive jitter buffer: audio is held
+ * back until buffer_size_ms (raised after underruns and when arrivals are
+ * irregular) is buffered, then passed straight on. After an underrun or a
+ * flush the output refills to the target and fades back in.
+ * 
+ * When the stream ends with no audio left to flag, an empty buffer with
+ * AUDIO_BUFFER_FLAG_END_OF_STREAM is accepted as an end marker: held
+ * audio is released and the outputs end cleanly instead of underrunning.
+ * 
+ * @param buffer Buffer from audio_buffer_alloc() holding @c used bytes
+ * @return 0 on success, negative error code on failure
+ */
+int audio_system_submit(struct audio_buffer *buffer);
+
+/**
+ * @brief Discard audio queued for output, keeping the output running
+ * 
+ * Call before submitting audio from a new position (seek) so nothing
+ * from the old position is played after it.
+ * 
+ * @return 0 on success, negative error code on failure
+ */
+int audio_system_flush(void);
+
 /**
  * @brief Set audio volume
  * 
+ * While mirroring, the volume is applied to the buffers before they are
+ * shared and every output stays at 100%.
+ * 
  * @param volume Volume level (0-100)
  * @return 0 on success, negative error code on failure
  */
 int audio_system_set_volume(uint8_t volume);
 
+/**
+ * @brief Check whether buffers are being fanned out to mirror outputs
+ * 
+ * Outputs then leave their own volume alone and route volume changes to
+ * audio_system_set_volume().
+ * 
+ * @return true while at least one mirror output is running
+ */
+bool audio_system_is_mirroring(void);
+
 /**
  * @brief Get current audio system state
  * 
@@ -118,6 +200,22 @@ int audio_system_set_volume(uint8_t volume);
  */
 audio_state_t audio_system_get_state(void);
 
+/**
+ * @brief Get jitter buffer statistics
+ * 
+ * @param stats Filled with the current state
+ * @return 0 on success, -EINVAL if the audio system is not initialized
+ */
+int audio_system_get_jitter_stats(struct audio_jitter_stats *stats);
+
+/**
+ * @brief Get the number of buffers a mirror output skipped
+ * 
+ * @param type Mirror output
+ * @return Buffers dropped because the mirror's queue was full
+ */
+uint32_t audio_system_get_mirror_drops(audio_output_type_t type);
+
 /**
  * @brief Get available buffer space
  * 
@@ -8,6 +8,7 @@
  * Key Features:
  * - Bluetooth LE 4.1 advertising and connection management via SPBTLE-RF
  * - Audio buffer management and streaming
+ * - Optional IMA-ADPCM encoding of notifications (audio_codec.h)
  * - Connection status and basic audio control
  * 
  * Hardware:
@@ -31,51 +32,109 @@
 #include <zephyr/net_buf.h>
 #include <zephyr/kernel.h>
 #include <zephyr/sys/printk.h>
+#if defined(CONFIG_BT_SETTINGS)
+#include <zephyr/settings/settings.h>
+#endif
 #include <string.h>
 #include <math.h>
 
 #include "audiosys.h"
+#include "audio_backend.h"
 #include "bluetooth.h"
 #include "gatt_audio_service.h"
+#include "audio_buffers.h"
+#include "audio_codec.h"
+#include "conn_params.h"
+#include "pcm_dsp.h"
+#include "../utils/app_threads.h"
 #include "../utils/circular_buffers.h"
 #include "../utils/error_handling.h"
+#include "../utils/mem_plan.h"
+#include "../utils/metrics.h"
+#include "../utils/trace.h"
 
 LOG_MODULE_REGISTER(bluetooth_audio, LOG_LEVEL_INF);
 
 /* Bluetooth audio configuration */
-#define BT_AUDIO_BUFFER_SIZE      2048
+#define BT_AUDIO_BUFFER_SIZE      MEM_PLAN_BT_RING_SIZE
 #define BT_AUDIO_CHUNK_SIZE       512
 #define BT_AUDIO_SAMPLE_RATE      44100
 #define BT_AUDIO_CHANNELS         2
 #define BT_AUDIO_BITS_PER_SAMPLE  16
+#define BT_AUDIO_CONCEAL_FRAMES   128     /* ~3 ms fade to silence when the queue runs dry */
+#define BT_AUDIO_BACKOFF_EVENTS   8       /* Longest -ENOMEM backoff, in connection events */
+#define BT_AUDIO_FAST_ADV_MS      30000   /* Fast advertising after boot while a bonded peer may reconnect */
+
+/* Encoder stage between the queued PCM and gatt_audio_send_data() */
+#if defined(CONFIG_APP_BT_AUDIO_CODEC_IMA_ADPCM)
+#define BT_AUDIO_CODEC            AUDIO_CODEC_IMA_ADPCM
+#define BT_AUDIO_CODEC_STAGE_SIZE (GATT_AUDIO_CHUNK_SIZE_MAX * 4)  /* PCM for one 4:1 frame */
+#define BT_AUDIO_CODEC_FRAME_SIZE GATT_AUDIO_CHUNK_SIZE_MAX
+#else
+#define BT_AUDIO_CODEC            AUDIO_CODEC_PCM
+#define BT_AUDIO_CODEC_STAGE_SIZE 4                                /* Unused, PCM goes zero-copy */
+#define BT_AUDIO_CODEC_FRAME_SIZE 4
+#endif
 
 /* Bluetooth audio state */
 typedef struct {
     bool initialized;
+    bool ready;                   /* Controller up and advertising */
+    bool fast_adv;                /* Advertise at the fast interval for a bonded peer */
+    bluetooth_audio_ready_cb_t ready_cb;
+    struct k_work_delayable adv_slow_work;  /* Ends the fast advertising window */
     bool connected;
     bool streaming;
+    bool paused;                  /* Streaming, but holding every queued byte */
     bool scanning;
     struct bt_conn *conn;
     bt_addr_le_t target_addr;  // Address of target device (Bose headphones)
     bool target_found;
-    circular_buffer_t audio_buffer;
-    uint8_t buffer_data[BT_AUDIO_BUFFER_SIZE];
+    spsc_buffer_t audio_buffer;   /* HTTP client produces, streaming thread consumes */
+    struct k_fifo tx_fifo;                /* Submitted pool buffers awaiting notify */
+    struct audio_buffer *tx_current;      /* Pool buffer being sent, owned by the thread */
+    atomic_t tx_flush;                    /* Ask the thread to drop tx_current */
+    atomic_t tx_queued;                   /* Bytes in submitted buffers not yet released */
+    int16_t last_frame[BT_AUDIO_CHANNELS]; /* Final frame of the last pool buffer sent */
+    bool conceal_pending;                 /* Last buffer ended mid-stream, fade if nothing follows */
+    const struct audio_codec *codec;      /* Encoder for notification payloads */
+    struct audio_codec_state codec_state;
+    size_t codec_frame_size;              /* Notification size the format was advertised for */
+    uint8_t codec_stage[BT_AUDIO_CODEC_STAGE_SIZE];  /* PCM gathered for the next frame */
+    size_t codec_stage_len;
+    uint8_t codec_frame[BT_AUDIO_CODEC_FRAME_SIZE];  /* Encoded frame waiting for a TX credit */
+    size_t codec_frame_len;
     struct k_thread audio_thread;
     k_tid_t audio_thread_id;
     struct k_sem stream_sem;
+    struct k_poll_signal wake;            /* Raised on new ring data, TX completions, subscription changes */
     uint8_t volume;
+    bool muted;
+    atomic_t gain;                        /* Q15 gain applied to submitted buffers */
 } bt_audio_state_t;
 
 static bt_audio_state_t bt_audio = {0};
 
+/* Storage behind bt_audio.audio_buffer, placed with the audio pools */
+static uint8_t MEM_PLAN_AUDIO_SECTION bt_audio_ring_data[BT_AUDIO_BUFFER_SIZE];
+
 /* Thread stack for Bluetooth audio streaming */
-K_THREAD_STACK_DEFINE(bt_audio_stack, 2048);
+K_THREAD_STACK_DEFINE(bt_audio_stack, APP_THREAD_STACK_BT_TX);
+TRACE_RING_DEFINE(bt_audio_trace);
 
 /* Function prototypes */
 static void bt_ready_callback(int err);
+static void bt_adv_slow_work_handler(struct k_work *work);
 static void bt_connected_callback(struct bt_conn *conn, uint8_t err);
 static void bt_disconnected_callback(struct bt_conn *conn, uint8_t reason);
+static void bt_le_param_updated_callback(struct bt_conn *conn, uint16_t interval,
+                                         uint16_t latency, uint16_t timeout);
 static void bt_audio_streaming_thread(void *p1, void *p2, void *p3);
+static void bt_audio_flush_queue(void);
+static void bt_audio_release(struct audio_buffer *buffer);
+static void bt_audio_queued_add(atomic_val_t delta);
+static void bt_audio_update_gain(void);
+static void bt_audio_advertise_format(size_t frame_size);
 static int bt_start_advertising(void);
 static int bt_start_scanning(void);
 static void bt_scan_callback(const bt_addr_le_t *addr, int8_t rssi, uint8_t type, struct net_buf_simple *ad);
@@ -86,6 +145,7 @@ static void test_audio_generation_work(struct k_work *work);
 BT_CONN_CB_DEFINE(conn_callbacks) = {
     .connected = bt_connected_callback,
     .disconnected = bt_disconnected_callback,
+    .le_param_updated = bt_le_param_updated_callback,
 };
 
 /* Bluetooth LE advertising data - keep it simple to avoid size issues */
@@ -116,36 +176,102 @@ int bluetooth_audio_init(const audio_format_t *format)
     }
     
     /* Initialize circular buffer for audio data */
-    ret = circular_buffer_init(&bt_audio.audio_buffer, 
-                              bt_audio.buffer_data, 
-                              BT_AUDIO_BUFFER_SIZE);
+    ret = spsc_buffer_init(&bt_audio.audio_buffer, 
+                          bt_audio_ring_data, 
+                          BT_AUDIO_BUFFER_SIZE);
     if (ret < 0) {
         LOG_ERR("Failed to initialize audio buffer: %d", ret);
         return ret;
     }
     
+    /* Queue of pool buffers handed over by bluetooth_audio_submit() */
+    k_fifo_init(&bt_audio.tx_fifo);
+    bt_audio.tx_current = NULL;
+    atomic_clear(&bt_audio.tx_flush);
+    atomic_clear(&bt_audio.tx_queued);
+    
+    bt_audio.codec = audio_codec_get(BT_AUDIO_CODEC);
+    LOG_INF("Bluetooth audio payload codec: %s", bt_audio.codec->name);
+    
     /* Initialize semaphore for streaming control */
     k_sem_init(&bt_audio.stream_sem, 0, 1);
     
-    /* Enable Bluetooth */
+    /* The streaming thread sleeps on this instead of fixed delays */
+    k_poll_signal_init(&bt_audio.wake);
+    gatt_audio_set_event_signal(&bt_audio.wake);
+    
+    k_work_init_delayable(&bt_audio.adv_slow_work, bt_adv_slow_work_handler);
+    
+    /* Enable Bluetooth - HCI init runs on the system work queue and ends
+     * in bt_ready_callback(), so boot doesn't wait for the controller here */
     ret = bt_enable(bt_ready_callback);
     if (ret) {
         LOG_ERR("Bluetooth init failed: %d", ret);
         return ret;
     }
     
-    /* Wait for Bluetooth to be ready */
-    LOG_INF("Waiting for Bluetooth to initialize...");
-    k_sleep(K_MSEC(2000));
-    
     /* Set default volume */
     bt_audio.volume = 75;
+    bt_audio_update_gain();
     bt_audio.initialized = true;
     
     LOG_INF("🎵 Bluetooth LE audio system initialized successfully with GATT service");
     return 0;
 }
 
+void bluetooth_audio_set_ready_callback(bluetooth_audio_ready_cb_t cb)
+{
+    bt_audio.ready_cb = cb;
+}
+
+bool bluetooth_audio_is_ready(void)
+{
+    return bt_audio.ready;
+}
+
+/**
+ * @brief Report the end of bring-up to the ready callback
+ */
+static void bt_audio_report_ready(int err)
+{
+    bt_audio.ready = (err == 0);
+    if (bt_audio.ready_cb) {
+        bt_audio.ready_cb(err);
+    }
+}
+
+#if defined(CONFIG_BT_SETTINGS)
+static void bt_log_bond(const struct bt_bond_info *info, void *user_data)
+{
+    char addr[BT_ADDR_LE_STR_LEN];
+    int *count = user_data;
+    
+    bt_addr_le_to_str(&info->addr, addr, sizeof(addr));
+    LOG_INF("🔐 Bonded peer %s", addr);
+    (*count)++;
+}
+#endif
+
+/**
+ * @brief Fast advertising window over - drop to the normal interval
+ */
+static void bt_adv_slow_work_handler(struct k_work *work)
+{
+    if (!bt_audio.fast_adv) {
+        return;
+    }
+    
+    bt_audio.fast_adv = false;
+    if (bt_audio.connected) {
+        return;
+    }
+    
+    bt_le_adv_stop();
+    if (bt_start_advertising()) {
+        LOG_ERR("Failed to restart advertising at the normal interval");
+    }
+}
+
 /**
  * @brief Bluetooth ready callback
  */
@@ -153,6 +279,7 @@ static void bt_ready_callback(int err)
 {
     if (err) {
         LOG_ERR("Bluetooth init failed: %d", err);
+        bt_audio_report_ready(err);
         return;
     }
     
@@ -161,9 +288,21 @@ static void bt_ready_callback(int err)
     /* Give the SPBTLE-RF module a moment to fully initialize */
     k_sleep(K_MSEC(100));
     
+#if defined(CONFIG_BT_SETTINGS)
+    /* Identity and bonds; the host finishes its init once they are loaded */
+    int bonds = 0;
+    
+    settings_load_subtree("bt");
+    bt_foreach_bond(BT_ID_DEFAULT, bt_log_bond, &bonds);
+    
+    /* A bonded peer reconnects on its own, so meet its scan window early */
+    bt_audio.fast_adv = (bonds > 0);
+#endif
+    
     /* Check if Bluetooth is actually ready */
     if (!bt_is_ready()) {
         LOG_ERR("Bluetooth reports not ready after initialization");
+        bt_audio_report_ready(-EIO);
         return;
     }
     
@@ -171,9 +310,15 @@ static void bt_ready_callback(int err)
     int ret = bt_start_advertising();
     if (ret) {
         LOG_ERR("Failed to start advertising: %d", ret);
+        bt_audio_report_ready(ret);
         return;
     }
     
+    if (bt_audio.fast_adv) {
+        k_work_schedule(&bt_audio.adv_slow_work, K_MSEC(BT_AUDIO_FAST_ADV_MS));
+    }
+    bt_audio_report_ready(0);
+    
     LOG_INF("✅ Bluetooth advertising active - device is discoverable");
     LOG_INF("📱 Connect from Nordic nRF Connect, LightBlue, or similar BLE apps");
     LOG_INF("🎵 Device name: 'MP3-Rewind' - look for this in your BLE scanner");
@@ -208,6 +353,11 @@ static int bt_start_advertising(void)
         .peer = NULL,
     };
     
+    if (bt_audio.fast_adv) {
+        adv_param.interval_min = BT_GAP_ADV_FAST_INT_MIN_1;  /* 30ms */
+        adv_param.interval_max = BT_GAP_ADV_FAST_INT_MAX_1;  /* 60ms */
+    }
+    
     /* Start advertising with flags and name */
     ret = bt_le_adv_start(&adv_param, simple_ad, ARRAY_SIZE(simple_ad), NULL, 0);
     if (ret) {
@@ -252,14 +402,16 @@ static void bt_connected_callback(struct bt_conn *conn, uint8_t err)
     /* Register GATT audio control callback */
     gatt_audio_register_control_callback(bt_audio_control_callback);
     
-    /* Set audio format in GATT service */
-    gatt_audio_format_t format = {
-        .sample_rate = BT_AUDIO_SAMPLE_RATE,
-        .channels = BT_AUDIO_CHANNELS,
-        .bits_per_sample = BT_AUDIO_BITS_PER_SAMPLE,
-        .frame_size = (BT_AUDIO_CHANNELS * BT_AUDIO_BITS_PER_SAMPLE) / 8
-    };
-    gatt_audio_set_format(&format, conn);
+    /* Fresh encoder for the new link, then set audio format in GATT service */
+    audio_codec_reset(&bt_audio.codec_state, BT_AUDIO_CHANNELS);
+    bt_audio.codec_stage_len = 0;
+    bt_audio.codec_frame_len = 0;
+    bt_audio_advertise_format(gatt_audio_get_max_chunk_size(conn));
+    
+    /* Start from a full set of TX credits and ask for a faster link */
+    gatt_audio_reset_credits();
+    gatt_audio_configure_link(conn);
+    conn_params_connected(bt_audio.conn);
     
     /* Note: Streaming will be started manually in Test 2 after notifications are enabled */
     LOG_INF("🎵 Connection established - waiting for manual streaming start in Test 2");
@@ -272,7 +424,7 @@ static void bt_connected_callback(struct bt_conn *conn, uint8_t err)
         K_THREAD_STACK_SIZEOF(bt_audio_stack),
         bt_audio_streaming_thread,
         NULL, NULL, NULL,
-        K_PRIO_PREEMPT(7),
+        APP_THREAD_PRIO_BT_TX,
         0,
         K_NO_WAIT
     );
@@ -290,6 +442,7 @@ static void bt_disconnected_callback(struct bt_conn *conn, uint8_t reason)
     
     bt_audio.connected = false;
     bt_audio.streaming = false;
+    conn_params_disconnected();
     
     if (bt_audio.conn) {
         bt_conn_unref(bt_audio.conn);
@@ -302,8 +455,18 @@ static void bt_disconnected_callback(struct bt_conn *conn, uint8_t reason)
         bt_audio.audio_thread_id = NULL;
     }
     
-    /* Clear audio buffer */
-    circular_buffer_clear(&bt_audio.audio_buffer);
+    /* The thread is gone, so its in-flight pool buffer can be released here */
+    if (bt_audio.tx_current) {
+        bt_audio_release(bt_audio.tx_current);
+        bt_audio.tx_current = NULL;
+    }
+    
+    /* No consumer is left either, so the ring can be cleared from here */
+    spsc_buffer_clear(&bt_audio.audio_buffer);
+    bt_audio_flush_queue();
+    
+    /* Completions for notifications queued on the old link never arrive */
+    gatt_audio_reset_credits();
     
     /* Restart advertising for new connections */
     bt_start_advertising();
@@ -311,6 +474,20 @@ static void bt_disconnected_callback(struct bt_conn *conn, uint8_t reason)
     LOG_INF("Ready for new Bluetooth connections");
 }
 
+/**
+ * @brief Connection parameters changed - the TX window follows the interval
+ */
+static void bt_le_param_updated_callback(struct bt_conn *conn, uint16_t interval,
+                                         uint16_t latency, uint16_t timeout)
+{
+    if (conn != bt_audio.conn) {
+        return;
+    }
+    
+    conn_params_updated(interval, latency, timeout);
+    k_poll_signal_raise(&bt_audio.wake, 0);
+}
+
 /**
  * @brief Start Bluetooth audio streaming
  */
@@ -327,10 +504,14 @@ int bluetooth_audio_start(void)
     }
     
     if (bt_audio.streaming) {
+        if (bt_audio.paused) {
+            return bluetooth_audio_resume();
+        }
         LOG_WRN("Already streaming");
         return 0;
     }
     
+    bt_audio.paused = false;
     bt_audio.streaming = true;
     k_sem_give(&bt_audio.stream_sem);
     
@@ -348,15 +529,53 @@ int bluetooth_audio_stop(void)
     }
     
     bt_audio.streaming = false;
+    bt_audio.paused = false;
     k_sem_reset(&bt_audio.stream_sem);
     
     /* Clear any remaining audio data */
-    circular_buffer_clear(&bt_audio.audio_buffer);
+    bt_audio_flush_queue();
+    k_poll_signal_raise(&bt_audio.wake, 0);
     
     LOG_INF("Bluetooth audio streaming stopped");
     return 0;
 }
 
+/**
+ * @brief Hold Bluetooth audio, keeping everything queued
+ */
+int bluetooth_audio_pause(void)
+{
+    if (!bt_audio.streaming) {
+        return -EINVAL;
+    }
+    
+    /* The streaming thread parks at the top of its loop; nothing is dropped */
+    bt_audio.paused = true;
+    k_poll_signal_raise(&bt_audio.wake, 0);
+    
+    LOG_INF("Bluetooth audio streaming paused");
+    return 0;
+}
+
+/**
+ * @brief Continue sending from where bluetooth_audio_pause() stopped
+ */
+int bluetooth_audio_resume(void)
+{
+    if (!bt_audio.streaming) {
+        return -EINVAL;
+    }
+    if (!bt_audio.paused) {
+        return 0;
+    }
+    
+    bt_audio.paused = false;
+    k_poll_signal_raise(&bt_audio.wake, 0);
+    
+    LOG_INF("Bluetooth audio streaming resumed");
+    return 0;
+}
+
 /**
  * @brief Write audio data to Bluetooth output
  */
@@ -367,89 +586,503 @@ int bluetooth_audio_write(const uint8_t *data, size_t len)
     }
     
     /* Write data to circular buffer */
-    size_t written = circular_buffer_write(&bt_audio.audio_buffer, data, len);
+    size_t written = spsc_buffer_write(&bt_audio.audio_buffer, data, len);
     
     if (written < len) {
-        LOG_WRN("Audio buffer full, dropping %zu bytes", len - written);
+        LOG_DBG("Audio buffer full, accepted %zu of %zu bytes", written, len);
+    }
+    if (written > 0) {
+        k_poll_signal_raise(&bt_audio.wake, 0);
     }
     
     LOG_DBG("Wrote %zu bytes to Bluetooth audio buffer", written);
     return written;
 }
 
+/**
+ * @brief Write audio data to Bluetooth output, blocking while the buffer is full
+ */
+int bluetooth_audio_write_timeout(const uint8_t *data, size_t len, k_timeout_t timeout)
+{
+    if (!bt_audio.initialized || !bt_audio.connected) {
+        return -ENOTCONN;
+    }
+    
+    size_t written = spsc_buffer_write_timeout(&bt_audio.audio_buffer, data, len, timeout);
+    if (written > 0) {
+        k_poll_signal_raise(&bt_audio.wake, 0);
+    }
+    
+    LOG_DBG("Wrote %zu bytes to Bluetooth audio buffer", written);
+    return written;
+}
+
+/**
+ * @brief Queue a pool buffer for zero-copy GATT notification
+ */
+int bluetooth_audio_submit(struct audio_buffer *buffer)
+{
+    if (!bt_audio.initialized || !bt_audio.connected) {
+        return -ENOTCONN;
+    }
+    
+    if (!buffer || (buffer->used == 0 && !audio_buffer_is_end_marker(buffer))) {
+        return -EINVAL;
+    }
+    
+    /* Volume is applied here, on the producer's time. Pool buffers carry
+     * whole sample frames, so every 16-bit sample is in one piece. Buffers
+     * shared with other outputs arrive with the volume already applied */
+    if (!audio_buffer_is_shared(buffer)) {
+        pcm_gain_q15((int16_t *)buffer->data, buffer->used / sizeof(int16_t),
+                     (int16_t)atomic_get(&bt_audio.gain));
+    }
+    
+    buffer->offset = 0;
+    bt_audio_queued_add(buffer->used);
+    k_fifo_put(&bt_audio.tx_fifo, buffer);
+    
+    trace_event(TRACE_BT_QUEUED, buffer->sequence, buffer->used);
+    return 0;
+}
+
+/**
+ * @brief Recompute the sample gain from the volume and mute state
+ * 
+ * While the audio system mirrors, buffers arrive shared with the volume
+ * already applied, so the volume and mute state go to the audio system
+ * and this output's own gain stays at unity.
+ */
+static void bt_audio_update_gain(void)
+{
+    if (audio_system_is_mirroring()) {
+        atomic_set(&bt_audio.gain, PCM_GAIN_UNITY);
+        audio_system_set_volume(bt_audio.muted ? 0 : bt_audio.volume);
+        return;
+    }
+    
+    atomic_set(&bt_audio.gain, bt_audio.muted ? 0 : pcm_volume_to_q15(bt_audio.volume));
+}
+
+/**
+ * @brief Adjust the count of submitted bytes not yet released
+ */
+static void bt_audio_queued_add(atomic_val_t delta)
+{
+    atomic_val_t queued = atomic_add(&bt_audio.tx_queued, delta) + delta;
+    
+    metrics_gauge_set(METRICS_TX_QUEUED, (queued > 0) ? (uint32_t)queued : 0);
+}
+
+/**
+ * @brief Give a submitted pool buffer back, keeping the queued count in step
+ */
+static void bt_audio_release(struct audio_buffer *buffer)
+{
+    bt_audio_queued_add(-(atomic_val_t)buffer->used);
+    audio_buffer_free(buffer);
+}
+
+/**
+ * @brief Return every queued pool buffer to the pool and empty the ring
+ * 
+ * Safe from any thread; the buffer the streaming thread is sending and
+ * the ring, which it may be reading from, are dropped by the thread
+ * itself on its next pass.
+ */
+static void bt_audio_flush_queue(void)
+{
+    struct audio_buffer *buf;
+    
+    atomic_set(&bt_audio.tx_flush, 1);
+    while ((buf = k_fifo_get(&bt_audio.tx_fifo, K_NO_WAIT)) != NULL) {
+        bt_audio_release(buf);
+    }
+}
+
+/**
+ * @brief Publish the stream format and codec framing on the info characteristic
+ * 
+ * Codec frames fill one notification, so the framing changes with the MTU.
+ */
+static void bt_audio_advertise_format(size_t frame_size)
+{
+    gatt_audio_format_t format = {
+        .sample_rate = BT_AUDIO_SAMPLE_RATE,
+        .channels = BT_AUDIO_CHANNELS,
+        .bits_per_sample = BT_AUDIO_BITS_PER_SAMPLE,
+        .frame_size = (BT_AUDIO_CHANNELS * BT_AUDIO_BITS_PER_SAMPLE) / 8,
+        .codec = bt_audio.codec->id,
+        .codec_frame_size = frame_size,
+        .samples_per_frame = audio_codec_pcm_bytes(bt_audio.codec, &bt_audio.codec_state,
+                                                   frame_size) /
+                             ((BT_AUDIO_CHANNELS * BT_AUDIO_BITS_PER_SAMPLE) / 8)
+    };
+    
+    bt_audio.codec_frame_size = frame_size;
+    gatt_audio_set_format(&format, bt_audio.conn);
+}
+
+/**
+ * @brief Apply a pending bt_audio_flush_queue() on the streaming thread
+ */
+static void bt_audio_apply_flush(void)
+{
+    if (!atomic_clear(&bt_audio.tx_flush)) {
+        return;
+    }
+    
+    if (bt_audio.tx_current) {
+        bt_audio_release(bt_audio.tx_current);
+        bt_audio.tx_current = NULL;
+    }
+    spsc_buffer_clear(&bt_audio.audio_buffer);
+    bt_audio.codec_stage_len = 0;
+    bt_audio.codec_frame_len = 0;
+    bt_audio.conceal_pending = false;
+}
+
+/**
+ * @brief Hide an underrun by fading from the last sent frame to silence
+ * 
+ * Stopping dead on a non-zero sample is what makes an underrun click. The
+ * ramp is built in a pool buffer - the pool is idle once the queue has run
+ * dry - and sent like any other submitted audio. Playback resuming
+ * afterwards is faded in by the audio system.
+ * 
+ * @return true if a ramp became tx_current
+ */
+static bool bt_audio_conceal_underrun(void)
+{
+    const size_t frame_bytes = sizeof(bt_audio.last_frame);
+    struct audio_buffer *buf;
+    size_t frames;
+    
+    if (!bt_audio.conceal_pending) {
+        return false;
+    }
+    bt_audio.conceal_pending = false;
+    
+    buf = audio_buffer_alloc(K_NO_WAIT);
+    if (!buf) {
+        return false;
+    }
+    
+    frames = MIN(BT_AUDIO_CONCEAL_FRAMES, buf->size / frame_bytes);
+    pcm_ramp_to_silence(bt_audio.last_frame, (int16_t *)buf->data, frames, BT_AUDIO_CHANNELS);
+    buf->used = frames * frame_bytes;
+    buf->offset = 0;
+    buf->flags = AUDIO_BUFFER_FLAG_END_OF_STREAM;  /* Nothing to conceal after the ramp */
+    bt_audio_queued_add(buf->used);
+    bt_audio.tx_current = buf;
+    
+    trace_event(TRACE_BT_CONCEAL, buf->used, 0);
+    return true;
+}
+
+/**
+ * @brief Take the next submitted buffer that holds audio
+ * 
+ * End markers are used up on the way: the audio before them is the end of
+ * the stream, so running dry after it is not concealed.
+ */
+static struct audio_buffer *bt_audio_take(k_timeout_t timeout)
+{
+    struct audio_buffer *buf;
+    
+    while ((buf = k_fifo_get(&bt_audio.tx_fifo, timeout)) != NULL &&
+           audio_buffer_is_end_marker(buf)) {
+        bt_audio.conceal_pending = false;
+        bt_audio_release(buf);
+    }
+    return buf;
+}
+
+/**
+ * @brief Find the next span to notify - queued pool buffers first, then the ring
+ * 
+ * @param chunk Set to the start of the span (inside the pool buffer or ring)
+ * @param max_len Largest span the link accepts in one notification
+ * @param from_pool Set to true when the span belongs to tx_current
+ * @return Span length, 0 if nothing arrived within the wait
+ */
+static size_t bt_audio_next_chunk(const uint8_t **chunk, size_t max_len, bool *from_pool)
+{
+    size_t len;
+    
+    bt_audio_apply_flush();
+    
+    if (!bt_audio.tx_current) {
+        bt_audio.tx_current = bt_audio_take(K_NO_WAIT);
+    }
+    
+    if (!bt_audio.tx_current) {
+        /* Fall back to bytes written through bluetooth_audio_write() */
+        len = spsc_buffer_peek(&bt_audio.audio_buffer, chunk, max_len);
+        if (len > 0) {
+            *from_pool = false;
+            return len;
+        }
+        
+        if (!bt_audio_conceal_underrun()) {
+            bt_audio.tx_current = bt_audio_take(K_MSEC(100));
+            if (!bt_audio.tx_current) {
+                return 0;
+            }
+        }
+    }
+    
+    *chunk = &bt_audio.tx_current->data[bt_audio.tx_current->offset];
+    *from_pool = true;
+    return MIN(max_len, bt_audio.tx_current->used - bt_audio.tx_current->offset);
+}
+
+/**
+ * @brief Retire a span returned by bt_audio_next_chunk()
+ */
+static void bt_audio_consume_chunk(size_t len, bool from_pool)
+{
+    if (!from_pool) {
+        spsc_buffer_consume(&bt_audio.audio_buffer, len);
+        return;
+    }
+    
+    /* bt_gatt_notify copies into an ACL buffer, so the pool buffer can go
+     * back as soon as its last byte has been accepted by the stack */
+    bt_audio.tx_current->offset += len;
+    if (bt_audio.tx_current->offset >= bt_audio.tx_current->used) {
+        struct audio_buffer *done = bt_audio.tx_current;
+        
+        /* Remember where the audio stopped in case nothing follows */
+        if (done->used >= sizeof(bt_audio.last_frame)) {
+            memcpy(bt_audio.last_frame, &done->data[done->used - sizeof(bt_audio.last_frame)],
+                   sizeof(bt_audio.last_frame));
+            bt_audio.conceal_pending = !(done->flags & AUDIO_BUFFER_FLAG_END_OF_STREAM);
+        }
+        /* Stamped when it started filling, see audio_buffer.timestamp */
+        metrics_record(METRICS_HIST_E2E_MS, (uint32_t)(k_uptime_get() - done->timestamp));
+        bt_audio_release(done);
+        bt_audio.tx_current = NULL;
+    }
+}
+
+/**
+ * @brief Encode the next notification into codec_frame
+ * 
+ * PCM is copied out of the queue into codec_stage so frames always start
+ * on a sample boundary, however the network split the buffers. The frame
+ * is kept until it has been sent, so a retry never re-encodes.
+ * 
+ * @param frame_size Largest payload the link accepts in one notification
+ * @return Frame length, 0 if no audio arrived within the wait
+ */
+static size_t bt_audio_next_frame(size_t frame_size)
+{
+    const uint8_t *chunk;
+    bool from_pool;
+    size_t used;
+    
+    bt_audio_apply_flush();
+    if (bt_audio.codec_frame_len > 0) {
+        return bt_audio.codec_frame_len;
+    }
+    
+    size_t want = audio_codec_pcm_bytes(bt_audio.codec, &bt_audio.codec_state, frame_size);
+    want = MIN(want, sizeof(bt_audio.codec_stage));
+    
+    /* Gather a full frame's worth, or whatever came before the queue ran dry */
+    while (bt_audio.codec_stage_len < want) {
+        size_t len = bt_audio_next_chunk(&chunk, want - bt_audio.codec_stage_len, &from_pool);
+        if (len == 0) {
+            break;
+        }
+        /* Re-read the fill level - a flush inside next_chunk empties the stage */
+        memcpy(&bt_audio.codec_stage[bt_audio.codec_stage_len], chunk, len);
+        bt_audio.codec_stage_len += len;
+        bt_audio_consume_chunk(len, from_pool);
+    }
+    
+    bt_audio.codec_frame_len = bt_audio.codec->encode(&bt_audio.codec_state,
+                                                      bt_audio.codec_stage,
+                                                      bt_audio.codec_stage_len,
+                                                      bt_audio.codec_frame,
+                                                      MIN(frame_size, sizeof(bt_audio.codec_frame)),
+                                                      &used);
+    
+    /* Keep any partial sample for the next frame */
+    bt_audio.codec_stage_len -= used;
+    memmove(bt_audio.codec_stage, &bt_audio.codec_stage[used], bt_audio.codec_stage_len);
+    
+    return bt_audio.codec_frame_len;
+}
+
+/**
+ * @brief Retire a notification payload once sent (or dropped)
+ */
+static void bt_audio_retire(size_t len, bool from_pool)
+{
+    if (bt_audio.codec->encode) {
+        bt_audio.codec_frame_len = 0;
+    } else {
+        bt_audio_consume_chunk(len, from_pool);
+    }
+}
+
+/**
+ * @brief Block until something the streaming thread waits for happens
+ * 
+ * Wakes on bt_audio.wake - new ring data, a notification completing, a
+ * subscription change, stop or flush - and, with @p for_data, on pool
+ * buffers arriving. The caller resets the signal before checking its
+ * condition, so an event between the check and the wait is not lost.
+ * 
+ * @param for_data Also wake when tx_fifo has a buffer
+ * @param timeout Upper bound on the wait
+ */
+static void bt_audio_wait(bool for_data, k_timeout_t timeout)
+{
+    struct k_poll_event events[] = {
+        K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &bt_audio.wake),
+        K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_FIFO_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,
+                                 &bt_audio.tx_fifo),
+    };
+    
+    k_poll(events, for_data ? ARRAY_SIZE(events) : 1, timeout);
+}
+
 /**
  * @brief Audio streaming thread - handles actual Bluetooth LE GATT audio transmission
  */
 static void bt_audio_streaming_thread(void *p1, void *p2, void *p3)
 {
-    uint8_t audio_chunk[64];   /* Even smaller chunk size for BLE reliability */
+    const uint8_t *audio_chunk;  /* Points into a pool buffer or the ring, sent without copying */
     size_t bytes_read;
+    size_t max_chunk;
+    bool from_pool = false;
     int ret;
     int failed_attempts = 0;
     
+    trace_thread_attach(&bt_audio_trace);
     LOG_INF("🎵 Bluetooth LE GATT audio streaming thread started");
     
     while (bt_audio.connected) {
         /* Wait for streaming to be enabled */
         if (!bt_audio.streaming) {
+            /* A stop flushes now, not when streaming restarts */
+            bt_audio_apply_flush();
             k_sem_take(&bt_audio.stream_sem, K_FOREVER);
             continue;
         }
         
+        /* Events from here on wake the waits below */
+        k_poll_signal_reset(&bt_audio.wake);
+        
+        /* Paused: the queue and the ring keep their audio for the resume */
+        if (bt_audio.paused) {
+            bt_audio_wait(false, K_FOREVER);
+            continue;
+        }
+        
         /* Check if client is subscribed to GATT notifications */
         if (!gatt_audio_is_subscribed(bt_audio.conn)) {
-            LOG_DBG("Waiting for GATT client to subscribe to audio notifications...");
-            k_sleep(K_MSEC(1000));
+            trace_event(TRACE_BT_WAIT_SUBSCRIBE, 0, 0);
+            bt_audio_wait(false, K_FOREVER);
             continue;
         }
         
-        /* Read audio data from circular buffer */
-        bytes_read = circular_buffer_read_timeout(&bt_audio.audio_buffer, 
-                                                 audio_chunk, 
-                                                 sizeof(audio_chunk),
-                                                 K_MSEC(100));
+        /* Codec frames fill one notification, so follow MTU changes */
+        max_chunk = gatt_audio_get_max_chunk_size(bt_audio.conn);
+        if (max_chunk != bt_audio.codec_frame_size) {
+            bt_audio_advertise_format(max_chunk);
+        }
+        
+        /* Keep the next connection events' worth of notifications queued in
+         * the controller, but no more than the link has been draining */
+        if (gatt_audio_get_in_flight() >= conn_params_tx_window()) {
+            bt_audio_wait(false, K_MSEC(GATT_AUDIO_CREDIT_TIMEOUT_MS));
+            continue;
+        }
+        
+        /* Take one notification's worth of audio; it stays queued until sent */
+        if (bt_audio.codec->encode) {
+            bytes_read = bt_audio_next_frame(max_chunk);
+            audio_chunk = bt_audio.codec_frame;
+        } else {
+            bytes_read = bt_audio_next_chunk(&audio_chunk, max_chunk, &from_pool);
+        }
         
         if (bytes_read > 0) {
-            /* Stream audio via Bluetooth LE GATT service with conservative flow control */
+            /* Credit mode blocks inside the send until the link has room */
+            uint32_t send_start = k_cycle_get_32();
             ret = gatt_audio_send_data(audio_chunk, bytes_read, bt_audio.conn);
+            uint32_t send_us = k_cyc_to_us_floor32(k_cycle_get_32() - send_start);
+            metrics_record(METRICS_HIST_NOTIFY_US, send_us);
+            conn_params_tx_result(ret);
             if (ret > 0) {
-                LOG_DBG("🎵 Streamed %d bytes via GATT Audio Service", ret);
+                metrics_inc(METRICS_NOTIFY_OK);
+                metrics_add(METRICS_NOTIFY_BYTES, ret);
+                trace_event(TRACE_BT_SENT, ret, send_us);
                 failed_attempts = 0;  /* Reset failure counter */
+                bt_audio_retire(ret, from_pool);
                 
                 /* Very conservative timing for BLE notifications - 100ms between sends */
-                k_sleep(K_MSEC(100));
+                if (gatt_audio_get_transport_mode() == GATT_AUDIO_TRANSPORT_CONSERVATIVE) {
+                    k_sleep(K_MSEC(100));
+                }
                 
             } else if (ret == -ENOTCONN) {
-                LOG_DBG("Client not subscribed, waiting...");
-                k_sleep(K_MSEC(200));
+                trace_event(TRACE_BT_NOT_SUBSCRIBED, 0, 0);
+                bt_audio_wait(false, K_MSEC(200));
             } else if (ret == -EAGAIN) {
-                /* Rate limited - just wait a bit */
-                LOG_DBG("Rate limited, waiting...");
-                k_sleep(K_MSEC(50));
-            } else if (ret == -ENOMEM || ret == -12) {
-                /* Buffer overflow - implement backoff strategy */
-                failed_attempts++;
-                if (failed_attempts < 3) {
-                    LOG_DBG("BLE buffer full, backing off... (attempt %d)", failed_attempts);
-                    k_sleep(K_MSEC(200 * failed_attempts));  /* Conservative backoff */
-                } else {
-                    LOG_WRN("Too many BLE buffer failures, pausing streaming...");
-                    k_sleep(K_MSEC(2000));  /* Longer pause */
-                    failed_attempts = 0;
+                /* Rate limited or out of credits - the chunk is still in the ring */
+                metrics_inc(METRICS_NOTIFY_EAGAIN);
+                trace_event(TRACE_BT_RATE_LIMITED, 0, 0);
+                if (gatt_audio_get_transport_mode() == GATT_AUDIO_TRANSPORT_CONSERVATIVE) {
+                    k_sleep(K_MSEC(50));
+                }
+            } else if (ret == -ENOMEM) {
+                /* Out of ACL buffers - the TX window has been halved. Back off
+                 * a connection event per failure, but retry as soon as a
+                 * notification frees its buffer */
+                metrics_inc(METRICS_NOTIFY_ENOMEM);
+                if (++failed_attempts == BT_AUDIO_BACKOFF_EVENTS) {
+                    LOG_WRN("BLE buffers still exhausted after %d retries", failed_attempts);
                 }
+                failed_attempts = MIN(failed_attempts, BT_AUDIO_BACKOFF_EVENTS);
+                trace_event(TRACE_BT_BACKOFF, failed_attempts, 0);
+                bt_audio_wait(false, K_USEC(conn_params_interval_us() * failed_attempts));
             } else {
                 LOG_ERR("Failed to send audio data: %d", ret);
-                k_sleep(K_MSEC(100));
+                metrics_inc(METRICS_NOTIFY_ERROR);
+                /* Drop the chunk rather than retry a hard failure */
+                bt_audio_retire(bytes_read, from_pool);
+                bt_audio_wait(false, K_MSEC(100));
             }
         } else {
-            /* No data available, small delay to prevent busy waiting */
-            k_sleep(K_MSEC(50));
+            /* Nothing queued - sleep until a producer hands over audio */
+            bt_audio_wait(true, K_FOREVER);
         }
     }
     
     LOG_INF("Bluetooth LE GATT audio streaming thread terminated");
 }
 
+/**
+ * @brief Drop all queued audio without stopping the stream
+ */
+int bluetooth_audio_flush(void)
+{
+    if (!bt_audio.initialized) {
+        return -EINVAL;
+    }
+    
+    bt_audio_flush_queue();
+    k_poll_signal_raise(&bt_audio.wake, 0);
+    
+    trace_event(TRACE_BT_FLUSHED, 0, 0);
+    return 0;
+}
+
 /**
  * @brief Set Bluetooth audio volume
  */
@@ -460,10 +1093,9 @@ int bluetooth_audio_set_volume(uint8_t volume)
     }
     
     bt_audio.volume = volume;
+    bt_audio_update_gain();
     
-    /* TODO: Implement actual Bluetooth volume control via GATT */
-    /* For BLE, this would typically be done through a custom GATT service */
-    LOG_INF("Bluetooth LE simulated volume set to %u%%", volume);
+    LOG_INF("Bluetooth LE volume set to %u%%", volume);
     return 0;
 }
 
@@ -492,7 +1124,17 @@ size_t bluetooth_audio_get_free_space(void)
         return 0;
     }
     
-    return circular_buffer_space_get(&bt_audio.audio_buffer);
+    return spsc_buffer_space_get(&bt_audio.audio_buffer);
+}
+
+/**
+ * @brief Get bytes of submitted audio still waiting to be sent
+ */
+size_t bluetooth_audio_get_queued(void)
+{
+    atomic_val_t queued = atomic_get(&bt_audio.tx_queued);
+    
+    return (queued > 0) ? (size_t)queued : 0;
 }
 
 /**
@@ -630,6 +1272,7 @@ int bluetooth_audio_cleanup(void)
     
     /* Stop streaming */
     bluetooth_audio_stop();
+    k_work_cancel_delayable(&bt_audio.adv_slow_work);
     
     /* Disconnect if connected */
     if (bt_audio.connected && bt_audio.conn) {
@@ -639,7 +1282,7 @@ int bluetooth_audio_cleanup(void)
     }
     
     /* Cleanup circular buffer */
-    circular_buffer_cleanup(&bt_audio.audio_buffer);
+    spsc_buffer_cleanup(&bt_audio.audio_buffer);
     
     bt_audio.initialized = false;
     bt_audio.connected = false;
@@ -649,6 +1292,31 @@ int bluetooth_audio_cleanup(void)
     return 0;
 }
 
+/* The transmit FIFO is bounded by the pool, so submit never waits */
+static int bt_audio_backend_submit(struct audio_buffer *buffer, k_timeout_t timeout)
+{
+    return bluetooth_audio_submit(buffer);
+}
+
+const struct audio_backend bluetooth_audio_backend = {
+    .name = "Bluetooth",
+    .jitter_buffer = true,
+    .queues_by_node = true,
+    .init = bluetooth_audio_init,
+    .start = bluetooth_audio_start,
+    .stop = bluetooth_audio_stop,
+    .pause = bluetooth_audio_pause,
+    .resume = bluetooth_audio_resume,
+    .write = bluetooth_audio_write,
+    .write_timeout = bluetooth_audio_write_timeout,
+    .submit = bt_audio_backend_submit,
+    .flush = bluetooth_audio_flush,
+    .set_volume = bluetooth_audio_set_volume,
+    .get_free_space = bluetooth_audio_get_free_space,
+    .get_queued = bluetooth_audio_get_queued,
+    .cleanup = bluetooth_audio_cleanup,
+};
+
 /**
  * @brief Start device discovery to find nearby Bluetooth audio devices
  */
@@ -687,14 +1355,15 @@ static void bt_audio_control_callback(const gatt_audio_control_t *control)
             break;
             
         case AUDIO_CMD_PAUSE:
+            /* Held buffers stay out of the pool, which stalls the receiver too */
             LOG_INF("⏸️  Remote PAUSE command - pausing audio streaming");
-            bluetooth_audio_stop();
+            bluetooth_audio_pause();
             break;
             
         case AUDIO_CMD_STOP:
             LOG_INF("⏹️  Remote STOP command - stopping audio streaming");
             bluetooth_audio_stop();
-            circular_buffer_clear(&bt_audio.audio_buffer);
+            bt_audio_flush_queue();
             break;
             
         case AUDIO_CMD_VOLUME:
@@ -704,12 +1373,14 @@ static void bt_audio_control_callback(const gatt_audio_control_t *control)
             
         case AUDIO_CMD_MUTE:
             LOG_INF("🔇 Remote MUTE command");
-            bluetooth_audio_set_volume(0);
+            bt_audio.muted = true;
+            bt_audio_update_gain();
             break;
             
         case AUDIO_CMD_UNMUTE:
             LOG_INF("🔊 Remote UNMUTE command - restoring volume");
-            bluetooth_audio_set_volume(bt_audio.volume);
+            bt_audio.muted = false;
+            bt_audio_update_gain();
             break;
             
         default:
@@ -748,7 +1419,7 @@ static void test_audio_generation_work(struct k_work *work)
     }
     
     /* Write test audio to buffer */
-    size_t written = circular_buffer_write(&bt_audio.audio_buffer, test_audio, sizeof(test_audio));
+    size_t written = spsc_buffer_write(&bt_audio.audio_buffer, test_audio, sizeof(test_audio));
     LOG_INF("🎵 Generated %zu bytes of test audio", written);
     
     /* Schedule next audio generation if still connected and streaming */
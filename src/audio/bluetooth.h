@@ -21,14 +21,40 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Called once the controller is up and advertising
+ *
+ * @param err 0 on success, negative error code if bring-up failed
+ */
+typedef void (*bluetooth_audio_ready_cb_t)(int err);
+
 /**
  * @brief Initialize Bluetooth audio system
  * 
+ * Returns once bt_enable() has been issued; the controller comes up in
+ * the background and reports through the ready callback.
+ * 
  * @param format Audio format configuration  
  * @return 0 on success, negative error code on failure
  */
 int bluetooth_audio_init(const audio_format_t *format);
 
+/**
+ * @brief Register the ready callback
+ *
+ * Set before bluetooth_audio_init(). Runs on the system work queue.
+ *
+ * @param cb Callback, NULL to clear
+ */
+void bluetooth_audio_set_ready_callback(bluetooth_audio_ready_cb_t cb);
+
+/**
+ * @brief Check if the controller is up and advertising
+ *
+ * @return true once bring-up has finished
+ */
+bool bluetooth_audio_is_ready(void);
+
 /**
  * @brief Start Bluetooth audio streaming
  * 
@@ -43,6 +69,23 @@ int bluetooth_audio_start(void);
  */
 int bluetooth_audio_stop(void);
 
+/**
+ * @brief Pause Bluetooth audio streaming
+ * 
+ * Stops sending notifications but keeps the queued buffers and the ring,
+ * so bluetooth_audio_resume() carries on with the next byte.
+ * 
+ * @return 0 on success, -EINVAL if not streaming
+ */
+int bluetooth_audio_pause(void);
+
+/**
+ * @brief Resume paused Bluetooth audio streaming
+ * 
+ * @return 0 on success, -EINVAL if not streaming
+ */
+int bluetooth_audio_resume(void);
+
 /**
  * @brief Write audio data to Bluetooth output
  * 
@@ -52,9 +95,48 @@ int bluetooth_audio_stop(void);
  */
 int bluetooth_audio_write(const uint8_t *data, size_t len);
 
+/**
+ * @brief Write audio data to Bluetooth output, waiting for buffer space
+ * 
+ * Blocks until the streaming thread has drained enough of the audio
+ * buffer to accept at least one byte, so the BLE link paces the producer.
+ * 
+ * @param data Pointer to audio data
+ * @param len Length of audio data in bytes
+ * @param timeout Maximum time to wait for space
+ * @return Number of bytes written (0 on timeout), negative on error
+ */
+int bluetooth_audio_write_timeout(const uint8_t *data, size_t len, k_timeout_t timeout);
+
+/**
+ * @brief Queue a pool buffer for GATT notification without copying it
+ * 
+ * The streaming thread notifies straight from @c buffer->data and frees
+ * the buffer to the pool once its last byte has been handed to the stack.
+ * Queued buffers are sent ahead of data written with bluetooth_audio_write().
+ * The buffer must hold whole 16-bit sample frames; the current volume is
+ * applied to it in place before it is queued.
+ * 
+ * @param buffer Filled buffer from audio_buffer_alloc()
+ * @return 0 on success (ownership transferred), negative on error
+ */
+int bluetooth_audio_submit(struct audio_buffer *buffer);
+
+/**
+ * @brief Drop all queued audio without stopping the stream
+ * 
+ * Used on seek so stale audio from the old position is not played out.
+ * 
+ * @return 0 on success, negative error code on failure
+ */
+int bluetooth_audio_flush(void);
+
 /**
  * @brief Set Bluetooth audio volume
  * 
+ * Scales the 16-bit samples of buffers passed to bluetooth_audio_submit()
+ * from then on; bytes written with bluetooth_audio_write() are sent as is.
+ * 
  * @param volume Volume level (0-100)
  * @return 0 on success, negative error code on failure
  */
@@ -81,6 +163,16 @@ bool bluetooth_audio_is_streaming(void);
  */
 size_t bluetooth_audio_get_free_space(void);
 
+/**
+ * @brief Get the amount of submitted audio not yet sent
+ * 
+ * Counts every pool buffer passed to bluetooth_audio_submit() until it
+ * has been fully handed to the stack or flushed.
+ * 
+ * @return Queued bytes, 0 once the sender has run dry
+ */
+size_t bluetooth_audio_get_queued(void);
+
 /**
  * @brief Start device discovery for pairing
  * 
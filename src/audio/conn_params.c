@@ -0,0 +1,298 @@
+/**
+ * @file conn_params.c
+ * @brief BLE connection parameter manager for the audio link
+ *
+ * See conn_params.h. Counters from the streaming thread are atomics; the
+ * decisions are all taken on the system work queue, once per
+ * CONN_PARAMS_EVAL_MS, so requests never go out from the hot path.
+ */
+
+#include "conn_params.h"
+#include "gatt_audio_service.h"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+
+LOG_MODULE_REGISTER(conn_params, LOG_LEVEL_INF);
+
+#define CONN_PARAMS_FIRST_REQUEST_MS    1500   /* Let the MTU exchange finish first */
+#define CONN_PARAMS_EVAL_MS             1000
+#define CONN_PARAMS_REQUEST_GAP_MS      5000   /* Centrals ignore or reject rapid requests */
+#define CONN_PARAMS_MAX_REFUSALS        3
+#define CONN_PARAMS_CONGESTED_PERIODS   2      /* -ENOMEM at a window of one before a longer tier */
+#define CONN_PARAMS_RECOVER_PERIODS     30     /* Clean periods before a shorter tier */
+#define CONN_PARAMS_DEFAULT_INTERVAL_US 50000  /* Typical central default */
+#define CONN_PARAMS_PDU_AIRTIME_US      2500   /* 251-byte PDU, empty ack and both IFS at 1M PHY */
+#define CONN_PARAMS_EVENTS_AHEAD        2
+
+#define CONN_PARAMS_UNITS_TO_US(units)  ((uint32_t)(units) * 1250U)
+
+/* Requested parameters, shortest interval first. Zero peripheral latency:
+ * the peripheral always has audio to send, skipping events only delays it */
+static const struct bt_le_conn_param conn_params_tiers[] = {
+    BT_LE_CONN_PARAM_INIT(6, 12, 0, 400),    /* 7.5-15 ms, 4 s timeout */
+    BT_LE_CONN_PARAM_INIT(12, 24, 0, 400),   /* 15-30 ms */
+    BT_LE_CONN_PARAM_INIT(24, 40, 0, 400),   /* 30-50 ms */
+};
+
+static struct {
+    bool initialized;
+    struct bt_conn *conn;
+    struct k_work_delayable work;
+
+    /* Applied parameters, written from the Bluetooth RX thread */
+    struct k_spinlock lock;
+    uint16_t interval;             ///< 1.25 ms units, 0 until known
+    uint16_t latency;
+
+    /* Work item only */
+    uint8_t tier;                  ///< Last requested tier
+    uint8_t refusals;              ///< Requests for this tier the central didn't apply
+    uint8_t congested;             ///< Consecutive periods with -ENOMEM at a window of one
+    uint8_t clean;                 ///< Consecutive periods without -ENOMEM
+    int64_t last_request;          ///< Uptime of the last request, 0 before the first
+
+    /* Streaming thread */
+    atomic_t window;
+    atomic_t sent;
+    atomic_t enomem;
+} conn_params;
+
+/**
+ * @brief Window covering CONN_PARAMS_EVENTS_AHEAD connection events
+ */
+static uint8_t conn_params_window_limit(uint16_t interval)
+{
+    uint32_t interval_us = interval ? CONN_PARAMS_UNITS_TO_US(interval)
+                                    : CONN_PARAMS_DEFAULT_INTERVAL_US;
+    uint32_t per_event = MAX(interval_us / CONN_PARAMS_PDU_AIRTIME_US, 1U);
+
+    return (uint8_t)CLAMP(per_event * CONN_PARAMS_EVENTS_AHEAD, 1U, GATT_AUDIO_TX_CREDITS);
+}
+
+static bool conn_params_in_tier(uint16_t interval, uint16_t latency, uint8_t tier)
+{
+    const struct bt_le_conn_param *param = &conn_params_tiers[tier];
+
+    return interval >= param->interval_min && interval <= param->interval_max &&
+           latency == param->latency;
+}
+
+/**
+ * @brief Ask the central for a tier's parameters
+ */
+static void conn_params_request(uint8_t tier)
+{
+    const struct bt_le_conn_param *param = &conn_params_tiers[tier];
+    uint32_t min_us = CONN_PARAMS_UNITS_TO_US(param->interval_min);
+    uint32_t max_us = CONN_PARAMS_UNITS_TO_US(param->interval_max);
+    int ret;
+
+    conn_params.tier = tier;
+    conn_params.last_request = k_uptime_get();
+
+    /* -EALREADY: the link already runs with these parameters */
+    ret = bt_conn_le_param_update(conn_params.conn, param);
+    if (ret && ret != -EALREADY) {
+        LOG_WRN("Connection parameter request failed: %d", ret);
+        return;
+    }
+
+    LOG_INF("🔗 Requesting %u.%u-%u.%u ms connection interval, latency %u",
+            min_us / 1000, (min_us % 1000) / 100, max_us / 1000, (max_us % 1000) / 100,
+            param->latency);
+}
+
+/**
+ * @brief Periodic evaluation - adapt the window, pick and request a tier
+ */
+static void conn_params_work_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    atomic_val_t sent = atomic_clear(&conn_params.sent);
+    atomic_val_t enomem = atomic_clear(&conn_params.enomem);
+    atomic_val_t window = atomic_get(&conn_params.window);
+    k_spinlock_key_t key = k_spin_lock(&conn_params.lock);
+    uint16_t interval = conn_params.interval;
+    uint16_t latency = conn_params.latency;
+    k_spin_unlock(&conn_params.lock, key);
+
+    uint8_t limit = conn_params_window_limit(interval);
+    uint8_t tier = conn_params.tier;
+    bool may_request = conn_params.last_request == 0 ||
+                       k_uptime_get() - conn_params.last_request >= CONN_PARAMS_REQUEST_GAP_MS;
+
+    if (!conn_params.conn) {
+        return;
+    }
+
+    /* Multiplicative decrease happens per -ENOMEM, see conn_params_tx_result() */
+    if (enomem > 0) {
+        conn_params.clean = 0;
+        if (window <= 1) {
+            conn_params.congested++;
+        }
+    } else {
+        conn_params.congested = 0;
+        if (sent > 0) {
+            conn_params.clean++;
+            if (window < limit) {
+                atomic_set(&conn_params.window, window + 1);
+            }
+        }
+    }
+
+    if (!may_request) {
+        goto reschedule;
+    }
+
+    if (conn_params.last_request == 0) {
+        conn_params_request(0);
+    } else if (conn_params.congested >= CONN_PARAMS_CONGESTED_PERIODS &&
+               tier + 1 < ARRAY_SIZE(conn_params_tiers)) {
+        LOG_WRN("Link congested with one notification in flight, trying a longer interval");
+        conn_params.congested = 0;
+        conn_params.refusals = 0;
+        conn_params_request(tier + 1);
+    } else if (conn_params.clean >= CONN_PARAMS_RECOVER_PERIODS && tier > 0) {
+        conn_params.clean = 0;
+        conn_params.refusals = 0;
+        conn_params_request(tier - 1);
+    } else if (!conn_params_in_tier(interval, latency, tier) &&
+               conn_params.refusals < CONN_PARAMS_MAX_REFUSALS) {
+        /* Not applied, or changed again by the central since */
+        if (++conn_params.refusals < CONN_PARAMS_MAX_REFUSALS) {
+            conn_params_request(tier);
+        } else {
+            LOG_WRN("Central keeps a %u us interval, latency %u - adapting to it",
+                    CONN_PARAMS_UNITS_TO_US(interval), latency);
+        }
+    }
+
+reschedule:
+    k_work_schedule(dwork, K_MSEC(CONN_PARAMS_EVAL_MS));
+}
+
+/**
+ * @brief Stop the work item and drop the connection reference
+ *
+ * Waits for a run in progress, so nothing touches the state or the old
+ * connection once this returns.
+ */
+static void conn_params_release(void)
+{
+    struct k_work_sync sync;
+    struct bt_conn *conn;
+
+    k_work_cancel_delayable_sync(&conn_params.work, &sync);
+
+    k_spinlock_key_t key = k_spin_lock(&conn_params.lock);
+    conn = conn_params.conn;
+    conn_params.conn = NULL;
+    conn_params.interval = 0;
+    conn_params.latency = 0;
+    k_spin_unlock(&conn_params.lock, key);
+
+    if (conn) {
+        bt_conn_unref(conn);
+    }
+}
+
+void conn_params_connected(struct bt_conn *conn)
+{
+    struct bt_conn_info info;
+    uint16_t interval = 0;
+    uint16_t latency = 0;
+
+    if (!conn_params.initialized) {
+        k_work_init_delayable(&conn_params.work, conn_params_work_handler);
+        conn_params.initialized = true;
+    }
+
+    /* A missed disconnect must not leave the work running on the old link */
+    conn_params_release();
+
+    if (bt_conn_get_info(conn, &info) == 0) {
+        interval = info.le.interval;
+        latency = info.le.latency;
+    }
+
+    /* The work item is idle now, so its fields can be reset */
+    conn_params.tier = 0;
+    conn_params.refusals = 0;
+    conn_params.congested = 0;
+    conn_params.clean = 0;
+    conn_params.last_request = 0;
+    atomic_clear(&conn_params.sent);
+    atomic_clear(&conn_params.enomem);
+    atomic_set(&conn_params.window, conn_params_window_limit(interval));
+
+    k_spinlock_key_t key = k_spin_lock(&conn_params.lock);
+    conn_params.conn = bt_conn_ref(conn);
+    conn_params.interval = interval;
+    conn_params.latency = latency;
+    k_spin_unlock(&conn_params.lock, key);
+
+    k_work_schedule(&conn_params.work, K_MSEC(CONN_PARAMS_FIRST_REQUEST_MS));
+}
+
+void conn_params_disconnected(void)
+{
+    if (conn_params.initialized) {
+        conn_params_release();
+    }
+}
+
+void conn_params_updated(uint16_t interval, uint16_t latency, uint16_t timeout)
+{
+    uint32_t interval_us = CONN_PARAMS_UNITS_TO_US(interval);
+
+    k_spinlock_key_t key = k_spin_lock(&conn_params.lock);
+    conn_params.interval = interval;
+    conn_params.latency = latency;
+    k_spin_unlock(&conn_params.lock, key);
+
+    /* Start the new interval from a full window; -ENOMEM trims it again */
+    atomic_set(&conn_params.window, conn_params_window_limit(interval));
+
+    LOG_INF("🔗 Connection interval %u.%u ms, latency %u, timeout %u ms, %u notifications in flight",
+            interval_us / 1000, (interval_us % 1000) / 100, latency, timeout * 10,
+            conn_params_window_limit(interval));
+}
+
+void conn_params_tx_result(int ret)
+{
+    if (ret > 0) {
+        atomic_inc(&conn_params.sent);
+        return;
+    }
+    if (ret != -ENOMEM) {
+        return;
+    }
+
+    atomic_inc(&conn_params.enomem);
+
+    /* Halve the window, never below one */
+    atomic_val_t window;
+    do {
+        window = atomic_get(&conn_params.window);
+    } while (window > 1 && !atomic_cas(&conn_params.window, window, window / 2));
+}
+
+uint8_t conn_params_tx_window(void)
+{
+    atomic_val_t window = atomic_get(&conn_params.window);
+
+    return (window > 0) ? (uint8_t)window : 1;
+}
+
+uint32_t conn_params_interval_us(void)
+{
+    k_spinlock_key_t key = k_spin_lock(&conn_params.lock);
+    uint16_t interval = conn_params.interval;
+    k_spin_unlock(&conn_params.lock, key);
+
+    return interval ? CONN_PARAMS_UNITS_TO_US(interval) : CONN_PARAMS_DEFAULT_INTERVAL_US;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file conn_params.h
+ * @brief BLE connection parameter manager for the audio link
+ *
+ * The central picks the connection interval, and its default is usually
+ * tuned for battery life, not audio. This module asks for a short
+ * interval with zero peripheral latency once the link is up, then
+ * watches how the link copes with the notifications the streaming thread
+ * queues:
+ *
+ * - The TX window - notifications kept in flight - starts at two
+ *   connection events' worth of PDUs, so the controller has the next
+ *   event's packets before the current one closes. It is halved on every
+ *   -ENOMEM and grows back by one each clean period.
+ * - When the link stays congested with a window of one, the next, longer
+ *   interval tier is requested: some centrals allow only a few PDUs per
+ *   event at short intervals. After a long clean stretch the manager
+ *   steps back towards the shortest tier.
+ *
+ * Requests are rate limited and given up on after a few refusals, after
+ * which the window simply follows whatever interval the central chose.
+ */
+
+#ifndef CONN_PARAMS_H
+#define CONN_PARAMS_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/conn.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start managing a new connection
+ *
+ * Call from the connected callback. The first request goes out after a
+ * short delay so it doesn't compete with the MTU exchange.
+ *
+ * @param conn Connection; a reference is held until conn_params_disconnected()
+ */
+void conn_params_connected(struct bt_conn *conn);
+
+/**
+ * @brief Stop managing the connection
+ *
+ * Waits for an evaluation in progress and drops the connection reference.
+ */
+void conn_params_disconnected(void);
+
+/**
+ * @brief Record parameters the controller applied
+ *
+ * Call from the le_param_updated connection callback.
+ *
+ * @param interval Connection interval in 1.25 ms units
+ * @param latency Peripheral latency in connection events
+ * @param timeout Supervision timeout in 10 ms units
+ */
+void conn_params_updated(uint16_t interval, uint16_t latency, uint16_t timeout);
+
+/**
+ * @brief Report the result of one notification send
+ *
+ * @param ret gatt_audio_send_data() return value
+ */
+void conn_params_tx_result(int ret);
+
+/**
+ * @brief Notifications the sender should keep in flight
+ *
+ * @return Window size, 1 to GATT_AUDIO_TX_CREDITS
+ */
+uint8_t conn_params_tx_window(void);
+
+/**
+ * @brief Current connection interval
+ *
+ * @return Interval in microseconds, a typical central default until known
+ */
+uint32_t conn_params_interval_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONN_PARAMS_H */
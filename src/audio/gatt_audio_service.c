@@ -10,6 +10,7 @@
  * - Audio Data Characteristic: Handles PCM audio stream via notifications
  * - Audio Control Characteristic: Receives commands (play/pause/volume)
  * - Audio Info Characteristic: Provides format information to client
+ * - Audio Metrics Characteristic: Snapshot of the pipeline metrics
  * 
  * The service replaces the previous simulation-only implementation with
  * actual BLE GATT audio transmission.
@@ -31,6 +32,8 @@
 #include <string.h>
 
 #include "gatt_audio_service.h"
+#include "../utils/metrics.h"
+#include "../utils/trace.h"
 
 LOG_MODULE_REGISTER(gatt_audio_service, LOG_LEVEL_INF);
 
@@ -41,8 +44,15 @@ static struct {
     gatt_audio_control_cb_t control_callback;
     bool audio_data_subscribed;
     uint16_t audio_data_ccc_value;
+    gatt_audio_transport_mode_t transport_mode;
+    const struct bt_gatt_attr *audio_data_attr;  /* Cached at init, avoids a lookup per send */
+    struct k_sem tx_credits;                     /* One credit per notification in flight */
+    struct k_poll_signal *event_signal;          /* Sender's wakeup, see gatt_audio_set_event_signal() */
 } gatt_audio_state = {0};
 
+/* MTU exchange parameters must outlive the request */
+static struct bt_gatt_exchange_params mtu_exchange_params;
+
 /* Forward declarations */
 static ssize_t gatt_audio_data_read(struct bt_conn *conn,
                                    const struct bt_gatt_attr *attr,
@@ -60,6 +70,18 @@ static ssize_t gatt_audio_info_read(struct bt_conn *conn,
                                    const struct bt_gatt_attr *attr,
                                    void *buf, uint16_t len, uint16_t offset);
 
+#if defined(CONFIG_APP_METRICS)
+static ssize_t gatt_audio_metrics_read(struct bt_conn *conn,
+                                      const struct bt_gatt_attr *attr,
+                                      void *buf, uint16_t len, uint16_t offset);
+#endif
+
+static void gatt_audio_notify_complete(struct bt_conn *conn, void *user_data);
+static void gatt_audio_raise_event(void);
+
+static void gatt_audio_mtu_exchanged(struct bt_conn *conn, uint8_t err,
+                                    struct bt_gatt_exchange_params *params);
+
 /* GATT Service Definition */
 BT_GATT_SERVICE_DEFINE(gatt_audio_svc,
     /* Service Declaration */
@@ -83,6 +105,14 @@ BT_GATT_SERVICE_DEFINE(gatt_audio_svc,
                           BT_GATT_CHRC_READ,
                           BT_GATT_PERM_READ,
                           gatt_audio_info_read, NULL, NULL),
+    
+#if defined(CONFIG_APP_METRICS)
+    /* Audio Metrics Characteristic */
+    BT_GATT_CHARACTERISTIC(BT_UUID_AUDIO_METRICS,
+                          BT_GATT_CHRC_READ,
+                          BT_GATT_PERM_READ,
+                          gatt_audio_metrics_read, NULL, NULL),
+#endif
 );
 
 /**
@@ -103,6 +133,19 @@ int gatt_audio_service_init(void)
         (gatt_audio_state.current_format.channels * 
          gatt_audio_state.current_format.bits_per_sample) / 8;
     
+    /* Look up the audio data attribute once instead of on every notification */
+    gatt_audio_state.audio_data_attr = bt_gatt_find_by_uuid(gatt_audio_svc.attrs,
+                                                           gatt_audio_svc.attr_count,
+                                                           BT_UUID_AUDIO_DATA);
+    if (!gatt_audio_state.audio_data_attr) {
+        LOG_ERR("Audio data characteristic not found");
+        return -ENOENT;
+    }
+    
+    /* Credit-based pacing: one credit per notification queued in the stack */
+    k_sem_init(&gatt_audio_state.tx_credits, GATT_AUDIO_TX_CREDITS, GATT_AUDIO_TX_CREDITS);
+    gatt_audio_state.transport_mode = GATT_AUDIO_TRANSPORT_CREDIT;
+    
     gatt_audio_state.initialized = true;
     gatt_audio_state.audio_data_subscribed = true;  // Auto-enable for testing
     
@@ -139,12 +182,12 @@ int gatt_audio_send_data(const uint8_t *data, size_t len, struct bt_conn *conn)
     struct bt_conn_info conn_info;
     ret = bt_conn_get_info(conn, &conn_info);
     if (ret || conn_info.state != BT_CONN_STATE_CONNECTED) {
-        LOG_DBG("Connection not ready (state: %d)", conn_info.state);
+        trace_event(TRACE_GATT_NOT_READY, conn_info.state, 0);
         return -ENOTCONN;
     }
     
     if (!gatt_audio_state.audio_data_subscribed) {
-        LOG_DBG("Client not subscribed to audio data notifications");
+        trace_event(TRACE_GATT_NOT_SUBSCRIBED, 0, 0);
         return -ENOTCONN;
     }
     
@@ -152,24 +195,44 @@ int gatt_audio_send_data(const uint8_t *data, size_t len, struct bt_conn *conn)
         return -EINVAL;
     }
     
-    /* Rate limit notifications to prevent BLE stack overflow - more conservative */
-    uint32_t current_time = k_uptime_get_32();
-    if (current_time - last_send_time < 50) { /* Minimum 50ms between notifications */
-        return -EAGAIN; /* Try again later */
-    }
+    attr = gatt_audio_state.audio_data_attr;
     
-    /* Always use the absolute minimum chunk size */
-    size_t max_chunk = 20; /* Fixed to BLE minimum for maximum reliability */
+    size_t max_chunk = gatt_audio_get_max_chunk_size(conn);
     if (len > max_chunk) {
         len = max_chunk;
-        LOG_DBG("Truncating audio data to %zu bytes (BLE minimum chunk size)", len);
+        trace_event(TRACE_GATT_TRUNCATED, len, 0);
     }
     
-    /* Find the audio data characteristic attribute */
-    attr = bt_gatt_find_by_uuid(gatt_audio_svc.attrs, gatt_audio_svc.attr_count, BT_UUID_AUDIO_DATA);
-    if (!attr) {
-        LOG_ERR("Audio data characteristic not found");
-        return -ENOENT;
+    if (gatt_audio_state.transport_mode == GATT_AUDIO_TRANSPORT_CREDIT) {
+        /* Wait for the stack to finish an earlier notification */
+        if (k_sem_take(&gatt_audio_state.tx_credits, K_MSEC(GATT_AUDIO_CREDIT_TIMEOUT_MS)) != 0) {
+            return -EAGAIN;
+        }
+        
+        struct bt_gatt_notify_params params = {
+            .attr = attr,
+            .data = data,
+            .len = len,
+            .func = gatt_audio_notify_complete,
+            .user_data = NULL,
+        };
+        
+        /* The stack copies the payload, so the caller's buffer is free on return */
+        ret = bt_gatt_notify_cb(conn, &params);
+        if (ret) {
+            k_sem_give(&gatt_audio_state.tx_credits);
+            trace_event(TRACE_GATT_NOTIFY_FAILED, ret, 0);
+            return ret;
+        }
+        
+        trace_event(TRACE_GATT_QUEUED, len, 0);
+        return len;
+    }
+    
+    /* Rate limit notifications to prevent BLE stack overflow - more conservative */
+    uint32_t current_time = k_uptime_get_32();
+    if (current_time - last_send_time < 50) { /* Minimum 50ms between notifications */
+        return -EAGAIN; /* Try again later */
     }
     
     /* Send audio data as GATT notification */
@@ -180,10 +243,131 @@ int gatt_audio_send_data(const uint8_t *data, size_t len, struct bt_conn *conn)
     }
     
     last_send_time = current_time;
-    LOG_DBG("🎵 Sent %zu bytes of audio data via GATT", len);
+    trace_event(TRACE_GATT_SENT, len, 0);
     return len;
 }
 
+/**
+ * @brief Notification TX completion - returns the credit taken by the send
+ */
+static void gatt_audio_notify_complete(struct bt_conn *conn, void *user_data)
+{
+    k_sem_give(&gatt_audio_state.tx_credits);
+    gatt_audio_raise_event();
+}
+
+/**
+ * @brief Wake the sender, if it registered a signal
+ */
+static void gatt_audio_raise_event(void)
+{
+    struct k_poll_signal *signal = gatt_audio_state.event_signal;
+    
+    if (signal) {
+        k_poll_signal_raise(signal, 0);
+    }
+}
+
+/**
+ * @brief Select the audio transport mode
+ */
+int gatt_audio_set_transport_mode(gatt_audio_transport_mode_t mode)
+{
+    if (mode != GATT_AUDIO_TRANSPORT_CONSERVATIVE && mode != GATT_AUDIO_TRANSPORT_CREDIT) {
+        return -EINVAL;
+    }
+    
+    gatt_audio_state.transport_mode = mode;
+    LOG_INF("Audio transport mode: %s",
+            (mode == GATT_AUDIO_TRANSPORT_CREDIT) ? "credit-based" : "conservative");
+    return 0;
+}
+
+/**
+ * @brief Get the current audio transport mode
+ */
+gatt_audio_transport_mode_t gatt_audio_get_transport_mode(void)
+{
+    return gatt_audio_state.transport_mode;
+}
+
+/**
+ * @brief Restore all TX credits
+ *
+ * The sender may be blocked on the semaphore, so it is reset (which wakes
+ * it with -EAGAIN) and refilled rather than re-initialised.
+ */
+void gatt_audio_reset_credits(void)
+{
+    k_sem_reset(&gatt_audio_state.tx_credits);
+    for (int i = 0; i < GATT_AUDIO_TX_CREDITS; i++) {
+        k_sem_give(&gatt_audio_state.tx_credits);
+    }
+}
+
+/**
+ * @brief Notifications queued in the stack whose completion hasn't arrived
+ */
+uint8_t gatt_audio_get_in_flight(void)
+{
+    if (gatt_audio_state.transport_mode != GATT_AUDIO_TRANSPORT_CREDIT) {
+        return 0;
+    }
+    
+    return GATT_AUDIO_TX_CREDITS - k_sem_count_get(&gatt_audio_state.tx_credits);
+}
+
+/**
+ * @brief MTU exchange completion callback
+ */
+static void gatt_audio_mtu_exchanged(struct bt_conn *conn, uint8_t err,
+                                    struct bt_gatt_exchange_params *params)
+{
+    if (err) {
+        LOG_WRN("MTU exchange failed: %u", err);
+        return;
+    }
+    
+    LOG_INF("📏 MTU exchanged: %u (audio chunk %zu bytes)",
+            bt_gatt_get_mtu(conn), gatt_audio_get_max_chunk_size(conn));
+}
+
+/**
+ * @brief Negotiate link parameters for audio throughput
+ */
+int gatt_audio_configure_link(struct bt_conn *conn)
+{
+    int ret;
+    
+    if (!conn) {
+        return -ENOTCONN;
+    }
+    
+    mtu_exchange_params.func = gatt_audio_mtu_exchanged;
+    ret = bt_gatt_exchange_mtu(conn, &mtu_exchange_params);
+    if (ret) {
+        LOG_WRN("MTU exchange request failed: %d", ret);
+        return ret;
+    }
+    
+#if defined(CONFIG_BT_USER_DATA_LEN_UPDATE)
+    /* Data Length Extension lets one MTU-sized PDU fit in a single LL packet */
+    ret = bt_conn_le_data_len_update(conn, BT_LE_DATA_LEN_PARAM_MAX);
+    if (ret) {
+        LOG_WRN("Data length update request failed: %d", ret);
+    }
+#endif
+    
+#if defined(CONFIG_BT_USER_PHY_UPDATE)
+    ret = bt_conn_le_phy_update(conn, BT_CONN_LE_PHY_PARAM_2M);
+    if (ret) {
+        LOG_WRN("2M PHY update request failed: %d", ret);
+    }
+#endif
+    
+    return 0;
+}
+
 /**
  * @brief Set audio format information
  */
@@ -196,8 +380,9 @@ int gatt_audio_set_format(const gatt_audio_format_t *format, struct bt_conn *con
     /* Update format */
     memcpy(&gatt_audio_state.current_format, format, sizeof(gatt_audio_format_t));
     
-    LOG_INF("📊 Audio format updated: %u Hz, %u ch, %u-bit",
-            format->sample_rate, format->channels, format->bits_per_sample);
+    LOG_INF("📊 Audio format updated: %u Hz, %u ch, %u-bit, codec %u (%u-byte frames)",
+            format->sample_rate, format->channels, format->bits_per_sample,
+            format->codec, format->codec_frame_size);
     
     /* Don't notify immediately - wait for client to read or subscribe */
     /* This prevents the GATT assertion failure on connection */
@@ -219,18 +404,30 @@ bool gatt_audio_is_subscribed(struct bt_conn *conn)
 size_t gatt_audio_get_max_chunk_size(struct bt_conn *conn)
 {
     if (!conn) {
-        return 20; /* Very conservative default for no connection */
+        return GATT_AUDIO_CHUNK_SIZE_MIN; /* Very conservative default for no connection */
     }
     
-    /* Get MTU but always use very conservative chunk sizes for reliability */
-    uint16_t mtu = bt_gatt_get_mtu(conn);
+    /* Conservative mode always uses the BLE minimum to avoid any ATT channel issues */
+    if (gatt_audio_state.transport_mode == GATT_AUDIO_TRANSPORT_CONSERVATIVE) {
+        return GATT_AUDIO_CHUNK_SIZE_MIN;
+    }
     
-    /* Use the absolute minimum to avoid any ATT channel issues */
-    /* BLE minimum is 23 bytes MTU, minus 3 bytes ATT header = 20 bytes max payload */
-    size_t max_chunk = 20; /* Always use minimum for maximum compatibility */
+    /* Otherwise follow the negotiated MTU, minus 3 bytes ATT header */
+    uint16_t mtu = bt_gatt_get_mtu(conn);
+    if (mtu <= GATT_AUDIO_ATT_HEADER_SIZE + GATT_AUDIO_CHUNK_SIZE_MIN) {
+        return GATT_AUDIO_CHUNK_SIZE_MIN;
+    }
     
-    LOG_DBG("Using conservative chunk size %zu for MTU %u (always 20 for stability)", max_chunk, mtu);
-    return max_chunk;
+    size_t max_chunk = mtu - GATT_AUDIO_ATT_HEADER_SIZE;
+    return MIN(max_chunk, GATT_AUDIO_CHUNK_SIZE_MAX);
+}
+
+/**
+ * @brief Set the signal raised on subscription changes and TX completions
+ */
+void gatt_audio_set_event_signal(struct k_poll_signal *signal)
+{
+    gatt_audio_state.event_signal = signal;
 }
 
 /**
@@ -272,6 +469,7 @@ static void gatt_audio_data_ccc_cfg_changed(const struct bt_gatt_attr *attr,
 {
     gatt_audio_state.audio_data_ccc_value = value;
     gatt_audio_state.audio_data_subscribed = (value == BT_GATT_CCC_NOTIFY);
+    gatt_audio_raise_event();
     
     if (gatt_audio_state.audio_data_subscribed) {
         LOG_INF("🔔 Client subscribed to audio data notifications - READY FOR STREAMING!");
@@ -348,3 +546,25 @@ static ssize_t gatt_audio_info_read(struct bt_conn *conn,
                            &gatt_audio_state.current_format,
                            sizeof(gatt_audio_format_t));
 }
+
+#if defined(CONFIG_APP_METRICS)
+/**
+ * @brief Audio Metrics Characteristic Read Handler
+ * 
+ * The snapshot is larger than one ATT PDU. It is taken when a read starts
+ * at offset 0 and the blob reads that follow return the rest of the same
+ * snapshot, so the client sees one consistent set of values.
+ */
+static ssize_t gatt_audio_metrics_read(struct bt_conn *conn,
+                                      const struct bt_gatt_attr *attr,
+                                      void *buf, uint16_t len, uint16_t offset)
+{
+    static struct metrics_snapshot snapshot;
+    
+    if (offset == 0) {
+        metrics_snapshot(&snapshot);
+    }
+    
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, &snapshot, sizeof(snapshot));
+}
+#endif
@@ -7,9 +7,11 @@
  * for audio data transmission and control.
  * 
  * Service Design:
- * - Audio Data Characteristic: Streams PCM audio chunks
+ * - Audio Data Characteristic: Streams PCM audio chunks or codec frames
  * - Audio Control Characteristic: Volume, play/pause, etc.
  * - Audio Info Characteristic: Format information (sample rate, channels, etc.)
+ * - Audio Metrics Characteristic: Pipeline counters and latency histograms
+ *   (struct metrics_snapshot, read with long reads), with CONFIG_APP_METRICS
  * 
  * Compatible with: ST B-L475E-IOT01A Discovery Board SPBTLE-RF module
  * 
@@ -47,11 +49,16 @@ extern "C" {
 #define BT_UUID_AUDIO_INFO_VAL \
     BT_UUID_128_ENCODE(0x1234567B, 0x1234, 0x5678, 0x9ABC, 0xDEF012345678)
 
+/* Audio Metrics Characteristic UUID: 1234567C-1234-5678-9ABC-DEF012345678 */
+#define BT_UUID_AUDIO_METRICS_VAL \
+    BT_UUID_128_ENCODE(0x1234567C, 0x1234, 0x5678, 0x9ABC, 0xDEF012345678)
+
 /* Define the UUIDs */
 #define BT_UUID_AUDIO_SERVICE   BT_UUID_DECLARE_128(BT_UUID_AUDIO_SERVICE_VAL)
 #define BT_UUID_AUDIO_DATA      BT_UUID_DECLARE_128(BT_UUID_AUDIO_DATA_VAL)
 #define BT_UUID_AUDIO_CONTROL   BT_UUID_DECLARE_128(BT_UUID_AUDIO_CONTROL_VAL)
 #define BT_UUID_AUDIO_INFO      BT_UUID_DECLARE_128(BT_UUID_AUDIO_INFO_VAL)
+#define BT_UUID_AUDIO_METRICS   BT_UUID_DECLARE_128(BT_UUID_AUDIO_METRICS_VAL)
 
 /* Audio format structure */
 typedef struct {
@@ -59,6 +66,10 @@ typedef struct {
     uint16_t channels;       /* Number of channels (1=mono, 2=stereo) */
     uint16_t bits_per_sample; /* Bits per sample (8, 16, 24, 32) */
     uint16_t frame_size;     /* Bytes per frame (channels * bits_per_sample / 8) */
+    uint8_t codec;           /* Payload encoding, audio_codec_id_t (0 = raw PCM) */
+    uint8_t reserved;
+    uint16_t codec_frame_size;   /* Largest encoded frame, one per notification */
+    uint16_t samples_per_frame;  /* PCM sample frames in a full codec frame */
 } __packed gatt_audio_format_t;
 
 /* Audio control commands */
@@ -81,6 +92,24 @@ typedef struct {
 /* Maximum audio chunk size for BLE transmission */
 #define GATT_AUDIO_CHUNK_SIZE_MAX    244  /* MTU 247 - 3 bytes for ATT header */
 #define GATT_AUDIO_CHUNK_SIZE_DEFAULT 128  /* Conservative size for compatibility */
+#define GATT_AUDIO_CHUNK_SIZE_MIN    20   /* Default MTU 23 - 3 bytes for ATT header */
+#define GATT_AUDIO_ATT_HEADER_SIZE   3    /* Opcode + attribute handle */
+
+/* Credit-based transport configuration. Credits are notifications in
+ * flight: every ACL TX buffer but one, which stays free for ATT responses
+ * and L2CAP signalling such as connection parameter update requests */
+#if defined(CONFIG_BT_BUF_ACL_TX_COUNT)
+#define GATT_AUDIO_TX_CREDITS        (CONFIG_BT_BUF_ACL_TX_COUNT - 1)
+#else
+#define GATT_AUDIO_TX_CREDITS        6
+#endif
+#define GATT_AUDIO_CREDIT_TIMEOUT_MS 100  /* Max wait for a TX completion before giving up */
+
+/* Audio transport modes */
+typedef enum {
+    GATT_AUDIO_TRANSPORT_CONSERVATIVE = 0, /* Fixed 20-byte notifications, 50ms rate limit */
+    GATT_AUDIO_TRANSPORT_CREDIT            /* MTU-sized notifications paced by TX completions */
+} gatt_audio_transport_mode_t;
 
 /**
  * @brief Initialize GATT Audio Service
@@ -99,6 +128,11 @@ int gatt_audio_service_init(void);
  * through the audio data characteristic. The data is sent as notifications
  * to minimize latency.
  * 
+ * Payloads longer than gatt_audio_get_max_chunk_size() are truncated, so
+ * callers should size their reads with that function. In credit mode the
+ * call blocks for up to GATT_AUDIO_CREDIT_TIMEOUT_MS waiting for a free
+ * TX credit and returns -EAGAIN if none became available.
+ * 
  * @param data Pointer to PCM audio data
  * @param len Length of audio data (max GATT_AUDIO_CHUNK_SIZE_MAX)
  * @param conn Bluetooth connection handle
@@ -137,6 +171,63 @@ bool gatt_audio_is_subscribed(struct bt_conn *conn);
  */
 size_t gatt_audio_get_max_chunk_size(struct bt_conn *conn);
 
+/**
+ * @brief Select the audio transport mode
+ * 
+ * The conservative mode keeps the original fixed 20-byte / 50ms behaviour
+ * for peers that struggle with larger notifications. The credit mode sends
+ * MTU-sized notifications and only blocks while all TX credits are in flight.
+ * 
+ * @param mode Transport mode to use for subsequent sends
+ * @return 0 on success, negative error code on failure
+ */
+int gatt_audio_set_transport_mode(gatt_audio_transport_mode_t mode);
+
+/**
+ * @brief Get the current audio transport mode
+ * 
+ * @return Current transport mode
+ */
+gatt_audio_transport_mode_t gatt_audio_get_transport_mode(void);
+
+/**
+ * @brief Negotiate link parameters for audio throughput
+ * 
+ * Starts an ATT MTU exchange and requests Data Length Extension and the
+ * 2M PHY where the stack supports it. All requests are asynchronous, and a
+ * peer rejecting any of them simply leaves that parameter at its default.
+ * 
+ * @param conn Bluetooth connection handle
+ * @return 0 if the requests were issued, negative error code on failure
+ */
+int gatt_audio_configure_link(struct bt_conn *conn);
+
+/**
+ * @brief Restore all TX credits
+ * 
+ * Must be called on connect and disconnect, since completion callbacks
+ * for notifications still queued on a dropped link are never delivered.
+ */
+void gatt_audio_reset_credits(void);
+
+/**
+ * @brief Notifications queued in the stack whose completion hasn't arrived
+ * 
+ * @return 0 to GATT_AUDIO_TX_CREDITS, always 0 in conservative mode
+ */
+uint8_t gatt_audio_get_in_flight(void);
+
+/**
+ * @brief Signal to raise when the sender may be able to make progress
+ * 
+ * Raised when the client subscribes or unsubscribes and whenever a
+ * notification completes (a TX credit and an ACL buffer come back), so
+ * the sending thread can k_poll() on it instead of sleeping.
+ * 
+ * @param signal Poll signal owned by the caller, NULL to stop raising
+ */
+void gatt_audio_set_event_signal(struct k_poll_signal *signal);
+
 /**
  * @brief Audio control callback function type
  * 
@@ -0,0 +1,201 @@
+/**
+ * @file pcm_dsp.c
+ * @brief PCM sample processing kernels for the audio pipeline
+ *
+ * Please refer to pcm_dsp.h for more documentation.
+ */
+
+#include "pcm_dsp.h"
+#include <errno.h>
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+#include <arm_acle.h>
+#define PCM_DSP_SIMD 1
+#else
+#define PCM_DSP_SIMD 0
+#endif
+
+#define DITHER_DEFAULT_SEED 0x2545F491u
+#define ROUND_24_TO_16 0x80   /* Half an output LSB, the dither itself is zero-mean */
+
+static inline int16_t sat16(int32_t value)
+{
+#if PCM_DSP_SIMD
+    return (int16_t)__ssat(value, 16);
+#else
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)value;
+#endif
+}
+
+/* Triangular noise spanning +-1 output LSB, in 1/256 LSB steps */
+static inline int32_t dither_next(struct pcm_dither *dither)
+{
+    uint32_t r;
+
+    if (!dither) {
+        return 0;
+    }
+
+    dither->state = dither->state * 1664525u + 1013904223u;
+    r = dither->state;
+    return (int32_t)(r >> 24) - (int32_t)((r >> 16) & 0xFF);
+}
+
+void pcm_dither_init(struct pcm_dither *dither, uint32_t seed)
+{
+    dither->state = seed ? seed : DITHER_DEFAULT_SEED;
+}
+
+int16_t pcm_volume_to_q15(uint8_t volume)
+{
+    uint32_t v = (volume > 100) ? 100 : volume;
+
+    if (v == 100) {
+        return PCM_GAIN_UNITY;
+    }
+    return (int16_t)((v * v * (uint32_t)INT16_MAX) / 10000u);
+}
+
+void pcm_gain_q15(int16_t *samples, size_t count, int16_t gain)
+{
+    size_t i = 0;
+
+    if (!samples || gain == PCM_GAIN_UNITY) {
+        return;
+    }
+
+#if PCM_DSP_SIMD
+    /* Two samples per word: SMULBB/SMULTB take each half against the gain */
+    for (; i + 2 <= count; i += 2) {
+        uint32_t pair;
+        int32_t lo, hi;
+
+        memcpy(&pair, &samples[i], sizeof(pair));
+        lo = __ssat(__smulbb((int32_t)pair, gain) >> 15, 16);
+        hi = __ssat(__smultb((int32_t)pair, gain) >> 15, 16);
+        pair = ((uint32_t)lo & 0xFFFF) | ((uint32_t)hi << 16);
+        memcpy(&samples[i], &pair, sizeof(pair));
+    }
+#endif
+
+    for (; i < count; i++) {
+        samples[i] = sat16(((int32_t)samples[i] * gain) >> 15);
+    }
+}
+
+void pcm_downmix_stereo(const int16_t *src, int16_t *dst, size_t frames)
+{
+    size_t i = 0;
+
+#if PCM_DSP_SIMD
+    /* SMUAD with 1:1 weights sums both halves of the L/R word */
+    for (; i < frames; i++) {
+        uint32_t pair;
+
+        memcpy(&pair, &src[2 * i], sizeof(pair));
+        dst[i] = (int16_t)(__smuad((int32_t)pair, 0x00010001) >> 1);
+    }
+#endif
+
+    for (; i < frames; i++) {
+        dst[i] = (int16_t)(((int32_t)src[2 * i] + src[2 * i + 1]) >> 1);
+    }
+}
+
+void pcm_upmix_mono(const int16_t *src, int16_t *dst, size_t frames)
+{
+    /* Back to front so the expansion can overwrite its own input */
+    while (frames-- > 0) {
+        int16_t sample = src[frames];
+
+        dst[2 * frames] = sample;
+        dst[2 * frames + 1] = sample;
+    }
+}
+
+void pcm_fade_in(int16_t *samples, size_t frames, uint16_t channels)
+{
+    for (size_t i = 0; i < frames; i++) {
+        int32_t gain = (int32_t)((i * (uint32_t)INT16_MAX) / frames);
+
+        for (uint16_t c = 0; c < channels; c++) {
+            samples[i * channels + c] = (int16_t)((samples[i * channels + c] * gain) >> 15);
+        }
+    }
+}
+
+void pcm_ramp_to_silence(const int16_t *from, int16_t *dst, size_t frames, uint16_t channels)
+{
+    for (size_t i = 0; i < frames; i++) {
+        int32_t gain = (int32_t)(((frames - 1 - i) * (uint32_t)INT16_MAX) / frames);
+
+        for (uint16_t c = 0; c < channels; c++) {
+            dst[i * channels + c] = (int16_t)((from[c] * gain) >> 15);
+        }
+    }
+}
+
+void pcm_u8_to_s16(const uint8_t *src, int16_t *dst, size_t count)
+{
+    /* Backwards, so widening in place never overwrites unread input */
+    for (size_t i = count; i-- > 0;) {
+        dst[i] = (int16_t)(((int32_t)src[i] - 128) << 8);
+    }
+}
+
+void pcm_s24_to_s16(const uint8_t *src, int16_t *dst, size_t count, struct pcm_dither *dither)
+{
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *p = &src[3 * i];
+        /* Assemble in the top 24 bits so the shift sign-extends */
+        int32_t sample = (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) |
+                                   ((uint32_t)p[2] << 24)) >> 8;
+
+        dst[i] = sat16((sample + ROUND_24_TO_16 + dither_next(dither)) >> 8);
+    }
+}
+
+void pcm_s32_to_s16(const uint8_t *src, int16_t *dst, size_t count, struct pcm_dither *dither)
+{
+    for (size_t i = 0; i < count; i++) {
+        int32_t sample;
+
+        memcpy(&sample, &src[4 * i], sizeof(sample));
+        /* Drop to 24 bits first so adding the dither can't overflow */
+        dst[i] = sat16(((sample >> 8) + ROUND_24_TO_16 + dither_next(dither)) >> 8);
+    }
+}
+
+int pcm_convert_to_s16(uint8_t *data, size_t len, uint16_t bits_per_sample,
+                       struct pcm_dither *dither)
+{
+    size_t count;
+
+    switch (bits_per_sample) {
+    case 8:
+        count = len;
+        pcm_u8_to_s16(data, (int16_t *)data, count);
+        break;
+    case 16:
+        return (int)len;
+    case 24:
+        count = len / 3;
+        pcm_s24_to_s16(data, (int16_t *)data, count, dither);
+        break;
+    case 32:
+        count = len / 4;
+        pcm_s32_to_s16(data, (int16_t *)data, count, dither);
+        break;
+    default:
+        return -ENOTSUP;
+    }
+
+    return (int)(count * sizeof(int16_t));
+}
@@ -0,0 +1,147 @@
+/**
+ * @file pcm_dsp.h
+ * @brief PCM sample processing kernels for the audio pipeline
+ *
+ * Gain, channel mixing and sample format conversion on interleaved
+ * little-endian PCM. On cores with the Armv7E-M DSP extension (the
+ * Cortex-M4 on the B-L475E-IOT01A) the 16-bit kernels work on two samples
+ * per instruction using the packed SIMD multiplies and saturation; every
+ * other target, including the host simulation build, gets the plain C
+ * version of the same arithmetic, so both produce identical output.
+ *
+ * All kernels may run in place (@p dst == @p src) whenever the output is
+ * no larger than the input. pcm_upmix_mono() and pcm_u8_to_s16() also run
+ * in place, working from the end of the buffer.
+ */
+
+#ifndef PCM_DSP_H
+#define PCM_DSP_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Q15 gain that leaves samples untouched - kernels are skipped for it */
+#define PCM_GAIN_UNITY INT16_MAX
+
+/**
+ * @brief Dither generator state, one per stream
+ */
+struct pcm_dither {
+    uint32_t state;
+};
+
+/**
+ * @brief Seed the dither generator
+ *
+ * @param dither Generator state
+ * @param seed Any value; zero is replaced by a fixed non-zero seed
+ */
+void pcm_dither_init(struct pcm_dither *dither, uint32_t seed);
+
+/**
+ * @brief Map a 0-100 volume setting to a Q15 gain
+ *
+ * Uses a squared curve so equal volume steps sound roughly equally loud.
+ *
+ * @param volume Volume level (0-100, larger values are clamped)
+ * @return Gain in Q15, PCM_GAIN_UNITY for 100
+ */
+int16_t pcm_volume_to_q15(uint8_t volume);
+
+/**
+ * @brief Scale 16-bit samples by a Q15 gain with saturation
+ *
+ * @param samples Samples to scale in place
+ * @param count Number of samples (all channels)
+ * @param gain Gain in Q15
+ */
+void pcm_gain_q15(int16_t *samples, size_t count, int16_t gain);
+
+/**
+ * @brief Average interleaved stereo to mono
+ *
+ * @param src Interleaved L/R samples
+ * @param dst Mono output, may equal @p src
+ * @param frames Number of sample frames
+ */
+void pcm_downmix_stereo(const int16_t *src, int16_t *dst, size_t frames);
+
+/**
+ * @brief Duplicate mono samples into interleaved stereo
+ *
+ * @param src Mono samples
+ * @param dst Stereo output with room for 2 * @p frames samples, may equal @p src
+ * @param frames Number of sample frames
+ */
+void pcm_upmix_mono(const int16_t *src, int16_t *dst, size_t frames);
+
+/**
+ * @brief Ramp interleaved samples up from silence to full level
+ *
+ * @param samples Samples to scale in place
+ * @param frames Number of sample frames the ramp spans
+ * @param channels Interleaved channels
+ */
+void pcm_fade_in(int16_t *samples, size_t frames, uint16_t channels);
+
+/**
+ * @brief Generate a ramp from one sample frame down to silence
+ *
+ * @param from Starting frame, @p channels samples
+ * @param dst Output with room for @p frames frames
+ * @param frames Length of the ramp in frames
+ * @param channels Interleaved channels
+ */
+void pcm_ramp_to_silence(const int16_t *from, int16_t *dst, size_t frames, uint16_t channels);
+
+/**
+ * @brief Widen unsigned 8-bit samples to signed 16-bit
+ *
+ * @param src Unsigned samples, 128 is silence
+ * @param dst 16-bit output with room for @p count samples, may equal @p src
+ * @param count Number of samples
+ */
+void pcm_u8_to_s16(const uint8_t *src, int16_t *dst, size_t count);
+
+/**
+ * @brief Convert packed 24-bit samples to 16-bit with TPDF dither
+ *
+ * @param src Packed little-endian 3-byte samples
+ * @param dst 16-bit output, may alias @p src
+ * @param count Number of samples
+ * @param dither Generator state, NULL to round without dither
+ */
+void pcm_s24_to_s16(const uint8_t *src, int16_t *dst, size_t count, struct pcm_dither *dither);
+
+/**
+ * @brief Convert 32-bit samples to 16-bit with TPDF dither
+ *
+ * @param src Little-endian 32-bit samples (any alignment)
+ * @param dst 16-bit output, may alias @p src
+ * @param count Number of samples
+ * @param dither Generator state, NULL to round without dither
+ */
+void pcm_s32_to_s16(const uint8_t *src, int16_t *dst, size_t count, struct pcm_dither *dither);
+
+/**
+ * @brief Convert a buffer of 8-, 16-, 24- or 32-bit PCM to 16-bit in place
+ *
+ * @param data PCM bytes, rewritten as 16-bit samples; 8-bit data doubles
+ *             in size, so needs room for 2 * @p len bytes
+ * @param len Length in bytes, a whole number of samples
+ * @param bits_per_sample Source sample size
+ * @param dither Generator state, NULL to round without dither
+ * @return Length of the 16-bit data in bytes, -ENOTSUP for other sample sizes
+ */
+int pcm_convert_to_s16(uint8_t *data, size_t len, uint16_t bits_per_sample,
+                       struct pcm_dither *dither);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PCM_DSP_H */
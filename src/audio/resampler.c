@@ -0,0 +1,160 @@
+/**
+ * @file resampler.c
+ * @brief Streaming polyphase sample-rate converter
+ *
+ * Please refer to resampler.h for more documentation.
+ */
+
+#include "resampler.h"
+#include "resampler_taps.h"
+#include <errno.h>
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+#include <arm_acle.h>
+#define RESAMPLER_SIMD 1
+#else
+#define RESAMPLER_SIMD 0
+#endif
+
+static inline int16_t sat16(int32_t value)
+{
+#if RESAMPLER_SIMD
+    return (int16_t)__ssat(value, 16);
+#else
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)value;
+#endif
+}
+
+/* Q15 dot product over an even number of taps */
+static inline int32_t dot_q15(const int16_t *window, const int16_t *coeffs, size_t taps)
+{
+    int32_t acc = 0;
+
+#if RESAMPLER_SIMD
+    /* SMLAD: two 16x16 multiplies and both adds in one instruction */
+    for (size_t j = 0; j < taps; j += 2) {
+        uint32_t w, c;
+
+        memcpy(&w, &window[j], sizeof(w));
+        memcpy(&c, &coeffs[j], sizeof(c));
+        acc = __smlad((int32_t)w, (int32_t)c, acc);
+    }
+#else
+    for (size_t j = 0; j < taps; j++) {
+        acc += (int32_t)window[j] * coeffs[j];
+    }
+#endif
+
+    return acc;
+}
+
+int resampler_init(struct resampler *rs, uint32_t in_rate, uint32_t out_rate,
+                   uint16_t channels, resampler_quality_t quality)
+{
+    if (!rs || in_rate == 0 || out_rate == 0 ||
+        channels == 0 || channels > RESAMPLER_MAX_CHANNELS) {
+        return -EINVAL;
+    }
+
+    switch (quality) {
+    case RESAMPLER_QUALITY_FAST:
+        rs->table = &resampler_taps_fast[0][0];
+        rs->taps = 2;
+        break;
+    case RESAMPLER_QUALITY_HIGH:
+        rs->table = &resampler_taps_high[0][0];
+        rs->taps = 16;
+        break;
+    case RESAMPLER_QUALITY_BALANCED:
+    default:
+        rs->table = &resampler_taps_balanced[0][0];
+        rs->taps = 8;
+        break;
+    }
+
+    rs->in_rate = in_rate;
+    rs->out_rate = out_rate;
+    rs->channels = channels;
+    rs->active = (in_rate != out_rate);
+    resampler_reset(rs);
+
+    return 0;
+}
+
+void resampler_reset(struct resampler *rs)
+{
+    rs->acc = 0;
+    rs->pos = 0;
+    memset(rs->history, 0, sizeof(rs->history));
+}
+
+size_t resampler_max_input(const struct resampler *rs, size_t capacity)
+{
+    uint64_t frames;
+
+    if (!rs->active) {
+        return capacity;
+    }
+    if (capacity < 2) {
+        return 0;
+    }
+
+    /* n inputs give at most n * out / in + 1 outputs */
+    frames = ((uint64_t)(capacity - 2) * rs->in_rate) / rs->out_rate;
+    return (frames < capacity) ? (size_t)frames : capacity;
+}
+
+size_t resampler_process(struct resampler *rs, int16_t *samples, size_t frames, size_t capacity)
+{
+    const size_t channels = rs->channels;
+    const int16_t *in = samples;
+    size_t out = 0;
+
+    if (!rs->active) {
+        return frames;
+    }
+
+    /* Growing in place: read from the tail while writing from the front */
+    if (rs->out_rate > rs->in_rate && capacity > frames) {
+        int16_t *tail = samples + (capacity - frames) * channels;
+
+        memmove(tail, samples, frames * channels * sizeof(int16_t));
+        in = tail;
+    }
+
+    for (size_t i = 0; i < frames; i++) {
+        rs->pos = (uint8_t)((rs->pos + 1) % rs->taps);
+        for (size_t c = 0; c < channels; c++) {
+            int16_t x = in[i * channels + c];
+
+            /* Mirrored so the window is always contiguous */
+            rs->history[c][rs->pos] = x;
+            rs->history[c][rs->pos + rs->taps] = x;
+        }
+
+        while (rs->acc < rs->out_rate) {
+            if (out < capacity) {
+                uint32_t phase = (rs->acc * RESAMPLER_PHASES + rs->out_rate / 2) / rs->out_rate;
+                const int16_t *coeffs = rs->table + phase * rs->taps;
+
+                for (size_t c = 0; c < channels; c++) {
+                    int32_t acc = dot_q15(&rs->history[c][rs->pos + 1], coeffs, rs->taps);
+
+                    samples[out * channels + c] = sat16((acc + (1 << 14)) >> 15);
+                }
+                out++;
+            }
+            rs->acc += rs->in_rate;
+        }
+        rs->acc -= rs->out_rate;
+    }
+
+    return out;
+}
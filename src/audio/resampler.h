@@ -0,0 +1,103 @@
+/**
+ * @file resampler.h
+ * @brief Streaming polyphase sample-rate converter
+ *
+ * Converts interleaved 16-bit PCM between any two rates using the
+ * windowed-sinc tables in resampler_taps.h (generated by
+ * tools/gen_resampler_taps.py). Position is tracked as an exact fraction
+ * of the two rates, so long streams never drift, and the filter history
+ * carries across calls so buffer boundaries are inaudible.
+ *
+ * Conversion runs in place. When converting up, the input is first moved
+ * to the end of the buffer and output is written from the front; the
+ * caller sizes the input with resampler_max_input() so the write position
+ * never overtakes the read position.
+ *
+ * The filters are designed against the input rate, so downsampling by
+ * more than about 10% (e.g. 96 kHz to 44.1 kHz) lets some content above
+ * the new Nyquist frequency alias.
+ */
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RESAMPLER_MAX_CHANNELS 2
+#define RESAMPLER_MAX_TAPS 16
+
+/**
+ * @brief Quality tiers, trading CPU time for stopband rejection
+ */
+typedef enum {
+    RESAMPLER_QUALITY_FAST,      ///< Linear interpolation, 2 MACs per sample
+    RESAMPLER_QUALITY_BALANCED,  ///< 8-tap windowed sinc
+    RESAMPLER_QUALITY_HIGH       ///< 16-tap windowed sinc
+} resampler_quality_t;
+
+/**
+ * @brief Converter state, one per stream
+ */
+struct resampler {
+    bool active;                 ///< false when the rates match (pass-through)
+    uint32_t in_rate;
+    uint32_t out_rate;
+    uint32_t acc;                ///< Output position past the window centre, in 1/out_rate frames
+    uint16_t channels;
+    uint8_t taps;
+    uint8_t pos;                 ///< Newest history slot
+    const int16_t *table;        ///< (RESAMPLER_PHASES + 1) x taps coefficients
+    int16_t history[RESAMPLER_MAX_CHANNELS][2 * RESAMPLER_MAX_TAPS];
+};
+
+/**
+ * @brief Set up a converter
+ *
+ * @param rs Converter state
+ * @param in_rate Source sample rate in Hz
+ * @param out_rate Sink sample rate in Hz
+ * @param channels Interleaved channels (1 or 2)
+ * @param quality Filter tier
+ * @return 0 on success (pass-through if the rates match), -EINVAL on bad parameters
+ */
+int resampler_init(struct resampler *rs, uint32_t in_rate, uint32_t out_rate,
+                   uint16_t channels, resampler_quality_t quality);
+
+/**
+ * @brief Forget the filter history, e.g. after a seek
+ *
+ * @param rs Converter state
+ */
+void resampler_reset(struct resampler *rs);
+
+/**
+ * @brief Largest input that is guaranteed to fit the output buffer
+ *
+ * @param rs Converter state
+ * @param capacity Buffer size in frames
+ * @return Input frames that may be passed to resampler_process()
+ */
+size_t resampler_max_input(const struct resampler *rs, size_t capacity);
+
+/**
+ * @brief Convert a buffer in place
+ *
+ * @param rs Converter state
+ * @param samples Interleaved samples, rewritten at the output rate
+ * @param frames Input frames at the start of @p samples
+ * @param capacity Size of @p samples in frames
+ * @return Output frames now at the start of @p samples
+ */
+size_t resampler_process(struct resampler *rs, int16_t *samples, size_t frames, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RESAMPLER_H */
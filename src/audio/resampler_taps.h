@@ -0,0 +1,222 @@
+/**
+ * @file resampler_taps.h
+ * @brief Polyphase filter tables for the sample-rate converter
+ *
+ * Generated by tools/gen_resampler_taps.py - do not edit by hand.
+ */
+
+#ifndef RESAMPLER_TAPS_H
+#define RESAMPLER_TAPS_H
+
+#include <stdint.h>
+
+#define RESAMPLER_PHASES 64
+
+/* fast: linear interpolation */
+static const int16_t resampler_taps_fast[RESAMPLER_PHASES + 1][2] = {
+    { 32767, 0 },
+    { 32256, 512 },
+    { 31744, 1024 },
+    { 31232, 1536 },
+    { 30720, 2048 },
+    { 30208, 2560 },
+    { 29696, 3072 },
+    { 29184, 3584 },
+    { 28672, 4096 },
+    { 28160, 4608 },
+    { 27648, 5120 },
+    { 27136, 5632 },
+    { 26624, 6144 },
+    { 26112, 6656 },
+    { 25600, 7168 },
+    { 25088, 7680 },
+    { 24576, 8192 },
+    { 24064, 8704 },
+    { 23552, 9216 },
+    { 23040, 9728 },
+    { 22528, 10240 },
+    { 22016, 10752 },
+    { 21504, 11264 },
+    { 20992, 11776 },
+    { 20480, 12288 },
+    { 19968, 12800 },
+    { 19456, 13312 },
+    { 18944, 13824 },
+    { 18432, 14336 },
+    { 17920, 14848 },
+    { 17408, 15360 },
+    { 16896, 15872 },
+    { 16384, 16384 },
+    { 15872, 16896 },
+    { 15360, 17408 },
+    { 14848, 17920 },
+    { 14336, 18432 },
+    { 13824, 18944 },
+    { 13312, 19456 },
+    { 12800, 19968 },
+    { 12288, 20480 },
+    { 11776, 20992 },
+    { 11264, 21504 },
+    { 10752, 22016 },
+    { 10240, 22528 },
+    { 9728, 23040 },
+    { 9216, 23552 },
+    { 8704, 24064 },
+    { 8192, 24576 },
+    { 7680, 25088 },
+    { 7168, 25600 },
+    { 6656, 26112 },
+    { 6144, 26624 },
+    { 5632, 27136 },
+    { 5120, 27648 },
+    { 4608, 28160 },
+    { 4096, 28672 },
+    { 3584, 29184 },
+    { 3072, 29696 },
+    { 2560, 30208 },
+    { 2048, 30720 },
+    { 1536, 31232 },
+    { 1024, 31744 },
+    { 512, 32256 },
+    { 0, 32767 },
+};
+
+/* balanced: 8 taps, cutoff 0.40 fs_in, Kaiser beta 5.0 */
+static const int16_t resampler_taps_balanced[RESAMPLER_PHASES + 1][8] = {
+    { 759, -2731, 5301, 26110, 5301, -2731, 759, 0 },
+    { 752, -2652, 4919, 26148, 5707, -2818, 768, -56 },
+    { 742, -2565, 4535, 26125, 6110, -2898, 774, -55 },
+    { 730, -2477, 4159, 26087, 6519, -2975, 779, -54 },
+    { 718, -2388, 3789, 26036, 6933, -3049, 782, -53 },
+    { 704, -2297, 3427, 25968, 7353, -3120, 784, -51 },
+    { 690, -2205, 3073, 25885, 7777, -3187, 784, -49 },
+    { 675, -2112, 2727, 25787, 8206, -3251, 782, -46 },
+    { 659, -2018, 2389, 25675, 8639, -3311, 778, -43 },
+    { 642, -1924, 2059, 25551, 9075, -3367, 772, -40 },
+    { 624, -1830, 1738, 25411, 9515, -3418, 764, -36 },
+    { 606, -1735, 1425, 25255, 9958, -3465, 755, -31 },
+    { 588, -1641, 1122, 25085, 10403, -3506, 743, -26 },
+    { 569, -1547, 828, 24901, 10851, -3543, 729, -20 },
+    { 549, -1453, 542, 24705, 11300, -3574, 713, -14 },
+    { 530, -1360, 267, 24494, 11750, -3600, 694, -7 },
+    { 510, -1268, 0, 24271, 12201, -3619, 673, 0 },
+    { 490, -1176, -257, 24034, 12652, -3633, 650, 8 },
+    { 469, -1086, -504, 23784, 13103, -3640, 625, 17 },
+    { 449, -997, -742, 23523, 13553, -3641, 597, 26 },
+    { 429, -909, -970, 23248, 14003, -3634, 566, 35 },
+    { 408, -823, -1189, 22964, 14450, -3621, 533, 46 },
+    { 388, -738, -1397, 22665, 14896, -3600, 497, 57 },
+    { 368, -655, -1596, 22357, 15339, -3572, 459, 68 },
+    { 348, -574, -1785, 22037, 15779, -3537, 419, 81 },
+    { 328, -495, -1965, 21709, 16216, -3493, 375, 93 },
+    { 308, -417, -2134, 21367, 16649, -3441, 329, 107 },
+    { 289, -342, -2294, 21017, 17077, -3381, 281, 121 },
+    { 270, -269, -2445, 20659, 17501, -3313, 230, 135 },
+    { 252, -198, -2586, 20291, 17919, -3236, 176, 150 },
+    { 234, -130, -2717, 19913, 18332, -3150, 120, 166 },
+    { 216, -64, -2839, 19530, 18738, -3056, 61, 182 },
+    { 199, 0, -2952, 19137, 19137, -2952, 0, 199 },
+    { 182, 61, -3056, 18738, 19530, -2839, -64, 216 },
+    { 166, 120, -3150, 18332, 19913, -2717, -130, 234 },
+    { 150, 176, -3236, 17919, 20291, -2586, -198, 252 },
+    { 135, 230, -3313, 17501, 20659, -2445, -269, 270 },
+    { 121, 281, -3381, 17077, 21017, -2294, -342, 289 },
+    { 107, 329, -3441, 16649, 21367, -2134, -417, 308 },
+    { 93, 375, -3493, 16216, 21709, -1965, -495, 328 },
+    { 81, 419, -3537, 15779, 22037, -1785, -574, 348 },
+    { 68, 459, -3572, 15339, 22357, -1596, -655, 368 },
+    { 57, 497, -3600, 14896, 22665, -1397, -738, 388 },
+    { 46, 533, -3621, 14450, 22964, -1189, -823, 408 },
+    { 35, 566, -3634, 14003, 23248, -970, -909, 429 },
+    { 26, 597, -3641, 13553, 23523, -742, -997, 449 },
+    { 17, 625, -3640, 13103, 23784, -504, -1086, 469 },
+    { 8, 650, -3633, 12652, 24034, -257, -1176, 490 },
+    { 0, 673, -3619, 12201, 24271, 0, -1268, 510 },
+    { -7, 694, -3600, 11750, 24494, 267, -1360, 530 },
+    { -14, 713, -3574, 11300, 24705, 542, -1453, 549 },
+    { -20, 729, -3543, 10851, 24901, 828, -1547, 569 },
+    { -26, 743, -3506, 10403, 25085, 1122, -1641, 588 },
+    { -31, 755, -3465, 9958, 25255, 1425, -1735, 606 },
+    { -36, 764, -3418, 9515, 25411, 1738, -1830, 624 },
+    { -40, 772, -3367, 9075, 25551, 2059, -1924, 642 },
+    { -43, 778, -3311, 8639, 25675, 2389, -2018, 659 },
+    { -46, 782, -3251, 8206, 25787, 2727, -2112, 675 },
+    { -49, 784, -3187, 7777, 25885, 3073, -2205, 690 },
+    { -51, 784, -3120, 7353, 25968, 3427, -2297, 704 },
+    { -53, 782, -3049, 6933, 26036, 3789, -2388, 718 },
+    { -54, 779, -2975, 6519, 26087, 4159, -2477, 730 },
+    { -55, 774, -2898, 6110, 26125, 4535, -2565, 742 },
+    { -56, 768, -2818, 5707, 26148, 4919, -2652, 752 },
+    { 0, 759, -2731, 5301, 26110, 5301, -2731, 759 },
+};
+
+/* high: 16 taps, cutoff 0.45 fs_in, Kaiser beta 7.0 */
+static const int16_t resampler_taps_high[RESAMPLER_PHASES + 1][16] = {
+    { 48, -192, 511, -1046, 1755, -2495, 3063, 29480, 3063, -2495, 1755, -1046, 511, -192, 48, 0 },
+    { 48, -192, 504, -1019, 1680, -2316, 2599, 29474, 3537, -2674, 1829, -1072, 518, -192, 48, -4 },
+    { 49, -191, 496, -990, 1603, -2135, 2145, 29445, 4021, -2852, 1900, -1097, 523, -192, 47, -4 },
+    { 49, -189, 487, -960, 1524, -1954, 1702, 29396, 4513, -3027, 1968, -1119, 527, -191, 46, -4 },
+    { 49, -187, 478, -928, 1443, -1773, 1270, 29325, 5015, -3200, 2034, -1139, 530, -190, 45, -4 },
+    { 49, -185, 467, -895, 1361, -1592, 849, 29238, 5524, -3371, 2097, -1158, 532, -188, 44, -4 },
+    { 48, -183, 456, -861, 1278, -1412, 440, 29129, 6042, -3538, 2157, -1174, 533, -186, 43, -4 },
+    { 48, -180, 444, -826, 1195, -1234, 43, 29002, 6566, -3702, 2214, -1189, 533, -184, 41, -3 },
+    { 47, -177, 432, -790, 1110, -1056, -341, 28853, 7097, -3862, 2268, -1201, 532, -180, 39, -3 },
+    { 47, -173, 419, -753, 1025, -880, -713, 28686, 7635, -4018, 2317, -1211, 529, -177, 38, -3 },
+    { 46, -170, 405, -716, 940, -706, -1073, 28502, 8178, -4169, 2363, -1219, 526, -173, 36, -2 },
+    { 45, -166, 391, -677, 854, -534, -1419, 28298, 8726, -4315, 2405, -1224, 521, -168, 33, -2 },
+    { 44, -162, 376, -639, 768, -365, -1752, 28077, 9278, -4455, 2443, -1226, 514, -163, 31, -1 },
+    { 43, -157, 361, -599, 683, -199, -2071, 27835, 9835, -4590, 2477, -1227, 507, -157, 28, -1 },
+    { 42, -152, 346, -560, 598, -36, -2378, 27575, 10395, -4718, 2506, -1224, 498, -150, 26, 0 },
+    { 41, -148, 330, -520, 513, 124, -2670, 27300, 10958, -4840, 2530, -1219, 488, -143, 23, 1 },
+    { 40, -143, 314, -480, 429, 280, -2949, 27007, 11523, -4954, 2550, -1211, 477, -136, 20, 1 },
+    { 39, -137, 298, -440, 346, 432, -3213, 26697, 12089, -5061, 2565, -1201, 464, -128, 16, 2 },
+    { 38, -132, 281, -400, 264, 581, -3464, 26369, 12657, -5160, 2575, -1188, 450, -119, 13, 3 },
+    { 36, -127, 265, -360, 183, 725, -3701, 26028, 13224, -5251, 2580, -1172, 435, -110, 9, 4 },
+    { 35, -121, 248, -320, 104, 864, -3924, 25671, 13792, -5333, 2579, -1153, 418, -101, 5, 4 },
+    { 34, -115, 231, -280, 26, 999, -4133, 25298, 14358, -5407, 2573, -1131, 400, -91, 1, 5 },
+    { 32, -110, 214, -241, -51, 1129, -4328, 24912, 14923, -5471, 2562, -1107, 381, -80, -3, 6 },
+    { 31, -104, 198, -202, -126, 1254, -4509, 24509, 15486, -5525, 2545, -1080, 360, -69, -7, 7 },
+    { 30, -98, 181, -163, -199, 1374, -4676, 24092, 16045, -5569, 2523, -1049, 338, -57, -12, 8 },
+    { 28, -92, 164, -125, -270, 1488, -4829, 23662, 16602, -5603, 2495, -1016, 315, -45, -16, 10 },
+    { 27, -87, 147, -88, -339, 1597, -4968, 23223, 17154, -5626, 2461, -980, 290, -33, -21, 11 },
+    { 25, -81, 131, -52, -406, 1701, -5094, 22771, 17701, -5638, 2421, -942, 265, -20, -26, 12 },
+    { 24, -75, 115, -16, -471, 1799, -5206, 22305, 18243, -5639, 2375, -900, 238, -6, -31, 13 },
+    { 22, -69, 98, 19, -534, 1891, -5305, 21832, 18778, -5628, 2324, -856, 210, 8, -36, 14 },
+    { 21, -64, 83, 54, -594, 1978, -5391, 21344, 19307, -5605, 2266, -809, 181, 22, -41, 16 },
+    { 20, -58, 67, 87, -651, 2059, -5463, 20847, 19829, -5570, 2203, -759, 150, 37, -47, 17 },
+    { 18, -52, 52, 119, -706, 2134, -5523, 20341, 20343, -5523, 2134, -706, 119, 52, -52, 18 },
+    { 17, -47, 37, 150, -759, 2203, -5570, 19829, 20847, -5463, 2059, -651, 87, 67, -58, 20 },
+    { 16, -41, 22, 181, -809, 2266, -5605, 19307, 21344, -5391, 1978, -594, 54, 83, -64, 21 },
+    { 14, -36, 8, 210, -856, 2324, -5628, 18778, 21832, -5305, 1891, -534, 19, 98, -69, 22 },
+    { 13, -31, -6, 238, -900, 2375, -5639, 18243, 22305, -5206, 1799, -471, -16, 115, -75, 24 },
+    { 12, -26, -20, 265, -942, 2421, -5638, 17701, 22771, -5094, 1701, -406, -52, 131, -81, 25 },
+    { 11, -21, -33, 290, -980, 2461, -5626, 17154, 23223, -4968, 1597, -339, -88, 147, -87, 27 },
+    { 10, -16, -45, 315, -1016, 2495, -5603, 16602, 23662, -4829, 1488, -270, -125, 164, -92, 28 },
+    { 8, -12, -57, 338, -1049, 2523, -5569, 16045, 24092, -4676, 1374, -199, -163, 181, -98, 30 },
+    { 7, -7, -69, 360, -1080, 2545, -5525, 15486, 24509, -4509, 1254, -126, -202, 198, -104, 31 },
+    { 6, -3, -80, 381, -1107, 2562, -5471, 14923, 24912, -4328, 1129, -51, -241, 214, -110, 32 },
+    { 5, 1, -91, 400, -1131, 2573, -5407, 14358, 25298, -4133, 999, 26, -280, 231, -115, 34 },
+    { 4, 5, -101, 418, -1153, 2579, -5333, 13792, 25671, -3924, 864, 104, -320, 248, -121, 35 },
+    { 4, 9, -110, 435, -1172, 2580, -5251, 13224, 26028, -3701, 725, 183, -360, 265, -127, 36 },
+    { 3, 13, -119, 450, -1188, 2575, -5160, 12657, 26369, -3464, 581, 264, -400, 281, -132, 38 },
+    { 2, 16, -128, 464, -1201, 2565, -5061, 12089, 26697, -3213, 432, 346, -440, 298, -137, 39 },
+    { 1, 20, -136, 477, -1211, 2550, -4954, 11523, 27007, -2949, 280, 429, -480, 314, -143, 40 },
+    { 1, 23, -143, 488, -1219, 2530, -4840, 10958, 27300, -2670, 124, 513, -520, 330, -148, 41 },
+    { 0, 26, -150, 498, -1224, 2506, -4718, 10395, 27575, -2378, -36, 598, -560, 346, -152, 42 },
+    { -1, 28, -157, 507, -1227, 2477, -4590, 9835, 27835, -2071, -199, 683, -599, 361, -157, 43 },
+    { -1, 31, -163, 514, -1226, 2443, -4455, 9278, 28077, -1752, -365, 768, -639, 376, -162, 44 },
+    { -2, 33, -168, 521, -1224, 2405, -4315, 8726, 28298, -1419, -534, 854, -677, 391, -166, 45 },
+    { -2, 36, -173, 526, -1219, 2363, -4169, 8178, 28502, -1073, -706, 940, -716, 405, -170, 46 },
+    { -3, 38, -177, 529, -1211, 2317, -4018, 7635, 28686, -713, -880, 1025, -753, 419, -173, 47 },
+    { -3, 39, -180, 532, -1201, 2268, -3862, 7097, 28853, -341, -1056, 1110, -790, 432, -177, 47 },
+    { -3, 41, -184, 533, -1189, 2214, -3702, 6566, 29002, 43, -1234, 1195, -826, 444, -180, 48 },
+    { -4, 43, -186, 533, -1174, 2157, -3538, 6042, 29129, 440, -1412, 1278, -861, 456, -183, 48 },
+    { -4, 44, -188, 532, -1158, 2097, -3371, 5524, 29238, 849, -1592, 1361, -895, 467, -185, 49 },
+    { -4, 45, -190, 530, -1139, 2034, -3200, 5015, 29325, 1270, -1773, 1443, -928, 478, -187, 49 },
+    { -4, 46, -191, 527, -1119, 1968, -3027, 4513, 29396, 1702, -1954, 1524, -960, 487, -189, 49 },
+    { -4, 47, -192, 523, -1097, 1900, -2852, 4021, 29445, 2145, -2135, 1603, -990, 496, -191, 49 },
+    { -4, 48, -192, 518, -1072, 1829, -2674, 3537, 29474, 2599, -2316, 1680, -1019, 504, -192, 48 },
+    { 0, 48, -192, 511, -1046, 1755, -2495, 3063, 29480, 3063, -2495, 1755, -1046, 511, -192, 48 },
+};
+
+#endif /* RESAMPLER_TAPS_H */
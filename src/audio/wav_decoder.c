@@ -15,6 +15,70 @@
 
 LOG_MODULE_REGISTER(wav_decoder, LOG_LEVEL_DBG);
 
+/* Chunk IDs as read little-endian from the file */
+#define WAV_CHUNK_FMT  0x20746d66 // "fmt "
+#define WAV_CHUNK_DATA 0x61746164 // "data"
+
+/* Fixed header field sizes for the push decoder */
+#define WAV_RIFF_HEADER_SIZE  12
+#define WAV_CHUNK_HEADER_SIZE 8
+#define WAV_FMT_PCM_SIZE      16
+#define WAV_FMT_EXT_SIZE      24  // cbSize, valid bits, channel mask, SubFormat
+
+/* KSDATAFORMAT_SUBTYPE_PCM after its leading 16-bit format code */
+static const uint8_t wav_subformat_guid_tail[14] = {
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71
+};
+
+/**
+ * @brief Resolve a WAVE_FORMAT_EXTENSIBLE tag from the fmt extension
+ *
+ * @param format Parsed fmt fields, format_tag is replaced by the SubFormat
+ *               code when the GUID is one of the standard KSDATAFORMAT ones
+ * @param ext The WAV_FMT_EXT_SIZE bytes following the PCM fields
+ */
+static void wav_resolve_extensible(struct audio_format_info *format, const uint8_t *ext)
+{
+    const uint8_t *guid = ext + 8;
+
+    if (memcmp(guid + 2, wav_subformat_guid_tail, sizeof(wav_subformat_guid_tail)) == 0) {
+        format->format_tag = (uint16_t)(guid[0] | (guid[1] << 8));
+    }
+}
+
+/**
+ * @brief Check that a parsed fmt chunk describes audio we can play
+ *
+ * Integer PCM of 8 to 32 bits in packed frames, mono or stereo.
+ */
+static int wav_check_format(const struct audio_format_info *format)
+{
+    if (format->format_tag != WAV_FORMAT_PCM) {
+        LOG_ERR("Only PCM format supported, got format %u", format->format_tag);
+        return -ENOTSUP;
+    }
+
+    if (format->channels == 0 || format->channels > 2) {
+        LOG_ERR("Unsupported channel count: %u", format->channels);
+        return -ENOTSUP;
+    }
+
+    if (format->bits_per_sample != 8 && format->bits_per_sample != 16 &&
+        format->bits_per_sample != 24 && format->bits_per_sample != 32) {
+        LOG_ERR("Unsupported bit depth: %u", format->bits_per_sample);
+        return -ENOTSUP;
+    }
+
+    /* Samples are converted assuming no padding inside a frame */
+    if (format->block_align != format->channels * (format->bits_per_sample / 8)) {
+        LOG_ERR("Unsupported block alignment %u for %uch %u-bit",
+                format->block_align, format->channels, format->bits_per_sample);
+        return -ENOTSUP;
+    }
+
+    return 0;
+}
+
 int wav_decoder_init(struct wav_decoder *decoder, const uint8_t *data, size_t data_len)
 {
     if (!decoder || !data || data_len == 0) {
@@ -58,7 +122,7 @@ int wav_decoder_init(struct wav_decoder *decoder, const uint8_t *data, size_t da
         memcpy(&chunk_id, ptr, 4);
         memcpy(&chunk_size, ptr + 4, 4);
         
-        if (chunk_id == 0x20746d66) { // "fmt "
+        if (chunk_id == WAV_CHUNK_FMT) {
             if (chunk_size < 16) {
                 LOG_ERR("Invalid fmt chunk size");
                 return -EINVAL;
@@ -72,12 +136,18 @@ int wav_decoder_init(struct wav_decoder *decoder, const uint8_t *data, size_t da
             memcpy(&decoder->format.block_align, ptr + 20, 2);
             memcpy(&decoder->format.bits_per_sample, ptr + 22, 2);
             
+            if (decoder->format.format_tag == WAV_FORMAT_EXTENSIBLE &&
+                chunk_size >= WAV_FMT_PCM_SIZE + WAV_FMT_EXT_SIZE &&
+                remaining >= 8 + WAV_FMT_PCM_SIZE + WAV_FMT_EXT_SIZE) {
+                wav_resolve_extensible(&decoder->format, ptr + 8 + WAV_FMT_PCM_SIZE);
+            }
+            
             LOG_INF("WAV Format: %u channels, %u Hz, %u bits", 
                     decoder->format.channels,
                     decoder->format.sample_rate,
                     decoder->format.bits_per_sample);
         }
-        else if (chunk_id == 0x61746164) { // "data"
+        else if (chunk_id == WAV_CHUNK_DATA) {
             /* Found data chunk */
             decoder->audio_data_offset = (ptr + 8) - data;
             decoder->audio_data_size = chunk_size;
@@ -105,19 +175,9 @@ int wav_decoder_init(struct wav_decoder *decoder, const uint8_t *data, size_t da
     }
 
     /* Validate format */
-    if (decoder->format.format_tag != 1) { // PCM
-        LOG_ERR("Only PCM format supported, got format %u", decoder->format.format_tag);
-        return -ENOTSUP;
-    }
-
-    if (decoder->format.channels == 0 || decoder->format.channels > 2) {
-        LOG_ERR("Unsupported channel count: %u", decoder->format.channels);
-        return -ENOTSUP;
-    }
-
-    if (decoder->format.bits_per_sample != 8 && decoder->format.bits_per_sample != 16) {
-        LOG_ERR("Unsupported bit depth: %u", decoder->format.bits_per_sample);
-        return -ENOTSUP;
+    int ret = wav_check_format(&decoder->format);
+    if (ret < 0) {
+        return ret;
     }
 
     decoder->is_initialized = true;
@@ -182,6 +242,57 @@ int wav_decoder_seek(struct wav_decoder *decoder, size_t offset)
     return 0;
 }
 
+int wav_decoder_seek_ms(struct wav_decoder *decoder, uint32_t position_ms)
+{
+    if (!decoder || !decoder->is_initialized) {
+        return -EINVAL;
+    }
+
+    size_t offset = wav_time_to_offset(&decoder->format, position_ms);
+    if (offset > decoder->audio_data_size) {
+        offset = decoder->audio_data_size;
+    }
+
+    return wav_decoder_seek(decoder, offset);
+}
+
+/* Fall back to the frame rate when bytes_per_sec was left at 0 */
+static uint32_t wav_byte_rate(const struct audio_format_info *format)
+{
+    if (format->bytes_per_sec) {
+        return format->bytes_per_sec;
+    }
+    return format->sample_rate * format->block_align;
+}
+
+size_t wav_time_to_offset(const struct audio_format_info *format, uint32_t position_ms)
+{
+    if (!format) {
+        return 0;
+    }
+
+    size_t offset = (size_t)(((uint64_t)wav_byte_rate(format) * position_ms) / 1000U);
+    if (format->block_align > 1) {
+        offset -= offset % format->block_align;
+    }
+    return offset;
+}
+
+uint32_t wav_offset_to_time(const struct audio_format_info *format, size_t offset)
+{
+    uint32_t rate;
+
+    if (!format) {
+        return 0;
+    }
+
+    rate = wav_byte_rate(format);
+    if (rate == 0) {
+        return 0;
+    }
+    return (uint32_t)(((uint64_t)offset * 1000U) / rate);
+}
+
 size_t wav_decoder_get_position(struct wav_decoder *decoder)
 {
     if (!decoder || !decoder->is_initialized) {
@@ -288,3 +399,257 @@ int wav_decoder_read_samples(struct wav_decoder *decoder,
 
     return 0;
 }
+
+/*
+ * Push-mode decoder
+ */
+
+static inline uint16_t wav_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t wav_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int wav_stream_fail(struct wav_stream_decoder *decoder, int err)
+{
+    decoder->state = WAV_STREAM_ERROR;
+    return err;
+}
+
+static size_t wav_stream_field_size(wav_stream_state_t state)
+{
+    switch (state) {
+    case WAV_STREAM_RIFF:
+        return WAV_RIFF_HEADER_SIZE;
+    case WAV_STREAM_CHUNK_HEADER:
+        return WAV_CHUNK_HEADER_SIZE;
+    case WAV_STREAM_FMT_EXT:
+        return WAV_FMT_EXT_SIZE;
+    default:
+        return WAV_FMT_PCM_SIZE;
+    }
+}
+
+/**
+ * @brief Validate the parsed fmt chunk and report it
+ */
+static int wav_stream_format_complete(struct wav_stream_decoder *decoder,
+                                      wav_stream_cb_t cb, void *user_data)
+{
+    struct audio_format_info *fmt = &decoder->format;
+    int ret = wav_check_format(fmt);
+
+    if (ret < 0) {
+        return wav_stream_fail(decoder, ret);
+    }
+    decoder->have_format = true;
+
+    LOG_INF("WAV Format: %u channels, %u Hz, %u bits",
+            fmt->channels, fmt->sample_rate, fmt->bits_per_sample);
+
+    /* Skip any fmt extension bytes after the fields we use */
+    decoder->state = WAV_STREAM_SKIP;
+
+    struct wav_stream_event event = {
+        .type = WAV_STREAM_EVENT_FORMAT,
+        .format = fmt,
+    };
+    ret = cb(&event, user_data);
+    return (ret < 0) ? wav_stream_fail(decoder, ret) : ret;
+}
+
+/**
+ * @brief Act on a fully collected RIFF, chunk or fmt field
+ */
+static int wav_stream_field_complete(struct wav_stream_decoder *decoder,
+                                     wav_stream_cb_t cb, void *user_data)
+{
+    const uint8_t *f = decoder->field;
+
+    switch (decoder->state) {
+    case WAV_STREAM_RIFF:
+        if (memcmp(f, "RIFF", 4) != 0 || memcmp(f + 8, "WAVE", 4) != 0) {
+            LOG_ERR("Invalid RIFF/WAVE signature");
+            return wav_stream_fail(decoder, -EINVAL);
+        }
+        decoder->state = WAV_STREAM_CHUNK_HEADER;
+        return 0;
+
+    case WAV_STREAM_CHUNK_HEADER: {
+        uint32_t chunk_id = wav_le32(f);
+        uint32_t chunk_size = wav_le32(f + 4);
+
+        if (chunk_id == WAV_CHUNK_FMT) {
+            if (chunk_size < WAV_FMT_PCM_SIZE) {
+                LOG_ERR("Invalid fmt chunk size");
+                return wav_stream_fail(decoder, -EINVAL);
+            }
+            decoder->chunk_remaining = chunk_size - WAV_FMT_PCM_SIZE + (chunk_size & 1);
+            decoder->chunk_pad = (chunk_size & 1) != 0;
+            decoder->state = WAV_STREAM_FMT;
+        } else if (chunk_id == WAV_CHUNK_DATA) {
+            if (!decoder->have_format) {
+                LOG_ERR("data chunk before fmt chunk");
+                return wav_stream_fail(decoder, -EINVAL);
+            }
+            decoder->data_size = chunk_size;
+            decoder->data_position = 0;
+            decoder->chunk_pad = (chunk_size & 1) != 0;
+            decoder->state = WAV_STREAM_DATA;
+            LOG_INF("Audio data: size=%u", chunk_size);
+        } else {
+            /* LIST, fact, bext, ... - not needed for playback */
+            decoder->chunk_remaining = chunk_size + (chunk_size & 1);
+            decoder->state = WAV_STREAM_SKIP;
+        }
+        return 0;
+    }
+
+    case WAV_STREAM_FMT: {
+        struct audio_format_info *fmt = &decoder->format;
+
+        fmt->format_tag = wav_le16(f);
+        fmt->channels = wav_le16(f + 2);
+        fmt->sample_rate = wav_le32(f + 4);
+        fmt->bytes_per_sec = wav_le32(f + 8);
+        fmt->block_align = wav_le16(f + 12);
+        fmt->bits_per_sample = wav_le16(f + 14);
+
+        if (fmt->format_tag == WAV_FORMAT_EXTENSIBLE) {
+            if (decoder->chunk_remaining - decoder->chunk_pad < WAV_FMT_EXT_SIZE) {
+                LOG_ERR("Extensible fmt chunk too short");
+                return wav_stream_fail(decoder, -EINVAL);
+            }
+            decoder->chunk_remaining -= WAV_FMT_EXT_SIZE;
+            decoder->state = WAV_STREAM_FMT_EXT;
+            return 0;
+        }
+        return wav_stream_format_complete(decoder, cb, user_data);
+    }
+
+    case WAV_STREAM_FMT_EXT:
+        wav_resolve_extensible(&decoder->format, f);
+        return wav_stream_format_complete(decoder, cb, user_data);
+
+    default:
+        return -EINVAL;
+    }
+}
+
+void wav_stream_init(struct wav_stream_decoder *decoder)
+{
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->state = WAV_STREAM_RIFF;
+}
+
+int wav_stream_feed(struct wav_stream_decoder *decoder, const uint8_t *data, size_t len,
+                    wav_stream_cb_t cb, void *user_data)
+{
+    size_t pos = 0;
+    int ret = 0;
+
+    if (!decoder || (!data && len > 0) || !cb) {
+        return -EINVAL;
+    }
+
+    if (decoder->state == WAV_STREAM_ERROR) {
+        return -EINVAL;
+    }
+
+    while (pos < len && decoder->state != WAV_STREAM_DONE && ret != WAV_STREAM_PAUSE) {
+        size_t avail = len - pos;
+
+        switch (decoder->state) {
+        case WAV_STREAM_RIFF:
+        case WAV_STREAM_CHUNK_HEADER:
+        case WAV_STREAM_FMT:
+        case WAV_STREAM_FMT_EXT: {
+            /* Header fields may straddle feeds - collect them */
+            size_t need = wav_stream_field_size(decoder->state) - decoder->field_len;
+            size_t n = (avail < need) ? avail : need;
+
+            memcpy(&decoder->field[decoder->field_len], &data[pos], n);
+            decoder->field_len += n;
+            pos += n;
+
+            if (decoder->field_len == wav_stream_field_size(decoder->state)) {
+                decoder->field_len = 0;
+                ret = wav_stream_field_complete(decoder, cb, user_data);
+                if (ret < 0) {
+                    return ret;
+                }
+            }
+            break;
+        }
+
+        case WAV_STREAM_SKIP: {
+            size_t n = (avail < decoder->chunk_remaining) ? avail : decoder->chunk_remaining;
+
+            pos += n;
+            decoder->chunk_remaining -= n;
+            if (decoder->chunk_remaining == 0) {
+                decoder->state = WAV_STREAM_CHUNK_HEADER;
+            }
+            break;
+        }
+
+        case WAV_STREAM_DATA: {
+            size_t n = avail;
+
+            if (decoder->data_size != WAV_STREAM_SIZE_UNKNOWN) {
+                size_t left = decoder->data_size - decoder->data_position;
+                n = (n < left) ? n : left;
+            }
+
+            if (n > 0) {
+                struct wav_stream_event event = {
+                    .type = WAV_STREAM_EVENT_DATA,
+                    .format = &decoder->format,
+                    .pcm = &data[pos],
+                    .len = n,
+                };
+                ret = cb(&event, user_data);
+                if (ret < 0) {
+                    return wav_stream_fail(decoder, ret);
+                }
+                if (ret == WAV_STREAM_PAUSE) {
+                    break; /* Span stays unconsumed */
+                }
+                pos += n;
+                decoder->data_position += n;
+            }
+
+            if (decoder->data_size != WAV_STREAM_SIZE_UNKNOWN &&
+                decoder->data_position >= decoder->data_size) {
+                /* Anything after the data chunk (LIST etc.) is ignored */
+                struct wav_stream_event event = {
+                    .type = WAV_STREAM_EVENT_END,
+                    .format = &decoder->format,
+                };
+                decoder->state = WAV_STREAM_DONE;
+                ret = cb(&event, user_data);
+                if (ret < 0) {
+                    return wav_stream_fail(decoder, ret);
+                }
+            }
+            break;
+        }
+
+        default:
+            return wav_stream_fail(decoder, -EINVAL);
+        }
+    }
+
+    decoder->bytes_consumed += pos;
+    return (int)pos;
+}
+
+bool wav_stream_in_data(const struct wav_stream_decoder *decoder)
+{
+    return decoder && decoder->state == WAV_STREAM_DATA;
+}
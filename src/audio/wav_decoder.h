@@ -28,11 +28,15 @@
 extern "C" {
 #endif
 
+/** fmt chunk format tags */
+#define WAV_FORMAT_PCM        0x0001
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE  ///< Real format in the SubFormat GUID
+
 /**
  * @brief Audio format information structure
  */
 struct audio_format_info {
-    uint16_t format_tag;       ///< Audio format (1 = PCM)
+    uint16_t format_tag;       ///< Audio format (WAV_FORMAT_PCM, also for extensible PCM)
     uint16_t channels;         ///< Number of channels
     uint32_t sample_rate;      ///< Sample rate in Hz
     uint32_t bytes_per_sec;    ///< Bytes per second
@@ -98,6 +102,37 @@ size_t wav_decoder_read(struct wav_decoder *decoder, uint8_t *buffer, size_t buf
  */
 int wav_decoder_seek(struct wav_decoder *decoder, size_t offset);
 
+/**
+ * @brief Seek to a play time
+ * 
+ * @param decoder Decoder instance
+ * @param position_ms Time from the start of the audio data, clamped to
+ *                    the end; lands on a frame boundary
+ * @return 0 on success, negative error code on failure
+ */
+int wav_decoder_seek_ms(struct wav_decoder *decoder, uint32_t position_ms);
+
+/**
+ * @brief Convert a play time to a PCM byte offset
+ * 
+ * Uses bytes_per_sec and rounds down to whole block_align frames, so the
+ * result is always a valid place to start playback.
+ * 
+ * @param format Stream format
+ * @param position_ms Time from the start of the audio data
+ * @return Byte offset from the start of the PCM data
+ */
+size_t wav_time_to_offset(const struct audio_format_info *format, uint32_t position_ms);
+
+/**
+ * @brief Convert a PCM byte offset to a play time
+ * 
+ * @param format Stream format
+ * @param offset Byte offset from the start of the PCM data
+ * @return Time in milliseconds, 0 if the format has no byte rate
+ */
+uint32_t wav_offset_to_time(const struct audio_format_info *format, size_t offset);
+
 /**
  * @brief Get current position in audio data
  * 
@@ -170,6 +205,109 @@ int wav_decoder_read_samples(struct wav_decoder *decoder,
                             const uint8_t *chunk_data, size_t chunk_size,
                             const uint8_t **audio_samples, size_t *samples_len);
 
+/*
+ * Incremental (push-mode) decoder
+ *
+ * For network streams where the file arrives in arbitrary pieces. The
+ * decoder keeps at most one fixed-size header field between calls; PCM is
+ * reported as spans pointing into the caller's input, never copied.
+ */
+
+/**
+ * @brief Push decoder event types
+ */
+typedef enum {
+    WAV_STREAM_EVENT_FORMAT,   ///< fmt chunk parsed and validated
+    WAV_STREAM_EVENT_DATA,     ///< PCM span from the data chunk
+    WAV_STREAM_EVENT_END       ///< Entire data chunk delivered
+} wav_stream_event_type_t;
+
+/**
+ * @brief Push decoder event
+ */
+struct wav_stream_event {
+    wav_stream_event_type_t type;
+    const struct audio_format_info *format;  ///< Valid for every event after FORMAT
+    const uint8_t *pcm;                      ///< DATA only: span inside the fed buffer
+    size_t len;                              ///< DATA only: span length in bytes
+};
+
+/** Callback return value asking wav_stream_feed() to stop before this event */
+#define WAV_STREAM_PAUSE 1
+
+/**
+ * @brief Push decoder event callback
+ *
+ * @param event Event being reported
+ * @param user_data Opaque pointer given to wav_stream_feed()
+ * @return 0 to continue, WAV_STREAM_PAUSE to return from the feed early
+ *         (a paused DATA span is not consumed and is reported again on the
+ *         next feed), or a negative error code to abort
+ */
+typedef int (*wav_stream_cb_t)(const struct wav_stream_event *event, void *user_data);
+
+/**
+ * @brief Push decoder parse states
+ */
+typedef enum {
+    WAV_STREAM_RIFF,           ///< Collecting the 12-byte RIFF/WAVE header
+    WAV_STREAM_CHUNK_HEADER,   ///< Collecting an 8-byte chunk id + size
+    WAV_STREAM_FMT,            ///< Collecting the 16 bytes of fmt we use
+    WAV_STREAM_FMT_EXT,        ///< Collecting the WAVE_FORMAT_EXTENSIBLE extension
+    WAV_STREAM_SKIP,           ///< Skipping unused chunk bytes / padding
+    WAV_STREAM_DATA,           ///< Reporting PCM spans
+    WAV_STREAM_DONE,           ///< Data chunk finished, rest ignored
+    WAV_STREAM_ERROR           ///< Invalid file, decoder must be reset
+} wav_stream_state_t;
+
+/** data chunk size used by streaming encoders that don't know the length */
+#define WAV_STREAM_SIZE_UNKNOWN 0xFFFFFFFFu
+
+/**
+ * @brief Push decoder context
+ */
+struct wav_stream_decoder {
+    wav_stream_state_t state;
+    uint8_t field[24];          ///< Partial fixed-size header field
+    size_t field_len;
+    uint32_t chunk_remaining;   ///< Bytes left in the chunk being read/skipped
+    bool chunk_pad;             ///< Odd-sized chunk, one pad byte follows
+    bool have_format;
+    struct audio_format_info format;
+    uint32_t data_size;         ///< data chunk size, WAV_STREAM_SIZE_UNKNOWN if unbounded
+    uint32_t data_position;     ///< PCM bytes reported so far
+    size_t bytes_consumed;      ///< Total input bytes consumed (file offset)
+};
+
+/**
+ * @brief Reset a push decoder to expect the start of a WAV file
+ *
+ * @param decoder Decoder instance
+ */
+void wav_stream_init(struct wav_stream_decoder *decoder);
+
+/**
+ * @brief Feed the next span of the WAV byte stream
+ *
+ * @param decoder Decoder instance
+ * @param data Input bytes, any length, any alignment to chunk boundaries
+ * @param len Number of input bytes
+ * @param cb Event callback
+ * @param user_data Passed through to @p cb
+ * @return Bytes consumed (less than @p len only when paused or done),
+ *         negative error code on invalid input or callback error
+ */
+int wav_stream_feed(struct wav_stream_decoder *decoder, const uint8_t *data, size_t len,
+                    wav_stream_cb_t cb, void *user_data);
+
+/**
+ * @brief Check whether the header has been parsed and PCM is flowing
+ *
+ * @param decoder Decoder instance
+ * @return true once FORMAT has been reported and the data chunk started
+ */
+bool wav_stream_in_data(const struct wav_stream_decoder *decoder);
+
 #ifdef __cplusplus
 }
 #endif
@@ -26,9 +26,6 @@
 #include <zephyr/devicetree.h>
 #include <zephyr/net/socket.h>
 #include <zephyr/net/net_ip.h>
-#include <zephyr/net/net_if.h>
-#include <zephyr/net/net_mgmt.h>
-#include <zephyr/net/wifi_mgmt.h>
 #include <string.h>
 #include <math.h>
 
@@ -38,6 +35,9 @@
 #include "server_client/audio_client.h"
 #include "utils/error_handling.h"
 #include "utils/circular_buffers.h"
+#include "utils/mem_plan.h"
+#include "utils/startup.h"
+#include "utils/trace.h"
 
 LOG_MODULE_REGISTER(main, LOG_LEVEL_DBG);
 
@@ -59,6 +59,25 @@ static const struct gpio_dt_spec button = GPIO_DT_SPEC_GET(SW0_NODE, gpios);
 #define TEST_SERVER_PORT 8000
 #define SSID "Sikri-1"  // Change to your WiFi SSID
 #define WIFI_PASSWORD "Jeet-1356"  // Change to your WiFi password
+#define BT_READY_TIMEOUT_MS 10000
+#define WIFI_READY_TIMEOUT_MS 35000
+
+/* Bluetooth output using SPBTLE-RF, brought up by the startup orchestrator */
+static const audio_config_t bluetooth_audio_config = {
+    .output_type = AUDIO_OUTPUT_BLUETOOTH,
+    .format = {
+        .sample_rate = 44100,
+        .channels = 2,        // Stereo for better quality
+        .bits_per_sample = 16
+    },
+    .buffer_size_ms = 100
+};
+
+static const struct startup_config startup_config = {
+    .audio = &bluetooth_audio_config,
+    .ssid = SSID,
+    .psk = WIFI_PASSWORD,
+};
 
 /* Simple WAV test data (440Hz sine wave) - ensure 4-byte alignment 
  * This complies with the WAV decoder implementation (for now). 
@@ -91,7 +110,6 @@ static test_state_t current_test_state = TEST_STATE_INIT;
 
 /* Function prototypes */
 static int init_hardware(void);
-static int init_wifi_connection(void);
 static void wait_for_button_press(void);
 static int test_bluetooth_connection(void);
 static int test_audio_playback(void);
@@ -115,14 +133,13 @@ int main(void)
         goto error;
     }
 
-    /* Initialize WiFi connection for HTTP streaming */
-    printk("\n🌐 Setting up WiFi connection...\n");
-    ret = init_wifi_connection();
+    /* WiFi, Bluetooth and the SD card come up in the background; each
+     * test below waits only for the stages it needs */
+    ret = startup_begin(&startup_config);
     if (ret < 0) {
-        LOG_WRN("WiFi initialization failed: %d", ret);
-        printk("⚠ Continuing without WiFi - Bluetooth test only\n");
-    } else {
-        printk("✅ WiFi connection established\n");
+        LOG_ERR("Startup failed: %d", ret);
+        current_test_state = TEST_STATE_ERROR;
+        goto error;
     }
 
     /* Wait for user button press to start tests */
@@ -221,22 +238,21 @@ static int test_http_audio_streaming(void)
 {
     printk("🌐 Testing HTTP → Bluetooth LE audio streaming pipeline...\n");
     
+    /* The stream needs the network; Bluetooth is already up from Test 1 */
+    printk("⏳ Waiting for WiFi...\n");
+    int ret = startup_wait(STARTUP_STAGE_BIT(STARTUP_STAGE_WIFI), K_MSEC(WIFI_READY_TIMEOUT_MS));
+    if (ret < 0) {
+        LOG_ERR("WiFi not available: %d", ret);
+        return ret;
+    }
+    printk("✅ WiFi connection established\n");
+    
     /* First ensure we have a Bluetooth connection (reuse from Test 2) */
     if (!bluetooth_audio_is_connected()) {
         printk("⚠ No Bluetooth device connected - starting fresh connection\n");
         
         /* Re-initialize Bluetooth system if needed */
-        audio_config_t audio_config = {
-            .output_type = AUDIO_OUTPUT_BLUETOOTH,  
-            .format = {
-                .sample_rate = 44100,
-                .channels = 2,        
-                .bits_per_sample = 16
-            },
-            .buffer_size_ms = 100
-        };
-        
-        int ret = audio_system_init(&audio_config);
+        ret = audio_system_init(&bluetooth_audio_config);
         if (ret < 0 && ret != -EALREADY) {
             LOG_ERR("Failed to re-initialize Bluetooth audio system: %d", ret);
             return ret;
@@ -249,7 +265,7 @@ static int test_http_audio_streaming(void)
     
     /* Initialize HTTP audio client */
     printk("📡 Initializing HTTP audio client...\n");
-    int ret = audio_client_init(TEST_SERVER_HOST, TEST_SERVER_PORT);
+    ret = audio_client_init(TEST_SERVER_HOST, TEST_SERVER_PORT);
     if (ret < 0) {
         LOG_ERR("Failed to initialize audio client: %d", ret);
         return ret;
@@ -274,6 +290,14 @@ static int test_http_audio_streaming(void)
         return ret;
     }
     
+    /* The network receive thread streams until the server ends the body */
+    ret = audio_client_wait_stream(K_FOREVER);
+    if (ret < 0) {
+        LOG_ERR("HTTP audio stream failed: %d", ret);
+        audio_client_cleanup();
+        return ret;
+    }
+    
     printk("🎉 HTTP → Bluetooth LE Streaming Test Complete!\n");
     printk("✅ Audio data successfully streamed from HTTP server to Bluetooth\n");
     
@@ -321,106 +345,25 @@ static int init_hardware(void)
      */
 
     error_handler_init();
+    trace_init();
+    mem_plan_report();
 
     LOG_INF("Hardware initialized successfully");
     return 0;
 }
 
-static int init_wifi_connection(void)
-{
-    printk("🌐 Initializing WiFi connection...\n");
-    
-    /* Get the WiFi interface */
-    struct net_if *iface = net_if_get_default();
-    if (!iface) {
-        LOG_ERR("No default network interface found");
-        return -ENODEV;
-    }
-    
-    /* Ensure interface is up */
-    if (!net_if_is_up(iface)) {
-        net_if_up(iface);
-        k_sleep(K_MSEC(1000)); // Wait for interface to come up
-    }
-
-    char ssid[32] = SSID;
-    char password[64] = WIFI_PASSWORD;
-    
-    /* WiFi connection parameters - UPDATE THESE WITH YOUR CREDENTIALS */
-    struct wifi_connect_req_params wifi_params = {
-        .ssid = ssid,      // Replace with your actual WiFi network name
-        .ssid_length = strlen(ssid),
-        .psk = password,     // Replace with your actual WiFi password  
-        .psk_length = strlen(password),
-        .channel = WIFI_CHANNEL_ANY,
-        .security = WIFI_SECURITY_TYPE_PSK,
-        .band = WIFI_FREQ_BAND_2_4_GHZ,
-        .mfp = WIFI_MFP_OPTIONAL
-    };
-    
-    printk("📶 Connecting to WiFi network: %s\n", wifi_params.ssid);
-    
-    /* Connect to WiFi */
-    int ret = net_mgmt(NET_REQUEST_WIFI_CONNECT, iface, &wifi_params, sizeof(wifi_params));
-    if (ret) {
-        LOG_ERR("WiFi connection request failed: %d", ret);
-        return ret;
-    }
-    
-    /* Wait for connection to complete */
-    printk("⏳ Waiting for WiFi connection...\n");
-    
-    /* Check connection status multiple times */
-    for (int attempts = 0; attempts < 30; attempts++) {
-        struct wifi_iface_status status;
-        ret = net_mgmt(NET_REQUEST_WIFI_IFACE_STATUS, iface, &status, sizeof(status));
-        
-        if (ret == 0 && status.state == WIFI_STATE_COMPLETED) {
-            printk("✅ WiFi connected successfully!\n");
-            printk("   • SSID: %.*s\n", status.ssid_len, status.ssid);
-            printk("   • Channel: %d\n", status.channel);
-            printk("   • RSSI: %d dBm\n", status.rssi);
-            
-            /* Wait a bit more for DHCP to complete */
-            printk("⏳ Waiting for DHCP IP assignment...\n");
-            k_sleep(K_MSEC(3000));
-            
-            return 0;
-        }
-        
-        k_sleep(K_MSEC(1000)); // Wait 1 second between checks
-        
-        if (attempts % 5 == 0) {
-            printk("⏳ Still connecting... (attempt %d/30)\n", attempts + 1);
-        }
-    }
-    
-    LOG_ERR("WiFi connection timeout");
-    return -ETIMEDOUT;
-}
-
 static int test_bluetooth_connection(void)
 {
-    printk("🔵 Initializing Bluetooth LE Audio System...\n");
-    
-    /* Configure audio system for Bluetooth output using SPBTLE-RF */
-    audio_config_t audio_config = {
-        .output_type = AUDIO_OUTPUT_BLUETOOTH,  // Use actual Bluetooth hardware
-        .format = {
-            .sample_rate = 44100,
-            .channels = 2,        // Stereo for better quality
-            .bits_per_sample = 16
-        },
-        .buffer_size_ms = 100
-    };
-    
-    int ret = audio_system_init(&audio_config);
+    printk("🔵 Waiting for Bluetooth LE Audio System...\n");
+    
+    /* Brought up by the startup orchestrator, usually done by now */
+    int ret = startup_wait(STARTUP_STAGE_BIT(STARTUP_STAGE_BLUETOOTH), K_MSEC(BT_READY_TIMEOUT_MS));
     if (ret < 0) {
         LOG_ERR("Failed to initialize Bluetooth audio system: %d", ret);
         return ret;
     }
     
-    printk("✅ Bluetooth audio system initialized (SPBTLE-RF module)\n");
+    printk("✅ Bluetooth audio system initialized (SPBTLE-RF module) at %lld ms\n", k_uptime_get());
     printk("📱 Device is now advertising and discoverable!\n");
     printk("\n⏳ Waiting for incoming connections (60 second test window)...\n");
     
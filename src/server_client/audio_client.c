@@ -13,13 +13,23 @@
  */
 
 #include "audio_client.h"
+#include "http_chunked.h"
+#include "http_conn.h"
+#include "stream_frame.h"
 #include "../audio/audiosys.h"
 #include "../audio/wav_decoder.h"
 #include "../audio/audio_buffers.h"
+#include "../audio/pcm_dsp.h"
+#include "../audio/resampler.h"
+#include "../utils/app_threads.h"
 #include "../utils/error_handling.h"
+#include "../utils/metrics.h"
+#include "../utils/trace.h"
 
 #include <zephyr/kernel.h>
 #include <zephyr/net/socket.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
 #include <zephyr/logging/log.h>
 #include <string.h>
 #include <stdio.h>
@@ -29,32 +39,46 @@
 
 LOG_MODULE_REGISTER(audio_client, LOG_LEVEL_INF);
 
-/* Simple memmem implementation if not available */
-static void *simple_memmem(const void *haystack, size_t haystacklen,
-                          const void *needle, size_t needlelen)
-{
-    const char *h = haystack;
-    const char *n = needle;
-    size_t i;
-    
-    if (needlelen > haystacklen) return NULL;
-    
-    for (i = 0; i <= haystacklen - needlelen; i++) {
-        if (memcmp(h + i, n, needlelen) == 0) {
-            return (void *)(h + i);
-        }
-    }
-    return NULL;
-}
-
 /* Enhanced streaming configuration - conservative for STM32L475 memory */
-#define HTTP_RECV_BUFFER_SIZE 128         // Further reduced buffer to 128 bytes
+#define HTTP_RECV_BUFFER_SIZE 128         // Command responses only, streams use NET_RX_BUFFER_SIZE
 #define HTTP_REQUEST_BUFFER_SIZE 256      // Keep HTTP request buffer size
-#define AUDIO_CHUNK_SIZE 64               // Smaller audio processing chunks (was 128)
-#define STREAM_BUFFER_SIZE 256            // Smaller streaming buffer size (was 512)
+#define HTTP_HEADER_BUFFER_SIZE 512      // Response headers may span several receives
+#define HTTP_STREAM_PATH_SIZE 128        // Query string plus AUDIO_CLIENT_TRACK_NAME_MAX
+#define HTTP_RANGE_HEADER_SIZE 40
 #define MAX_HOSTNAME_LEN 32               // Keep hostname length
-#define CONNECTION_TIMEOUT_MS 10000
 #define HTTP_RESPONSE_TIMEOUT_MS 5000
+#define HTTP_RECV_TIMEOUT_MS 500          // Poll timeout, idle time accumulates to the above
+#define AUDIO_WRITE_TIMEOUT_MS 500        // Max wait for output buffer space before re-checking stop
+
+/* Network receive thread */
+#define NET_RX_MIN_RECV 256               // Submit a pool buffer once less than this is free
+#define NET_RX_HEADER_RECV 64             // Receive size until the WAV format is known
+#define NET_RX_STACK_SIZE APP_THREAD_STACK_NET_RX
+#define NET_RX_THREAD_PRIORITY APP_THREAD_PRIO_NET_RX  // Below BLE streaming so the consumer drains first
+#define NET_RX_STOP_TIMEOUT_MS 2000
+#define STREAM_FRAME_CARRY_SIZE 8         // Largest sample frame held back: 32-bit stereo
+#define STREAM_FRAME_PAYLOAD (CONFIG_APP_AUDIO_BUFFER_SIZE / 2)  // PCM per binary frame
+
+/* Output format of a stream; also what MP3/FLAC tracks are transcoded to
+ * on the server, so those need no resampling here */
+#define STREAM_SINK_RATE 44100
+#define STREAM_SINK_CHANNELS 2
+#define STREAM_SINK_BITS 16
+
+/* Periodic metrics report to the server, on the control connection */
+#if defined(CONFIG_APP_METRICS) && CONFIG_APP_METRICS_PUSH_INTERVAL_MS > 0
+#define METRICS_PUSH_ENABLED 1
+#define METRICS_PUSH_PATH "/api/metrics"
+#define METRICS_JSON_SIZE 512             // Longest report is about 460 bytes
+#endif
+
+#if defined(CONFIG_APP_RESAMPLER_QUALITY_HIGH)
+#define STREAM_RESAMPLER_QUALITY RESAMPLER_QUALITY_HIGH
+#elif defined(CONFIG_APP_RESAMPLER_QUALITY_FAST)
+#define STREAM_RESAMPLER_QUALITY RESAMPLER_QUALITY_FAST
+#else
+#define STREAM_RESAMPLER_QUALITY RESAMPLER_QUALITY_BALANCED
+#endif
 
 /* Enhanced client context */
 typedef struct {
@@ -63,16 +87,75 @@ typedef struct {
     int socket_fd;
     audio_client_state_t state;
     bool keep_alive;
+    struct http_conn control;           /* Persistent connection for commands */
     
     /* Streaming audio pipeline */
-    struct wav_decoder decoder;
-    bool decoder_initialized;
+    struct wav_stream_decoder decoder;   /* Parses the header as it streams in */
+    bool decoder_initialized;           /* Format known */
     struct audio_format_info format;
+    char stream_path[HTTP_STREAM_PATH_SIZE];
+    size_t data_start;                  /* File offset of the first PCM byte */
+    size_t stream_offset;               /* File offset of this response's first body byte */
+    bool range_requested;               /* Current request asked for a byte range */
+    bool discontinuity;                 /* Flag the next submitted buffer */
+    struct pcm_dither dither;           /* Requantisation noise for 24/32-bit sources */
+    uint8_t frame_carry[STREAM_FRAME_CARRY_SIZE];  /* Partial frame for the next buffer */
+    size_t frame_carry_len;
+    audio_format_t sink_format;         /* What the audio system was set up for */
+    struct resampler resampler;         /* Source rate to sink rate */
+    
+    /* Track that seeks apply to. A prefetched playlist track replaces the
+     * state above before its header has arrived; this keeps the last one
+     * whose PCM position is known */
+    struct {
+        char path[HTTP_STREAM_PATH_SIZE];
+        size_t index;
+        struct audio_format_info format;
+        struct wav_stream_decoder decoder;
+        size_t data_start;              /* 0 while no track's position is known */
+    } playing;
     
     /* HTTP streaming state */
     bool headers_parsed;
     bool chunked_encoding;
+    char header_buf[HTTP_HEADER_BUFFER_SIZE];
+    size_t header_len;
+    struct http_chunked_decoder chunked;
+    size_t body_bytes;
     
+    /* Binary framed stream, see stream_frame.h */
+    bool framed;                        /* Response is frames rather than a WAV file */
+    uint8_t frame_raw[STREAM_FRAME_HEADER_SIZE];
+    size_t frame_raw_len;
+    struct stream_frame_header frame;   /* Frame whose payload is arriving */
+    size_t frame_remaining;             /* Payload bytes still to come */
+    uint8_t frame_format[STREAM_FRAME_FORMAT_SIZE];
+    uint32_t frame_next_sequence;
+    bool frame_skip;                    /* Late or duplicate frame, drop its payload */
+    bool frame_stamp_pending;           /* Buffer has not taken a frame's sequence yet */
+    bool frame_done;                    /* END_OF_STREAM frame fully received */
+    
+    /* Receive thread control */
+    bool rx_active;
+    atomic_t rx_stop;
+    atomic_t rx_paused;                 /* Leave the socket unread until resumed */
+    bool rx_seek;                       /* Stopping only to restart elsewhere */
+    int rx_result;
+    uint32_t rx_sequence;
+    
+    /* Playlist */
+    char playlist[AUDIO_CLIENT_PLAYLIST_MAX][AUDIO_CLIENT_TRACK_NAME_MAX];
+    size_t playlist_count;
+    size_t playlist_index;              /* Track being received */
+    bool next_track_requested;          /* The following track's request is on the wire */
+    bool connection_reusable;           /* Server agreed to keep the socket open */
+    bool connection_reused;             /* Current request went out on a kept-alive socket */
+    
+#if defined(METRICS_PUSH_ENABLED)
+    struct k_work_delayable metrics_work;
+    struct metrics_snapshot metrics_prev;   /* Last report, for the rates */
+    bool metrics_have_prev;
+#endif
 } audio_client_t;
 
 static audio_client_t client = {
@@ -84,16 +167,70 @@ static audio_client_t client = {
     .chunked_encoding = false
 };
 
+K_THREAD_STACK_DEFINE(net_rx_stack, NET_RX_STACK_SIZE);
+static struct k_thread net_rx_thread_data;
+static K_SEM_DEFINE(net_rx_done, 0, 1);
+static K_SEM_DEFINE(net_rx_resume, 0, 1);
+TRACE_RING_DEFINE(net_rx_trace);
+
 /* Function prototypes */
 static int create_connection(void);
-static int send_http_request(const char *method, const char *path, const char *body);
-static int receive_http_response(char *buffer, size_t buffer_size);
-static int process_audio_stream(void);
+static int send_http_request(const char *method, const char *path, const char *body,
+                             const char *extra_headers);
+static int send_stream_request(const char *extra_headers);
+static void set_stream_track(const char *track_path);
+static int start_track_stream(const char *track_path);
+static int playlist_request_next(bool reuse_connection);
+static int resend_on_new_connection(void);
+static void begin_next_track(void);
+static void stream_mark_playing(void);
+static void spawn_net_rx_thread(void);
+static void reset_http_state(void);
+static int map_command(audio_client_command_t cmd, const char *param,
+                       const char **path, char *body, size_t body_size);
+static int prepare_audio_stream(void);
+static int receive_audio_stream(void);
+static void net_rx_thread(void *p1, void *p2, void *p3);
 static int parse_http_headers(const char *data, size_t len);
-static int process_chunked_data(const uint8_t *data, size_t len);
-static int process_audio_data(const uint8_t *data, size_t len);
+static int accumulate_http_headers(const uint8_t *data, size_t len);
+static int stream_format_ready(void);
+static int process_audio_data(const uint8_t *data, size_t len, void *user_data);
+static int process_framed_data(const uint8_t *data, size_t len, void *user_data);
+static void framed_recv_target(struct audio_buffer *buf, size_t limit,
+                               uint8_t **dst, size_t *len);
+static int submit_stream_buffer(struct audio_buffer **buffer);
+static int submit_end_of_stream(struct audio_buffer **buffer);
+static size_t stream_fill_limit(const struct audio_buffer *buf);
 static void close_connection(void);
 
+#if defined(METRICS_PUSH_ENABLED)
+/**
+ * @brief Report a metrics snapshot to the server and schedule the next one
+ *
+ * The POST is pipelined on the control connection, so a slow server only
+ * delays the next report.
+ */
+static void metrics_push_work(struct k_work *work)
+{
+    static char json[METRICS_JSON_SIZE];
+    struct metrics_snapshot now;
+
+    metrics_snapshot(&now);
+    int len = metrics_to_json(&now, client.metrics_have_prev ? &client.metrics_prev : NULL,
+                              json, sizeof(json));
+    if (len > 0) {
+        int ret = http_conn_send(&client.control, "POST", METRICS_PUSH_PATH, json);
+        if (ret < 0) {
+            LOG_DBG("Metrics push failed: %d", ret);
+        }
+    }
+    client.metrics_prev = now;
+    client.metrics_have_prev = true;
+
+    http_conn_schedule(&client.metrics_work, K_MSEC(CONFIG_APP_METRICS_PUSH_INTERVAL_MS));
+}
+#endif
+
 int audio_client_init(const char *server_host, uint16_t server_port)
 {
     if (!server_host || server_port == 0) {
@@ -112,6 +249,18 @@ int audio_client_init(const char *server_host, uint16_t server_port)
     client.socket_fd = -1;
     client.keep_alive = false;
 
+    /* Commands get their own kept-alive socket, connected in the background */
+    int ret = http_conn_init(&client.control, client.server_host, server_port);
+    if (ret < 0) {
+        return ret;
+    }
+
+#if defined(METRICS_PUSH_ENABLED)
+    k_work_init_delayable(&client.metrics_work, metrics_push_work);
+    client.metrics_have_prev = false;
+    http_conn_schedule(&client.metrics_work, K_MSEC(CONFIG_APP_METRICS_PUSH_INTERVAL_MS));
+#endif
+
     client.state = AUDIO_CLIENT_INITIALIZED;
     
     LOG_INF("Audio client initialized for %s:%u", server_host, server_port);
@@ -143,118 +292,481 @@ int audio_client_send_command(audio_client_command_t cmd, const char *param)
         return -ENOTCONN;
     }
 
+    /* With a playlist loaded, track changes are handled locally */
+    if (client.playlist_count > 0 && cmd == AUDIO_CLIENT_CMD_NEXT) {
+        return audio_client_playlist_next();
+    }
+    if (client.playlist_count > 0 && cmd == AUDIO_CLIENT_CMD_PREV) {
+        return audio_client_playlist_prev();
+    }
+
     const char *path;
     char body[64] = {0};  // Reduced body buffer size
+    int ret = map_command(cmd, param, &path, body, sizeof(body));
+    if (ret < 0) {
+        return ret;
+    }
+
+    LOG_INF("Sending command: POST %s", path);
+
+    /* One round trip on the kept-alive control connection */
+    char response[HTTP_RECV_BUFFER_SIZE];
+    int status = http_conn_request(&client.control, "POST", path,
+                                   strlen(body) > 0 ? body : NULL,
+                                   response, sizeof(response));
+    if (status < 0) {
+        LOG_ERR("Command request failed: %d", status);
+        return status;
+    }
+    if (status < 200 || status >= 300) {
+        LOG_WRN("HTTP error status: %d", status);
+        return -EIO;
+    }
+
+    LOG_DBG("Command response received: %.100s...", response);
+    return 0;
+}
 
-    /* Map commands to HTTP endpoints */
+int audio_client_queue_command(audio_client_command_t cmd, const char *param)
+{
+    if (client.state == AUDIO_CLIENT_DISCONNECTED) {
+        LOG_ERR("Client not connected");
+        return -ENOTCONN;
+    }
+
+    if (client.playlist_count > 0 &&
+        (cmd == AUDIO_CLIENT_CMD_NEXT || cmd == AUDIO_CLIENT_CMD_PREV)) {
+        return audio_client_send_command(cmd, param);
+    }
+
+    const char *path;
+    char body[64] = {0};
+    int ret = map_command(cmd, param, &path, body, sizeof(body));
+    if (ret < 0) {
+        return ret;
+    }
+
+    LOG_INF("Queueing command: POST %s", path);
+    return http_conn_send(&client.control, "POST", path, strlen(body) > 0 ? body : NULL);
+}
+
+/**
+ * @brief Map a command to its HTTP endpoint and JSON body
+ */
+static int map_command(audio_client_command_t cmd, const char *param,
+                       const char **path, char *body, size_t body_size)
+{
     switch (cmd) {
         case AUDIO_CLIENT_CMD_PLAY:
-            path = "/api/play";
+            *path = "/api/play";
             if (param) {
-                snprintf(body, sizeof(body), "{\"track\":\"%s\"}", param);
+                snprintf(body, body_size, "{\"track\":\"%s\"}", param);
             }
             break;
         case AUDIO_CLIENT_CMD_PAUSE:
-            path = "/api/pause";
+            *path = "/api/pause";
             break;
         case AUDIO_CLIENT_CMD_STOP:
-            path = "/api/stop";
+            *path = "/api/stop";
             break;
         case AUDIO_CLIENT_CMD_VOLUME:
-            path = "/api/volume";
+            *path = "/api/volume";
             if (param) {
-                snprintf(body, sizeof(body), "{\"volume\":%s}", param);
+                snprintf(body, body_size, "{\"volume\":%s}", param);
             }
             break;
         case AUDIO_CLIENT_CMD_NEXT:
-            path = "/api/next";
+            *path = "/api/next";
             break;
         case AUDIO_CLIENT_CMD_PREV:
-            path = "/api/prev";
+            *path = "/api/prev";
             break;
         default:
             LOG_ERR("Unknown command: %d", cmd);
             return -EINVAL;
     }
 
-    LOG_INF("Sending command: POST %s", path);
+    return 0;
+}
+
+int audio_client_start_stream(const char *track_path)
+{
+    LOG_INF("=== STARTING AUDIO STREAM DEBUG ===");
+    LOG_INF("Track path: %s", track_path ? track_path : "NULL");
+    LOG_INF("Client state: %d", client.state);
+    
+    if (client.state != AUDIO_CLIENT_CONNECTED) {
+        LOG_ERR("Client not connected");
+        return -ENOTCONN;
+    }
+
+    /* Skip play command for now - go straight to streaming request */
+    LOG_INF("Skipping play command to avoid hanging");
+    
+    /* A single track ends the stream, even if a playlist was loaded */
+    client.playlist_count = 0;
+    client.keep_alive = false;
+    
+    return start_track_stream(track_path);
+}
+
+/**
+ * @brief Point client.stream_path at a track
+ */
+static void set_stream_track(const char *track_path)
+{
+    int len;
+
+#if defined(CONFIG_APP_STREAM_FRAMED)
+    /* Binary frames sized so a couple fill one pool buffer */
+    if (track_path) {
+        len = snprintf(client.stream_path, sizeof(client.stream_path),
+                       "/audio/frames?track=%s&frame_size=%d", track_path, STREAM_FRAME_PAYLOAD);
+    } else {
+        len = snprintf(client.stream_path, sizeof(client.stream_path),
+                       "/audio/frames?frame_size=%d", STREAM_FRAME_PAYLOAD);
+    }
+#else
+    /* Request streaming endpoint with smaller chunk size for embedded client */
+    if (track_path) {
+        len = snprintf(client.stream_path, sizeof(client.stream_path),
+                       "/audio/stream?track=%s&chunk_size=128", track_path);
+    } else {
+        len = snprintf(client.stream_path, sizeof(client.stream_path),
+                       "/audio/stream?chunk_size=128");
+    }
+#endif
 
-    /* Always create a fresh connection for each command to avoid timing issues */
-    LOG_DBG("Creating fresh connection for command...");
-    close_connection();  /* Close any existing connection first */
+    /* Compressed tracks are decoded by the server into the sink format */
+    if (len > 0 && (size_t)len < sizeof(client.stream_path)) {
+        snprintf(&client.stream_path[len], sizeof(client.stream_path) - len,
+                 "&rate=%d&channels=%d&bits=%d",
+                 STREAM_SINK_RATE, STREAM_SINK_CHANNELS, STREAM_SINK_BITS);
+    }
+}
+
+/**
+ * @brief Request a track and start the output and receive thread for it
+ */
+static int start_track_stream(const char *track_path)
+{
+    client.playing.data_start = 0;
+    set_stream_track(track_path);
+    LOG_INF("Starting stream: GET %s", client.stream_path);
     
-    int conn_ret = create_connection();
-    if (conn_ret < 0) {
-        LOG_ERR("Failed to create fresh connection: %d", conn_ret);
-        return conn_ret;
+    int ret = send_stream_request(NULL);
+    if (ret < 0) {
+        return ret;
     }
 
-    LOG_DBG("About to send HTTP request...");
-    /* Send HTTP POST request */
-    int ret = send_http_request("POST", path, strlen(body) > 0 ? body : NULL);
+    LOG_INF("Audio streaming request sent successfully");
+    
+    ret = prepare_audio_stream();
     if (ret < 0) {
-        LOG_ERR("Failed to send HTTP request: %d", ret);
-        
-        /* Try to reconnect once */
-        LOG_INF("Attempting to reconnect...");
-        close_connection();
-        if (create_connection() >= 0) {
-            ret = send_http_request("POST", path, strlen(body) > 0 ? body : NULL);
-        }
-        
-        if (ret < 0) {
-            LOG_ERR("Send request failed after reconnect: %d", ret);
-            return ret;
+        return ret;
+    }
+    
+    spawn_net_rx_thread();
+    
+    LOG_INF("=== STREAM PROCESSING STARTED ON NET RX THREAD ===");
+    return 0;
+}
+
+int audio_client_playlist_set(const char *const *tracks, size_t count)
+{
+    if (count > AUDIO_CLIENT_PLAYLIST_MAX) {
+        return -ENOMEM;
+    }
+    if (count > 0 && !tracks) {
+        return -EINVAL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!tracks[i] || strlen(tracks[i]) >= AUDIO_CLIENT_TRACK_NAME_MAX) {
+            return -EINVAL;
         }
     }
+    
+    /* The receive thread reads these when a track ends - don't change the
+     * list under a running stream */
+    if (client.rx_active) {
+        LOG_WRN("Playlist replaced while streaming, it takes effect on the next play");
+        client.playlist_count = 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        strcpy(client.playlist[i], tracks[i]);
+    }
+    client.playlist_index = 0;
+    client.playlist_count = count;
+    client.keep_alive = (count > 0);
+    
+    LOG_INF("Playlist loaded with %zu tracks", count);
+    return 0;
+}
 
-    LOG_INF("HTTP request sent successfully, waiting for response...");
-    /* Receive and process response */
-    char response[128];  // Reduced response buffer size
+int audio_client_playlist_play(size_t index)
+{
+    if (index >= client.playlist_count) {
+        return -ENOENT;
+    }
+    if (client.state != AUDIO_CLIENT_CONNECTED && client.state != AUDIO_CLIENT_STREAMING) {
+        LOG_ERR("Client not connected");
+        return -ENOTCONN;
+    }
+    
+    /* A stream that already ran to its end has stopped the output */
+    if (client.rx_active && client.state != AUDIO_CLIENT_STREAMING) {
+        audio_client_wait_stream(K_MSEC(NET_RX_STOP_TIMEOUT_MS));
+    }
+    
+    client.keep_alive = true;
+    client.playlist_index = index;
+    LOG_INF("▶️ Playlist track %zu/%zu: %s", index + 1, client.playlist_count,
+            client.playlist[index]);
     
-    /* Add delay to prevent race condition with Flask server */
-    k_sleep(K_MSEC(100));
+    if (!client.rx_active) {
+        return start_track_stream(client.playlist[index]);
+    }
+    
+    /* Switch tracks in the running stream; the output keeps going */
+    client.rx_seek = true;
+    atomic_set(&client.rx_stop, 1);
+    int ret = audio_client_wait_stream(K_MSEC(NET_RX_STOP_TIMEOUT_MS));
+    if (ret == -EAGAIN) {
+        LOG_ERR("Receive thread did not stop in %d ms, aborting it", NET_RX_STOP_TIMEOUT_MS);
+        k_thread_abort(&net_rx_thread_data);
+        client.rx_active = false;
+    }
+    client.rx_seek = false;
+    
+    /* Nothing from the old track may play after the jump */
+    audio_system_flush();
     
-    ret = receive_http_response(response, sizeof(response));
+    /* The old response was cut off mid-body, so the socket can't be reused */
+    close_connection();
+    client.playing.data_start = 0;
+    set_stream_track(client.playlist[index]);
+    ret = send_stream_request(NULL);
     if (ret < 0) {
-        LOG_WRN("Failed to receive response: %d", ret);
+        client.state = AUDIO_CLIENT_CONNECTED;
+        audio_system_stop();
+        client.decoder_initialized = false;
         return ret;
     }
+    
+    begin_next_track();
+    client.discontinuity = true;
+    resampler_reset(&client.resampler);
+    
+    spawn_net_rx_thread();
+    return 0;
+}
+
+int audio_client_playlist_next(void)
+{
+    if (client.playlist_count == 0 || client.playlist_index + 1 >= client.playlist_count) {
+        return -ENOENT;
+    }
+    return audio_client_playlist_play(client.playlist_index + 1);
+}
 
-    LOG_DBG("Command response received: %.100s...", response);
+int audio_client_playlist_prev(void)
+{
+    if (client.playlist_count == 0 || client.playlist_index == 0) {
+        return -ENOENT;
+    }
+    return audio_client_playlist_play(client.playlist_index - 1);
+}
+
+int audio_client_playlist_get_index(void)
+{
+    if (client.playlist_count == 0) {
+        return -ENOENT;
+    }
+    return (int)client.playlist_index;
+}
+
+/**
+ * @brief Request the following playlist track once the current body is in
+ * 
+ * Runs on the receive thread while the end of the current track is still
+ * queued for output, so the connection round trip for the next track is
+ * hidden behind audio that is already buffered.
+ * 
+ * @param reuse_connection The current response ended cleanly and may leave
+ *                         the socket open for the next request
+ * @return 0 if the next track was requested, -ENOENT at the end of the
+ *         playlist, other negative error codes if the request failed
+ */
+static int playlist_request_next(bool reuse_connection)
+{
+    size_t next = client.playlist_index + 1;
     
-    /* Flask server provides better connection handling than BaseHTTPServer */
-    /* Add delay before closing to ensure clean shutdown */
-    k_sleep(K_MSEC(50));
-    close_connection();
+    if (next >= client.playlist_count) {
+        return -ENOENT;
+    }
+    
+    if (!reuse_connection || !client.connection_reusable) {
+        close_connection();
+    }
+    
+    set_stream_track(client.playlist[next]);
+    int ret = send_stream_request(NULL);
+    if (ret < 0) {
+        LOG_ERR("Failed to request playlist track %zu: %d", next + 1, ret);
+        return ret;
+    }
     
+    client.playlist_index = next;
+    LOG_INF("⏭️ Prefetching playlist track %zu/%zu: %s (%s connection)", next + 1,
+            client.playlist_count, client.playlist[next],
+            client.connection_reused ? "kept-alive" : "new");
     return 0;
 }
 
-int audio_client_start_stream(const char *track_path)
+/**
+ * @brief Re-send the current request after a kept-alive socket turned out
+ *        to be closed by the server
+ * 
+ * @return 0 if the request went out on a new connection, negative error
+ *         code if there was nothing to retry or the retry failed
+ */
+static int resend_on_new_connection(void)
 {
-    LOG_INF("=== STARTING AUDIO STREAM DEBUG ===");
-    LOG_INF("Track path: %s", track_path ? track_path : "NULL");
-    LOG_INF("Client state: %d", client.state);
+    if (!client.connection_reused || client.headers_parsed) {
+        return -ENOTCONN;
+    }
     
-    if (client.state != AUDIO_CLIENT_CONNECTED) {
-        LOG_ERR("Client not connected");
+    LOG_WRN("Kept-alive connection was closed by the server, reconnecting");
+    client.connection_reused = false;
+    close_connection();
+    return send_stream_request(NULL);
+}
+
+/**
+ * @brief Forget the previous track's response and WAV header
+ * 
+ * The output, dither and resampler state carry on so the next track's
+ * first sample follows the last one of the previous track directly.
+ */
+static void begin_next_track(void)
+{
+    reset_http_state();
+    client.decoder_initialized = false;
+    wav_stream_init(&client.decoder);
+    client.data_start = 0;
+    client.stream_offset = 0;
+    client.range_requested = false;
+}
+
+/**
+ * @brief Make the track being received the one seeks apply to
+ * 
+ * Called once its first PCM byte's file offset is known.
+ */
+static void stream_mark_playing(void)
+{
+    memcpy(client.playing.path, client.stream_path, sizeof(client.playing.path));
+    client.playing.index = client.playlist_index;
+    client.playing.format = client.format;
+    client.playing.decoder = client.decoder;
+    client.playing.data_start = client.data_start;
+}
+
+int audio_client_seek_ms(uint32_t position_ms)
+{
+    if (!client.rx_active) {
+        LOG_WRN("Not currently streaming");
         return -ENOTCONN;
     }
+    
+    /* Byte offsets are only known once the header has gone past */
+    if (client.playing.data_start == 0) {
+        return -EAGAIN;
+    }
+    
+    const struct audio_format_info *format = &client.playing.format;
+    size_t data_size = client.playing.decoder.data_size;
+    size_t offset = wav_time_to_offset(format, position_ms);
+    if (data_size != WAV_STREAM_SIZE_UNKNOWN && offset > data_size) {
+        offset = data_size;
+        if (format->block_align > 1) {
+            offset -= offset % format->block_align;
+        }
+    }
+    
+    LOG_INF("⏩ Seeking to %u ms (PCM byte %zu)", position_ms, offset);
+    
+    /* Park the receive thread but leave the audio output running */
+    client.rx_seek = true;
+    atomic_set(&client.rx_stop, 1);
+    k_sem_give(&net_rx_resume);
+    int ret = audio_client_wait_stream(K_MSEC(NET_RX_STOP_TIMEOUT_MS));
+    if (ret == -EAGAIN) {
+        LOG_ERR("Receive thread did not stop in %d ms, aborting it", NET_RX_STOP_TIMEOUT_MS);
+        k_thread_abort(&net_rx_thread_data);
+        client.rx_active = false;
+    }
+    client.rx_seek = false;
+    
+    /* Nothing from the old position may play after the jump */
+    audio_system_flush();
+    
+    /* Drop a prefetched next track and go back to the one playing */
+    memcpy(client.stream_path, client.playing.path, sizeof(client.stream_path));
+    client.playlist_index = client.playing.index;
+    client.decoder = client.playing.decoder;
+    client.data_start = client.playing.data_start;
+    bool rate_changed = (client.format.sample_rate != format->sample_rate ||
+                         client.format.channels != format->channels);
+    client.format = *format;
+    if (rate_changed) {
+        stream_format_ready();  /* The prefetched track had set the resampler up */
+    }
+    client.decoder_initialized = true;
+    
+    /* Ask for the rest of the file from the new frame */
+    char range[HTTP_RANGE_HEADER_SIZE];
+    snprintf(range, sizeof(range), "Range: bytes=%zu-\r\n", client.data_start + offset);
+    
+    close_connection();
+    ret = send_stream_request(range);
+    if (ret < 0) {
+        client.state = AUDIO_CLIENT_CONNECTED;
+        audio_system_stop();
+        atomic_clear(&client.rx_paused);
+        client.decoder_initialized = false;
+        client.playing.data_start = 0;
+        return ret;
+    }
+    
+    reset_http_state();
+    client.stream_offset = client.data_start + offset;
+    client.range_requested = true;
+    client.discontinuity = true;
+    resampler_reset(&client.resampler);
+    
+    spawn_net_rx_thread();
+    return 0;
+}
 
-    /* Skip play command for now - go straight to streaming request */
-    LOG_INF("Skipping play command to avoid hanging");
+uint32_t audio_client_get_position_ms(void)
+{
+    size_t received = client.stream_offset + client.body_bytes;
     
-    /* Request streaming endpoint with smaller chunk size for embedded client */
-    char stream_path[64];  // Reduced path buffer size
-    if (track_path) {
-        snprintf(stream_path, sizeof(stream_path), "/audio/stream?track=%s&chunk_size=128", track_path);
-    } else {
-        strcpy(stream_path, "/audio/stream?chunk_size=128");
+    if (!client.decoder_initialized || client.data_start == 0 || received < client.data_start) {
+        return 0;
     }
+    return wav_offset_to_time(&client.format, received - client.data_start);
+}
 
-    LOG_INF("Starting stream: GET %s", stream_path);
-    LOG_INF("Current socket fd: %d", client.socket_fd);
+/**
+ * @brief Send the GET for client.stream_path, reconnecting once on failure
+ */
+static int send_stream_request(const char *extra_headers)
+{
+    /* An open socket may have been closed by the server since it was last
+     * used; resend_on_new_connection() retries the request if so */
+    client.connection_reused = (client.socket_fd >= 0);
     
     /* Ensure we have a connection for streaming */
     if (client.socket_fd < 0) {
@@ -268,14 +780,15 @@ int audio_client_start_stream(const char *track_path)
     }
     
     LOG_INF("Sending HTTP request for streaming...");
-    int ret = send_http_request("GET", stream_path, NULL);
+    int ret = send_http_request("GET", client.stream_path, NULL, extra_headers);
     if (ret < 0) {
         LOG_ERR("Failed to start streaming: %d", ret);
         /* Try to reconnect once for streaming */
         LOG_INF("Attempting to reconnect for streaming...");
         close_connection();
+        client.connection_reused = false;
         if (create_connection() >= 0) {
-            ret = send_http_request("GET", stream_path, NULL);
+            ret = send_http_request("GET", client.stream_path, NULL, extra_headers);
         }
         
         if (ret < 0) {
@@ -283,35 +796,122 @@ int audio_client_start_stream(const char *track_path)
             return ret;
         }
     }
+    
+    return 0;
+}
 
+/**
+ * @brief Hand the socket to the receive thread
+ */
+static void spawn_net_rx_thread(void)
+{
+    /* The receive thread owns the socket until the stream ends or is stopped */
+    atomic_clear(&client.rx_stop);
+    k_sem_reset(&net_rx_done);
+    client.rx_result = 0;
+    client.rx_sequence = 0;
+    client.next_track_requested = false;
+    client.rx_active = true;
     client.state = AUDIO_CLIENT_STREAMING;
-    LOG_INF("Audio streaming request sent successfully");
-    LOG_INF("=== STARTING STREAM PROCESSING ===");
     
-    /* Give server more time to prepare and start sending large file */
-    k_sleep(K_MSEC(200));
-    
-    /* For this simplified version, we'll immediately start processing the stream */
-    return process_audio_stream();
+    k_thread_create(&net_rx_thread_data, net_rx_stack,
+                    K_THREAD_STACK_SIZEOF(net_rx_stack),
+                    net_rx_thread, NULL, NULL, NULL,
+                    NET_RX_THREAD_PRIORITY, 0, K_NO_WAIT);
+    k_thread_name_set(&net_rx_thread_data, "net_rx");
 }
 
-static int process_audio_stream(void)
+int audio_client_wait_stream(k_timeout_t timeout)
 {
-    LOG_INF("=== STARTING ENHANCED AUDIO STREAM PROCESSING ===");
+    if (!client.rx_active) {
+        return client.rx_result;
+    }
     
-    /* Initialize audio system for streaming */
+    if (k_sem_take(&net_rx_done, timeout) != 0) {
+        return -EAGAIN;
+    }
+    
+    k_thread_join(&net_rx_thread_data, K_FOREVER);
+    client.rx_active = false;
+    return client.rx_result;
+}
+
+/**
+ * @brief Receive thread - drains the stream socket into the audio output
+ */
+static void net_rx_thread(void *p1, void *p2, void *p3)
+{
+    int ret;
+    
+    trace_thread_attach(&net_rx_trace);
+    ret = receive_audio_stream();
+    
+    /* Playlist tracks follow on in the same output stream */
+    while (client.next_track_requested) {
+        client.next_track_requested = false;
+        begin_next_track();
+        ret = receive_audio_stream();
+    }
+    
+    /* No further request has taken the socket over, and whatever is left
+     * of the response must not be read as the next one's headers */
+    close_connection();
+    
+    /* Let audio continue playing buffered data unless we were asked to stop */
+    if (client.body_bytes > 0 && !atomic_get(&client.rx_stop)) {
+        LOG_INF("Allowing %d seconds for audio buffer playback...", 2);
+        for (int i = 0; i < 2; ) {
+            audio_state_t audio_state = audio_system_get_state();
+            
+            /* Paused time doesn't count, the tail is still to be played */
+            if (audio_state == AUDIO_STATE_PAUSED && !atomic_get(&client.rx_stop)) {
+                k_sem_take(&net_rx_resume, K_MSEC(1000));
+                continue;
+            }
+            if (audio_state != AUDIO_STATE_PLAYING || atomic_get(&client.rx_stop)) {
+                LOG_INF("Audio finished playing at %d seconds", i);
+                break;
+            }
+            k_sleep(K_MSEC(1000));
+            i++;
+            LOG_INF("Audio still playing... %d/2 seconds", i);
+        }
+    }
+    
+    /* A seek restarts the request and keeps the output and format */
+    if (!client.rx_seek) {
+        audio_system_stop();
+        atomic_clear(&client.rx_paused);
+        client.decoder_initialized = false;
+        
+        /* Every stage has just been through a whole stream - a good time to measure */
+        app_threads_report_stacks();
+    }
+    
+    client.rx_result = ret;
+    client.state = AUDIO_CLIENT_CONNECTED;
+    k_sem_give(&net_rx_done);
+}
+
+static int prepare_audio_stream(void)
+{
+    LOG_INF("=== STARTING ENHANCED AUDIO STREAM PROCESSING ===");
+    
+    /* Initialize audio system for streaming */
     audio_config_t audio_config = {
         .output_type = AUDIO_OUTPUT_BLUETOOTH,  // Changed from BUZZER to BLUETOOTH
         .format = {
-            .sample_rate = 44100,
-            .channels = 2,                      // Changed from 1 to 2 for stereo Bluetooth
-            .bits_per_sample = 16
+            .sample_rate = STREAM_SINK_RATE,
+            .channels = STREAM_SINK_CHANNELS,   // Stereo Bluetooth
+            .bits_per_sample = STREAM_SINK_BITS
         },
-        .buffer_size_ms = 100
+        .buffer_size_ms = 100,
+        .mirror_outputs = IS_ENABLED(CONFIG_APP_AUDIO_MIRROR_PWM) ? BIT(AUDIO_OUTPUT_BUZZER) : 0
     };
 
     LOG_INF("Initializing audio system...");
     /* Try to initialize audio system, but don't fail if already initialized */
+    client.sink_format = audio_config.format;
     int ret = audio_system_init(&audio_config);
     if (ret < 0 && ret != -EALREADY) {
         handle_error(ERROR_CODE_AUDIO_INIT_FAILED, ERROR_SEVERITY_ERROR,
@@ -341,355 +941,264 @@ static int process_audio_stream(void)
 
     LOG_INF("Resetting streaming state...");
     /* Reset streaming state */
+    begin_next_track();
+    client.discontinuity = false;
+    memset(&client.resampler, 0, sizeof(client.resampler));
+    pcm_dither_init(&client.dither, k_cycle_get_32());
+    
+    return 0;
+}
+
+/**
+ * @brief Forget the previous response before reading a new one
+ */
+static void reset_http_state(void)
+{
     client.headers_parsed = false;
     client.chunked_encoding = false;
-    client.decoder_initialized = false;
-    
-    uint8_t stream_buffer[HTTP_RECV_BUFFER_SIZE];
-    uint8_t *data_start = stream_buffer;
-    size_t data_len = 0;
+    client.header_len = 0;
+    client.body_bytes = 0;
+    client.frame_carry_len = 0;
+    http_chunked_init(&client.chunked);
+    client.framed = false;
+    client.frame_raw_len = 0;
+    client.frame_remaining = 0;
+    client.frame_next_sequence = 0;
+    client.frame_skip = false;
+    client.frame_done = false;
+}
+
+static int receive_audio_stream(void)
+{
+    struct zsock_pollfd pfd = {
+        .fd = client.socket_fd,
+        .events = ZSOCK_POLLIN
+    };
+    struct audio_buffer *buf = NULL;
     int total_bytes = 0;
-    int audio_chunks_processed = 0;
-    
-    /* Process stream for up to 10 seconds for small files like sine.wav */
-    int64_t start_time = k_uptime_get();
-    int64_t stream_duration = 10000; // Reduced from 30 seconds to 10 seconds for small files
+    int idle_ms = 0;
+    bool body_complete = false;
+    int ret = 0;
     
     LOG_INF("=== STARTING HTTP STREAMING LOOP ===");
     LOG_INF("Socket fd: %d", client.socket_fd);
-    LOG_INF("Stream duration limit: %lld ms", stream_duration);
-    LOG_INF("Buffer size: %d bytes", HTTP_RECV_BUFFER_SIZE);
-    LOG_INF("Audio streaming pipeline active - processing HTTP chunks...");
-    
-    /* Wait for initial HTTP response headers first */
-    bool initial_data_received = false;
-    int header_wait_attempts = 0;
-    const int max_header_wait = 50; // Reduced wait time for small files
     
-    LOG_INF("Waiting for initial HTTP response...");
-    
-    while (!initial_data_received && header_wait_attempts < max_header_wait) {
-        /* Try to receive initial data with short timeout */
-        int bytes_received = recv(client.socket_fd, stream_buffer, sizeof(stream_buffer), MSG_DONTWAIT);
+    while (!body_complete && !atomic_get(&client.rx_stop)) {
+        /* Paused: nothing is read, so the TCP window holds the server off
+         * and the connection stays open for the resume */
+        if (atomic_get(&client.rx_paused)) {
+            k_sem_take(&net_rx_resume, K_MSEC(HTTP_RECV_TIMEOUT_MS));
+            idle_ms = 0;
+            continue;
+        }
         
-        if (bytes_received > 0) {
-            LOG_INF("Received HTTP response: %d bytes", bytes_received);
-            
-            /* For demo mode, just show simple status instead of hex dump */
-            LOG_INF("📡 Processing HTTP headers and audio data...");
-            
-            /* Special handling for small files like sine.wav */
-            /* Check if we have a complete HTTP response with WAV data */
-            const char *wav_start = (const char *)simple_memmem(stream_buffer, bytes_received, "RIFF", 4);
-            if (wav_start != NULL) {
-                size_t header_offset = wav_start - (char *)stream_buffer;
-                size_t wav_size = bytes_received - header_offset;
-                
-                LOG_INF("🎵 Found RIFF WAV header at offset %zu, WAV data size: %zu bytes", 
-                       header_offset, wav_size);
-                
-                /* Show first few bytes of WAV data for verification */
-                char wav_hex[50];
-                int hex_pos = 0;
-                for (int i = 0; i < 8 && hex_pos < 40; i++) {
-                    hex_pos += snprintf(wav_hex + hex_pos, sizeof(wav_hex) - hex_pos, 
-                                      "%02x ", (uint8_t)wav_start[i]);
-                }
-                LOG_INF("WAV data starts with: %s", wav_hex);
-                
-                /* Process the WAV data directly to Bluetooth */
-                int written = audio_system_write((uint8_t *)wav_start, wav_size);
-                if (written > 0) {
-                    LOG_INF("✅ Successfully wrote %d bytes of sine.wav data to Bluetooth!", written);
-                    printk("🎵 SINE WAVE DATA STREAMED: %d bytes from HTTP → Bluetooth LE\n", written);
-                    audio_chunks_processed = 1;
-                } else {
-                    LOG_ERR("❌ Failed to write WAV data to Bluetooth: %d", written);
-                }
-                
-                /* For small files, this is likely all we need */
-                LOG_INF("Small WAV file processing complete - Test 3 SUCCESS!");
-                total_bytes = bytes_received;
-                break; /* Exit the loop successfully */
-            } else {
-                LOG_INF("No RIFF header found in first 128 bytes - HTTP headers only");
-                LOG_INF("WAV data should be in next receive - continuing to main loop");
-                
-                /* The WAV data will come in the main streaming loop */
-                /* Don't break here - let it continue to the main loop to receive more data */
+        /* A free pool buffer is the receive credit - waiting here while the
+         * BLE sender still holds them all is what paces the socket */
+        if (!buf) {
+            buf = audio_buffer_alloc(K_MSEC(AUDIO_WRITE_TIMEOUT_MS));
+            if (!buf) {
+                continue;
             }
             
-            initial_data_received = true;
-            total_bytes += bytes_received;
-            data_len = bytes_received;
-            data_start = stream_buffer;
-            
-            /* Parse HTTP headers */
-            ret = parse_http_headers((char*)stream_buffer, bytes_received);
+            /* The partial sample frame the last buffer ended on goes first */
+            memcpy(buf->data, client.frame_carry, client.frame_carry_len);
+            buf->used = client.frame_carry_len;
+            client.frame_carry_len = 0;
+            client.frame_stamp_pending = true;
+        }
+        
+        /* Sleep in the network stack until data arrives instead of polling */
+        ret = zsock_poll(&pfd, 1, HTTP_RECV_TIMEOUT_MS);
+        if (ret < 0) {
+            LOG_ERR("Stream poll error (errno: %d)", errno);
+            ret = -errno;
+            break;
+        }
+        if (ret == 0) {
+            /* Don't sit on a partly filled buffer while the server is quiet */
+            ret = submit_stream_buffer(&buf);
             if (ret < 0) {
-                LOG_ERR("Failed to parse HTTP headers");
                 break;
             }
-            if (ret > 0) {
-                /* Headers parsed, adjust data pointer */
-                data_start = stream_buffer + ret;
-                data_len = bytes_received - ret;
-                client.headers_parsed = true;
-                LOG_INF("HTTP headers parsed, body starts at %d bytes, remaining data: %zu bytes", ret, data_len);
-                
-                /* Debug: Show what's after headers */
-                if (data_len > 0) {
-                    char hex_debug[100];
-                    int hex_pos = 0;
-                    int debug_bytes = (data_len < 16 ? data_len : 16);
-                    for (int i = 0; i < debug_bytes && hex_pos < 80; i++) {
-                        hex_pos += snprintf(hex_debug + hex_pos, sizeof(hex_debug) - hex_pos, 
-                                          "%02x ", data_start[i]);
-                    }
-                    LOG_DBG("Audio data after headers (first %d bytes): %s", debug_bytes, hex_debug);
-                }
-                
-                /* Process first chunk of audio data if available */
-                if (data_len > 0) {
-                    LOG_INF("Processing first chunk with %zu bytes", data_len);
-                    if (client.chunked_encoding) {
-                        ret = process_chunked_data(data_start, data_len);
-                    } else {
-                        ret = process_audio_data(data_start, data_len);
-                    }
-                    if (ret > 0) {
-                        audio_chunks_processed++;
-                        LOG_INF("Processed first audio chunk successfully");
-                    }
-                }
-                
-                /* For small files like sine.wav, check if we got everything in first receive */
-                if (bytes_received < sizeof(stream_buffer)) {
-                    LOG_INF("Small response received (%d bytes), likely complete file", bytes_received);
-                    
-                    /* Try to receive one more time to check if server closes connection */
-                    k_sleep(K_MSEC(100)); // Brief wait
-                    int extra_bytes = recv(client.socket_fd, stream_buffer, sizeof(stream_buffer), MSG_DONTWAIT);
-                    
-                    if (extra_bytes <= 0) {
-                        LOG_INF("No additional data - file transfer complete");
-                        break; /* Exit the header waiting loop - file is complete */
-                    } else {
-                        LOG_INF("Received %d additional bytes", extra_bytes);
-                        /* Continue processing if more data arrived */
-                    }
-                }
+            
+            idle_ms += HTTP_RECV_TIMEOUT_MS;
+            if (idle_ms >= HTTP_RESPONSE_TIMEOUT_MS) {
+                LOG_WRN("No data from server for %d ms, giving up", idle_ms);
+                ret = (client.body_bytes > 0) ? 0 : -ETIMEDOUT;
+                break;
             }
-        } else if (bytes_received == 0) {
-            LOG_WRN("Server closed connection before sending data");
-            break; /* Server closed - no data coming */
-        } else {
-            /* No data yet, wait a bit */
-            header_wait_attempts++;
-            k_sleep(K_MSEC(100)); // Wait 100ms for server to start sending
+            continue;
         }
-    }
-    
-    if (!initial_data_received) {
-        LOG_ERR("No streaming data received from server after %d attempts", max_header_wait);
-        /* Stop audio system */
-        audio_system_stop();
         
-        /* Cleanup decoder if initialized */
-        if (client.decoder_initialized) {
-            wav_decoder_cleanup(&client.decoder);
-            client.decoder_initialized = false;
+        /* Receive straight into the free tail of the pool buffer, leaving
+         * room for the output to grow if it gets resampled up */
+        size_t limit = stream_fill_limit(buf);
+        if (buf->used >= limit) {
+            ret = submit_stream_buffer(&buf);
+            if (ret < 0) {
+                break;
+            }
+            continue;
         }
-        
-        /* Note: Keep audio system alive for continued Bluetooth connectivity */
-        LOG_INF("Enhanced audio stream processing completed: 0 chunks, 0 bytes total (no data received)");
-        return -ETIMEDOUT;
-    }
-    
-    LOG_INF("Starting main streaming loop...");
-    
-    /* Extended duration for complete file processing */
-    stream_duration = 60000; // Increase to 60 seconds for complete file transfer
-    
-    while ((k_uptime_get() - start_time) < stream_duration) {
-        /* Use shorter timeout for small files */
-        struct timeval timeout = {.tv_sec = 0, .tv_usec = 500000}; // 500ms timeout for small files
-        setsockopt(client.socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-        
-        int bytes_received = recv(client.socket_fd, stream_buffer, sizeof(stream_buffer), 0);
+        uint8_t *raw = &buf->data[buf->used];
+        size_t want = limit - buf->used;
+
+        /* Frames are read header by header and payload by payload, so
+         * nothing needs to be parsed or moved once it has arrived */
+        if (client.framed && !client.chunked_encoding) {
+            framed_recv_target(buf, limit, &raw, &want);
+        }
+        int bytes_received = recv(client.socket_fd, raw, want, 0);
         
         if (bytes_received > 0) {
-            total_bytes += bytes_received;
-            data_len = bytes_received;
-            data_start = stream_buffer;
+            const uint8_t *body = raw;
+            size_t body_len = bytes_received;
             
-            LOG_DBG("Main loop: received %d bytes (total: %d)", bytes_received, total_bytes);
-            
-            /* Check if this chunk contains RIFF WAV data */
-            const char *wav_start = (const char *)simple_memmem(stream_buffer, bytes_received, "RIFF", 4);
-            if (wav_start != NULL) {
-                size_t header_offset = wav_start - (char *)stream_buffer;
-                
-                /* For our known sine.wav file, we know it's exactly 60 bytes */
-                /* This avoids HTTP chunked encoding corruption issues */
-                size_t expected_wav_size = 60;
-                size_t available_data = bytes_received - header_offset;
-                size_t wav_size = (expected_wav_size <= available_data) ? expected_wav_size : available_data;
-                
-                LOG_INF("🎵 FOUND RIFF WAV DATA! Offset: %zu, Sending: %zu bytes (expected sine.wav)", 
-                       header_offset, wav_size);
-                
-                /* Show first few bytes of WAV for verification */
-                char wav_hex[50];
-                int hex_pos = 0;
-                for (int i = 0; i < 8 && hex_pos < 40; i++) {
-                    hex_pos += snprintf(wav_hex + hex_pos, sizeof(wav_hex) - hex_pos, 
-                                      "%02x ", (uint8_t)wav_start[i]);
-                }
-                LOG_INF("WAV data: %s", wav_hex);
-                
-                /* Send exact WAV data to Bluetooth (no HTTP artifacts) */
-                int written = audio_system_write((uint8_t *)wav_start, wav_size);
-                if (written > 0) {
-                    LOG_INF("✅ SUCCESS! Streamed %d bytes: HTTP → Bluetooth LE!", written);
-                    printk("🎵 HTTP → BLUETOOTH SUCCESS: %d bytes of sine.wav!\n", written);
-                    audio_chunks_processed = 1;
-                    break; /* Mission accomplished! */
-                } else {
-                    LOG_ERR("Failed to write WAV to Bluetooth: %d", written);
-                }
-            }
+            total_bytes += bytes_received;
+            idle_ms = 0;
+            metrics_add(METRICS_RX_BYTES, bytes_received);
             
-            /* Parse HTTP headers first if not done */
+            /* Headers may arrive split across receives - collect them first */
             if (!client.headers_parsed) {
-                ret = parse_http_headers((char*)stream_buffer, bytes_received);
+                ret = accumulate_http_headers(raw, bytes_received);
                 if (ret < 0) {
-                    LOG_ERR("Failed to parse HTTP headers");
+                    LOG_ERR("Failed to parse HTTP headers: %d", ret);
                     break;
                 }
-                if (ret > 0) {
-                    /* Headers parsed, adjust data pointer */
-                    data_start = stream_buffer + ret;
-                    data_len = bytes_received - ret;
-                    client.headers_parsed = true;
-                    LOG_INF("HTTP headers parsed, starting audio data processing");
+                if (ret == 0) {
+                    continue; /* Need more header bytes */
                 }
+                body += ret;
+                body_len -= ret;
+                LOG_INF("HTTP headers parsed, %zu body bytes in first receive", body_len);
             }
             
-            /* Process audio data (headers should already be parsed from initial receive) */
-            if (client.headers_parsed && data_len > 0) {
-                if (client.chunked_encoding) {
-                    ret = process_chunked_data(data_start, data_len);
-                } else {
-                    ret = process_audio_data(data_start, data_len);
-                }
-                
-                if (ret > 0) {
-                    audio_chunks_processed++;
-                    
-                    /* Progress logging every 5 chunks for small files */
-                    if (audio_chunks_processed % 5 == 1) {
-                        printk("🎵 AUDIO STREAMING: Processing chunk %d (%d total bytes)\n", 
-                               audio_chunks_processed, total_bytes);
-                        
-                        /* Check audio system health */
-                        audio_state_t audio_state = audio_system_get_state();
-                        if (audio_state == AUDIO_STATE_ERROR) {
-                            LOG_ERR("Audio system error detected");
-                            break;
-                        }
-                    }
-                }
+            if (body_len == 0) {
+                continue;
             }
             
-            
-            /* Add longer delay for WiFi buffer recovery */
-            k_sleep(K_MSEC(50));  // Increased from 5ms to 50ms
-            
-        } else if (bytes_received == 0) {
-            LOG_INF("Stream ended by server - received %d total bytes", total_bytes);
-            /* For small files like sine.wav, this is normal - server finished streaming */
-            if (total_bytes > 50) { // If we received reasonable amount of data
-                LOG_INF("Small file transfer completed successfully");
-                break;
+            /* Strip the framing in place; payload stays in the pool buffer */
+            http_chunked_sink_t sink = client.framed ? process_framed_data : process_audio_data;
+            if (client.chunked_encoding) {
+                ret = http_chunked_feed(&client.chunked, body, body_len, sink, buf);
+                body_complete = http_chunked_is_done(&client.chunked);
             } else {
-                LOG_WRN("Very little data received, may be connection issue");
+                ret = sink(body, body_len, buf);
+            }
+            if (client.framed && client.frame_done) {
+                body_complete = true;
+            }
+            
+            if (ret < 0) {
+                LOG_ERR("Failed to process audio stream data: %d", ret);
                 break;
             }
-        } else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ETIMEDOUT) {
-            /* Timeout or no data - for small files this is expected */
-            LOG_DBG("Socket timeout (errno: %d), may indicate end of small file", errno);
+            ret = 0;
             
-            /* If we've processed some audio chunks and hit timeout, file may be complete */
-            if (audio_chunks_processed > 0) {
-                LOG_INF("Timeout after processing %d chunks - small file likely complete", 
-                       audio_chunks_processed);
+            /* Hand the buffer on once too little room is left for a useful recv */
+            limit = stream_fill_limit(buf);
+            if (buf->used + MAX(MIN(NET_RX_MIN_RECV, limit / 4), 1) > limit) {
+                ret = submit_stream_buffer(&buf);
+                if (ret < 0) {
+                    break;
+                }
+            }
+            
+            /* Check audio system health */
+            if (audio_system_get_state() == AUDIO_STATE_ERROR) {
+                LOG_ERR("Audio system error detected");
+                ret = -EIO;
                 break;
             }
             
+        } else if (bytes_received == 0) {
+            if (resend_on_new_connection() == 0) {
+                pfd.fd = client.socket_fd;
+                continue;
+            }
+            if (client.chunked_encoding && !http_chunked_is_done(&client.chunked)) {
+                LOG_WRN("Server closed connection mid-body after %zu audio bytes",
+                        client.body_bytes);
+            } else {
+                LOG_INF("Stream ended by server - received %d total bytes", total_bytes);
+            }
+            ret = 0;
+            break;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
             continue;
         } else {
+            if (resend_on_new_connection() == 0) {
+                pfd.fd = client.socket_fd;
+                continue;
+            }
             LOG_ERR("Stream receive error: %d (errno: %d)", bytes_received, errno);
-            handle_error(ERROR_CODE_NETWORK_ERROR, ERROR_SEVERITY_WARNING,
-                        "Network receive error during streaming", __FILE__, __LINE__);
+            REPORT_WARNING_ASYNC(ERROR_CODE_NETWORK_ERROR,
+                                 "Network receive error during streaming");
+            ret = -errno;
             break;
         }
     }
     
-    LOG_INF("Stream receive completed. Letting audio play buffered data...");
+    /* Ask for the next playlist track before this one's tail goes out */
+    if (ret == 0 && !atomic_get(&client.rx_stop)) {
+        client.next_track_requested = (playlist_request_next(body_complete) == 0);
+    }
     
-    /* Let audio continue playing buffered data for a shorter time for small files */
-    if (audio_chunks_processed > 0) {
-        LOG_INF("Allowing %d seconds for small audio buffer playback...", 2);
-        for (int i = 0; i < 2; i++) {
-            audio_state_t audio_state = audio_system_get_state();
-            if (audio_state != AUDIO_STATE_PLAYING) {
-                LOG_INF("Audio finished playing at %d seconds", i);
-                break;
-            }
-            k_sleep(K_MSEC(1000));
-            LOG_INF("Audio still playing... %d/2 seconds", i + 1);
-        }
+    /* Flush the tail of the stream, or give the buffer back if we're bailing out.
+     * Between playlist tracks the tail is not the end of the output stream */
+    if (ret == 0 && !atomic_get(&client.rx_stop)) {
+        ret = client.next_track_requested ? submit_stream_buffer(&buf)
+                                          : submit_end_of_stream(&buf);
+    }
+    if (buf) {
+        audio_buffer_free(buf);
+    }
+    if (ret < 0) {
+        client.next_track_requested = false;
     }
     
-    /* Stop audio system */
-    audio_system_stop();
+    if (ret == -ECANCELED || atomic_get(&client.rx_stop)) {
+        LOG_INF("Stream stopped by request after %zu audio bytes", client.body_bytes);
+        ret = 0;
+    }
     
-    /* Cleanup decoder if initialized */
-    if (client.decoder_initialized) {
-        wav_decoder_cleanup(&client.decoder);
-        client.decoder_initialized = false;
+    if (body_complete) {
+        LOG_INF("🎵 Chunked audio body complete: %zu bytes", client.body_bytes);
     }
     
     /* Note: Keep audio system alive for continued Bluetooth connectivity */
-    LOG_INF("Enhanced audio stream processing completed: %d chunks, %d bytes total", 
-           audio_chunks_processed, total_bytes);
+    LOG_INF("Enhanced audio stream processing completed: %zu audio bytes, %d bytes total", 
+           client.body_bytes, total_bytes);
     
-    return 0;
+    return ret;
 }
 
 int audio_client_stop_stream(void)
 {
-    if (client.state != AUDIO_CLIENT_STREAMING) {
+    if (!client.rx_active) {
         LOG_WRN("Not currently streaming");
         return 0;
     }
 
     LOG_INF("Stopping audio stream...");
     
-    /* Stop audio system if running */
-    audio_state_t audio_state = audio_system_get_state();
-    if (audio_state == AUDIO_STATE_PLAYING) {
+    /* The receive thread stops the audio system and releases the decoder */
+    atomic_set(&client.rx_stop, 1);
+    k_sem_give(&net_rx_resume);
+    int ret = audio_client_wait_stream(K_MSEC(NET_RX_STOP_TIMEOUT_MS));
+    if (ret == -EAGAIN) {
+        LOG_ERR("Receive thread did not stop in %d ms, aborting it", NET_RX_STOP_TIMEOUT_MS);
+        k_thread_abort(&net_rx_thread_data);
+        client.rx_active = false;
         audio_system_stop();
-    }
-    
-    /* Cleanup decoder if initialized */
-    if (client.decoder_initialized) {
-        wav_decoder_cleanup(&client.decoder);
         client.decoder_initialized = false;
     }
     
+    /* The thread closes the socket on its way out, unless it was aborted */
+    close_connection();
+    
     /* Reset streaming state */
+    atomic_clear(&client.rx_paused);
     client.headers_parsed = false;
     client.chunked_encoding = false;
 
@@ -698,6 +1207,41 @@ int audio_client_stop_stream(void)
     return 0;
 }
 
+int audio_client_pause_stream(void)
+{
+    if (!client.rx_active) {
+        LOG_WRN("Not currently streaming");
+        return -ENOTCONN;
+    }
+    
+    int ret = audio_system_pause();
+    if (ret < 0) {
+        return ret;
+    }
+    
+    atomic_set(&client.rx_paused, 1);
+    LOG_INF("⏸️  Stream paused, connection kept open");
+    return 0;
+}
+
+int audio_client_resume_stream(void)
+{
+    if (!client.rx_active) {
+        LOG_WRN("Not currently streaming");
+        return -ENOTCONN;
+    }
+    
+    int ret = audio_system_resume();
+    if (ret < 0) {
+        return ret;
+    }
+    
+    atomic_clear(&client.rx_paused);
+    k_sem_give(&net_rx_resume);
+    LOG_INF("▶️  Stream resumed");
+    return 0;
+}
+
 audio_client_state_t audio_client_get_state(void)
 {
     return client.state;
@@ -705,6 +1249,9 @@ audio_client_state_t audio_client_get_state(void)
 
 int audio_client_disconnect(void)
 {
+    if (client.rx_active) {
+        audio_client_stop_stream();
+    }
     close_connection();
     client.state = AUDIO_CLIENT_INITIALIZED;
     LOG_INF("Audio client disconnected");
@@ -713,7 +1260,18 @@ int audio_client_disconnect(void)
 
 void audio_client_cleanup(void)
 {
+    if (client.rx_active) {
+        audio_client_stop_stream();
+    }
     close_connection();
+    if (client.state != AUDIO_CLIENT_DISCONNECTED) {
+#if defined(METRICS_PUSH_ENABLED)
+        struct k_work_sync sync;
+
+        k_work_cancel_delayable_sync(&client.metrics_work, &sync);
+#endif
+        http_conn_close(&client.control);
+    }
     client.state = AUDIO_CLIENT_DISCONNECTED;
     LOG_INF("Audio client cleaned up");
 }
@@ -722,66 +1280,20 @@ void audio_client_cleanup(void)
 
 static int create_connection(void)
 {
-    struct sockaddr_in server_addr;
-    int ret;
-
     /* Close any existing connection */
     close_connection();
 
-    LOG_DBG("Creating new socket...");
-    /* Create socket */
-    client.socket_fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (client.socket_fd < 0) {
-        LOG_ERR("Failed to create socket: %d", errno);
-        return -errno;
-    }
-
-    /* Enable socket reuse */
-    int reuse = 1;
-    setsockopt(client.socket_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
-
-    /* Optimize socket buffers for streaming */
-    int recv_buf_size = 2048;
-    setsockopt(client.socket_fd, SOL_SOCKET, SO_RCVBUF, &recv_buf_size, sizeof(recv_buf_size));
-    
-    /* Set socket timeouts to prevent hanging */
-    struct timeval timeout = {.tv_sec = 5, .tv_usec = 0};
-    setsockopt(client.socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-    setsockopt(client.socket_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
-    
-    /* Keep socket blocking for large transfers */
-    LOG_DBG("Socket configured for streaming with timeouts");
-
-    LOG_DBG("Setting up server address %s:%u", client.server_host, client.server_port);
-    /* Setup server address */
-    memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(client.server_port);
-    
-    ret = zsock_inet_pton(AF_INET, client.server_host, &server_addr.sin_addr);
-    if (ret != 1) {
-        LOG_ERR("Invalid server address: %s", client.server_host);
-        close(client.socket_fd);
-        client.socket_fd = -1;
-        return -EINVAL;
-    }
-
-    LOG_DBG("Connecting to server...");
-    /* Connect to server */
-    ret = connect(client.socket_fd, (struct sockaddr *)&server_addr, sizeof(server_addr));
-    if (ret < 0) {
-        LOG_ERR("Failed to connect to %s:%u: %d", 
-               client.server_host, client.server_port, errno);
-        close(client.socket_fd);
-        client.socket_fd = -1;
-        return -errno;
+    int fd = http_conn_open_socket(client.server_host, client.server_port);
+    if (fd < 0) {
+        return fd;
     }
 
-    LOG_INF("Connected to %s:%u", client.server_host, client.server_port);
+    client.socket_fd = fd;
     return 0;
 }
 
-static int send_http_request(const char *method, const char *path, const char *body)
+static int send_http_request(const char *method, const char *path, const char *body,
+                             const char *extra_headers)
 {
     char request[HTTP_REQUEST_BUFFER_SIZE];
     int len;
@@ -793,6 +1305,12 @@ static int send_http_request(const char *method, const char *path, const char *b
 
     LOG_DBG("Building HTTP %s request for %s", method, path);
     
+    if (!extra_headers) {
+        extra_headers = "";
+    }
+    
+    const char *connection = client.keep_alive ? "keep-alive" : "close";
+    
     /* Build HTTP request */
     if (body) {
         len = snprintf(request, sizeof(request),
@@ -800,18 +1318,20 @@ static int send_http_request(const char *method, const char *path, const char *b
             "Host: %s:%u\r\n"
             "Content-Type: application/json\r\n"
             "Content-Length: %d\r\n"
-            "Connection: close\r\n"
+            "Connection: %s\r\n"
+            "%s"
             "\r\n"
             "%s",
             method, path, client.server_host, client.server_port,
-            (int)strlen(body), body);
+            (int)strlen(body), connection, extra_headers, body);
     } else {
         len = snprintf(request, sizeof(request),
             "%s %s HTTP/1.1\r\n"
             "Host: %s:%u\r\n"
-            "Connection: close\r\n"
+            "Connection: %s\r\n"
+            "%s"
             "\r\n",
-            method, path, client.server_host, client.server_port);
+            method, path, client.server_host, client.server_port, connection, extra_headers);
     }
 
     if (len >= (int)sizeof(request)) {
@@ -835,104 +1355,6 @@ static int send_http_request(const char *method, const char *path, const char *b
     return 0;
 }
 
-static int receive_http_response(char *buffer, size_t buffer_size)
-{
-    if (client.socket_fd < 0) {
-        LOG_ERR("No connection available");
-        return -ENOTCONN;
-    }
-
-    LOG_INF("Waiting for HTTP response on socket %d...", client.socket_fd);
-    
-    int total_received = 0;
-    int attempts = 0;
-    const int max_attempts = 10;
-    
-    /* Try immediate read first - Flask might respond quickly */
-    int received = recv(client.socket_fd, buffer, buffer_size - 1, MSG_DONTWAIT);
-    
-    if (received > 0) {
-        buffer[received] = '\0';
-        total_received = received;
-        LOG_INF("Received immediate HTTP response: %d bytes", received);
-        LOG_DBG("Response: %.100s", buffer);
-    } else if (received == 0) {
-        /* Connection closed immediately - Flask sent response and closed */
-        LOG_INF("Server closed connection immediately (Flask sent response)");
-        strcpy(buffer, "HTTP/1.1 200 OK\r\n\r\n{\"status\":\"ok\"}");
-        total_received = strlen(buffer);
-    } else {
-        /* No immediate data, try with delays */
-        LOG_DBG("No immediate response, errno: %d, trying with delays...", errno);
-        
-        while (attempts < max_attempts && total_received == 0) {
-            attempts++;
-            
-            /* Wait a bit for Flask server to send response */
-            k_sleep(K_MSEC(20));
-            
-            /* Try to receive data */
-            received = recv(client.socket_fd, buffer, buffer_size - 1, MSG_DONTWAIT);
-            
-            if (received > 0) {
-                buffer[received] = '\0';
-                total_received = received;
-                LOG_INF("Received delayed HTTP response: %d bytes (attempt %d)", received, attempts);
-                LOG_DBG("Response: %.100s", buffer);
-                break;
-            } else if (received == 0) {
-                /* Connection closed by server */
-                LOG_INF("Server closed connection (attempt %d)", attempts);
-                if (attempts >= 2) {
-                    /* Assume Flask sent response before closing */
-                    strcpy(buffer, "HTTP/1.1 200 OK\r\n\r\n{\"status\":\"ok\"}");
-                    total_received = strlen(buffer);
-                    break;
-                }
-            } else {
-                /* recv() returned error */
-                if (errno != EAGAIN && errno != EWOULDBLOCK) {
-                    LOG_ERR("recv() error: %d (errno: %d)", received, errno);
-                    return -EIO;
-                }
-                LOG_DBG("No data yet, attempt %d/%d (errno: %d)", attempts, max_attempts, errno);
-            }
-        }
-    }
-    
-    if (total_received == 0) {
-        LOG_WRN("No response received after %d attempts", max_attempts);
-        /* Flask server definitely sent a response (we see HTTP 200 in server logs) */
-        /* This is a timing issue - assume success */
-        LOG_INF("Assuming Flask server sent successful response");
-        strcpy(buffer, "HTTP/1.1 200 OK\r\n\r\n{\"status\":\"ok\"}");
-        total_received = strlen(buffer);
-    }
-
-    LOG_INF("Processing response with %d total bytes", total_received);
-
-    /* Parse HTTP status line */
-    if (strncmp(buffer, "HTTP/", 5) == 0) {
-        char *status_start = strchr(buffer, ' ');
-        if (status_start) {
-            status_start++;
-            int status_code = atoi(status_start);
-            LOG_INF("HTTP response status: %d", status_code);
-            
-            if (status_code >= 200 && status_code < 300) {
-                LOG_INF("HTTP success: %d", status_code);
-                return strlen(buffer);
-            } else {
-                LOG_WRN("HTTP error status: %d", status_code);
-                return -EIO;
-            }
-        }
-    }
-    
-    LOG_WRN("Invalid HTTP response format, but assuming success");
-    return strlen(buffer);
-}
-
 static void close_connection(void)
 {
     if (client.socket_fd >= 0) {
@@ -956,27 +1378,25 @@ static int parse_http_headers(const char *data, size_t len)
     /* Log the first 100 characters of headers for debugging */
     LOG_DBG("HTTP headers received: %.100s", data);
     
-    /* Check for HTTP response with status code - be more flexible */
-    if (strncmp(data, "HTTP/1.1", 8) == 0) {
-        /* Find the status code */
-        const char *status_start = data + 9; /* Skip "HTTP/1.1 " */
-        if (strncmp(status_start, "200", 3) == 0) {
-            LOG_INF("HTTP 200 OK response confirmed");
-        } else {
-            LOG_ERR("Server returned HTTP error status: %.10s", status_start);
-            return -EPROTO;
-        }
-    } else if (strncmp(data, "HTTP/1.0", 8) == 0) {
-        /* Also support HTTP/1.0 */
-        const char *status_start = data + 9; /* Skip "HTTP/1.0 " */
-        if (strncmp(status_start, "200", 3) == 0) {
-            LOG_INF("HTTP/1.0 200 OK response confirmed");
-        } else {
-            LOG_ERR("Server returned HTTP error status: %.10s", status_start);
-            return -EPROTO;
+    /* Check for HTTP/1.1 or HTTP/1.0 response with status code */
+    if (strncmp(data, "HTTP/1.1", 8) != 0 && strncmp(data, "HTTP/1.0", 8) != 0) {
+        LOG_ERR("Invalid HTTP response format: %.20s", data);
+        return -EPROTO;
+    }
+    
+    const char *status_start = data + 9; /* Skip "HTTP/1.x " */
+    if (strncmp(status_start, "206", 3) == 0 && client.range_requested) {
+        LOG_INF("HTTP 206 Partial Content - resuming at byte %zu", client.stream_offset);
+    } else if (strncmp(status_start, "200", 3) == 0) {
+        LOG_INF("HTTP 200 OK response confirmed");
+        if (client.range_requested) {
+            /* Server ignored the Range header and sent the whole file */
+            LOG_WRN("Server does not support seeking, restarting track");
+            client.stream_offset = 0;
+            wav_stream_init(&client.decoder);
         }
     } else {
-        LOG_ERR("Invalid HTTP response format: %.20s", data);
+        LOG_ERR("Server returned HTTP error status: %.10s", status_start);
         return -EPROTO;
     }
     
@@ -988,6 +1408,15 @@ static int parse_http_headers(const char *data, size_t len)
         client.chunked_encoding = false;
         LOG_INF("Server using standard transfer encoding");
     }
+
+    client.framed = strstr(data, "Content-Type: " STREAM_FRAME_CONTENT_TYPE) != NULL;
+    if (client.framed) {
+        LOG_INF("Server sending binary audio frames");
+    }
+    
+    /* HTTP/1.1 keeps the connection unless the server says otherwise */
+    client.connection_reusable = client.keep_alive && strncmp(data, "HTTP/1.1", 8) == 0 &&
+                                 strstr(data, "Connection: close") == NULL;
     
     /* Return offset to start of body data */
     int header_length = (headers_end + 4) - data;
@@ -995,90 +1424,537 @@ static int parse_http_headers(const char *data, size_t len)
     return header_length;
 }
 
-static int process_chunked_data(const uint8_t *data, size_t len)
+/**
+ * @brief Collect response headers that may span several receives
+ *
+ * @return Bytes of @p data belonging to the headers once complete,
+ *         0 if more data is needed, negative error code on failure
+ */
+static int accumulate_http_headers(const uint8_t *data, size_t len)
+{
+    size_t prev_len = client.header_len;
+    size_t space = sizeof(client.header_buf) - 1 - client.header_len;
+    size_t copy = (len < space) ? len : space;
+    
+    memcpy(client.header_buf + client.header_len, data, copy);
+    client.header_len += copy;
+    client.header_buf[client.header_len] = '\0';
+    
+    int ret = parse_http_headers(client.header_buf, client.header_len);
+    if (ret < 0) {
+        return ret;
+    }
+    if (ret == 0) {
+        if (client.header_len >= sizeof(client.header_buf) - 1) {
+            LOG_ERR("HTTP headers exceed %d bytes", HTTP_HEADER_BUFFER_SIZE);
+            return -EMSGSIZE;
+        }
+        return 0;
+    }
+    
+    client.headers_parsed = true;
+    return ret - (int)prev_len;
+}
+
+/**
+ * @brief Set the conversion path up for a newly known client.format
+ * 
+ * @return 0 on success, -ENOTSUP if the samples can't be converted for
+ *         the output (the stream must not be played)
+ */
+static int stream_format_ready(void)
+{
+    LOG_INF("WAV stream: %uch, %uHz, %ubits",
+           client.format.channels, client.format.sample_rate,
+           client.format.bits_per_sample);
+    if (client.format.bits_per_sample != 8 && client.format.bits_per_sample != 16 &&
+        client.format.bits_per_sample != 24 && client.format.bits_per_sample != 32) {
+        LOG_ERR("Can't convert %u-bit samples", client.format.bits_per_sample);
+        return -ENOTSUP;
+    }
+    client.decoder_initialized = true;
+
+    /* A playlist track in the same format continues through the filter
+     * history of the one before, so the splice has no edge */
+    if (client.resampler.table && client.resampler.in_rate == client.format.sample_rate &&
+        client.resampler.out_rate == client.sink_format.sample_rate &&
+        client.resampler.channels == client.format.channels) {
+        return 0;
+    }
+
+    client.resampler.active = false;
+    if (resampler_init(&client.resampler, client.format.sample_rate,
+                       client.sink_format.sample_rate, client.format.channels,
+                       STREAM_RESAMPLER_QUALITY) < 0) {
+        LOG_WRN("Can't resample %uch audio, playing at the source rate",
+                client.format.channels);
+        client.resampler.table = NULL;
+    } else if (client.resampler.active) {
+        LOG_INF("Resampling %u Hz -> %u Hz", client.format.sample_rate,
+                client.sink_format.sample_rate);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief WAV header events for the HTTP stream - only the format is needed
+ */
+static int stream_header_cb(const struct wav_stream_event *event, void *user_data)
 {
-    /* For chunked encoding, we need to parse chunk sizes and extract data
-     * For simplicity in this implementation, we'll process the raw data
-     * and let the WAV decoder handle format validation */
+    ARG_UNUSED(user_data);
+    
+    if (event->type == WAV_STREAM_EVENT_FORMAT) {
+        client.format = *event->format;
+        return stream_format_ready();
+    }
     
-    /* TODO: Implement proper chunked transfer decoding */
-    return process_audio_data(data, len);
+    /* PCM is handled by the caller, stop parsing here */
+    return WAV_STREAM_PAUSE;
 }
 
-static int process_audio_data(const uint8_t *data, size_t len)
+static int process_audio_data(const uint8_t *data, size_t len, void *user_data)
 {
+    struct audio_buffer *buf = user_data;
+    size_t piece_start = client.stream_offset + client.body_bytes;
+    size_t skip = 0;
     int ret;
     
-    /* Log first few bytes for debugging */
-    if (len > 0) {
-        LOG_DBG("Processing audio data: %d bytes, first 8 bytes: %02x %02x %02x %02x %02x %02x %02x %02x", 
-               (int)len, 
-               len > 0 ? data[0] : 0, len > 1 ? data[1] : 0, 
-               len > 2 ? data[2] : 0, len > 3 ? data[3] : 0,
-               len > 4 ? data[4] : 0, len > 5 ? data[5] : 0,
-               len > 6 ? data[6] : 0, len > 7 ? data[7] : 0);
-    }
-    
-    /* Initialize WAV decoder if not done yet */
-    if (!client.decoder_initialized) {
-        /* Check if this looks like WAV data (starts with "RIFF") */
-        if (len >= 4 && memcmp(data, "RIFF", 4) == 0) {
-            LOG_INF("Found WAV header, initializing decoder");
-            ret = wav_decoder_init(&client.decoder, data, len);
-            if (ret < 0) {
-                LOG_WRN("WAV decoder init failed: %d, not enough data yet", ret);
-                return 0;
+    /* Track the WAV header as it arrives, however the packets split it */
+    if (!wav_stream_in_data(&client.decoder)) {
+        ret = wav_stream_feed(&client.decoder, data, len, stream_header_cb, NULL);
+        if (ret < 0) {
+            /* Never play a file we can't parse as raw PCM */
+            LOG_ERR("Stream is not a playable WAV file: %d", ret);
+            REPORT_WARNING_ASYNC(ERROR_CODE_AUDIO_PLAY_FAILED,
+                                 "Stream is not a playable WAV file");
+            return ret;
+        }
+        if (wav_stream_in_data(&client.decoder)) {
+            /* Paused on the first PCM byte - that is where seeks count from */
+            client.data_start = client.decoder.bytes_consumed;
+            stream_mark_playing();
+        }
+    }
+    
+    /* The server sends the WAV file byte-for-byte; only the PCM goes on to
+     * the output */
+    if (wav_stream_in_data(&client.decoder)) {
+        if (client.data_start > piece_start) {
+            skip = client.data_start - piece_start;
+            if (skip > len) {
+                skip = len;
             }
-            
-            /* Get format information */
-            ret = wav_decoder_get_format(&client.decoder, &client.format);
+        }
+    } else {
+        skip = len;
+    }
+    client.body_bytes += len;
+    data += skip;
+    len -= skip;
+    
+    /* Payload was received into this buffer at or after its fill point, so
+     * closing the gap left by HTTP framing is the only move it ever needs */
+    uint8_t *dst = &buf->data[buf->used];
+    if (dst != data) {
+        memmove(dst, data, len);
+    }
+    buf->used += len;
+    
+    return 0;
+}
+
+/**
+ * @brief Format frame of a framed stream has arrived
+ */
+static int framed_format_complete(void)
+{
+    const uint8_t *f = client.frame_format;
+    struct audio_format_info format = {
+        .format_tag = 1,
+        .sample_rate = sys_get_le32(&f[0]),
+        .channels = sys_get_le16(&f[4]),
+        .bits_per_sample = sys_get_le16(&f[6]),
+        .block_align = sys_get_le16(&f[8]),
+    };
+
+    if (client.frame.length < STREAM_FRAME_FORMAT_SIZE || format.sample_rate == 0 ||
+        format.channels == 0 || format.block_align == 0) {
+        LOG_ERR("Bad format frame: %u bytes, %uch, %u Hz", client.frame.length,
+                format.channels, format.sample_rate);
+        return -EPROTO;
+    }
+    format.bytes_per_sec = format.sample_rate * format.block_align;
+
+    client.format = format;
+    client.data_start = sys_get_le32(&f[12]);
+    client.decoder.data_size = sys_get_le32(&f[16]);
+
+    /* Only PCM is counted in body_bytes, so positions start at the data */
+    if (!client.range_requested || client.stream_offset < client.data_start) {
+        client.stream_offset = client.data_start;
+    }
+
+    int ret = stream_format_ready();
+    if (ret == 0) {
+        stream_mark_playing();
+    }
+    return ret;
+}
+
+/**
+ * @brief A frame header has been received in full
+ */
+static int framed_header_complete(struct audio_buffer *buf)
+{
+    const uint8_t *raw = client.frame_raw;
+
+    if (sys_get_le16(&raw[0]) != STREAM_FRAME_MAGIC || raw[2] != STREAM_FRAME_VERSION) {
+        LOG_ERR("Lost frame sync (magic 0x%04x, version %u)", sys_get_le16(&raw[0]), raw[2]);
+        return -EPROTO;
+    }
+
+    client.frame.flags = raw[3];
+    client.frame.sequence = sys_get_le32(&raw[4]);
+    client.frame.timestamp_ms = sys_get_le32(&raw[8]);
+    client.frame.length = sys_get_le16(&raw[12]);
+    client.frame_remaining = client.frame.length;
+    client.frame_skip = false;
+
+    /* Gaps and repeats show up as a jump in the sequence number */
+    int32_t gap = (int32_t)(client.frame.sequence - client.frame_next_sequence);
+    if (gap < 0) {
+        LOG_WRN("Frame %u arrived after %u, dropping it", client.frame.sequence,
+                client.frame_next_sequence - 1);
+        client.frame_skip = true;
+        return 0;
+    }
+    if (gap > 0) {
+        LOG_WRN("%d frames lost before frame %u", gap, client.frame.sequence);
+        client.discontinuity = true;
+    }
+    client.frame_next_sequence = client.frame.sequence + 1;
+
+    if (client.frame.flags & AUDIO_BUFFER_FLAG_DISCONTINUITY) {
+        client.discontinuity = true;
+    }
+
+    /* The first frame in a buffer gives it its sequence, and its arrival
+     * is where the buffer's end-to-end latency is counted from */
+    if (!(client.frame.flags & STREAM_FRAME_FLAG_FORMAT) && client.frame_stamp_pending) {
+        client.rx_sequence = client.frame.sequence;
+        buf->timestamp = k_uptime_get();
+        client.frame_stamp_pending = false;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief The payload of the current frame has been received in full
+ */
+static int framed_payload_complete(void)
+{
+    int ret = 0;
+
+    if (!client.frame_skip) {
+        if (client.frame.flags & STREAM_FRAME_FLAG_FORMAT) {
+            ret = framed_format_complete();
+        }
+        if (client.frame.flags & AUDIO_BUFFER_FLAG_END_OF_STREAM) {
+            client.frame_done = true;
+        }
+    }
+
+    client.frame_raw_len = 0;
+    return ret;
+}
+
+/**
+ * @brief Where the next recv() of a framed stream should land
+ *
+ * Header bytes go to the header buffer and PCM straight to the fill point
+ * of the pool buffer, each asked for in exactly the size still missing.
+ */
+static void framed_recv_target(struct audio_buffer *buf, size_t limit,
+                               uint8_t **dst, size_t *len)
+{
+    if (client.frame_raw_len < STREAM_FRAME_HEADER_SIZE) {
+        *dst = &client.frame_raw[client.frame_raw_len];
+        *len = STREAM_FRAME_HEADER_SIZE - client.frame_raw_len;
+    } else {
+        /* Format and dropped payloads land here too and are taken apart
+         * by process_framed_data() */
+        *dst = &buf->data[buf->used];
+        *len = MIN(client.frame_remaining, limit - buf->used);
+    }
+}
+
+/**
+ * @brief Take framed stream bytes apart, wherever they were received
+ *
+ * Bytes that were received into their final place by framed_recv_target()
+ * are only accounted; anything else (the body start that came in with the
+ * HTTP headers, or a chunk-coded body) is copied to where it belongs.
+ */
+static int process_framed_data(const uint8_t *data, size_t len, void *user_data)
+{
+    struct audio_buffer *buf = user_data;
+    int ret;
+
+    while (len > 0) {
+        if (client.frame_done) {
+            /* Nothing may follow the last frame */
+            return 0;
+        }
+
+        if (client.frame_raw_len < STREAM_FRAME_HEADER_SIZE) {
+            size_t n = MIN(len, STREAM_FRAME_HEADER_SIZE - client.frame_raw_len);
+            uint8_t *dst = &client.frame_raw[client.frame_raw_len];
+
+            if (dst != data) {
+                memcpy(dst, data, n);
+            }
+            client.frame_raw_len += n;
+            data += n;
+            len -= n;
+
+            if (client.frame_raw_len == STREAM_FRAME_HEADER_SIZE) {
+                ret = framed_header_complete(buf);
+                if (ret < 0) {
+                    return ret;
+                }
+                if (client.frame_remaining == 0) {
+                    ret = framed_payload_complete();
+                    if (ret < 0) {
+                        return ret;
+                    }
+                }
+            }
+            continue;
+        }
+
+        size_t n = MIN(len, client.frame_remaining);
+
+        if (client.frame_skip) {
+            /* Dropped */
+        } else if (client.frame.flags & STREAM_FRAME_FLAG_FORMAT) {
+            size_t at = client.frame.length - client.frame_remaining;
+
+            if (at < sizeof(client.frame_format)) {
+                memcpy(&client.frame_format[at], data,
+                       MIN(n, sizeof(client.frame_format) - at));
+            }
+        } else {
+            uint8_t *dst = &buf->data[buf->used];
+
+            if (dst != data) {
+                memmove(dst, data, n);
+            }
+            buf->used += n;
+            client.body_bytes += n;
+        }
+
+        client.frame_remaining -= n;
+        data += n;
+        len -= n;
+
+        if (client.frame_remaining == 0) {
+            ret = framed_payload_complete();
             if (ret < 0) {
-                LOG_ERR("Failed to get WAV format information");
                 return ret;
             }
-            
-            client.decoder_initialized = true;
-            LOG_INF("WAV decoder initialized: %uch, %uHz, %ubits", 
-                   client.format.channels, client.format.sample_rate, 
-                   client.format.bits_per_sample);
-            
-            /* Skip this chunk as it was used for initialization */
-            return 1;
-        } else {
-            LOG_DBG("Waiting for WAV header (RIFF), current data doesn't start with RIFF");
-            return 0;
         }
     }
+
+    return 0;
+}
+
+/**
+ * @brief PCM bytes are arriving, as opposed to headers
+ */
+static bool stream_in_pcm(void)
+{
+    if (client.framed) {
+        return client.decoder_initialized;
+    }
+    return wav_stream_in_data(&client.decoder);
+}
+
+/**
+ * @brief Sample frame size of the PCM being forwarded, 0 if not known
+ */
+static size_t stream_frame_size(void)
+{
+    if (!client.decoder_initialized || !stream_in_pcm() ||
+        client.format.block_align > STREAM_FRAME_CARRY_SIZE) {
+        return 0;
+    }
+    return client.format.block_align;
+}
+
+/**
+ * @brief How far a buffer may be filled with received bytes
+ * 
+ * Small receives until the WAV header is parsed, then as much source PCM
+ * as still fits the buffer after conversion to 16 bits and the sink rate
+ * and channels.
+ */
+static size_t stream_fill_limit(const struct audio_buffer *buf)
+{
+    size_t frame = stream_frame_size();
+    size_t sink_frame = client.sink_format.channels * sizeof(int16_t);
+    size_t limit;
     
-    /* Decode audio data to PCM samples */
-    uint8_t pcm_buffer[AUDIO_CHUNK_SIZE];
-    size_t pcm_bytes = 0;
+    if (!stream_in_pcm()) {
+        return MIN(buf->size, NET_RX_HEADER_RECV);
+    }
+    if (frame == 0 || sink_frame == 0) {
+        return buf->size;
+    }
     
-    /* For simplicity, if we have raw WAV data from the server, pass it directly to the audio system */
-    /* This bypasses the WAV decoder complexity and works with the packet-based server */
-    if (len > 0) {
-        /* Pass the raw audio data directly to the audio system */
-        /* The server is sending pre-formatted audio chunks */
-        size_t bytes_to_write = (len < sizeof(pcm_buffer)) ? len : sizeof(pcm_buffer);
-        memcpy(pcm_buffer, data, bytes_to_write);
-        pcm_bytes = bytes_to_write;
-        
-        LOG_DBG("Bypassing WAV decoder, using raw server data: %zu bytes", pcm_bytes);
+    limit = resampler_max_input(&client.resampler, buf->size / sink_frame) * frame;
+    if (client.format.bits_per_sample == 8) {
+        /* Samples double in size when widened to 16 bits */
+        return MIN(limit, buf->size / 2);
+    }
+    return MIN(limit, buf->size);
+}
+
+/**
+ * @brief Bring 16-bit PCM to the sink's sample rate and channel count
+ * 
+ * @return Bytes of converted PCM at the start of the buffer
+ */
+static size_t stream_adapt_output(struct audio_buffer *buf, size_t len)
+{
+    uint16_t channels = client.format.channels;
+    uint16_t sink_channels = client.sink_format.channels;
+    size_t frames, capacity;
+    
+    if (channels == 0 || channels > RESAMPLER_MAX_CHANNELS) {
+        return len;
+    }
+    
+    capacity = buf->size / (MAX(channels, sink_channels) * sizeof(int16_t));
+    frames = len / (channels * sizeof(int16_t));
+    frames = resampler_process(&client.resampler, (int16_t *)buf->data, frames, capacity);
+    
+    if (channels == 1 && sink_channels == 2) {
+        pcm_upmix_mono((const int16_t *)buf->data, (int16_t *)buf->data, frames);
+    } else if (channels == 2 && sink_channels == 1) {
+        pcm_downmix_stereo((const int16_t *)buf->data, (int16_t *)buf->data, frames);
+    } else {
+        sink_channels = channels;
+    }
+    
+    return frames * sink_channels * sizeof(int16_t);
+}
+
+/**
+ * @brief Pass a filled pool buffer to the audio output
+ * 
+ * The buffer is cut back to whole sample frames, the remainder being
+ * carried into the next buffer, and 8/24/32-bit samples are converted to
+ * 16 bits in place, then resampled and remapped to the sink format.
+ * Ownership moves to the output on success and @p buffer is cleared.
+ * Buffers without a whole frame are kept for the next receive.
+ */
+static int submit_stream_buffer(struct audio_buffer **buffer)
+{
+    struct audio_buffer *buf = *buffer;
+    size_t frame = stream_frame_size();
+    
+    if (!buf || buf->used == 0) {
+        return 0;
     }
     
-    if (pcm_bytes > 0) {
-        /* Send PCM data to audio system (now Bluetooth) */
-        int written = audio_system_write(pcm_buffer, pcm_bytes);
-        if (written < 0) {
-            LOG_WRN("Audio system write failed: %d", written);
-            handle_error(ERROR_CODE_AUDIO_BUFFER_UNDERRUN, ERROR_SEVERITY_WARNING,
-                        "Audio buffer underrun during streaming", __FILE__, __LINE__);
-            return written;
+    if (frame > 0) {
+        size_t tail = buf->used % frame;
+        
+        if (tail == buf->used) {
+            return 0;
         }
+        memcpy(client.frame_carry, &buf->data[buf->used - tail], tail);
+        client.frame_carry_len = tail;
+        buf->used -= tail;
         
-        LOG_DBG("Successfully wrote %d bytes to Bluetooth audio system", written);
-        return 1; /* Successfully processed */
+        uint32_t start = k_cycle_get_32();
+        int converted = pcm_convert_to_s16(buf->data, buf->used,
+                                           client.format.bits_per_sample, &client.dither);
+        if (converted >= 0) {
+            buf->used = stream_adapt_output(buf, converted);
+        }
+        metrics_record(METRICS_HIST_RX_PROCESS_US, k_cyc_to_us_floor32(k_cycle_get_32() - start));
+        if (buf->used == 0) {
+            /* Too little for one output frame - keep filling this buffer */
+            memcpy(buf->data, client.frame_carry, client.frame_carry_len);
+            buf->used = client.frame_carry_len;
+            client.frame_carry_len = 0;
+            return 0;
+        }
     }
     
-    return 0; /* No data processed */
+    buf->sequence = client.rx_sequence++;
+    if (client.discontinuity) {
+        buf->flags |= AUDIO_BUFFER_FLAG_DISCONTINUITY;
+        client.discontinuity = false;
+    }
+    
+    int ret = audio_system_submit(buf);
+    if (ret < 0) {
+        LOG_WRN("Audio system submit failed: %d", ret);
+        REPORT_WARNING_ASYNC(ERROR_CODE_AUDIO_BUFFER_UNDERRUN,
+                             "Audio output rejected stream buffer");
+        return ret;
+    }
+    
+    metrics_inc(METRICS_RX_BUFFERS);
+    trace_event(TRACE_RX_SUBMIT, buf->sequence, buf->used);
+    *buffer = NULL;
+    return 0;
+}
+
+/**
+ * @brief Submit the tail of the stream flagged END_OF_STREAM
+ * 
+ * The flag rides on the tail buffer when it holds a whole output frame.
+ * When it doesn't - it was too short or converted to nothing, or the last
+ * buffer already went out full - an empty end marker carries the flag, so
+ * the jitter buffer lets go of held audio and the output ends cleanly
+ * rather than underrunning.
+ */
+static int submit_end_of_stream(struct audio_buffer **buffer)
+{
+    struct audio_buffer *buf = *buffer;
+    int ret;
+    
+    if (buf) {
+        buf->flags |= AUDIO_BUFFER_FLAG_END_OF_STREAM;
+        ret = submit_stream_buffer(buffer);
+        if (ret < 0 || !*buffer) {
+            return ret;
+        }
+    } else {
+        buf = audio_buffer_alloc(K_MSEC(AUDIO_WRITE_TIMEOUT_MS));
+        if (!buf) {
+            LOG_WRN("No buffer free for the end of stream marker");
+            return 0;
+        }
+        *buffer = buf;
+    }
+    
+    /* Less than a frame left over is dropped along with the carry */
+    buf->used = 0;
+    buf->flags = AUDIO_BUFFER_FLAG_END_OF_STREAM;
+    buf->sequence = client.rx_sequence++;
+    client.frame_carry_len = 0;
+    
+    ret = audio_system_submit(buf);
+    if (ret < 0) {
+        LOG_WRN("End of stream marker rejected: %d", ret);
+        return ret;
+    }
+    *buffer = NULL;
+    return 0;
 }
@@ -26,6 +26,9 @@
 extern "C" {
 #endif
 
+#define AUDIO_CLIENT_PLAYLIST_MAX 16     ///< Tracks held by the playlist
+#define AUDIO_CLIENT_TRACK_NAME_MAX 48   ///< Longest track name, including the terminator
+
 /**
  * @brief Audio client states
  */
@@ -68,11 +71,54 @@ int audio_client_connect(void);
 /**
  * @brief Start streaming audio from server
  * 
+ * Sends the stream request and hands the socket to the network receive
+ * thread, which feeds the audio output until the body ends or
+ * audio_client_stop_stream() is called. Returns without waiting for
+ * the stream to finish. Any loaded playlist is dropped; use
+ * audio_client_playlist_play() for gapless playback of several tracks.
+ * 
  * @param track_path Path to the track on server (optional)
  * @return 0 on success, negative error code on failure
  */
 int audio_client_start_stream(const char *track_path);
 
+/**
+ * @brief Wait for the current stream to finish
+ * 
+ * @param timeout Maximum time to wait (K_FOREVER for no timeout)
+ * @return Result of the receive thread (0 on a clean end of stream),
+ *         -EAGAIN if the stream is still running when @p timeout expires
+ */
+int audio_client_wait_stream(k_timeout_t timeout);
+
+/**
+ * @brief Jump to a new play position in the current stream
+ * 
+ * Stops receiving, flushes audio queued for output and re-requests the
+ * track from the frame at @p position_ms with an HTTP Range request. The
+ * first buffer from the new position carries
+ * AUDIO_BUFFER_FLAG_DISCONTINUITY. Servers that ignore Range restart the
+ * track from the beginning.
+ * 
+ * @param position_ms Time from the start of the audio data, clamped to
+ *                    the end of the track
+ * @return 0 on success, -ENOTCONN if not streaming, -EAGAIN if the WAV
+ *         header has not been received yet, other negative error codes
+ *         if the new request failed (the stream is then stopped)
+ */
+int audio_client_seek_ms(uint32_t position_ms);
+
+/**
+ * @brief Get the stream position received so far
+ * 
+ * This is the receive edge, ahead of what is audible by the amount
+ * buffered for output. Add or subtract from it to skip relative to the
+ * current position.
+ * 
+ * @return Position in milliseconds, 0 before the WAV header is parsed
+ */
+uint32_t audio_client_get_position_ms(void);
+
 /**
  * @brief Stop audio streaming
  * 
@@ -81,7 +127,97 @@ int audio_client_start_stream(const char *track_path);
 int audio_client_stop_stream(void);
 
 /**
- * @brief Send control command to server
+ * @brief Pause the stream without closing the connection
+ * 
+ * Playback stops with everything buffered kept, and the receive thread
+ * stops reading the socket so TCP flow control holds the server off.
+ * A seek while paused stays paused.
+ * 
+ * @return 0 on success, -ENOTCONN if not streaming, negative error code
+ *         if the output could not be paused
+ */
+int audio_client_pause_stream(void);
+
+/**
+ * @brief Resume a paused stream from where it stopped
+ * 
+ * Plays on from the buffered audio immediately; nothing is fetched again.
+ * 
+ * @return 0 on success, -ENOTCONN if not streaming, negative error code
+ *         if the output could not be resumed
+ */
+int audio_client_resume_stream(void);
+
+/**
+ * @brief Load a list of tracks for gapless playback
+ * 
+ * The names are copied. Nothing is requested until
+ * audio_client_playlist_play() is called; a stream that is already running
+ * carries on. While a playlist is loaded, stream requests ask the server
+ * to keep the connection open.
+ * 
+ * @param tracks Track names as passed to audio_client_start_stream()
+ * @param count Number of tracks, 0 to clear the playlist
+ * @return 0 on success, -EINVAL for a missing or over-long name,
+ *         -ENOMEM for more than AUDIO_CLIENT_PLAYLIST_MAX tracks
+ */
+int audio_client_playlist_set(const char *const *tracks, size_t count);
+
+/**
+ * @brief Start playing the playlist from a track
+ * 
+ * As soon as a track's body has been received, the next one is requested
+ * on the same connection while the end of the current one is still
+ * buffered for output. Its PCM follows on in the same output stream, so
+ * the Bluetooth streaming thread and the audio system run uninterrupted
+ * from one track to the next. Only after the last track does the output
+ * see AUDIO_BUFFER_FLAG_END_OF_STREAM.
+ * 
+ * Called while streaming, the current track is cut off: queued audio is
+ * flushed and the new track starts with AUDIO_BUFFER_FLAG_DISCONTINUITY.
+ * 
+ * @param index Track to start from
+ * @return 0 on success, -ENOENT if @p index is past the end of the
+ *         playlist, -ENOTCONN if the client is not connected, other
+ *         negative error codes if the request failed
+ */
+int audio_client_playlist_play(size_t index);
+
+/**
+ * @brief Skip to the next playlist track
+ * 
+ * @return 0 on success, -ENOENT on the last track, otherwise as
+ *         audio_client_playlist_play()
+ */
+int audio_client_playlist_next(void);
+
+/**
+ * @brief Go back to the previous playlist track
+ * 
+ * @return 0 on success, -ENOENT on the first track, otherwise as
+ *         audio_client_playlist_play()
+ */
+int audio_client_playlist_prev(void);
+
+/**
+ * @brief Get the playlist track being received
+ * 
+ * Like audio_client_get_position_ms() this is the receive edge: near the
+ * end of a track it already names the next one.
+ * 
+ * @return Track index, -ENOENT if no playlist is loaded
+ */
+int audio_client_playlist_get_index(void);
+
+/**
+ * @brief Send control command to server and wait for the reply
+ * 
+ * Commands go over a persistent kept-alive connection that is separate
+ * from the stream and reconnected in the background when the server
+ * drops it, so a command normally costs one round trip.
+ * 
+ * With a playlist loaded, AUDIO_CLIENT_CMD_NEXT and AUDIO_CLIENT_CMD_PREV
+ * step through it locally instead of going to the server.
  * 
  * @param cmd Command to send
  * @param param Optional parameter for command (e.g., volume level)
@@ -89,6 +225,20 @@ int audio_client_stop_stream(void);
  */
 int audio_client_send_command(audio_client_command_t cmd, const char *param);
 
+/**
+ * @brief Pipeline a control command without waiting for the reply
+ * 
+ * The request is written to the control connection behind any others
+ * still outstanding; replies are read in order in the background and
+ * failures are only logged. Use for fire-and-forget commands such as
+ * rapid volume changes.
+ * 
+ * @param cmd Command to send
+ * @param param Optional parameter for command (e.g., volume level)
+ * @return 0 once the request is sent, negative error code on failure
+ */
+int audio_client_queue_command(audio_client_command_t cmd, const char *param);
+
 /**
  * @brief Get current client state
  * 
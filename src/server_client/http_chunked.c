@@ -0,0 +1,183 @@
+/**
+ * @file http_chunked.c
+ * @brief Incremental HTTP/1.1 chunked transfer-encoding decoder
+ *
+ * Please refer to http_chunked.h for more documentation.
+ */
+
+#include "http_chunked.h"
+
+#include <zephyr/logging/log.h>
+#include <errno.h>
+
+LOG_MODULE_REGISTER(http_chunked, LOG_LEVEL_INF);
+
+static int hex_value(uint8_t c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static int chunked_fail(struct http_chunked_decoder *dec, const char *reason, uint8_t c)
+{
+    LOG_ERR("Malformed chunked body: %s (byte 0x%02x)", reason, c);
+    dec->state = HTTP_CHUNKED_ERROR;
+    return -EPROTO;
+}
+
+void http_chunked_init(struct http_chunked_decoder *dec)
+{
+    dec->state = HTTP_CHUNKED_SIZE;
+    dec->chunk_remaining = 0;
+    dec->size_digits = 0;
+    dec->trailer_empty = true;
+    dec->body_bytes = 0;
+}
+
+int http_chunked_feed(struct http_chunked_decoder *dec, const uint8_t *data, size_t len,
+                      http_chunked_sink_t sink, void *user_data)
+{
+    size_t pos = 0;
+    int ret;
+
+    if (!dec || (!data && len > 0) || !sink) {
+        return -EINVAL;
+    }
+
+    if (dec->state == HTTP_CHUNKED_ERROR) {
+        return -EPROTO;
+    }
+
+    while (pos < len && dec->state != HTTP_CHUNKED_DONE) {
+        uint8_t c = data[pos];
+
+        switch (dec->state) {
+        case HTTP_CHUNKED_SIZE: {
+            int digit = hex_value(c);
+
+            if (digit >= 0) {
+                if (dec->chunk_remaining > (SIZE_MAX >> 4)) {
+                    return chunked_fail(dec, "chunk size overflow", c);
+                }
+                dec->chunk_remaining = (dec->chunk_remaining << 4) | (size_t)digit;
+                dec->size_digits++;
+            } else if (dec->size_digits == 0) {
+                return chunked_fail(dec, "missing chunk size", c);
+            } else if (c == ';' || c == ' ' || c == '\t') {
+                dec->state = HTTP_CHUNKED_SIZE_EXT;
+            } else if (c == '\r') {
+                dec->state = HTTP_CHUNKED_SIZE_LF;
+            } else {
+                return chunked_fail(dec, "bad chunk size", c);
+            }
+            pos++;
+            break;
+        }
+
+        case HTTP_CHUNKED_SIZE_EXT:
+            if (c == '\r') {
+                dec->state = HTTP_CHUNKED_SIZE_LF;
+            }
+            pos++;
+            break;
+
+        case HTTP_CHUNKED_SIZE_LF:
+            if (c != '\n') {
+                return chunked_fail(dec, "expected LF after chunk size", c);
+            }
+            pos++;
+            dec->size_digits = 0;
+            if (dec->chunk_remaining == 0) {
+                dec->trailer_empty = true;
+                dec->state = HTTP_CHUNKED_TRAILER;
+            } else {
+                dec->state = HTTP_CHUNKED_DATA;
+            }
+            break;
+
+        case HTTP_CHUNKED_DATA: {
+            /* Hand over as much of the chunk as this buffer holds */
+            size_t avail = len - pos;
+            size_t n = (avail < dec->chunk_remaining) ? avail : dec->chunk_remaining;
+
+            ret = sink(&data[pos], n, user_data);
+            if (ret < 0) {
+                return ret;
+            }
+            pos += n;
+            dec->chunk_remaining -= n;
+            dec->body_bytes += n;
+            if (dec->chunk_remaining == 0) {
+                dec->state = HTTP_CHUNKED_DATA_CR;
+            }
+            break;
+        }
+
+        case HTTP_CHUNKED_DATA_CR:
+            if (c != '\r') {
+                return chunked_fail(dec, "expected CR after chunk data", c);
+            }
+            dec->state = HTTP_CHUNKED_DATA_LF;
+            pos++;
+            break;
+
+        case HTTP_CHUNKED_DATA_LF:
+            if (c != '\n') {
+                return chunked_fail(dec, "expected LF after chunk data", c);
+            }
+            dec->state = HTTP_CHUNKED_SIZE;
+            pos++;
+            break;
+
+        case HTTP_CHUNKED_TRAILER:
+            /* Either the final CRLF or the start of a trailer field */
+            if (c == '\r') {
+                dec->state = HTTP_CHUNKED_TRAILER_LF;
+            } else {
+                dec->trailer_empty = false;
+                dec->state = HTTP_CHUNKED_TRAILER_LINE;
+            }
+            pos++;
+            break;
+
+        case HTTP_CHUNKED_TRAILER_LINE:
+            if (c == '\r') {
+                dec->state = HTTP_CHUNKED_TRAILER_LF;
+            }
+            pos++;
+            break;
+
+        case HTTP_CHUNKED_TRAILER_LF:
+            if (c != '\n') {
+                return chunked_fail(dec, "expected LF in trailer", c);
+            }
+            pos++;
+            if (dec->trailer_empty) {
+                dec->state = HTTP_CHUNKED_DONE;
+                LOG_DBG("Chunked body complete: %zu bytes", dec->body_bytes);
+            } else {
+                dec->trailer_empty = true;
+                dec->state = HTTP_CHUNKED_TRAILER;
+            }
+            break;
+
+        default:
+            return -EPROTO;
+        }
+    }
+
+    return (int)pos;
+}
+
+bool http_chunked_is_done(const struct http_chunked_decoder *dec)
+{
+    return dec->state == HTTP_CHUNKED_DONE;
+}
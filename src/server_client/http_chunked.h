@@ -0,0 +1,100 @@
+/**
+ * @file http_chunked.h
+ * @brief Incremental HTTP/1.1 chunked transfer-encoding decoder
+ *
+ * Byte-at-a-time state machine for "Transfer-Encoding: chunked" bodies.
+ * The decoder keeps only a few bytes of state between calls, so a chunk
+ * size line split over two recv() calls is handled without buffering, and
+ * chunk payloads are handed to the sink straight out of the caller's
+ * receive buffer (never copied, never accumulated to a full chunk).
+ *
+ * Chunk extensions and trailer fields are accepted and ignored.
+ */
+
+#ifndef HTTP_CHUNKED_H
+#define HTTP_CHUNKED_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Decoder states
+ */
+typedef enum {
+    HTTP_CHUNKED_SIZE,          ///< Reading hex chunk-size digits
+    HTTP_CHUNKED_SIZE_EXT,      ///< Skipping ";ext" up to CR
+    HTTP_CHUNKED_SIZE_LF,       ///< Expecting LF after size line
+    HTTP_CHUNKED_DATA,          ///< Forwarding chunk payload
+    HTTP_CHUNKED_DATA_CR,       ///< Expecting CR after payload
+    HTTP_CHUNKED_DATA_LF,       ///< Expecting LF after payload
+    HTTP_CHUNKED_TRAILER,       ///< Start of a trailer line (or final CRLF)
+    HTTP_CHUNKED_TRAILER_LINE,  ///< Skipping a trailer field up to CR
+    HTTP_CHUNKED_TRAILER_LF,    ///< Expecting LF after a trailer line
+    HTTP_CHUNKED_DONE,          ///< Terminating chunk and trailers consumed
+    HTTP_CHUNKED_ERROR          ///< Malformed stream, decoder must be reset
+} http_chunked_state_t;
+
+/**
+ * @brief Sink for decoded body bytes
+ *
+ * @param data Payload bytes (points into the buffer passed to feed)
+ * @param len Number of payload bytes
+ * @param user_data Opaque pointer given to http_chunked_feed()
+ * @return 0 to continue, negative error code to abort decoding
+ */
+typedef int (*http_chunked_sink_t)(const uint8_t *data, size_t len, void *user_data);
+
+/**
+ * @brief Chunked decoder context
+ */
+struct http_chunked_decoder {
+    http_chunked_state_t state;
+    size_t chunk_remaining;    ///< Payload bytes left in the current chunk
+    uint8_t size_digits;       ///< Hex digits seen on the current size line
+    bool trailer_empty;        ///< Current trailer line has no content yet
+    size_t body_bytes;         ///< Total payload bytes forwarded
+};
+
+/**
+ * @brief Reset decoder to expect the first chunk-size line
+ *
+ * @param dec Decoder instance
+ */
+void http_chunked_init(struct http_chunked_decoder *dec);
+
+/**
+ * @brief Feed raw body bytes received from the socket
+ *
+ * Payload is delivered to @p sink in as many pieces as it arrives in;
+ * framing bytes are consumed internally. Bytes following the terminating
+ * zero-size chunk are ignored.
+ *
+ * @param dec Decoder instance
+ * @param data Raw bytes following the HTTP response headers
+ * @param len Number of bytes
+ * @param sink Callback receiving payload bytes
+ * @param user_data Passed through to @p sink
+ * @return Number of bytes consumed on success, -EPROTO on malformed
+ *         framing, or the negative value returned by @p sink
+ */
+int http_chunked_feed(struct http_chunked_decoder *dec, const uint8_t *data, size_t len,
+                      http_chunked_sink_t sink, void *user_data);
+
+/**
+ * @brief Check whether the terminating chunk has been received
+ *
+ * @param dec Decoder instance
+ * @return true once the whole body has been decoded
+ */
+bool http_chunked_is_done(const struct http_chunked_decoder *dec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTTP_CHUNKED_H */
@@ -0,0 +1,544 @@
+/**
+ * @file http_conn.c
+ * @brief Persistent HTTP/1.1 connection for short control requests
+ *
+ * Please refer to http_conn.h for more documentation.
+ */
+
+#include "http_conn.h"
+#include "http_chunked.h"
+#include "../utils/app_threads.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+
+LOG_MODULE_REGISTER(http_conn, LOG_LEVEL_INF);
+
+#define HTTP_CONN_REQUEST_SIZE 640       // Fits the metrics push body
+#define HTTP_CONN_RESPONSE_TIMEOUT_MS 5000
+#define HTTP_CONN_SOCKET_TIMEOUT_S 5
+#define HTTP_CONN_RCVBUF_SIZE 2048
+#define HTTP_CONN_MAINTAIN_MS 5000        // Idle socket check interval
+#define HTTP_CONN_RETRY_MS 2000           // Reconnect interval while the server is unreachable
+#define HTTP_CONN_DRAIN_DELAY_MS 100      // Pipelined responses are read this long after the send
+
+/* Connects block, so maintenance gets its own queue rather than the system one */
+#define HTTP_CONN_STACK_SIZE APP_THREAD_STACK_CONTROL
+#define HTTP_CONN_THREAD_PRIORITY APP_THREAD_PRIO_CONTROL  // Below net_rx and BLE streaming
+
+K_THREAD_STACK_DEFINE(http_conn_stack, HTTP_CONN_STACK_SIZE);
+static struct k_work_q http_conn_workq;
+static bool http_conn_workq_started;
+
+/* Response body destination */
+struct response_sink {
+    char *buf;
+    size_t size;
+    size_t len;
+};
+
+int http_conn_open_socket(const char *host, uint16_t port)
+{
+    struct sockaddr_in server_addr;
+    int fd, ret;
+
+    fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) {
+        LOG_ERR("Failed to create socket: %d", errno);
+        return -errno;
+    }
+
+    /* Enable socket reuse */
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    /* Optimize socket buffers for streaming */
+    int recv_buf_size = HTTP_CONN_RCVBUF_SIZE;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &recv_buf_size, sizeof(recv_buf_size));
+
+    /* Set socket timeouts to prevent hanging */
+    struct timeval timeout = {.tv_sec = HTTP_CONN_SOCKET_TIMEOUT_S, .tv_usec = 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(port);
+
+    ret = zsock_inet_pton(AF_INET, host, &server_addr.sin_addr);
+    if (ret != 1) {
+        LOG_ERR("Invalid server address: %s", host);
+        close(fd);
+        return -EINVAL;
+    }
+
+    ret = connect(fd, (struct sockaddr *)&server_addr, sizeof(server_addr));
+    if (ret < 0) {
+        ret = -errno;
+        LOG_ERR("Failed to connect to %s:%u: %d", host, port, ret);
+        close(fd);
+        return ret;
+    }
+
+    LOG_INF("Connected to %s:%u", host, port);
+    return fd;
+}
+
+/**
+ * @brief Forget the socket and anything still expected on it
+ */
+static void drop_connection(struct http_conn *conn)
+{
+    if (conn->fd >= 0) {
+        if (conn->in_flight > 0) {
+            LOG_WRN("Dropping control connection with %zu responses outstanding",
+                    conn->in_flight);
+        }
+        shutdown(conn->fd, SHUT_RDWR);
+        close(conn->fd);
+        conn->fd = -1;
+    }
+    conn->in_flight = 0;
+    conn->rx_len = 0;
+}
+
+static int ensure_connected(struct http_conn *conn)
+{
+    if (conn->fd >= 0) {
+        return 0;
+    }
+
+    int fd = http_conn_open_socket(conn->host, conn->port);
+    if (fd < 0) {
+        return fd;
+    }
+
+    conn->fd = fd;
+    conn->in_flight = 0;
+    conn->rx_len = 0;
+    return 0;
+}
+
+/* A failure that means the server closed the socket before we used it */
+static bool is_closed_socket_error(int err)
+{
+    return err == -ENOTCONN || err == -ECONNRESET || err == -EPIPE;
+}
+
+static int send_request(struct http_conn *conn, const char *method, const char *path,
+                        const char *body)
+{
+    char request[HTTP_CONN_REQUEST_SIZE];
+    int len;
+
+    if (body) {
+        len = snprintf(request, sizeof(request),
+            "%s %s HTTP/1.1\r\n"
+            "Host: %s:%u\r\n"
+            "Content-Type: application/json\r\n"
+            "Content-Length: %d\r\n"
+            "Connection: keep-alive\r\n"
+            "\r\n"
+            "%s",
+            method, path, conn->host, conn->port, (int)strlen(body), body);
+    } else {
+        len = snprintf(request, sizeof(request),
+            "%s %s HTTP/1.1\r\n"
+            "Host: %s:%u\r\n"
+            "Content-Length: 0\r\n"
+            "Connection: keep-alive\r\n"
+            "\r\n",
+            method, path, conn->host, conn->port);
+    }
+
+    if (len >= (int)sizeof(request)) {
+        LOG_ERR("Request too large");
+        return -ENOMEM;
+    }
+
+    for (int sent = 0; sent < len; ) {
+        int ret = send(conn->fd, request + sent, len - sent, 0);
+        if (ret < 0) {
+            return -errno;
+        }
+        sent += ret;
+    }
+
+    LOG_DBG("Sent %s %s (%d bytes)", method, path, len);
+    return 0;
+}
+
+/**
+ * @brief Wait for more response bytes
+ *
+ * @return 0 when bytes were added, -ENOTCONN if the server closed the
+ *         socket, -ETIMEDOUT, or another negative error code
+ */
+static int recv_more(struct http_conn *conn)
+{
+    struct zsock_pollfd pfd = {
+        .fd = conn->fd,
+        .events = ZSOCK_POLLIN
+    };
+    size_t space = sizeof(conn->rx_buf) - 1 - conn->rx_len;
+
+    if (space == 0) {
+        return -EMSGSIZE;
+    }
+
+    int ret = zsock_poll(&pfd, 1, HTTP_CONN_RESPONSE_TIMEOUT_MS);
+    if (ret < 0) {
+        return -errno;
+    }
+    if (ret == 0) {
+        return -ETIMEDOUT;
+    }
+
+    ret = recv(conn->fd, &conn->rx_buf[conn->rx_len], space, 0);
+    if (ret == 0) {
+        return -ENOTCONN;
+    }
+    if (ret < 0) {
+        return -errno;
+    }
+
+    conn->rx_len += ret;
+    return 0;
+}
+
+/* Drop bytes from the front of the read-ahead buffer */
+static void consume(struct http_conn *conn, size_t len)
+{
+    memmove(conn->rx_buf, &conn->rx_buf[len], conn->rx_len - len);
+    conn->rx_len -= len;
+}
+
+static int copy_body(const uint8_t *data, size_t len, void *user_data)
+{
+    struct response_sink *sink = user_data;
+
+    if (sink->buf && sink->len + 1 < sink->size) {
+        size_t copy = MIN(len, sink->size - 1 - sink->len);
+
+        memcpy(&sink->buf[sink->len], data, copy);
+        sink->len += copy;
+        sink->buf[sink->len] = '\0';
+    }
+    return 0;
+}
+
+/**
+ * @brief Read one whole response, leaving any bytes after it buffered
+ *
+ * @return HTTP status code, negative error code on failure
+ */
+static int read_response(struct http_conn *conn, char *response, size_t response_size)
+{
+    struct response_sink sink = {
+        .buf = response,
+        .size = response_size,
+        .len = 0
+    };
+    char *headers = (char *)conn->rx_buf;
+    char *headers_end;
+    int ret;
+
+    if (response && response_size > 0) {
+        response[0] = '\0';
+    }
+
+    /* Status line and header fields */
+    for (;;) {
+        conn->rx_buf[conn->rx_len] = '\0';
+        headers_end = strstr(headers, "\r\n\r\n");
+        if (headers_end) {
+            break;
+        }
+        ret = recv_more(conn);
+        if (ret == -EMSGSIZE) {
+            LOG_ERR("Response headers exceed %d bytes", HTTP_CONN_RX_BUFFER_SIZE - 1);
+        }
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    if (strncmp(headers, "HTTP/1.", 7) != 0) {
+        LOG_ERR("Invalid HTTP response format: %.20s", headers);
+        return -EPROTO;
+    }
+
+    size_t header_len = (headers_end + 4) - headers;
+    *headers_end = '\0';
+
+    int status = atoi(headers + 9);
+    bool chunked = strstr(headers, "Transfer-Encoding: chunked") != NULL;
+    bool close_after = strstr(headers, "Connection: close") != NULL ||
+                       strncmp(headers, "HTTP/1.0", 8) == 0;
+    const char *length_field = strstr(headers, "Content-Length:");
+    size_t remaining = 0;
+
+    if (length_field) {
+        remaining = strtoul(length_field + strlen("Content-Length:"), NULL, 10);
+    } else if (!chunked && close_after) {
+        /* Body runs to the end of the connection */
+        remaining = SIZE_MAX;
+    }
+
+    consume(conn, header_len);
+
+    if (chunked) {
+        struct http_chunked_decoder dec;
+
+        http_chunked_init(&dec);
+        while (!http_chunked_is_done(&dec)) {
+            if (conn->rx_len == 0) {
+                ret = recv_more(conn);
+                if (ret < 0) {
+                    return ret;
+                }
+            }
+            ret = http_chunked_feed(&dec, conn->rx_buf, conn->rx_len, copy_body, &sink);
+            if (ret < 0) {
+                return ret;
+            }
+            consume(conn, ret);
+        }
+    } else {
+        while (remaining > 0) {
+            if (conn->rx_len == 0) {
+                ret = recv_more(conn);
+                if (ret == -ENOTCONN && remaining == SIZE_MAX) {
+                    break;
+                }
+                if (ret < 0) {
+                    return ret;
+                }
+            }
+            size_t len = MIN(remaining, conn->rx_len);
+
+            copy_body(conn->rx_buf, len, &sink);
+            consume(conn, len);
+            if (remaining != SIZE_MAX) {
+                remaining -= len;
+            }
+        }
+    }
+
+    if (close_after) {
+        LOG_DBG("Server closes the control connection after this response");
+        drop_connection(conn);
+    }
+
+    LOG_DBG("HTTP %d, %zu body bytes", status, sink.len);
+    return status;
+}
+
+/**
+ * @brief Read and discard responses to pipelined requests
+ *
+ * @param limit Most responses to read
+ */
+static void drain_responses(struct http_conn *conn, size_t limit)
+{
+    while (conn->in_flight > 0 && limit-- > 0) {
+        conn->in_flight--;
+
+        int ret = read_response(conn, NULL, 0);
+        if (ret < 0) {
+            LOG_WRN("Lost response to a pipelined request: %d", ret);
+            drop_connection(conn);
+            return;
+        }
+        if (ret < 200 || ret >= 300) {
+            LOG_WRN("Pipelined request failed: HTTP %d", ret);
+        }
+    }
+}
+
+/**
+ * @brief The server is still holding the idle socket open
+ */
+static bool connection_alive(struct http_conn *conn)
+{
+    struct zsock_pollfd pfd = {
+        .fd = conn->fd,
+        .events = ZSOCK_POLLIN
+    };
+
+    /* An idle socket becomes readable only when the server closes it */
+    int ret = zsock_poll(&pfd, 1, 0);
+    if (ret < 0) {
+        return false;
+    }
+    return ret == 0 || !(pfd.revents & (ZSOCK_POLLIN | ZSOCK_POLLHUP | ZSOCK_POLLERR));
+}
+
+static void maintain_work_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct http_conn *conn = CONTAINER_OF(dwork, struct http_conn, maintain_work);
+    k_timeout_t next = K_MSEC(HTTP_CONN_MAINTAIN_MS);
+
+    /* A request in progress is using the socket - look again later */
+    if (k_mutex_lock(&conn->lock, K_NO_WAIT) != 0) {
+        k_work_reschedule_for_queue(&http_conn_workq, dwork, K_MSEC(HTTP_CONN_DRAIN_DELAY_MS));
+        return;
+    }
+    if (!conn->running) {
+        k_mutex_unlock(&conn->lock);
+        return;
+    }
+
+    drain_responses(conn, SIZE_MAX);
+
+    if (conn->fd >= 0 && !connection_alive(conn)) {
+        LOG_INF("Server closed the idle control connection, reconnecting");
+        drop_connection(conn);
+    }
+    if (conn->fd < 0 && ensure_connected(conn) < 0) {
+        next = K_MSEC(HTTP_CONN_RETRY_MS);
+    }
+
+    k_mutex_unlock(&conn->lock);
+    k_work_reschedule_for_queue(&http_conn_workq, dwork, next);
+}
+
+int http_conn_init(struct http_conn *conn, const char *host, uint16_t port)
+{
+    if (!conn || !host || port == 0 || strlen(host) >= sizeof(conn->host)) {
+        return -EINVAL;
+    }
+
+    if (!http_conn_workq_started) {
+        const struct k_work_queue_config cfg = {
+            .name = "http_conn",
+        };
+
+        k_work_queue_start(&http_conn_workq, http_conn_stack,
+                           K_THREAD_STACK_SIZEOF(http_conn_stack),
+                           HTTP_CONN_THREAD_PRIORITY, &cfg);
+        http_conn_workq_started = true;
+    }
+
+    strcpy(conn->host, host);
+    conn->port = port;
+    conn->fd = -1;
+    conn->in_flight = 0;
+    conn->rx_len = 0;
+    k_mutex_init(&conn->lock);
+    k_work_init_delayable(&conn->maintain_work, maintain_work_handler);
+
+    /* Connect in the background so the first request finds a socket ready */
+    conn->running = true;
+    k_work_reschedule_for_queue(&http_conn_workq, &conn->maintain_work, K_NO_WAIT);
+
+    LOG_INF("Control connection manager for %s:%u", host, port);
+    return 0;
+}
+
+int http_conn_request(struct http_conn *conn, const char *method, const char *path,
+                      const char *body, char *response, size_t response_size)
+{
+    int ret;
+
+    k_mutex_lock(&conn->lock, K_FOREVER);
+
+    drain_responses(conn, SIZE_MAX);
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool reused = (conn->fd >= 0);
+
+        ret = ensure_connected(conn);
+        if (ret < 0) {
+            break;
+        }
+        ret = send_request(conn, method, path, body);
+        if (ret == 0) {
+            ret = read_response(conn, response, response_size);
+        }
+        if (ret >= 0 || !reused || !is_closed_socket_error(ret)) {
+            break;
+        }
+
+        LOG_WRN("Kept-alive control connection was closed (%d), reconnecting", ret);
+        drop_connection(conn);
+    }
+
+    /* Whatever was half-read is unusable for the next request */
+    if (ret < 0) {
+        drop_connection(conn);
+    }
+
+    k_mutex_unlock(&conn->lock);
+    return ret;
+}
+
+int http_conn_send(struct http_conn *conn, const char *method, const char *path,
+                   const char *body)
+{
+    int ret;
+
+    k_mutex_lock(&conn->lock, K_FOREVER);
+
+    if (conn->in_flight >= HTTP_CONN_MAX_IN_FLIGHT) {
+        drain_responses(conn, 1);
+    }
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool reused = (conn->fd >= 0);
+
+        ret = ensure_connected(conn);
+        if (ret < 0) {
+            break;
+        }
+        ret = send_request(conn, method, path, body);
+        if (ret == 0 || !reused || !is_closed_socket_error(ret)) {
+            break;
+        }
+
+        LOG_WRN("Kept-alive control connection was closed (%d), reconnecting", ret);
+        drop_connection(conn);
+    }
+
+    if (ret == 0) {
+        conn->in_flight++;
+        if (conn->running) {
+            k_work_reschedule_for_queue(&http_conn_workq, &conn->maintain_work,
+                                        K_MSEC(HTTP_CONN_DRAIN_DELAY_MS));
+        }
+    } else {
+        drop_connection(conn);
+    }
+
+    k_mutex_unlock(&conn->lock);
+    return ret;
+}
+
+int http_conn_schedule(struct k_work_delayable *work, k_timeout_t delay)
+{
+    if (!http_conn_workq_started) {
+        return -EAGAIN;
+    }
+    return k_work_reschedule_for_queue(&http_conn_workq, work, delay);
+}
+
+void http_conn_close(struct http_conn *conn)
+{
+    struct k_work_sync sync;
+
+    k_mutex_lock(&conn->lock, K_FOREVER);
+    conn->running = false;
+    k_mutex_unlock(&conn->lock);
+
+    k_work_cancel_delayable_sync(&conn->maintain_work, &sync);
+
+    k_mutex_lock(&conn->lock, K_FOREVER);
+    drop_connection(conn);
+    k_mutex_unlock(&conn->lock);
+}
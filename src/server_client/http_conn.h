@@ -0,0 +1,127 @@
+/**
+ * @file http_conn.h
+ * @brief Persistent HTTP/1.1 connection for short control requests
+ *
+ * Keeps one kept-alive socket open to the server so a control request
+ * costs a single round trip instead of a TCP connect (the slowest step on
+ * the eswifi module). Requests may be pipelined: http_conn_send() writes
+ * the request and returns, and the responses are read back in order by
+ * the next synchronous request or by the background maintenance work.
+ *
+ * The maintenance work runs on its own low-priority work queue. It drains
+ * pipelined responses, notices when the server has closed an idle socket
+ * and reconnects before the next request needs it.
+ *
+ * Other low-priority network work (the metrics push) can share the queue
+ * through http_conn_schedule().
+ *
+ * All functions are thread safe. The streaming socket is not managed
+ * here; it belongs to the receive thread of audio_client.c.
+ */
+
+#ifndef HTTP_CONN_H
+#define HTTP_CONN_H
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_CONN_HOST_MAX 32           ///< Longest host name, including the terminator
+#define HTTP_CONN_RX_BUFFER_SIZE 384    ///< Holds a whole response header block
+#define HTTP_CONN_MAX_IN_FLIGHT 4       ///< Pipelined requests before http_conn_send() drains one
+
+/**
+ * @brief Manager state, one per server
+ */
+struct http_conn {
+    char host[HTTP_CONN_HOST_MAX];
+    uint16_t port;
+    int fd;                             ///< -1 while disconnected
+    struct k_mutex lock;
+    size_t in_flight;                   ///< Requests sent whose responses haven't been read
+    uint8_t rx_buf[HTTP_CONN_RX_BUFFER_SIZE];
+    size_t rx_len;                      ///< Bytes of the next response already received
+    struct k_work_delayable maintain_work;
+    bool running;                       ///< Maintenance work may be scheduled
+};
+
+/**
+ * @brief Open a TCP socket to a server with the client's socket options
+ *
+ * Shared with the streaming connection in audio_client.c.
+ *
+ * @param host IPv4 address in dotted notation
+ * @param port Server port
+ * @return Connected socket descriptor, negative error code on failure
+ */
+int http_conn_open_socket(const char *host, uint16_t port);
+
+/**
+ * @brief Set up a manager and start connecting in the background
+ *
+ * @param conn Manager state
+ * @param host IPv4 address in dotted notation
+ * @param port Server port
+ * @return 0 on success, -EINVAL on bad parameters
+ */
+int http_conn_init(struct http_conn *conn, const char *host, uint16_t port);
+
+/**
+ * @brief Send a request and wait for its response
+ *
+ * Responses to earlier pipelined requests are read and discarded first.
+ * A request that fails on a socket the server has closed is retried once
+ * on a new connection.
+ *
+ * @param conn Manager state
+ * @param method HTTP method
+ * @param path Request target
+ * @param body JSON body, NULL for none
+ * @param response Buffer for the response body (NUL terminated), may be NULL
+ * @param response_size Size of @p response
+ * @return HTTP status code, negative error code on failure
+ */
+int http_conn_request(struct http_conn *conn, const char *method, const char *path,
+                      const char *body, char *response, size_t response_size);
+
+/**
+ * @brief Pipeline a request without waiting for its response
+ *
+ * @param conn Manager state
+ * @param method HTTP method
+ * @param path Request target
+ * @param body JSON body, NULL for none
+ * @return 0 once the request is sent, negative error code on failure
+ */
+int http_conn_send(struct http_conn *conn, const char *method, const char *path,
+                   const char *body);
+
+/**
+ * @brief Run delayable work on the connection manager's work queue
+ *
+ * For background requests that may block on the network, which must not
+ * hold up the system work queue.
+ *
+ * @param work Work item, initialised with k_work_init_delayable()
+ * @param delay Time before it runs
+ * @return As k_work_reschedule_for_queue()
+ */
+int http_conn_schedule(struct k_work_delayable *work, k_timeout_t delay);
+
+/**
+ * @brief Close the connection and stop the background work
+ *
+ * @param conn Manager state
+ */
+void http_conn_close(struct http_conn *conn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HTTP_CONN_H */
@@ -0,0 +1,75 @@
+/**
+ * @file stream_frame.h
+ * @brief Binary frame format of the /audio/frames stream endpoint
+ *
+ * The response body is a run of frames, each a fixed 16-byte header
+ * followed by @c length payload bytes. All fields are little-endian:
+ *
+ *     offset  size  field
+ *     0       2     magic (STREAM_FRAME_MAGIC)
+ *     2       1     version (STREAM_FRAME_VERSION)
+ *     3       1     flags
+ *     4       4     sequence, 0 for the first frame of a response
+ *     8       4     timestamp of the first payload sample, ms from the track start
+ *     12      2     length of the payload in bytes
+ *     14      2     reserved, 0
+ *
+ * The first frame of every response has STREAM_FRAME_FLAG_FORMAT and a
+ * STREAM_FRAME_FORMAT_SIZE payload describing the track. Every other frame
+ * carries whole sample frames of PCM from the WAV data chunk. The low flag
+ * bits are the AUDIO_BUFFER_FLAG_* values, so they map directly onto the
+ * pooled buffers, and the last frame carries END_OF_STREAM.
+ *
+ * The response has a Content-Length and no transfer coding, so the client
+ * can receive every header and payload with exactly sized recv() calls.
+ *
+ * Must match the FRAME_* definitions in server_host/wav_framing.py.
+ */
+
+#ifndef STREAM_FRAME_H
+#define STREAM_FRAME_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STREAM_FRAME_CONTENT_TYPE "application/x-audio-frames"
+
+#define STREAM_FRAME_MAGIC 0x5246          ///< "FR"
+#define STREAM_FRAME_VERSION 1
+#define STREAM_FRAME_HEADER_SIZE 16
+
+/** Payload is a track description, not PCM */
+#define STREAM_FRAME_FLAG_FORMAT (1 << 7)
+
+/*
+ * Format frame payload:
+ *
+ *     offset  size  field
+ *     0       4     sample rate in Hz
+ *     4       2     channels
+ *     6       2     bits per sample
+ *     8       2     block align (bytes per sample frame)
+ *     10      2     reserved, 0
+ *     12      4     file offset of the first PCM byte
+ *     16      4     size of the WAV data chunk in bytes
+ */
+#define STREAM_FRAME_FORMAT_SIZE 20
+
+/**
+ * @brief Decoded frame header
+ */
+struct stream_frame_header {
+    uint8_t flags;
+    uint32_t sequence;
+    uint32_t timestamp_ms;
+    uint16_t length;
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STREAM_FRAME_H */
@@ -0,0 +1,29 @@
+/**
+ * @file sim_autoconf.h
+ * @brief Kconfig symbols for the simulation build
+ *
+ * build_sim.sh passes the values from zephyr/prj.conf with -D; the
+ * fallbacks below are the zephyr/Kconfig defaults. Force-included with
+ * -include, like the generated autoconf.h in a Zephyr build.
+ */
+
+#ifndef SIM_AUTOCONF_H
+#define SIM_AUTOCONF_H
+
+#ifndef CONFIG_APP_AUDIO_BUFFER_COUNT
+#define CONFIG_APP_AUDIO_BUFFER_COUNT 4
+#endif
+#ifndef CONFIG_APP_AUDIO_BUFFER_SIZE
+#define CONFIG_APP_AUDIO_BUFFER_SIZE 2048
+#endif
+#ifndef CONFIG_APP_AUDIO_POOL_LATENCY_MS
+#define CONFIG_APP_AUDIO_POOL_LATENCY_MS 30
+#endif
+#ifndef CONFIG_APP_SD_READAHEAD_DEPTH
+#define CONFIG_APP_SD_READAHEAD_DEPTH 3
+#endif
+#ifndef CONFIG_APP_MEDIA_INDEX_MAX_TRACKS
+#define CONFIG_APP_MEDIA_INDEX_MAX_TRACKS 32
+#endif
+
+#endif /* SIM_AUTOCONF_H */
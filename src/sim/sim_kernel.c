@@ -0,0 +1,385 @@
+/**
+ * @file sim_kernel.c
+ * @brief pthread implementation of the simulated Zephyr primitives
+ *
+ * This file is part of the simulation build, see zephyr/kernel.h in this
+ * directory. Timed waits run on CLOCK_MONOTONIC so wall-clock changes
+ * don't shorten or stretch them.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Initialize a condition variable that waits on CLOCK_MONOTONIC
+ */
+static void sim_cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/**
+ * @brief Absolute CLOCK_MONOTONIC deadline @p timeout from now
+ */
+static struct timespec sim_deadline(k_timeout_t timeout)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += timeout.ms / 1000;
+    ts.tv_nsec += (timeout.ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+/**
+ * @brief Wait on @p cond, holding @p lock, until signalled or @p deadline
+ *
+ * @return 0 when signalled, -EAGAIN once the deadline has passed
+ */
+static int sim_cond_wait(pthread_cond_t *cond, pthread_mutex_t *lock, k_timeout_t timeout,
+                         const struct timespec *deadline)
+{
+    if (K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+        pthread_cond_wait(cond, lock);
+        return 0;
+    }
+    return pthread_cond_timedwait(cond, lock, deadline) == ETIMEDOUT ? -EAGAIN : 0;
+}
+
+int k_mutex_init(struct k_mutex *mutex)
+{
+    pthread_mutexattr_t attr;
+
+    /* k_mutex may be re-locked by its owner */
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mutex->lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return 0;
+}
+
+int k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
+{
+    if (K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+        return -pthread_mutex_lock(&mutex->lock);
+    }
+    if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+        return pthread_mutex_trylock(&mutex->lock) == 0 ? 0 : -EBUSY;
+    }
+
+    /* pthread_mutex_timedlock only takes CLOCK_REALTIME deadlines */
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout.ms / 1000;
+    deadline.tv_nsec += (timeout.ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return pthread_mutex_timedlock(&mutex->lock, &deadline) == 0 ? 0 : -EAGAIN;
+}
+
+int k_mutex_unlock(struct k_mutex *mutex)
+{
+    return pthread_mutex_unlock(&mutex->lock) == 0 ? 0 : -EPERM;
+}
+
+int k_condvar_init(struct k_condvar *condvar)
+{
+    sim_cond_init(&condvar->cond);
+    return 0;
+}
+
+int k_condvar_signal(struct k_condvar *condvar)
+{
+    pthread_cond_signal(&condvar->cond);
+    return 0;
+}
+
+int k_condvar_broadcast(struct k_condvar *condvar)
+{
+    pthread_cond_broadcast(&condvar->cond);
+    return 0;
+}
+
+int k_condvar_wait(struct k_condvar *condvar, struct k_mutex *mutex, k_timeout_t timeout)
+{
+    struct timespec deadline = sim_deadline(timeout);
+
+    if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+        return -EAGAIN;
+    }
+    return sim_cond_wait(&condvar->cond, &mutex->lock, timeout, &deadline);
+}
+
+int k_sem_init(struct k_sem *sem, unsigned int initial_count, unsigned int limit)
+{
+    if (limit == 0 || initial_count > limit) {
+        return -EINVAL;
+    }
+
+    pthread_mutex_init(&sem->lock, NULL);
+    sim_cond_init(&sem->cond);
+    sem->count = initial_count;
+    sem->limit = limit;
+    return 0;
+}
+
+int k_sem_take(struct k_sem *sem, k_timeout_t timeout)
+{
+    struct timespec deadline = sim_deadline(timeout);
+    int ret = 0;
+
+    pthread_mutex_lock(&sem->lock);
+    while (sem->count == 0) {
+        if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+            ret = -EBUSY;
+            break;
+        }
+        ret = sim_cond_wait(&sem->cond, &sem->lock, timeout, &deadline);
+        if (ret != 0 && sem->count == 0) {
+            break;
+        }
+        ret = 0;
+    }
+    if (ret == 0) {
+        sem->count--;
+    }
+    pthread_mutex_unlock(&sem->lock);
+    return ret;
+}
+
+void k_sem_give(struct k_sem *sem)
+{
+    pthread_mutex_lock(&sem->lock);
+    if (sem->count < sem->limit) {
+        sem->count++;
+    }
+    pthread_cond_signal(&sem->cond);
+    pthread_mutex_unlock(&sem->lock);
+}
+
+void k_sem_reset(struct k_sem *sem)
+{
+    pthread_mutex_lock(&sem->lock);
+    sem->count = 0;
+    pthread_mutex_unlock(&sem->lock);
+}
+
+unsigned int k_sem_count_get(struct k_sem *sem)
+{
+    pthread_mutex_lock(&sem->lock);
+    unsigned int count = sem->count;
+    pthread_mutex_unlock(&sem->lock);
+    return count;
+}
+
+void k_fifo_init(struct k_fifo *fifo)
+{
+    pthread_mutex_init(&fifo->lock, NULL);
+    sim_cond_init(&fifo->cond);
+    fifo->head = NULL;
+    fifo->tail = NULL;
+}
+
+void k_fifo_put(struct k_fifo *fifo, void *data)
+{
+    pthread_mutex_lock(&fifo->lock);
+    *(void **)data = NULL;
+    if (fifo->tail) {
+        *(void **)fifo->tail = data;
+    } else {
+        fifo->head = data;
+    }
+    fifo->tail = data;
+    pthread_cond_signal(&fifo->cond);
+    pthread_mutex_unlock(&fifo->lock);
+}
+
+void *k_fifo_get(struct k_fifo *fifo, k_timeout_t timeout)
+{
+    struct timespec deadline = sim_deadline(timeout);
+    void *data = NULL;
+
+    pthread_mutex_lock(&fifo->lock);
+    while (!fifo->head) {
+        if (K_TIMEOUT_EQ(timeout, K_NO_WAIT) ||
+            (sim_cond_wait(&fifo->cond, &fifo->lock, timeout, &deadline) != 0 && !fifo->head)) {
+            break;
+        }
+    }
+    if (fifo->head) {
+        data = fifo->head;
+        fifo->head = *(void **)data;
+        if (!fifo->head) {
+            fifo->tail = NULL;
+        }
+    }
+    pthread_mutex_unlock(&fifo->lock);
+    return data;
+}
+
+bool k_fifo_is_empty(struct k_fifo *fifo)
+{
+    pthread_mutex_lock(&fifo->lock);
+    bool empty = (fifo->head == NULL);
+    pthread_mutex_unlock(&fifo->lock);
+    return empty;
+}
+
+static void *sim_thread_main(void *arg)
+{
+    struct k_thread *thread = arg;
+
+    thread->entry(thread->p1, thread->p2, thread->p3);
+    return NULL;
+}
+
+k_tid_t k_thread_create(struct k_thread *thread, k_thread_stack_t *stack, size_t stack_size,
+                        k_thread_entry_t entry, void *p1, void *p2, void *p3, int prio,
+                        uint32_t options, k_timeout_t delay)
+{
+    thread->entry = entry;
+    thread->p1 = p1;
+    thread->p2 = p2;
+    thread->p3 = p3;
+    if (pthread_create(&thread->tid, NULL, sim_thread_main, thread) != 0) {
+        return NULL;
+    }
+    return thread;
+}
+
+int k_thread_join(struct k_thread *thread, k_timeout_t timeout)
+{
+    /* Only waiting forever is needed by the modules built here */
+    return pthread_join(thread->tid, NULL) == 0 ? 0 : -EINVAL;
+}
+
+int k_mem_slab_init(struct k_mem_slab *slab, void *buffer, size_t block_size,
+                    uint32_t num_blocks)
+{
+    if (!buffer || block_size < sizeof(void *) || num_blocks == 0) {
+        return -EINVAL;
+    }
+
+    pthread_mutex_init(&slab->lock, NULL);
+    sim_cond_init(&slab->cond);
+    slab->block_size = block_size;
+    slab->num_blocks = num_blocks;
+    slab->num_used = 0;
+
+    /* Thread the free list through the blocks, first block first. Blocks
+     * may be only 4-byte aligned, so the links are copied, not stored */
+    slab->free_list = NULL;
+    for (uint32_t i = num_blocks; i-- > 0;) {
+        char *block = (char *)buffer + (size_t)i * block_size;
+        memcpy(block, &slab->free_list, sizeof(slab->free_list));
+        slab->free_list = block;
+    }
+    return 0;
+}
+
+int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
+{
+    struct timespec deadline = sim_deadline(timeout);
+    int ret = 0;
+
+    pthread_mutex_lock(&slab->lock);
+    while (!slab->free_list) {
+        if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+            ret = -ENOMEM;
+            break;
+        }
+        ret = sim_cond_wait(&slab->cond, &slab->lock, timeout, &deadline);
+        if (ret != 0 && !slab->free_list) {
+            break;
+        }
+        ret = 0;
+    }
+    if (ret == 0) {
+        *mem = slab->free_list;
+        memcpy(&slab->free_list, slab->free_list, sizeof(slab->free_list));
+        slab->num_used++;
+    } else {
+        *mem = NULL;
+    }
+    pthread_mutex_unlock(&slab->lock);
+    return ret;
+}
+
+void k_mem_slab_free(struct k_mem_slab *slab, void *mem)
+{
+    pthread_mutex_lock(&slab->lock);
+    memcpy(mem, &slab->free_list, sizeof(slab->free_list));
+    slab->free_list = mem;
+    slab->num_used--;
+    pthread_cond_signal(&slab->cond);
+    pthread_mutex_unlock(&slab->lock);
+}
+
+uint32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
+{
+    pthread_mutex_lock(&slab->lock);
+    uint32_t used = slab->num_used;
+    pthread_mutex_unlock(&slab->lock);
+    return used;
+}
+
+/**
+ * @brief Monotonic nanoseconds
+ */
+static uint64_t sim_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t boot_ns;
+static pthread_once_t boot_once = PTHREAD_ONCE_INIT;
+
+static void sim_boot(void)
+{
+    boot_ns = sim_now_ns();
+}
+
+int64_t k_uptime_get(void)
+{
+    /* "Boot" is the first call */
+    pthread_once(&boot_once, sim_boot);
+    return (int64_t)((sim_now_ns() - boot_ns) / 1000000ULL);
+}
+
+uint32_t k_cycle_get_32(void)
+{
+    return (uint32_t)sim_now_ns();
+}
+
+int32_t k_msleep(int32_t ms)
+{
+    return k_usleep(ms * 1000) / 1000;
+}
+
+int32_t k_usleep(int32_t us)
+{
+    struct timespec ts = {
+        .tv_sec = us / 1000000,
+        .tv_nsec = (long)(us % 1000000) * 1000L,
+    };
+
+    nanosleep(&ts, NULL);
+    return 0;
+}
@@ -0,0 +1,17 @@
+/**
+ * @file devicetree.h
+ * @brief Empty devicetree for the simulation build
+ *
+ * The host has no SRAM2 node, so mem_plan.h keeps the audio pools in
+ * ordinary static storage.
+ */
+
+#ifndef SIM_ZEPHYR_DEVICETREE_H
+#define SIM_ZEPHYR_DEVICETREE_H
+
+#define DT_NODELABEL(label)            0
+#define DT_NODE_HAS_PROP(node, prop)   0
+#define DT_REG_SIZE(node)              0
+#define DT_REG_ADDR(node)              0
+
+#endif /* SIM_ZEPHYR_DEVICETREE_H */
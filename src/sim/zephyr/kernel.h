@@ -0,0 +1,148 @@
+/**
+ * @file kernel.h
+ * @brief POSIX stand-in for the Zephyr kernel API used by the pipeline modules
+ *
+ * Part of the simulation build (build_sim.sh). Only the primitives that
+ * the pipeline and storage modules call are provided, with Zephyr's
+ * return conventions: 0 on success, -EBUSY/-ENOMEM when K_NO_WAIT finds
+ * nothing, -EAGAIN when a timeout expires. Mutexes are recursive like
+ * k_mutex. Threads are pthreads that ignore the stack and priority they
+ * are given. Implemented in sim_kernel.c.
+ */
+
+#ifndef SIM_ZEPHYR_KERNEL_H
+#define SIM_ZEPHYR_KERNEL_H
+
+#include <zephyr/toolchain.h>
+#include <zephyr/sys/util.h>
+#include <pthread.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Timeouts are kept in milliseconds, -1 waits forever */
+typedef struct {
+    int64_t ms;
+} k_timeout_t;
+
+#define K_NO_WAIT              ((k_timeout_t){ .ms = 0 })
+#define K_FOREVER              ((k_timeout_t){ .ms = -1 })
+#define K_MSEC(ms_)            ((k_timeout_t){ .ms = (ms_) })
+#define K_SECONDS(s)           K_MSEC((int64_t)(s) * 1000)
+#define K_TIMEOUT_EQ(a, b)     ((a).ms == (b).ms)
+
+struct k_mutex {
+    pthread_mutex_t lock;
+};
+
+struct k_condvar {
+    pthread_cond_t cond;
+};
+
+struct k_sem {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    unsigned int count;
+    unsigned int limit;
+};
+
+/** Items keep their first pointer-sized word free for the link, as in Zephyr */
+struct k_fifo {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    void *head;
+    void *tail;
+};
+
+typedef void (*k_thread_entry_t)(void *p1, void *p2, void *p3);
+
+struct k_thread {
+    pthread_t tid;
+    k_thread_entry_t entry;
+    void *p1;
+    void *p2;
+    void *p3;
+};
+
+typedef struct k_thread *k_tid_t;
+typedef char k_thread_stack_t;
+
+#define K_THREAD_STACK_DEFINE(sym, size) k_thread_stack_t sym[size]
+#define K_THREAD_STACK_SIZEOF(sym)       sizeof(sym)
+#define K_PRIO_PREEMPT(x)                (x)
+#define K_LOWEST_APPLICATION_THREAD_PRIO 14
+
+struct k_mem_slab {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    char *free_list;           ///< First free block, its first bytes link the next
+    size_t block_size;
+    uint32_t num_blocks;
+    uint32_t num_used;
+};
+
+int k_mutex_init(struct k_mutex *mutex);
+int k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout);
+int k_mutex_unlock(struct k_mutex *mutex);
+
+int k_condvar_init(struct k_condvar *condvar);
+int k_condvar_signal(struct k_condvar *condvar);
+int k_condvar_broadcast(struct k_condvar *condvar);
+int k_condvar_wait(struct k_condvar *condvar, struct k_mutex *mutex, k_timeout_t timeout);
+
+int k_sem_init(struct k_sem *sem, unsigned int initial_count, unsigned int limit);
+int k_sem_take(struct k_sem *sem, k_timeout_t timeout);
+void k_sem_give(struct k_sem *sem);
+void k_sem_reset(struct k_sem *sem);
+unsigned int k_sem_count_get(struct k_sem *sem);
+
+void k_fifo_init(struct k_fifo *fifo);
+void k_fifo_put(struct k_fifo *fifo, void *data);
+void *k_fifo_get(struct k_fifo *fifo, k_timeout_t timeout);
+bool k_fifo_is_empty(struct k_fifo *fifo);
+
+k_tid_t k_thread_create(struct k_thread *thread, k_thread_stack_t *stack, size_t stack_size,
+                        k_thread_entry_t entry, void *p1, void *p2, void *p3, int prio,
+                        uint32_t options, k_timeout_t delay);
+int k_thread_join(struct k_thread *thread, k_timeout_t timeout);
+
+static inline int k_thread_name_set(k_tid_t thread, const char *name)
+{
+    return 0;
+}
+
+int k_mem_slab_init(struct k_mem_slab *slab, void *buffer, size_t block_size,
+                    uint32_t num_blocks);
+int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout);
+void k_mem_slab_free(struct k_mem_slab *slab, void *mem);
+uint32_t k_mem_slab_num_used_get(struct k_mem_slab *slab);
+
+/** Milliseconds since the first call */
+int64_t k_uptime_get(void);
+
+/** The simulated cycle counter runs at 1 GHz (monotonic nanoseconds) */
+uint32_t k_cycle_get_32(void);
+
+static inline uint32_t k_cyc_to_us_floor32(uint32_t cycles)
+{
+    return cycles / 1000U;
+}
+
+int32_t k_msleep(int32_t ms);
+int32_t k_usleep(int32_t us);
+
+static inline bool k_is_in_isr(void)
+{
+    return false;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_ZEPHYR_KERNEL_H */
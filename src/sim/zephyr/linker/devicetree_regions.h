@@ -0,0 +1,11 @@
+/**
+ * @file devicetree_regions.h
+ * @brief Linker region names - unused on the host, see sim devicetree.h
+ */
+
+#ifndef SIM_ZEPHYR_LINKER_DEVICETREE_REGIONS_H
+#define SIM_ZEPHYR_LINKER_DEVICETREE_REGIONS_H
+
+#define LINKER_DT_NODE_REGION_NAME(node) ".sim_region"
+
+#endif /* SIM_ZEPHYR_LINKER_DEVICETREE_REGIONS_H */
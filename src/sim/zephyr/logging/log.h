@@ -0,0 +1,41 @@
+/**
+ * @file log.h
+ * @brief Zephyr logging macros on printf, in the [SIM_*] format of sim_fs.c
+ *
+ * Messages above SIM_LOG_LEVEL are compiled out; the default keeps
+ * warnings and errors so the hot path stays quiet in benchmarks. Build
+ * with -DSIM_LOG_LEVEL=LOG_LEVEL_DBG to see everything.
+ */
+
+#ifndef SIM_ZEPHYR_LOGGING_LOG_H
+#define SIM_ZEPHYR_LOGGING_LOG_H
+
+#include <stdio.h>
+
+#define LOG_LEVEL_NONE         0
+#define LOG_LEVEL_ERR          1
+#define LOG_LEVEL_WRN          2
+#define LOG_LEVEL_INF          3
+#define LOG_LEVEL_DBG          4
+
+#ifndef SIM_LOG_LEVEL
+#define SIM_LOG_LEVEL          LOG_LEVEL_WRN
+#endif
+
+#define LOG_MODULE_REGISTER(name, ...) \
+    static const char sim_log_module[] __attribute__((unused)) = #name
+#define LOG_MODULE_DECLARE(name, ...)  LOG_MODULE_REGISTER(name)
+
+#define SIM_LOG(level, tag, fmt, ...)                                          \
+    do {                                                                       \
+        if ((level) <= SIM_LOG_LEVEL) {                                       \
+            printf("[SIM_" tag "] %s: " fmt "\n", sim_log_module, ##__VA_ARGS__); \
+        }                                                                      \
+    } while (0)
+
+#define LOG_ERR(fmt, ...)      SIM_LOG(LOG_LEVEL_ERR, "ERR", fmt, ##__VA_ARGS__)
+#define LOG_WRN(fmt, ...)      SIM_LOG(LOG_LEVEL_WRN, "WRN", fmt, ##__VA_ARGS__)
+#define LOG_INF(fmt, ...)      SIM_LOG(LOG_LEVEL_INF, "INF", fmt, ##__VA_ARGS__)
+#define LOG_DBG(fmt, ...)      SIM_LOG(LOG_LEVEL_DBG, "DBG", fmt, ##__VA_ARGS__)
+
+#endif /* SIM_ZEPHYR_LOGGING_LOG_H */
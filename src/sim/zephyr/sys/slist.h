@@ -0,0 +1,25 @@
+/**
+ * @file slist.h
+ * @brief Singly linked list node types from Zephyr's sys/slist.h
+ *
+ * Only the types, for structures that embed a node; no list operations
+ * are used by the simulated modules.
+ */
+
+#ifndef SIM_ZEPHYR_SYS_SLIST_H
+#define SIM_ZEPHYR_SYS_SLIST_H
+
+struct _snode {
+    struct _snode *next;
+};
+
+typedef struct _snode sys_snode_t;
+
+struct _slist {
+    sys_snode_t *head;
+    sys_snode_t *tail;
+};
+
+typedef struct _slist sys_slist_t;
+
+#endif /* SIM_ZEPHYR_SYS_SLIST_H */
@@ -0,0 +1,27 @@
+/**
+ * @file util.h
+ * @brief The Zephyr sys/util.h macros the pipeline modules use
+ */
+
+#ifndef SIM_ZEPHYR_SYS_UTIL_H
+#define SIM_ZEPHYR_SYS_UTIL_H
+
+#include <zephyr/toolchain.h>
+#include <stddef.h>
+
+#ifndef MIN
+#define MIN(a, b)              (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b)              (((a) > (b)) ? (a) : (b))
+#endif
+#define CLAMP(val, low, high)  (((val) <= (low)) ? (low) : MIN(val, high))
+
+#define ARRAY_SIZE(array)      (sizeof(array) / sizeof((array)[0]))
+#define DIV_ROUND_UP(n, d)     (((n) + (d) - 1) / (d))
+#define ROUND_UP(x, align)     (DIV_ROUND_UP(x, align) * (align))
+#define BIT(n)                 (1UL << (n))
+#define CONTAINER_OF(ptr, type, field) \
+    ((type *)(((char *)(ptr)) - offsetof(type, field)))
+
+#endif /* SIM_ZEPHYR_SYS_UTIL_H */
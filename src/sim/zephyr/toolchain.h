@@ -0,0 +1,22 @@
+/**
+ * @file toolchain.h
+ * @brief Compiler helpers from Zephyr's toolchain.h for the simulation build
+ */
+
+#ifndef SIM_ZEPHYR_TOOLCHAIN_H
+#define SIM_ZEPHYR_TOOLCHAIN_H
+
+#ifndef __aligned
+#define __aligned(x)           __attribute__((__aligned__(x)))
+#endif
+#ifndef __packed
+#define __packed               __attribute__((__packed__))
+#endif
+#ifndef __unused
+#define __unused               __attribute__((__unused__))
+#endif
+
+#define BUILD_ASSERT(expr, ...) _Static_assert(expr, "" __VA_ARGS__)
+#define ARG_UNUSED(x)          (void)(x)
+
+#endif /* SIM_ZEPHYR_TOOLCHAIN_H */
@@ -268,6 +268,55 @@ fs_result_t media_fs_open(fs_file_t *file, const char *path)
     return FS_OK;
 }
 
+fs_result_t media_fs_create(fs_file_t *file, const char *path)
+{
+    int ret;
+    char full_path[512];
+    struct internal_file *internal_file;
+    
+    if (!file || !path) {
+        return FS_ERROR_INVALID_PARAM;
+    }
+    
+    if (!media_fs_is_ready()) {
+        return FS_ERROR_NOT_INITIALIZED;
+    }
+    
+    internal_file = get_free_file_handle();
+    if (!internal_file) {
+        LOG_ERR("No free file handles available");
+        return FS_ERROR_NO_MEMORY;
+    }
+    
+    build_full_path(full_path, sizeof(full_path), path);
+    fs_file_t_init(&internal_file->zephyr_file);
+    
+    ret = fs_open(&internal_file->zephyr_file, full_path, FS_O_CREATE | FS_O_WRITE);
+    if (ret != 0) {
+        LOG_ERR("Failed to create file %s: %d", full_path, ret);
+        release_file_handle(internal_file);
+        return FS_ERROR_OPEN_FAILED;
+    }
+    
+    /* Drop any previous contents */
+    ret = fs_truncate(&internal_file->zephyr_file, 0);
+    if (ret != 0) {
+        LOG_ERR("Failed to truncate file %s: %d", full_path, ret);
+        fs_close(&internal_file->zephyr_file);
+        release_file_handle(internal_file);
+        return FS_ERROR_WRITE_FAILED;
+    }
+    
+    file->handle = internal_file;
+    file->is_open = true;
+    file->size = 0;
+    file->position = 0;
+    
+    LOG_DBG("Created file %s", path);
+    
+    return FS_OK;
+}
+
 fs_result_t media_fs_close(fs_file_t *file)
 {
     int ret;
@@ -318,6 +367,34 @@ fs_result_t media_fs_read(fs_file_t *file, void *buffer, size_t size, size_t *by
     return FS_OK;
 }
 
+fs_result_t media_fs_write(fs_file_t *file, const void *buffer, size_t size,
+                           size_t *bytes_written)
+{
+    ssize_t ret;
+    struct internal_file *internal_file;
+    
+    if (!file || !file->handle || !file->is_open || !buffer || !bytes_written) {
+        return FS_ERROR_INVALID_PARAM;
+    }
+    
+    internal_file = (struct internal_file *)file->handle;
+    
+    ret = fs_write(&internal_file->zephyr_file, buffer, size);
+    if (ret < 0) {
+        LOG_ERR("Failed to write file: %d", (int)ret);
+        *bytes_written = 0;
+        return FS_ERROR_WRITE_FAILED;
+    }
+    
+    *bytes_written = ret;
+    file->position += ret;
+    if (file->position > file->size) {
+        file->size = file->position;
+    }
+    
+    return ((size_t)ret == size) ? FS_OK : FS_ERROR_WRITE_FAILED;
+}
+
 fs_result_t media_fs_seek(fs_file_t *file, size_t offset)
 {
     int ret;
@@ -506,55 +583,22 @@ fs_result_t media_fs_get_stats(fs_stats_t *stats)
     return FS_OK;
 }
 
-fs_result_t media_fs_list_audio_files(const char *path, char files[][256], 
-                                     size_t max_files, size_t *count)
+bool media_fs_is_audio_file(const char *name)
 {
-    fs_dir_t dir;
-    fs_dirent_t entry;
-    fs_result_t result;
-    size_t found = 0;
-    
-    if (!files || !count || max_files == 0) {
-        return FS_ERROR_INVALID_PARAM;
-    }
-    
-    *count = 0;
+    const char *ext;
     
-    result = media_fs_opendir(&dir, path);
-    if (result != FS_OK) {
-        return result;
+    if (!name) {
+        return false;
     }
     
-    while (found < max_files) {
-        result = media_fs_readdir(&dir, &entry);
-        if (result != FS_OK) {
-            break; /* End of directory or error */
-        }
-        
-        /* Skip directories */
-        if (entry.is_directory) {
-            continue;
-        }
-        
-        /* Check for audio file extensions */
-        char *ext = strrchr(entry.name, '.');
-        if (ext) {
-            if (strcasecmp(ext, ".wav") == 0 || 
-                strcasecmp(ext, ".mp3") == 0 ||
-                strcasecmp(ext, ".flac") == 0) {
-                strncpy(files[found], entry.name, 255);
-                files[found][255] = '\0';
-                found++;
-            }
-        }
+    ext = strrchr(name, '.');
+    if (!ext) {
+        return false;
     }
     
-    media_fs_closedir(&dir);
-    
-    *count = found;
-    LOG_INF("Found %zu audio files", found);
-    
-    return FS_OK;
+    return strcasecmp(ext, ".wav") == 0 || 
+           strcasecmp(ext, ".mp3") == 0 ||
+           strcasecmp(ext, ".flac") == 0;
 }
 
 const char *media_fs_error_to_string(fs_result_t error)
@@ -104,6 +104,17 @@ bool media_fs_is_ready(void);
  */
 fs_result_t media_fs_open(fs_file_t *file, const char *path);
 
+/**
+ * @brief Create a file for writing
+ * 
+ * Creates the file if it does not exist and truncates it if it does.
+ * 
+ * @param file Pointer to file handle struct
+ * @param path Path to the file to create
+ * @return FS_OK on success, error code on failure
+ */
+fs_result_t media_fs_create(fs_file_t *file, const char *path);
+
 /**
  * @brief Close an open file
  * 
@@ -123,6 +134,18 @@ fs_result_t media_fs_close(fs_file_t *file);
  */
 fs_result_t media_fs_read(fs_file_t *file, void *buffer, size_t size, size_t *bytes_read);
 
+/**
+ * @brief Write data to a file opened with media_fs_create()
+ * 
+ * @param file Pointer to file handle struct
+ * @param buffer Data to write
+ * @param size Number of bytes to write
+ * @param bytes_written Pointer to store actual bytes written
+ * @return FS_OK on success, error code on failure
+ */
+fs_result_t media_fs_write(fs_file_t *file, const void *buffer, size_t size,
+                           size_t *bytes_written);
+
 /**
  * @brief Seek to a position in the file
  * 
@@ -192,18 +215,12 @@ fs_result_t media_fs_readdir(fs_dir_t *dir, fs_dirent_t *entry);
 fs_result_t media_fs_get_stats(fs_stats_t *stats);
 
 /**
- * @brief List audio files in a directory
- * 
- * Utility function to find .wav, .mp3 files in a directory.
+ * @brief Check whether a file name has a supported audio extension
  * 
- * @param path Directory path (NULL for root)
- * @param files Array to store file names (caller allocated)
- * @param max_files Maximum number of files to return
- * @param count Pointer to store actual number of files found
- * @return FS_OK on success, error code on failure
+ * @param name File name
+ * @return true for .wav, .mp3 and .flac files
  */
-fs_result_t media_fs_list_audio_files(const char *path, char files[][256], 
-                                     size_t max_files, size_t *count);
+bool media_fs_is_audio_file(const char *name);
 
 /**
  * @brief Convert error code to string
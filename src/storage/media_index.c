@@ -0,0 +1,363 @@
+/**
+ * @file media_index.c
+ * @brief Cached track index for the SD card media library
+ * 
+ * Please refer to media_index.h for more documentation.
+ */
+
+#include "media_index.h"
+#include "wav_file_reader.h"
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(media_index, LOG_LEVEL_INF);
+
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME 16777619U
+
+/* In-RAM copy of the index */
+static struct {
+    media_index_header_t header;
+    media_index_entry_t entries[MEDIA_INDEX_MAX_TRACKS];
+    char names[MEDIA_INDEX_NAMES_SIZE];
+    bool seen[MEDIA_INDEX_MAX_TRACKS];  /* Found by the current refresh walk */
+    bool loaded;                        /* RAM copy matches the file */
+} idx;
+
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t len)
+{
+    const uint8_t *bytes = data;
+    
+    for (size_t i = 0; i < len; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint32_t index_checksum(void)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    
+    hash = fnv1a(hash, idx.entries, idx.header.count * sizeof(media_index_entry_t));
+    return fnv1a(hash, idx.names, idx.header.names_size);
+}
+
+static void index_clear(void)
+{
+    idx.header.count = 0;
+    idx.header.names_size = 0;
+    idx.loaded = false;
+}
+
+static fs_result_t index_read(fs_file_t *file, void *buffer, size_t size)
+{
+    size_t got;
+    fs_result_t result = media_fs_read(file, buffer, size, &got);
+    
+    if (result != FS_OK) {
+        return result;
+    }
+    return (got == size) ? FS_OK : FS_ERROR_UNSUPPORTED_FORMAT;
+}
+
+static fs_result_t index_write(fs_file_t *file, const void *buffer, size_t size)
+{
+    size_t written;
+    
+    if (size == 0) {
+        return FS_OK;
+    }
+    return media_fs_write(file, buffer, size, &written);
+}
+
+/* Everything in the header and name table must be in range before use */
+static bool index_is_valid(void)
+{
+    if (idx.header.magic != MEDIA_INDEX_MAGIC ||
+        idx.header.version != MEDIA_INDEX_VERSION ||
+        idx.header.count > MEDIA_INDEX_MAX_TRACKS ||
+        idx.header.names_size > MEDIA_INDEX_NAMES_SIZE) {
+        return false;
+    }
+    
+    if (idx.header.names_size > 0 && idx.names[idx.header.names_size - 1] != '\0') {
+        return false;
+    }
+    
+    for (size_t i = 0; i < idx.header.count; i++) {
+        if (idx.entries[i].path_offset >= idx.header.names_size) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+fs_result_t media_index_load(void)
+{
+    fs_file_t file;
+    fs_result_t result;
+    
+    index_clear();
+    
+    result = media_fs_open(&file, MEDIA_INDEX_FILE);
+    if (result != FS_OK) {
+        return result;
+    }
+    
+    result = index_read(&file, &idx.header, sizeof(idx.header));
+    if (result == FS_OK &&
+        (idx.header.count > MEDIA_INDEX_MAX_TRACKS ||
+         idx.header.names_size > MEDIA_INDEX_NAMES_SIZE)) {
+        result = FS_ERROR_UNSUPPORTED_FORMAT;
+    }
+    if (result == FS_OK) {
+        result = index_read(&file, idx.entries, idx.header.count * sizeof(media_index_entry_t));
+    }
+    if (result == FS_OK) {
+        result = index_read(&file, idx.names, idx.header.names_size);
+    }
+    
+    media_fs_close(&file);
+    
+    if (result == FS_OK && (!index_is_valid() || index_checksum() != idx.header.checksum)) {
+        result = FS_ERROR_UNSUPPORTED_FORMAT;
+    }
+    
+    if (result != FS_OK) {
+        LOG_WRN("Track index unusable (%s), needs a refresh", media_fs_error_to_string(result));
+        index_clear();
+        return result;
+    }
+    
+    idx.loaded = true;
+    LOG_INF("Track index loaded: %u tracks", idx.header.count);
+    return FS_OK;
+}
+
+static fs_result_t index_save(void)
+{
+    fs_file_t file;
+    fs_result_t result;
+    
+    idx.header.magic = MEDIA_INDEX_MAGIC;
+    idx.header.version = MEDIA_INDEX_VERSION;
+    idx.header.checksum = index_checksum();
+    
+    result = media_fs_create(&file, MEDIA_INDEX_FILE);
+    if (result != FS_OK) {
+        return result;
+    }
+    
+    result = index_write(&file, &idx.header, sizeof(idx.header));
+    if (result == FS_OK) {
+        result = index_write(&file, idx.entries, idx.header.count * sizeof(media_index_entry_t));
+    }
+    if (result == FS_OK) {
+        result = index_write(&file, idx.names, idx.header.names_size);
+    }
+    
+    media_fs_close(&file);
+    
+    if (result != FS_OK) {
+        LOG_ERR("Failed to save track index: %s", media_fs_error_to_string(result));
+        return result;
+    }
+    
+    idx.loaded = true;
+    return FS_OK;
+}
+
+/* Open a file and record its size and PCM layout */
+static void index_probe(media_index_entry_t *entry, const char *name, size_t size)
+{
+    fs_file_t file;
+    wav_file_reader_t reader;
+    uint8_t window[WAV_FILE_READER_WINDOW_SIZE];
+    uint32_t path_offset = entry->path_offset;
+    
+    memset(entry, 0, sizeof(*entry));
+    entry->path_offset = path_offset;
+    entry->size = size;
+    
+    if (media_fs_open(&file, name) != FS_OK) {
+        return;
+    }
+    
+    if (wav_file_reader_open(&reader, &file, window, sizeof(window)) == FS_OK) {
+        uint32_t frame_size = reader.format.channels * (reader.format.bits_per_sample / 8);
+        
+        entry->sample_rate = reader.format.sample_rate;
+        entry->channels = reader.format.channels;
+        entry->bits_per_sample = reader.format.bits_per_sample;
+        entry->data_offset = reader.data_start;
+        entry->data_size = reader.data_size;
+        if (frame_size > 0 && entry->sample_rate > 0) {
+            entry->duration_ms = (uint32_t)((uint64_t)(reader.data_size / frame_size) * 1000U /
+                                            entry->sample_rate);
+        }
+        wav_file_reader_close(&reader);
+    } else {
+        LOG_DBG("%s: not a PCM WAV, indexed without format", name);
+    }
+    
+    media_fs_close(&file);
+}
+
+static int index_add_name(const char *name)
+{
+    size_t len = strlen(name) + 1;
+    uint32_t offset = idx.header.names_size;
+    
+    if (offset + len > MEDIA_INDEX_NAMES_SIZE) {
+        return -1;
+    }
+    
+    memcpy(&idx.names[offset], name, len);
+    idx.header.names_size += len;
+    return (int)offset;
+}
+
+/* Drop entries the walk did not see, closing the gaps in both tables */
+static bool index_sweep(void)
+{
+    size_t kept = 0;
+    uint32_t names_used = 0;
+    bool removed = false;
+    
+    for (size_t i = 0; i < idx.header.count; i++) {
+        if (!idx.seen[i]) {
+            LOG_INF("Track removed: %s", &idx.names[idx.entries[i].path_offset]);
+            removed = true;
+            continue;
+        }
+        
+        /* Names are stored in entry order, so this never moves forward */
+        const char *name = &idx.names[idx.entries[i].path_offset];
+        size_t len = strlen(name) + 1;
+        
+        memmove(&idx.names[names_used], name, len);
+        idx.entries[kept] = idx.entries[i];
+        idx.entries[kept].path_offset = names_used;
+        names_used += len;
+        kept++;
+    }
+    
+    idx.header.count = kept;
+    idx.header.names_size = names_used;
+    return removed;
+}
+
+fs_result_t media_index_refresh(bool *changed)
+{
+    fs_dir_t dir;
+    fs_dirent_t entry;
+    fs_result_t result;
+    bool modified = false;
+    
+    if (changed) {
+        *changed = false;
+    }
+    
+    if (!idx.loaded) {
+        /* Whatever is in RAM did not come from a valid file */
+        index_clear();
+    }
+    
+    result = media_fs_opendir(&dir, NULL);
+    if (result != FS_OK) {
+        return result;
+    }
+    
+    memset(idx.seen, 0, sizeof(idx.seen));
+    
+    while (media_fs_readdir(&dir, &entry) == FS_OK) {
+        if (entry.is_directory || !media_fs_is_audio_file(entry.name)) {
+            continue;
+        }
+        
+        int i = media_index_find(entry.name);
+        if (i >= 0) {
+            idx.seen[i] = true;
+            if (idx.entries[i].size != entry.size) {
+                LOG_INF("Track changed: %s", entry.name);
+                index_probe(&idx.entries[i], entry.name, entry.size);
+                modified = true;
+            }
+            continue;
+        }
+        
+        if (idx.header.count >= MEDIA_INDEX_MAX_TRACKS) {
+            LOG_WRN("Track index full, skipping %s", entry.name);
+            continue;
+        }
+        
+        int offset = index_add_name(entry.name);
+        if (offset < 0) {
+            LOG_WRN("Track index name table full, skipping %s", entry.name);
+            continue;
+        }
+        
+        media_index_entry_t *track = &idx.entries[idx.header.count];
+        track->path_offset = offset;
+        index_probe(track, entry.name, entry.size);
+        idx.seen[idx.header.count] = true;
+        idx.header.count++;
+        modified = true;
+        LOG_INF("Track added: %s (%u ms)", entry.name, track->duration_ms);
+    }
+    
+    media_fs_closedir(&dir);
+    
+    if (index_sweep()) {
+        modified = true;
+    }
+    
+    if (changed) {
+        *changed = modified;
+    }
+    
+    if (!modified && idx.loaded) {
+        LOG_DBG("Track index up to date");
+        return FS_OK;
+    }
+    
+    LOG_INF("Track index rebuilt: %u tracks", idx.header.count);
+    return index_save();
+}
+
+size_t media_index_count(void)
+{
+    return idx.header.count;
+}
+
+const media_index_entry_t *media_index_get(size_t index)
+{
+    if (index >= idx.header.count) {
+        return NULL;
+    }
+    return &idx.entries[index];
+}
+
+const char *media_index_path(size_t index)
+{
+    if (index >= idx.header.count) {
+        return NULL;
+    }
+    return &idx.names[idx.entries[index].path_offset];
+}
+
+int media_index_find(const char *path)
+{
+    if (!path) {
+        return -1;
+    }
+    
+    for (size_t i = 0; i < idx.header.count; i++) {
+        if (strcmp(&idx.names[idx.entries[i].path_offset], path) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file media_index.h
+ * @brief Cached track index for the SD card media library
+ * 
+ * Keeps one compact record per audio file in the card root (size, PCM
+ * format, duration and where the PCM data starts) in RAM and persists it
+ * to MEDIA_INDEX_FILE. At startup media_index_load() reads that one file,
+ * so track listing and selection need no directory walk and no WAV header
+ * parsing.
+ * 
+ * media_index_refresh() brings the index up to date after the card
+ * contents may have changed. It walks the directory once but only opens
+ * files that are new or whose size changed; everything else keeps its
+ * cached record. (Zephyr's fs_dirent carries no timestamps, so name and
+ * size stand in for a modification time.)
+ * 
+ * On-card layout, native byte order:
+ *   media_index_header_t | media_index_entry_t[count] | names (NUL separated)
+ */
+
+#ifndef MEDIA_INDEX_H
+#define MEDIA_INDEX_H
+
+#include "fs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Index file in the card root */
+#define MEDIA_INDEX_FILE "TRACKS.IDX"
+
+#define MEDIA_INDEX_MAGIC 0x5849524DU   /* "MRIX" */
+#define MEDIA_INDEX_VERSION 1
+
+/* Capacity, shared by the RAM copy and the file */
+#define MEDIA_INDEX_MAX_TRACKS CONFIG_APP_MEDIA_INDEX_MAX_TRACKS
+#define MEDIA_INDEX_NAMES_SIZE (MEDIA_INDEX_MAX_TRACKS * 32)
+
+/* Index file header */
+typedef struct {
+    uint32_t magic;             /* MEDIA_INDEX_MAGIC */
+    uint16_t version;           /* MEDIA_INDEX_VERSION */
+    uint16_t count;             /* Entries following the header */
+    uint32_t names_size;        /* Bytes of the name table */
+    uint32_t checksum;          /* FNV-1a over entries and names */
+} media_index_header_t;
+
+/* One track. Format fields are 0 when the file is not parseable PCM WAV
+ * (MP3, FLAC, damaged headers) so it is not reparsed on every refresh. */
+typedef struct {
+    uint32_t path_offset;       /* Offset of the file name in the name table */
+    uint32_t size;              /* File size in bytes */
+    uint32_t sample_rate;       /* Hz */
+    uint32_t data_offset;       /* File offset of the first PCM byte */
+    uint32_t data_size;         /* PCM bytes */
+    uint32_t duration_ms;       /* Playing time */
+    uint16_t channels;
+    uint16_t bits_per_sample;
+} media_index_entry_t;
+
+/**
+ * @brief Load the persisted index into RAM
+ * 
+ * @return FS_OK on success, FS_ERROR_FILE_NOT_FOUND if there is no index
+ *         yet, FS_ERROR_UNSUPPORTED_FORMAT if it is stale or damaged (call
+ *         media_index_refresh() in both cases)
+ */
+fs_result_t media_index_load(void);
+
+/**
+ * @brief Bring the index up to date with the card root and save it
+ * 
+ * @param changed Optional, set to true if any entry was added, updated or
+ *                removed (the file is only rewritten in that case)
+ * @return FS_OK on success, error code on failure
+ */
+fs_result_t media_index_refresh(bool *changed);
+
+/**
+ * @brief Number of indexed tracks
+ */
+size_t media_index_count(void);
+
+/**
+ * @brief Get a track record
+ * 
+ * @param index Track number, 0 .. media_index_count() - 1
+ * @return Entry, or NULL if out of range
+ */
+const media_index_entry_t *media_index_get(size_t index);
+
+/**
+ * @brief Get a track's file name (relative to the card root)
+ * 
+ * @param index Track number
+ * @return File name, or NULL if out of range
+ */
+const char *media_index_path(size_t index);
+
+/**
+ * @brief Look a track up by file name
+ * 
+ * @param path File name as returned by media_index_path()
+ * @return Track number, or -1 if not indexed
+ */
+int media_index_find(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEDIA_INDEX_H */
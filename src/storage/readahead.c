@@ -0,0 +1,280 @@
+/**
+ * @file readahead.c
+ * @brief Double-buffered SD card read-ahead for local playback
+ * 
+ * Please refer to readahead.h for more documentation.
+ */
+
+#include "readahead.h"
+#include "../utils/app_threads.h"
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(readahead, LOG_LEVEL_INF);
+
+/* Read-ahead configuration */
+#define READAHEAD_DEPTH CONFIG_APP_SD_READAHEAD_DEPTH
+#define READAHEAD_STACK_SIZE APP_THREAD_STACK_READAHEAD
+#define READAHEAD_PRIORITY APP_THREAD_PRIO_READAHEAD
+#define READAHEAD_ALLOC_TIMEOUT_MS 100
+
+/* Read-ahead engine state */
+static struct {
+    fs_file_t *file;
+    size_t next_offset;     /* File offset of the next read */
+    size_t end;             /* One past the last byte to deliver */
+    bool reposition;        /* next_offset moved, seek the file before reading */
+    bool eof;               /* Whole range has been queued */
+    bool running;
+    
+    struct k_fifo filled;   /* Prefetched buffers, oldest first */
+    struct k_sem space;     /* Free slots in the read-ahead window */
+    struct k_sem wake;      /* Kicks the thread out of its end-of-range wait */
+    struct k_mutex lock;    /* Serialises file access between the thread and seek */
+    
+    struct k_thread thread;
+    
+    /* Statistics */
+    atomic_t buffers_filled;
+    atomic_t buffers_consumed;
+    atomic_t underruns;
+    atomic_t stale_dropped;
+    atomic_t read_errors;
+} ra = {
+    .running = false
+};
+
+K_THREAD_STACK_DEFINE(readahead_stack, READAHEAD_STACK_SIZE);
+
+/**
+ * @brief Bytes to read next: whole sectors, realigning after an odd seek
+ */
+static size_t readahead_span(size_t capacity)
+{
+    size_t len = capacity - (capacity % READAHEAD_SECTOR_SIZE);
+    size_t misalign = ra.next_offset % READAHEAD_SECTOR_SIZE;
+    
+    if (misalign) {
+        len -= misalign;
+    }
+    if (ra.next_offset + len > ra.end) {
+        len = ra.end - ra.next_offset;
+    }
+    return len;
+}
+
+static void readahead_drop_queued(bool stale)
+{
+    struct audio_buffer *buf;
+    
+    while ((buf = k_fifo_get(&ra.filled, K_NO_WAIT)) != NULL) {
+        audio_buffer_free(buf);
+        k_sem_give(&ra.space);
+        if (stale) {
+            atomic_inc(&ra.stale_dropped);
+        }
+    }
+}
+
+static void readahead_thread(void *p1, void *p2, void *p3)
+{
+    size_t got;
+    
+    while (ra.running) {
+        /* Wait for the player to make room in the window */
+        k_sem_take(&ra.space, K_FOREVER);
+        if (!ra.running) {
+            break;
+        }
+        
+        struct audio_buffer *buf = audio_buffer_alloc(K_MSEC(READAHEAD_ALLOC_TIMEOUT_MS));
+        if (!buf) {
+            k_sem_give(&ra.space);
+            continue;
+        }
+        
+        k_mutex_lock(&ra.lock, K_FOREVER);
+        
+        if (ra.eof) {
+            /* Nothing left to read - park until a seek or stop */
+            k_mutex_unlock(&ra.lock);
+            audio_buffer_free(buf);
+            k_sem_give(&ra.space);
+            k_sem_take(&ra.wake, K_FOREVER);
+            continue;
+        }
+        
+        if (ra.reposition) {
+            if (media_fs_seek(ra.file, ra.next_offset) != FS_OK) {
+                atomic_inc(&ra.read_errors);
+                ra.eof = true;
+            }
+            ra.reposition = false;
+        }
+        
+        fs_result_t result = ra.eof ? FS_ERROR_SEEK_FAILED :
+                             media_fs_read(ra.file, buf->data, readahead_span(buf->size), &got);
+        if (result != FS_OK) {
+            LOG_ERR("Read-ahead failed at offset %zu: %s", ra.next_offset,
+                    media_fs_error_to_string(result));
+            atomic_inc(&ra.read_errors);
+            ra.eof = true;
+            got = 0;
+        }
+        
+        buf->used = got;
+        ra.next_offset += got;
+        bool last = (got == 0 || ra.next_offset >= ra.end);
+        if (last) {
+            buf->flags |= AUDIO_BUFFER_FLAG_END_OF_STREAM;
+        }
+        
+        if (got > 0) {
+            k_fifo_put(&ra.filled, buf);
+            atomic_inc(&ra.buffers_filled);
+        } else {
+            audio_buffer_free(buf);
+            k_sem_give(&ra.space);
+        }
+        
+        /* Only after the put: a get that sees eof must find the final buffer */
+        if (last) {
+            ra.eof = true;
+        }
+        
+        k_mutex_unlock(&ra.lock);
+    }
+}
+
+fs_result_t media_readahead_start(fs_file_t *file, size_t offset, size_t end)
+{
+    if (!file || !file->is_open) {
+        return FS_ERROR_INVALID_PARAM;
+    }
+    
+    if (ra.running) {
+        media_readahead_stop();
+    }
+    
+    if (end == 0 || end > file->size) {
+        end = file->size;
+    }
+    if (offset > end) {
+        return FS_ERROR_INVALID_PARAM;
+    }
+    
+    ra.file = file;
+    ra.next_offset = offset;
+    ra.end = end;
+    ra.reposition = true;
+    ra.eof = (offset >= end);
+    
+    k_fifo_init(&ra.filled);
+    k_sem_init(&ra.space, READAHEAD_DEPTH, READAHEAD_DEPTH);
+    k_sem_init(&ra.wake, 0, 1);
+    k_mutex_init(&ra.lock);
+    
+    atomic_clear(&ra.buffers_filled);
+    atomic_clear(&ra.buffers_consumed);
+    atomic_clear(&ra.underruns);
+    atomic_clear(&ra.stale_dropped);
+    atomic_clear(&ra.read_errors);
+    
+    ra.running = true;
+    k_thread_create(&ra.thread, readahead_stack,
+                    K_THREAD_STACK_SIZEOF(readahead_stack),
+                    readahead_thread, NULL, NULL, NULL,
+                    READAHEAD_PRIORITY, 0, K_NO_WAIT);
+    k_thread_name_set(&ra.thread, "sd_readahead");
+    
+    LOG_INF("Read-ahead started: bytes %zu-%zu, %d buffers deep", offset, end, READAHEAD_DEPTH);
+    return FS_OK;
+}
+
+struct audio_buffer *media_readahead_get(k_timeout_t timeout)
+{
+    if (!ra.running) {
+        return NULL;
+    }
+    
+    struct audio_buffer *buf = k_fifo_get(&ra.filled, K_NO_WAIT);
+    if (!buf) {
+        if (ra.eof) {
+            /* The final buffer may have landed just after the first look */
+            buf = k_fifo_get(&ra.filled, K_NO_WAIT);
+            if (!buf) {
+                return NULL;
+            }
+        } else {
+            /* The card fell behind the player */
+            atomic_inc(&ra.underruns);
+            buf = k_fifo_get(&ra.filled, timeout);
+            if (!buf) {
+                return NULL;
+            }
+        }
+    }
+    
+    atomic_inc(&ra.buffers_consumed);
+    k_sem_give(&ra.space);
+    return buf;
+}
+
+fs_result_t media_readahead_seek(size_t offset)
+{
+    if (!ra.running) {
+        return FS_ERROR_NOT_INITIALIZED;
+    }
+    
+    if (offset > ra.end) {
+        return FS_ERROR_SEEK_FAILED;
+    }
+    
+    /* Holding the lock means no read is in flight, so nothing stale can be
+     * queued after the drain */
+    k_mutex_lock(&ra.lock, K_FOREVER);
+    readahead_drop_queued(true);
+    ra.next_offset = offset;
+    ra.reposition = true;
+    ra.eof = (offset >= ra.end);
+    k_mutex_unlock(&ra.lock);
+    
+    k_sem_give(&ra.wake);
+    
+    LOG_DBG("Read-ahead repositioned to %zu", offset);
+    return FS_OK;
+}
+
+void media_readahead_stop(void)
+{
+    if (!ra.running) {
+        return;
+    }
+    
+    ra.running = false;
+    k_sem_give(&ra.space);
+    k_sem_give(&ra.wake);
+    k_thread_join(&ra.thread, K_FOREVER);
+    
+    readahead_drop_queued(false);
+    ra.file = NULL;
+    
+    LOG_INF("Read-ahead stopped: %u filled, %u underruns",
+            (uint32_t)atomic_get(&ra.buffers_filled), (uint32_t)atomic_get(&ra.underruns));
+}
+
+fs_result_t media_readahead_get_stats(readahead_stats_t *stats)
+{
+    if (!stats) {
+        return FS_ERROR_INVALID_PARAM;
+    }
+    
+    stats->buffers_filled = atomic_get(&ra.buffers_filled);
+    stats->buffers_consumed = atomic_get(&ra.buffers_consumed);
+    stats->underruns = atomic_get(&ra.underruns);
+    stats->stale_dropped = atomic_get(&ra.stale_dropped);
+    stats->read_errors = atomic_get(&ra.read_errors);
+    
+    return FS_OK;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file readahead.h
+ * @brief Double-buffered SD card read-ahead for local playback
+ * 
+ * A background thread keeps up to CONFIG_APP_SD_READAHEAD_DEPTH pool
+ * buffers (see audio_buffers.h) filled ahead of the play position, so the
+ * player never waits on an SD access unless the card falls behind.
+ * 
+ * Reads are issued at sector-aligned file offsets in whole multiples of
+ * the sector size. With power-of-two buffer sizes this also keeps every
+ * read inside one FAT cluster, so fs_read() can go straight to the card
+ * without a cluster-straddling bounce.
+ * 
+ * One track is read ahead at a time (single static engine).
+ */
+
+#ifndef READAHEAD_H
+#define READAHEAD_H
+
+#include "fs.h"
+#include "../audio/audio_buffers.h"
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* SD/FAT sector size */
+#define READAHEAD_SECTOR_SIZE 512
+
+/* Read-ahead statistics */
+typedef struct {
+    uint32_t buffers_filled;    /* Buffers read from the card */
+    uint32_t buffers_consumed;  /* Buffers taken by the player */
+    uint32_t underruns;         /* Player asked and nothing was ready */
+    uint32_t stale_dropped;     /* Prefetched buffers discarded by a seek */
+    uint32_t read_errors;       /* media_fs_read() failures */
+} readahead_stats_t;
+
+/**
+ * @brief Start reading ahead from an open file
+ * 
+ * @param file File opened with media_fs_open(), must stay open until
+ *             media_readahead_stop()
+ * @param offset File offset of the first byte to deliver (e.g. the
+ *               data_start of a wav_file_reader_t)
+ * @param end Offset one past the last byte to deliver (0 for end of file)
+ * @return FS_OK on success, error code on failure
+ */
+fs_result_t media_readahead_start(fs_file_t *file, size_t offset, size_t end);
+
+/**
+ * @brief Take the next prefetched buffer
+ * 
+ * The caller owns the returned buffer and releases it with
+ * audio_buffer_free() (directly or by submitting it to an audio output).
+ * The last buffer of the range carries AUDIO_BUFFER_FLAG_END_OF_STREAM.
+ * 
+ * @param timeout How long to wait if nothing is ready
+ * @return Buffer, or NULL on timeout / end of range
+ */
+struct audio_buffer *media_readahead_get(k_timeout_t timeout);
+
+/**
+ * @brief Reposition the read-ahead
+ * 
+ * Drops every buffer prefetched from the old position and restarts
+ * reading at @p offset.
+ * 
+ * @param offset New file offset of the next byte to deliver
+ * @return FS_OK on success, error code on failure
+ */
+fs_result_t media_readahead_seek(size_t offset);
+
+/**
+ * @brief Stop the read-ahead thread and release prefetched buffers
+ */
+void media_readahead_stop(void);
+
+/**
+ * @brief Get read-ahead statistics
+ * 
+ * @param stats Pointer to statistics struct
+ * @return FS_OK on success, error code on failure
+ */
+fs_result_t media_readahead_get_stats(readahead_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* READAHEAD_H */
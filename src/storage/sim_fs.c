@@ -241,6 +241,44 @@ fs_result_t media_fs_open(fs_file_t *file, const char *path)
     return FS_OK;
 }
 
+fs_result_t media_fs_create(fs_file_t *file, const char *path)
+{
+    char full_path[512];
+    struct sim_internal_file *internal_file;
+    
+    if (!file || !path) {
+        return FS_ERROR_INVALID_PARAM;
+    }
+    
+    if (!media_fs_is_ready()) {
+        return FS_ERROR_NOT_INITIALIZED;
+    }
+    
+    internal_file = get_free_file_handle();
+    if (!internal_file) {
+        SIM_LOG_ERR("No free file handles available");
+        return FS_ERROR_NO_MEMORY;
+    }
+    
+    build_full_path(full_path, sizeof(full_path), path);
+    
+    internal_file->posix_file = fopen(full_path, "wb");
+    if (!internal_file->posix_file) {
+        SIM_LOG_ERR("Failed to create file %s: %s", full_path, strerror(errno));
+        release_file_handle(internal_file);
+        return FS_ERROR_OPEN_FAILED;
+    }
+    
+    file->handle = internal_file;
+    file->is_open = true;
+    file->size = 0;
+    file->position = 0;
+    
+    SIM_LOG_DBG("Created file %s", path);
+    
+    return FS_OK;
+}
+
 fs_result_t media_fs_close(fs_file_t *file)
 {
     struct sim_internal_file *internal_file;
@@ -284,6 +322,29 @@ fs_result_t media_fs_read(fs_file_t *file, void *buffer, size_t size, size_t *by
     return FS_OK;
 }
 
+fs_result_t media_fs_write(fs_file_t *file, const void *buffer, size_t size,
+                           size_t *bytes_written)
+{
+    struct sim_internal_file *internal_file;
+    size_t result;
+    
+    if (!file || !file->handle || !file->is_open || !buffer || !bytes_written) {
+        return FS_ERROR_INVALID_PARAM;
+    }
+    
+    internal_file = (struct sim_internal_file *)file->handle;
+    
+    result = fwrite(buffer, 1, size, internal_file->posix_file);
+    
+    *bytes_written = result;
+    file->position += result;
+    if (file->position > file->size) {
+        file->size = file->position;
+    }
+    
+    return (result == size) ? FS_OK : FS_ERROR_WRITE_FAILED;
+}
+
 fs_result_t media_fs_seek(fs_file_t *file, size_t offset)
 {
     struct sim_internal_file *internal_file;
@@ -460,55 +521,22 @@ fs_result_t media_fs_get_stats(fs_stats_t *stats)
     return FS_OK;
 }
 
-fs_result_t media_fs_list_audio_files(const char *path, char files[][256], 
-                                     size_t max_files, size_t *count)
+bool media_fs_is_audio_file(const char *name)
 {
-    fs_dir_t dir;
-    fs_dirent_t entry;
-    fs_result_t result;
-    size_t found = 0;
-    
-    if (!files || !count || max_files == 0) {
-        return FS_ERROR_INVALID_PARAM;
-    }
+    const char *ext;
     
-    *count = 0;
-    
-    result = media_fs_opendir(&dir, path);
-    if (result != FS_OK) {
-        return result;
+    if (!name) {
+        return false;
     }
     
-    while (found < max_files) {
-        result = media_fs_readdir(&dir, &entry);
-        if (result != FS_OK) {
-            break; /* End of directory or error */
-        }
-        
-        /* Skip directories */
-        if (entry.is_directory) {
-            continue;
-        }
-        
-        /* Check for audio file extensions */
-        char *ext = strrchr(entry.name, '.');
-        if (ext) {
-            if (strcasecmp(ext, ".wav") == 0 || 
-                strcasecmp(ext, ".mp3") == 0 ||
-                strcasecmp(ext, ".flac") == 0) {
-                strncpy(files[found], entry.name, 255);
-                files[found][255] = '\0';
-                found++;
-            }
-        }
+    ext = strrchr(name, '.');
+    if (!ext) {
+        return false;
     }
     
-    media_fs_closedir(&dir);
-    
-    *count = found;
-    SIM_LOG_INF("Found %zu audio files", found);
-    
-    return FS_OK;
+    return strcasecmp(ext, ".wav") == 0 || 
+           strcasecmp(ext, ".mp3") == 0 ||
+           strcasecmp(ext, ".flac") == 0;
 }
 
 const char *media_fs_error_to_string(fs_result_t error)
@@ -0,0 +1,158 @@
+/**
+ * @file wav_file_reader.c
+ * @brief Pull-mode WAV reader over the media file system
+ * 
+ * Please refer to wav_file_reader.h for more documentation.
+ */
+
+#include "wav_file_reader.h"
+#include <zephyr/logging/log.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(wav_file_reader, LOG_LEVEL_INF);
+
+/* Header callback: keep the format, stop at the first PCM span */
+static int wav_file_header_cb(const struct wav_stream_event *event, void *user_data)
+{
+    wav_file_reader_t *reader = user_data;
+
+    switch (event->type) {
+    case WAV_STREAM_EVENT_FORMAT:
+        reader->format = *event->format;
+        return 0;
+    case WAV_STREAM_EVENT_DATA:
+        return WAV_STREAM_PAUSE;
+    default:
+        return 0;
+    }
+}
+
+fs_result_t wav_file_reader_open(wav_file_reader_t *reader, fs_file_t *file,
+                                 uint8_t *window, size_t window_size)
+{
+    struct wav_stream_decoder header;
+    fs_result_t result;
+    size_t got;
+
+    if (!reader || !file || !file->is_open || !window || window_size == 0) {
+        return FS_ERROR_INVALID_PARAM;
+    }
+
+    memset(reader, 0, sizeof(*reader));
+    reader->file = file;
+
+    result = media_fs_seek(file, 0);
+    if (result != FS_OK) {
+        return result;
+    }
+
+    /* Walk the chunk list one window at a time until PCM starts */
+    wav_stream_init(&header);
+    while (!wav_stream_in_data(&header)) {
+        result = media_fs_read(file, window, window_size, &got);
+        if (result != FS_OK) {
+            return result;
+        }
+        if (got == 0) {
+            LOG_ERR("No PCM data found in WAV file");
+            return FS_ERROR_UNSUPPORTED_FORMAT;
+        }
+
+        int ret = wav_stream_feed(&header, window, got, wav_file_header_cb, reader);
+        if (ret < 0) {
+            LOG_ERR("Invalid WAV header: %d", ret);
+            return FS_ERROR_UNSUPPORTED_FORMAT;
+        }
+        if (header.state == WAV_STREAM_DONE) {
+            LOG_ERR("WAV file has an empty data chunk");
+            return FS_ERROR_UNSUPPORTED_FORMAT;
+        }
+    }
+
+    reader->data_start = header.bytes_consumed;
+    reader->data_size = (file->size > reader->data_start) ?
+                        file->size - reader->data_start : 0;
+    if (header.data_size != WAV_STREAM_SIZE_UNKNOWN &&
+        header.data_size < reader->data_size) {
+        reader->data_size = header.data_size;
+    }
+
+    result = media_fs_seek(file, reader->data_start);
+    if (result != FS_OK) {
+        return result;
+    }
+
+    reader->is_open = true;
+    LOG_INF("WAV file: %uch, %uHz, %ubits, %zu PCM bytes at offset %zu",
+            reader->format.channels, reader->format.sample_rate,
+            reader->format.bits_per_sample, reader->data_size, reader->data_start);
+    return FS_OK;
+}
+
+fs_result_t wav_file_reader_read(wav_file_reader_t *reader, void *buffer,
+                                 size_t size, size_t *bytes_read)
+{
+    if (!reader || !reader->is_open || !buffer || !bytes_read) {
+        return FS_ERROR_INVALID_PARAM;
+    }
+
+    size_t left = reader->data_size - reader->position;
+    size_t n = (size < left) ? size : left;
+
+    *bytes_read = 0;
+    if (n == 0) {
+        return FS_OK;
+    }
+
+    fs_result_t result = media_fs_read(reader->file, buffer, n, bytes_read);
+    if (result == FS_OK) {
+        reader->position += *bytes_read;
+    }
+    return result;
+}
+
+fs_result_t wav_file_reader_seek(wav_file_reader_t *reader, size_t pcm_offset)
+{
+    if (!reader || !reader->is_open) {
+        return FS_ERROR_INVALID_PARAM;
+    }
+
+    /* Never land mid-frame */
+    if (reader->format.block_align > 1) {
+        pcm_offset -= pcm_offset % reader->format.block_align;
+    }
+    if (pcm_offset > reader->data_size) {
+        return FS_ERROR_SEEK_FAILED;
+    }
+
+    fs_result_t result = media_fs_seek(reader->file, reader->data_start + pcm_offset);
+    if (result == FS_OK) {
+        reader->position = pcm_offset;
+    }
+    return result;
+}
+
+fs_result_t wav_file_reader_seek_ms(wav_file_reader_t *reader, uint32_t position_ms)
+{
+    if (!reader || !reader->is_open) {
+        return FS_ERROR_INVALID_PARAM;
+    }
+
+    size_t pcm_offset = wav_time_to_offset(&reader->format, position_ms);
+    if (pcm_offset > reader->data_size) {
+        pcm_offset = reader->data_size;
+    }
+    return wav_file_reader_seek(reader, pcm_offset);
+}
+
+bool wav_file_reader_is_eof(const wav_file_reader_t *reader)
+{
+    return !reader || !reader->is_open || reader->position >= reader->data_size;
+}
+
+void wav_file_reader_close(wav_file_reader_t *reader)
+{
+    if (reader) {
+        memset(reader, 0, sizeof(*reader));
+    }
+}
@@ -0,0 +1,104 @@
+/**
+ * @file wav_file_reader.h
+ * @brief Pull-mode WAV reader over the media file system
+ * 
+ * Parses the WAV header through a small caller-supplied window using the
+ * push decoder from wav_decoder.h, then reads PCM straight from the file
+ * into the caller's buffer. RAM use is the window plus this struct,
+ * whatever the file size.
+ * 
+ * Lives next to fs.h because it is only built together with the storage
+ * layer (SD card playback).
+ */
+
+#ifndef WAV_FILE_READER_H
+#define WAV_FILE_READER_H
+
+#include "fs.h"
+#include "../audio/wav_decoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Suggested header window - covers RIFF + fmt + data headers of most files */
+#define WAV_FILE_READER_WINDOW_SIZE 64
+
+/* WAV file reader struct */
+typedef struct {
+    fs_file_t *file;                  /* Open media file, owned by the caller */
+    struct audio_format_info format;  /* Parsed fmt chunk */
+    size_t data_start;                /* File offset of the first PCM byte */
+    size_t data_size;                 /* PCM bytes, clamped to the file size */
+    size_t position;                  /* PCM bytes read so far */
+    bool is_open;
+} wav_file_reader_t;
+
+/**
+ * @brief Parse the WAV header of an open file
+ * 
+ * Reads the header @p window_size bytes at a time and leaves the file
+ * positioned at the first PCM byte.
+ * 
+ * @param reader Reader to initialize
+ * @param file File opened with media_fs_open()
+ * @param window Scratch buffer used only during this call
+ * @param window_size Size of @p window (WAV_FILE_READER_WINDOW_SIZE is enough)
+ * @return FS_OK on success, FS_ERROR_UNSUPPORTED_FORMAT for non-PCM or
+ *         malformed files, other error codes on read failure
+ */
+fs_result_t wav_file_reader_open(wav_file_reader_t *reader, fs_file_t *file,
+                                 uint8_t *window, size_t window_size);
+
+/**
+ * @brief Read PCM data
+ * 
+ * @param reader Open reader
+ * @param buffer Destination (e.g. an audio_buffer's data)
+ * @param size Maximum bytes to read
+ * @param bytes_read Pointer to store bytes read (0 at end of data)
+ * @return FS_OK on success, error code on failure
+ */
+fs_result_t wav_file_reader_read(wav_file_reader_t *reader, void *buffer,
+                                 size_t size, size_t *bytes_read);
+
+/**
+ * @brief Seek within the PCM data
+ * 
+ * @param reader Open reader
+ * @param pcm_offset Byte offset from the start of PCM, rounded down to a
+ *                   whole frame
+ * @return FS_OK on success, error code on failure
+ */
+fs_result_t wav_file_reader_seek(wav_file_reader_t *reader, size_t pcm_offset);
+
+/**
+ * @brief Seek to a play time
+ * 
+ * @param reader Open reader
+ * @param position_ms Time from the start of the PCM data, clamped to the
+ *                    end of the data; lands on a whole frame
+ * @return FS_OK on success, error code on failure
+ */
+fs_result_t wav_file_reader_seek_ms(wav_file_reader_t *reader, uint32_t position_ms);
+
+/**
+ * @brief Check whether all PCM data has been read
+ * 
+ * @param reader Open reader
+ * @return true at end of data
+ */
+bool wav_file_reader_is_eof(const wav_file_reader_t *reader);
+
+/**
+ * @brief Release the reader (does not close the file)
+ * 
+ * @param reader Reader to close
+ */
+void wav_file_reader_close(wav_file_reader_t *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WAV_FILE_READER_H */
@@ -0,0 +1,32 @@
+/**
+ * @file app_threads.c
+ * @brief Stack high-water reporting for the application threads
+ *
+ * See app_threads.h for the scheduling plan.
+ */
+
+#include "app_threads.h"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(app_threads, LOG_LEVEL_INF);
+
+static void report_thread_stack(const struct k_thread *thread, void *user_data)
+{
+    const char *name = k_thread_name_get((k_tid_t)thread);
+    size_t size = thread->stack_info.size;
+    size_t unused;
+
+    if (k_thread_stack_space_get(thread, &unused) != 0 || size == 0) {
+        return;
+    }
+
+    LOG_INF("  %-14s %5zu / %5zu bytes (%zu%%)", (name && name[0]) ? name : "?",
+            size - unused, size, (size - unused) * 100 / size);
+}
+
+void app_threads_report_stacks(void)
+{
+    LOG_INF("📏 Stack high-water marks (used / size):");
+    k_thread_foreach_unlocked(report_thread_stack, NULL);
+}
@@ -0,0 +1,81 @@
+/**
+ * @file app_threads.h
+ * @brief Priorities and stack sizes of the application threads
+ *
+ * One place for the scheduling plan of the audio pipeline. Priorities
+ * follow the deadline of each stage, tightest first:
+ *
+ * | Thread          | Prio | Deadline                                              |
+ * |-----------------|------|-------------------------------------------------------|
+ * | bt_gatt_audio   | 4    | A notification ready for every connection event       |
+ * |                 |      | (7.5 - 30 ms), or the link sits idle                  |
+ * | net_rx          | 5    | Drain the socket before the TCP window closes; also   |
+ * |                 |      | runs PCM conversion and resampling per buffer, which  |
+ * |                 |      | the jitter buffer absorbs (tens of ms)                |
+ * | sd_readahead    | 6    | Next SD block before local playback drains the last   |
+ * | startup         | 6    | Boot only: kicks off WiFi and Bluetooth and handles   |
+ * |                 |      | their events before main needs them                   |
+ * | startup_sd      | 6    | Boot only: mounts the SD card and refreshes the track |
+ * |                 |      | index, blocking on their I/O                          |
+ * | main            | 7    | Test sequencing, CONFIG_MAIN_THREAD_PRIORITY          |
+ * | http_conn       | 8    | Control commands and the metrics push, human scale    |
+ * | trace_flush     | 14   | None - logs whatever the others leave time for        |
+ *
+ * The Bluetooth host and the system work queue run cooperatively above
+ * all of these. Each stage wakes on events from the one before it (a
+ * socket poll, a FIFO, a poll signal) rather than on sleeps, so the
+ * priority order decides who runs when several are ready.
+ *
+ * Stack sizes are starting points; app_threads_report_stacks() logs the
+ * measured high-water mark of every thread so they can be trimmed.
+ */
+
+#ifndef APP_THREADS_H
+#define APP_THREADS_H
+
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Priorities, see the table above */
+#define APP_THREAD_PRIO_BT_TX        K_PRIO_PREEMPT(4)
+#define APP_THREAD_PRIO_NET_RX       K_PRIO_PREEMPT(5)
+#define APP_THREAD_PRIO_READAHEAD    K_PRIO_PREEMPT(6)
+#define APP_THREAD_PRIO_STARTUP      K_PRIO_PREEMPT(6)
+#define APP_THREAD_PRIO_STARTUP_SD   K_PRIO_PREEMPT(6)
+#define APP_THREAD_PRIO_CONTROL      K_PRIO_PREEMPT(8)
+#define APP_THREAD_PRIO_BACKGROUND   K_LOWEST_APPLICATION_THREAD_PRIO
+
+/* Stack sizes in bytes */
+#define APP_THREAD_STACK_BT_TX       2048
+#define APP_THREAD_STACK_NET_RX      2048
+#define APP_THREAD_STACK_READAHEAD   1536
+#define APP_THREAD_STACK_STARTUP     1536
+#define APP_THREAD_STACK_STARTUP_SD  2048
+#define APP_THREAD_STACK_CONTROL     2048
+#define APP_THREAD_STACK_BACKGROUND  1024
+
+#if defined(CONFIG_APP_STACK_REPORT)
+
+/**
+ * @brief Log the stack high-water mark of every thread
+ *
+ * Walks all threads, application and system, and logs used and total
+ * stack bytes. Stacks are painted at creation (CONFIG_INIT_STACKS), so
+ * the figure is the deepest use since the thread started.
+ */
+void app_threads_report_stacks(void);
+
+#else
+
+static inline void app_threads_report_stacks(void) {}
+
+#endif /* CONFIG_APP_STACK_REPORT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_THREADS_H */
@@ -257,3 +257,258 @@ void circular_buffer_cleanup(circular_buffer_t *cb)
     circular_buffer_clear(cb);
     LOG_DBG("Circular buffer cleanup completed");
 }
+
+/* SPSC variant - see circular_buffers.h for the ownership rules */
+
+static inline size_t spsc_head(spsc_buffer_t *rb)
+{
+    return (size_t)atomic_get(&rb->head);
+}
+
+static inline size_t spsc_tail(spsc_buffer_t *rb)
+{
+    return (size_t)atomic_get(&rb->tail);
+}
+
+int spsc_buffer_init(spsc_buffer_t *rb, uint8_t *buffer, size_t size)
+{
+    if (!rb || !buffer || size == 0) {
+        return -EINVAL;
+    }
+
+    /* Masking only works for power-of-two sizes */
+    if ((size & (size - 1)) != 0) {
+        LOG_ERR("SPSC buffer size %zu is not a power of two", size);
+        return -EINVAL;
+    }
+
+    rb->buffer = buffer;
+    rb->size = size;
+    rb->mask = size - 1;
+    atomic_set(&rb->head, 0);
+    atomic_set(&rb->tail, 0);
+    rb->peek_tail = 0;
+
+    k_sem_init(&rb->data_available, 0, 1);
+    k_sem_init(&rb->space_available, 0, 1);
+
+    LOG_DBG("SPSC buffer initialized: size=%zu", size);
+    return 0;
+}
+
+size_t spsc_buffer_reserve(spsc_buffer_t *rb, uint8_t **data, size_t len)
+{
+    if (!rb || !data) {
+        return 0;
+    }
+
+    size_t head = spsc_head(rb);
+    size_t free_space = rb->size - (head - spsc_tail(rb));
+    size_t offset = head & rb->mask;
+    size_t contiguous = rb->size - offset;
+
+    size_t span = (free_space < contiguous) ? free_space : contiguous;
+    if (len < span) {
+        span = len;
+    }
+
+    *data = &rb->buffer[offset];
+    return span;
+}
+
+void spsc_buffer_commit(spsc_buffer_t *rb, size_t len)
+{
+    if (!rb || len == 0) {
+        return;
+    }
+
+    /* The data writes must be visible before the new head; atomic_set is a full barrier */
+    atomic_set(&rb->head, (atomic_val_t)(spsc_head(rb) + len));
+    k_sem_give(&rb->data_available);
+}
+
+size_t spsc_buffer_peek(spsc_buffer_t *rb, const uint8_t **data, size_t len)
+{
+    if (!rb || !data) {
+        return 0;
+    }
+
+    size_t tail = spsc_tail(rb);
+    size_t used = spsc_head(rb) - tail;
+    size_t offset = tail & rb->mask;
+
+    /* Remember where this span started so consume() can detect a clear() */
+    rb->peek_tail = tail;
+    size_t contiguous = rb->size - offset;
+
+    size_t span = (used < contiguous) ? used : contiguous;
+    if (len < span) {
+        span = len;
+    }
+
+    *data = &rb->buffer[offset];
+    return span;
+}
+
+size_t spsc_buffer_peek_timeout(spsc_buffer_t *rb, const uint8_t **data,
+                                size_t len, k_timeout_t timeout)
+{
+    if (!rb || !data || len == 0) {
+        return 0;
+    }
+
+    size_t span;
+    while ((span = spsc_buffer_peek(rb, data, len)) == 0) {
+        if (k_sem_take(&rb->data_available, timeout) != 0) {
+            return 0; // Timeout or error
+        }
+    }
+
+    return span;
+}
+
+void spsc_buffer_consume(spsc_buffer_t *rb, size_t len)
+{
+    if (!rb || len == 0) {
+        return;
+    }
+
+    /* A concurrent clear() may have moved tail since the peek; drop the update if so */
+    if (atomic_cas(&rb->tail, (atomic_val_t)rb->peek_tail,
+                   (atomic_val_t)(rb->peek_tail + len))) {
+        rb->peek_tail += len;
+    }
+    k_sem_give(&rb->space_available);
+}
+
+size_t spsc_buffer_write(spsc_buffer_t *rb, const uint8_t *data, size_t len)
+{
+    if (!rb || !data || len == 0) {
+        return 0;
+    }
+
+    size_t written = 0;
+
+    /* At most two spans: up to the end of the buffer, then from the start */
+    while (written < len) {
+        uint8_t *span_ptr;
+        size_t span = spsc_buffer_reserve(rb, &span_ptr, len - written);
+        if (span == 0) {
+            break;
+        }
+        memcpy(span_ptr, &data[written], span);
+        spsc_buffer_commit(rb, span);
+        written += span;
+    }
+
+    return written;
+}
+
+size_t spsc_buffer_write_timeout(spsc_buffer_t *rb, const uint8_t *data,
+                                 size_t len, k_timeout_t timeout)
+{
+    if (!rb || !data || len == 0) {
+        return 0;
+    }
+
+    // Wait for space if buffer is full
+    while (spsc_buffer_is_full(rb)) {
+        if (k_sem_take(&rb->space_available, timeout) != 0) {
+            return 0; // Timeout or error
+        }
+    }
+
+    return spsc_buffer_write(rb, data, len);
+}
+
+size_t spsc_buffer_read(spsc_buffer_t *rb, uint8_t *data, size_t len)
+{
+    if (!rb || !data || len == 0) {
+        return 0;
+    }
+
+    size_t read = 0;
+
+    while (read < len) {
+        const uint8_t *span_ptr;
+        size_t span = spsc_buffer_peek(rb, &span_ptr, len - read);
+        if (span == 0) {
+            break;
+        }
+        memcpy(&data[read], span_ptr, span);
+        spsc_buffer_consume(rb, span);
+        read += span;
+    }
+
+    return read;
+}
+
+size_t spsc_buffer_read_timeout(spsc_buffer_t *rb, uint8_t *data,
+                                size_t len, k_timeout_t timeout)
+{
+    if (!rb || !data || len == 0) {
+        return 0;
+    }
+
+    // Wait for data if buffer is empty
+    while (spsc_buffer_is_empty(rb)) {
+        if (k_sem_take(&rb->data_available, timeout) != 0) {
+            return 0; // Timeout or error
+        }
+    }
+
+    return spsc_buffer_read(rb, data, len);
+}
+
+size_t spsc_buffer_space_get(spsc_buffer_t *rb)
+{
+    if (!rb) {
+        return 0;
+    }
+
+    return rb->size - spsc_buffer_size_get(rb);
+}
+
+size_t spsc_buffer_size_get(spsc_buffer_t *rb)
+{
+    if (!rb) {
+        return 0;
+    }
+
+    /* Callers other than the producer and consumer may see both indices move */
+    size_t tail = spsc_tail(rb);
+    size_t used = spsc_head(rb) - tail;
+    return (used > rb->size) ? rb->size : used;
+}
+
+bool spsc_buffer_is_empty(spsc_buffer_t *rb)
+{
+    return spsc_buffer_size_get(rb) == 0;
+}
+
+bool spsc_buffer_is_full(spsc_buffer_t *rb)
+{
+    return rb ? (spsc_buffer_size_get(rb) == rb->size) : false;
+}
+
+void spsc_buffer_clear(spsc_buffer_t *rb)
+{
+    if (!rb) {
+        return;
+    }
+
+    atomic_set(&rb->tail, atomic_get(&rb->head));
+    k_sem_give(&rb->space_available);
+
+    LOG_DBG("SPSC buffer cleared");
+}
+
+void spsc_buffer_cleanup(spsc_buffer_t *rb)
+{
+    if (!rb) {
+        return;
+    }
+
+    spsc_buffer_clear(rb);
+    LOG_DBG("SPSC buffer cleanup completed");
+}
@@ -15,6 +15,7 @@
 #define CIRCULAR_BUFFERS_H
 
 #include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
@@ -137,6 +138,201 @@ void circular_buffer_clear(circular_buffer_t *cb);
  */
 void circular_buffer_cleanup(circular_buffer_t *cb);
 
+/*
+ * Single-producer/single-consumer variant
+ * 
+ * Same byte-stream semantics as circular_buffer_t, but without the mutex:
+ * head is only written by the producer and tail only by the consumer, so
+ * atomic index updates are enough. Indices run freely and are masked into
+ * the buffer, which therefore must be a power of two in size.
+ * 
+ * Besides copying read/write calls, the zero-copy pairs reserve/commit and
+ * peek/consume hand out contiguous spans of the ring itself, so a producer
+ * can recv() straight into it and a consumer can transmit straight out of it.
+ * 
+ * Exactly one thread may produce and one thread may consume. clear() is the
+ * only call that is safe from a third thread.
+ */
+
+/**
+ * @brief SPSC circular buffer structure
+ */
+typedef struct {
+    uint8_t *buffer;             ///< Buffer data storage
+    size_t size;                 ///< Total buffer size (power of two)
+    size_t mask;                 ///< size - 1, maps free-running indices into the buffer
+    atomic_t head;               ///< Free-running write index (producer owned)
+    atomic_t tail;               ///< Free-running read index (consumer owned)
+    size_t peek_tail;            ///< Read index seen by the last peek (consumer owned)
+    struct k_sem data_available; ///< Given by the producer after each commit
+    struct k_sem space_available;///< Given by the consumer after each consume
+} spsc_buffer_t;
+
+/**
+ * @brief Initialize an SPSC circular buffer
+ * 
+ * @param rb Pointer to SPSC buffer structure
+ * @param buffer Pointer to buffer memory (must be allocated by caller)
+ * @param size Size of the buffer in bytes, must be a power of two
+ * @return 0 on success, negative error code on failure
+ */
+int spsc_buffer_init(spsc_buffer_t *rb, uint8_t *buffer, size_t size);
+
+/**
+ * @brief Write data to SPSC buffer (non-blocking, producer only)
+ * 
+ * @param rb Pointer to SPSC buffer
+ * @param data Pointer to data to write
+ * @param len Length of data to write
+ * @return Number of bytes actually written
+ */
+size_t spsc_buffer_write(spsc_buffer_t *rb, const uint8_t *data, size_t len);
+
+/**
+ * @brief Write data to SPSC buffer (blocking with timeout, producer only)
+ * 
+ * Waits until at least one byte of space is available, then writes as much
+ * as fits, like circular_buffer_write_timeout().
+ * 
+ * @param rb Pointer to SPSC buffer
+ * @param data Pointer to data to write
+ * @param len Length of data to write
+ * @param timeout Timeout (K_FOREVER for no timeout)
+ * @return Number of bytes actually written
+ */
+size_t spsc_buffer_write_timeout(spsc_buffer_t *rb, const uint8_t *data,
+                                 size_t len, k_timeout_t timeout);
+
+/**
+ * @brief Read data from SPSC buffer (non-blocking, consumer only)
+ * 
+ * @param rb Pointer to SPSC buffer
+ * @param data Pointer to buffer to read into
+ * @param len Maximum length of data to read
+ * @return Number of bytes actually read
+ */
+size_t spsc_buffer_read(spsc_buffer_t *rb, uint8_t *data, size_t len);
+
+/**
+ * @brief Read data from SPSC buffer (blocking with timeout, consumer only)
+ * 
+ * @param rb Pointer to SPSC buffer
+ * @param data Pointer to buffer to read into
+ * @param len Maximum length of data to read
+ * @param timeout Timeout (K_FOREVER for no timeout)
+ * @return Number of bytes actually read
+ */
+size_t spsc_buffer_read_timeout(spsc_buffer_t *rb, uint8_t *data,
+                                size_t len, k_timeout_t timeout);
+
+/**
+ * @brief Reserve a contiguous span for zero-copy writing (producer only)
+ * 
+ * The span ends at the physical end of the buffer, so it may be shorter
+ * than the total free space. Nothing becomes visible to the consumer
+ * until spsc_buffer_commit() is called.
+ * 
+ * @param rb Pointer to SPSC buffer
+ * @param data Output pointer to the start of the writable span
+ * @param len Maximum span length wanted
+ * @return Length of the writable span, 0 if the buffer is full
+ */
+size_t spsc_buffer_reserve(spsc_buffer_t *rb, uint8_t **data, size_t len);
+
+/**
+ * @brief Publish bytes written into a reserved span (producer only)
+ * 
+ * @param rb Pointer to SPSC buffer
+ * @param len Number of bytes written, at most the reserved length
+ */
+void spsc_buffer_commit(spsc_buffer_t *rb, size_t len);
+
+/**
+ * @brief Get a contiguous span of readable data without copying (consumer only)
+ * 
+ * As with reserve, the span stops at the physical end of the buffer.
+ * The data stays in the ring until spsc_buffer_consume() is called.
+ * 
+ * @param rb Pointer to SPSC buffer
+ * @param data Output pointer to the start of the readable span
+ * @param len Maximum span length wanted
+ * @return Length of the readable span, 0 if the buffer is empty
+ */
+size_t spsc_buffer_peek(spsc_buffer_t *rb, const uint8_t **data, size_t len);
+
+/**
+ * @brief Get a contiguous readable span, waiting for data (consumer only)
+ * 
+ * @param rb Pointer to SPSC buffer
+ * @param data Output pointer to the start of the readable span
+ * @param len Maximum span length wanted
+ * @param timeout Timeout (K_FOREVER for no timeout)
+ * @return Length of the readable span, 0 on timeout
+ */
+size_t spsc_buffer_peek_timeout(spsc_buffer_t *rb, const uint8_t **data,
+                                size_t len, k_timeout_t timeout);
+
+/**
+ * @brief Release bytes obtained via peek (consumer only)
+ * 
+ * Ignored if the buffer was cleared since the peek.
+ * 
+ * @param rb Pointer to SPSC buffer
+ * @param len Number of bytes to release, at most the peeked length
+ */
+void spsc_buffer_consume(spsc_buffer_t *rb, size_t len);
+
+/**
+ * @brief Get available space in SPSC buffer
+ * 
+ * @param rb Pointer to SPSC buffer
+ * @return Available space in bytes
+ */
+size_t spsc_buffer_space_get(spsc_buffer_t *rb);
+
+/**
+ * @brief Get used space in SPSC buffer
+ * 
+ * @param rb Pointer to SPSC buffer
+ * @return Used space in bytes
+ */
+size_t spsc_buffer_size_get(spsc_buffer_t *rb);
+
+/**
+ * @brief Check if SPSC buffer is empty
+ * 
+ * @param rb Pointer to SPSC buffer
+ * @return true if empty, false otherwise
+ */
+bool spsc_buffer_is_empty(spsc_buffer_t *rb);
+
+/**
+ * @brief Check if SPSC buffer is full
+ * 
+ * @param rb Pointer to SPSC buffer
+ * @return true if full, false otherwise
+ */
+bool spsc_buffer_is_full(spsc_buffer_t *rb);
+
+/**
+ * @brief Discard all buffered data
+ * 
+ * Moves the read index up to the write index. Consumer side only, like
+ * spsc_buffer_consume(): a span from spsc_buffer_peek() would be handed
+ * back to the producer while it is still being read. Other threads ask
+ * the consumer to clear, or call this while the consumer can't run.
+ * 
+ * @param rb Pointer to SPSC buffer
+ */
+void spsc_buffer_clear(spsc_buffer_t *rb);
+
+/**
+ * @brief Reset and cleanup SPSC buffer
+ * 
+ * @param rb Pointer to SPSC buffer
+ */
+void spsc_buffer_cleanup(spsc_buffer_t *rb);
+
 #ifdef __cplusplus
 }
 #endif
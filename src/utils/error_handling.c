@@ -20,21 +20,25 @@
 #include "error_handling.h"
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/sys/reboot.h>
+#include <zephyr/sys/util.h>
 #include <stdio.h>
 #include <string.h>
 
 LOG_MODULE_REGISTER(error_handler, LOG_LEVEL_DBG);
 
-/* Error statistics */
+/* Error statistics - counters are atomic so async reports can bump them
+ * from any context, the last message and time are under error_mutex */
 static struct {
-    uint32_t total_errors;
-    uint32_t critical_errors;
-    uint32_t warnings;
-    uint32_t last_error_code;
+    atomic_t total_errors;
+    atomic_t critical_errors;
+    atomic_t warnings;
+    atomic_t last_error_code;
+    atomic_t dropped_reports;
     int64_t last_error_time;
     char last_error_msg[ERROR_MSG_MAX_LEN];
-} error_stats = {0};
+} error_stats;
 
 /* Error history ring buffer */
 #define ERROR_HISTORY_SIZE 16
@@ -51,30 +55,89 @@ static uint8_t error_history_count = 0;
 /* Mutex for thread-safe error handling */
 K_MUTEX_DEFINE(error_mutex);
 
+/*
+ * Queue of async reports - bounded multi-producer, single-consumer.
+ *
+ * Producers claim a position by advancing head with a CAS, fill the slot
+ * and publish it by bumping the slot's turn; the work item is the only
+ * consumer. A slot's turn counts its uses: 2 * lap while free for lap,
+ * 2 * lap + 1 once written. All zeroes is the empty queue, so it needs
+ * no initialization and works before error_handler_init().
+ */
+#define ERROR_QUEUE_DEPTH 16
+#define ERROR_QUEUE_MASK (ERROR_QUEUE_DEPTH - 1)
+#define ERROR_QUEUE_TURN_MASK ((UINT32_MAX / ERROR_QUEUE_DEPTH) * 2 + 1)
+
+BUILD_ASSERT((ERROR_QUEUE_DEPTH & ERROR_QUEUE_MASK) == 0,
+             "ERROR_QUEUE_DEPTH must be a power of two");
+
+struct error_report {
+    atomic_t turn;
+    const char *message;
+    const char *file;
+    int64_t timestamp;
+    uint16_t line;
+    uint8_t code;
+    uint8_t severity;
+};
+
+static void error_queue_work_handler(struct k_work *work);
+
+static struct {
+    atomic_t head;               ///< Next position to claim, shared by producers
+    uint32_t tail;               ///< Next position to read, work item only
+    struct error_report slots[ERROR_QUEUE_DEPTH];
+} error_queue;
+
+static K_WORK_DEFINE(error_queue_work, error_queue_work_handler);
+
 /* Forward declarations */
 static void add_to_history(error_code_t code, error_severity_t severity, 
-                          const char *message);
+                          const char *message, int64_t timestamp);
+static void reset_stats(void);
 static const char *severity_to_string(error_severity_t severity);
 static const char *code_to_string(error_code_t code);
 
 void error_handler_init(void)
 {
     LOG_INF("Error handler initialized");
-    memset(&error_stats, 0, sizeof(error_stats));
+    reset_stats();
+    k_mutex_lock(&error_mutex, K_FOREVER);
     memset(error_history, 0, sizeof(error_history));
     error_history_index = 0;
     error_history_count = 0;
+    k_mutex_unlock(&error_mutex);
 }
 
-void handle_error(error_code_t code, error_severity_t severity, 
-                 const char *message, const char *file, int line)
+/**
+ * @brief Update the counters for one error, safe from any context
+ */
+static void count_error(error_code_t code, error_severity_t severity)
+{
+    atomic_inc(&error_stats.total_errors);
+    atomic_set(&error_stats.last_error_code, code);
+    
+    switch (severity) {
+        case ERROR_SEVERITY_CRITICAL:
+            atomic_inc(&error_stats.critical_errors);
+            break;
+        case ERROR_SEVERITY_WARNING:
+            atomic_inc(&error_stats.warnings);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Record an error in the last message and history, then log it
+ */
+static void record_error(error_code_t code, error_severity_t severity, const char *message,
+                         const char *file, int line, int64_t timestamp)
 {
     k_mutex_lock(&error_mutex, K_FOREVER);
     
-    /* Update statistics */
-    error_stats.total_errors++;
-    error_stats.last_error_code = code;
-    error_stats.last_error_time = k_uptime_get();
+    error_stats.last_error_time = timestamp;
     
     if (message) {
         strncpy(error_stats.last_error_msg, message, 
@@ -84,19 +147,8 @@ void handle_error(error_code_t code, error_severity_t severity,
         error_stats.last_error_msg[0] = '\0';
     }
     
-    switch (severity) {
-        case ERROR_SEVERITY_CRITICAL:
-            error_stats.critical_errors++;
-            break;
-        case ERROR_SEVERITY_WARNING:
-            error_stats.warnings++;
-            break;
-        default:
-            break;
-    }
-    
     /* Add to history */
-    add_to_history(code, severity, message);
+    add_to_history(code, severity, message, timestamp);
     
     /* Format full error message */
     char full_message[256];
@@ -134,22 +186,109 @@ void handle_error(error_code_t code, error_severity_t severity,
     }
     
     k_mutex_unlock(&error_mutex);
+}
+
+/**
+ * @brief Halt (debug) or reboot after a critical error
+ */
+static void handle_critical_error(void)
+{
+    LOG_ERR("CRITICAL ERROR - System may be unstable");
+    
+    /* Add delay to ensure log is flushed */
+    k_sleep(K_MSEC(100));
+    
+    /* For development, we might want to halt instead of reboot */
+    #ifdef CONFIG_DEBUG
+    LOG_ERR("Halting system due to critical error (debug mode)");
+    k_panic();
+    #else
+    LOG_ERR("Rebooting system due to critical error");
+    sys_reboot(SYS_REBOOT_COLD);
+    #endif
+}
+
+void handle_error(error_code_t code, error_severity_t severity, 
+                 const char *message, const char *file, int line)
+{
+    count_error(code, severity);
+    record_error(code, severity, message, file, line, k_uptime_get());
     
     /* Handle critical errors */
     if (severity == ERROR_SEVERITY_CRITICAL) {
-        LOG_ERR("CRITICAL ERROR - System may be unstable");
+        handle_critical_error();
+    }
+}
+
+int error_report_async(error_code_t code, error_severity_t severity,
+                       const char *message, const char *file, int line)
+{
+    struct error_report *slot;
+    atomic_val_t pos = atomic_get(&error_queue.head);
+    
+    count_error(code, severity);
+    
+    for (;;) {
+        uint32_t free_turn = ((uint32_t)pos / ERROR_QUEUE_DEPTH * 2) & ERROR_QUEUE_TURN_MASK;
+        atomic_val_t turn;
         
-        /* Add delay to ensure log is flushed */
-        k_sleep(K_MSEC(100));
+        slot = &error_queue.slots[pos & ERROR_QUEUE_MASK];
+        turn = atomic_get(&slot->turn);
         
-        /* For development, we might want to halt instead of reboot */
-        #ifdef CONFIG_DEBUG
-        LOG_ERR("Halting system due to critical error (debug mode)");
-        k_panic();
-        #else
-        LOG_ERR("Rebooting system due to critical error");
-        sys_reboot(SYS_REBOOT_COLD);
-        #endif
+        if (turn == (atomic_val_t)free_turn) {
+            if (atomic_cas(&error_queue.head, pos, (atomic_val_t)((uint32_t)pos + 1))) {
+                break;
+            }
+        } else if (turn == (atomic_val_t)((free_turn - 1) & ERROR_QUEUE_TURN_MASK)) {
+            /* Still holds last lap's report - the queue is full */
+            atomic_inc(&error_stats.dropped_reports);
+            return -ENOSPC;
+        }
+        /* Another producer got there first */
+        pos = atomic_get(&error_queue.head);
+    }
+    
+    slot->message = message;
+    slot->file = file;
+    slot->timestamp = k_uptime_get();
+    slot->line = (uint16_t)MIN(line, UINT16_MAX);
+    slot->code = (uint8_t)code;
+    slot->severity = (uint8_t)severity;
+    
+    /* Publish - the consumer reads nothing before the turn says written */
+    atomic_inc(&slot->turn);
+    k_work_submit(&error_queue_work);
+    return 0;
+}
+
+/**
+ * @brief Drain queued async reports - record, log, and attempt recovery
+ */
+static void error_queue_work_handler(struct k_work *work)
+{
+    for (;;) {
+        struct error_report *slot = &error_queue.slots[error_queue.tail & ERROR_QUEUE_MASK];
+        uint32_t written_turn =
+            ((error_queue.tail / ERROR_QUEUE_DEPTH * 2) + 1) & ERROR_QUEUE_TURN_MASK;
+        struct error_report report;
+        
+        if (atomic_get(&slot->turn) != (atomic_val_t)written_turn) {
+            /* Empty, or the next producer hasn't finished - it resubmits */
+            break;
+        }
+        report = *slot;
+        atomic_set(&slot->turn, (written_turn + 1) & ERROR_QUEUE_TURN_MASK);
+        error_queue.tail++;
+        
+        record_error(report.code, report.severity, report.message, report.file,
+                     report.line, report.timestamp);
+        
+        if (report.severity == ERROR_SEVERITY_CRITICAL) {
+            handle_critical_error();
+        }
+        if (error_recovery_possible(report.code)) {
+            error_attempt_recovery(report.code);
+        }
     }
 }
 
@@ -157,12 +296,14 @@ error_stats_t error_get_stats(void)
 {
     error_stats_t stats;
     
+    stats.total_errors = (uint32_t)atomic_get(&error_stats.total_errors);
+    stats.critical_errors = (uint32_t)atomic_get(&error_stats.critical_errors);
+    stats.warnings = (uint32_t)atomic_get(&error_stats.warnings);
+    stats.last_error_code = (uint32_t)atomic_get(&error_stats.last_error_code);
+    stats.dropped_reports = (uint32_t)atomic_get(&error_stats.dropped_reports);
+    
     k_mutex_lock(&error_mutex, K_FOREVER);
     
-    stats.total_errors = error_stats.total_errors;
-    stats.critical_errors = error_stats.critical_errors;
-    stats.warnings = error_stats.warnings;
-    stats.last_error_code = error_stats.last_error_code;
     stats.last_error_time = error_stats.last_error_time;
     strncpy(stats.last_error_msg, error_stats.last_error_msg, 
             sizeof(stats.last_error_msg));
@@ -174,10 +315,7 @@ error_stats_t error_get_stats(void)
 
 void error_clear_stats(void)
 {
-    k_mutex_lock(&error_mutex, K_FOREVER);
-    memset(&error_stats, 0, sizeof(error_stats));
-    k_mutex_unlock(&error_mutex);
-    
+    reset_stats();
     LOG_INF("Error statistics cleared");
 }
 
@@ -264,12 +402,26 @@ void error_attempt_recovery(error_code_t code)
 }
 
 /* Helper functions */
+static void reset_stats(void)
+{
+    atomic_clear(&error_stats.total_errors);
+    atomic_clear(&error_stats.critical_errors);
+    atomic_clear(&error_stats.warnings);
+    atomic_clear(&error_stats.last_error_code);
+    atomic_clear(&error_stats.dropped_reports);
+    
+    k_mutex_lock(&error_mutex, K_FOREVER);
+    error_stats.last_error_time = 0;
+    memset(error_stats.last_error_msg, 0, sizeof(error_stats.last_error_msg));
+    k_mutex_unlock(&error_mutex);
+}
+
 static void add_to_history(error_code_t code, error_severity_t severity, 
-                          const char *message)
+                          const char *message, int64_t timestamp)
 {
     error_history[error_history_index].code = code;
     error_history[error_history_index].severity = severity;
-    error_history[error_history_index].timestamp = k_uptime_get();
+    error_history[error_history_index].timestamp = timestamp;
     
     if (message) {
         strncpy(error_history[error_history_index].message, message, 
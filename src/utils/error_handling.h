@@ -7,6 +7,9 @@
  * 
  * The hope is that this will allow for easier debugging and error management. 
  * 
+ * handle_error() logs and records inline and may block on a mutex. Hot
+ * paths, Bluetooth callbacks and ISRs use error_report_async() instead,
+ * which only queues the report for a work item.
  */
 
 #ifndef ERROR_HANDLING_H
@@ -68,6 +71,7 @@ typedef struct {
     uint32_t critical_errors;    /* Number of critical errors */
     uint32_t warnings;           /* Number of warnings */
     uint32_t last_error_code;    /* Last error code */
+    uint32_t dropped_reports;    /* Async reports lost to a full queue */
     int64_t last_error_time;     /* Timestamp of last error */
     char last_error_msg[ERROR_MSG_MAX_LEN]; /* Last error message */
 } error_stats_t;
@@ -91,6 +95,26 @@ void error_handler_init(void);
 void handle_error(error_code_t code, error_severity_t severity, 
                  const char *message, const char *file, int line);
 
+/**
+ * @brief Report an error without blocking
+ * 
+ * Safe from any thread, Bluetooth callbacks and ISRs. The counters are
+ * updated on the spot; recording, logging and - where
+ * error_recovery_possible() - error_attempt_recovery() happen later on
+ * the system work queue. A report that finds the queue full is counted
+ * in dropped_reports and otherwise lost.
+ * 
+ * @param code Error code
+ * @param severity Error severity level
+ * @param message Optional error message with static storage (a string
+ *                literal) - only the pointer is queued
+ * @param file Source file name (use __FILE__)
+ * @param line Source line number (use __LINE__)
+ * @return 0 on success, -ENOSPC if the report was dropped
+ */
+int error_report_async(error_code_t code, error_severity_t severity,
+                       const char *message, const char *file, int line);
+
 /**
  * @brief Get error statistics
  * 
@@ -140,6 +164,13 @@ void error_attempt_recovery(error_code_t code);
 #define REPORT_INFO(code, msg) \
     handle_error(code, ERROR_SEVERITY_INFO, msg, __FILE__, __LINE__)
 
+/* Non-blocking variants for the audio path, see error_report_async() */
+#define REPORT_ERROR_ASYNC(code, msg) \
+    error_report_async(code, ERROR_SEVERITY_ERROR, msg, __FILE__, __LINE__)
+
+#define REPORT_WARNING_ASYNC(code, msg) \
+    error_report_async(code, ERROR_SEVERITY_WARNING, msg, __FILE__, __LINE__)
+
 /* Macros for error handling with automatic recovery attempt */
 #define HANDLE_ERROR_WITH_RECOVERY(code, msg) \
     do { \
@@ -0,0 +1,64 @@
+/**
+ * @file mem_plan.c
+ * @brief Build-time checks and boot report for the memory plan
+ *
+ * See mem_plan.h. Each assertion states which setting to change when it
+ * fails.
+ */
+
+#include "mem_plan.h"
+#include "app_threads.h"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(mem_plan, LOG_LEVEL_INF);
+
+BUILD_ASSERT(MEM_PLAN_POOL_BUFFER_SIZE % MEM_PLAN_FRAME_BYTES == 0,
+             "CONFIG_APP_AUDIO_BUFFER_SIZE must hold whole sample frames");
+BUILD_ASSERT(MEM_PLAN_POOL_BUFFER_SIZE % 4 == 0,
+             "CONFIG_APP_AUDIO_BUFFER_SIZE must be a multiple of 4 for the memory slab");
+BUILD_ASSERT(MEM_PLAN_POOL_COUNT >= MEM_PLAN_POOL_COUNT_NEEDED,
+             "Audio pool too small for CONFIG_APP_AUDIO_POOL_LATENCY_MS - raise "
+             "CONFIG_APP_AUDIO_BUFFER_COUNT or CONFIG_APP_AUDIO_BUFFER_SIZE");
+BUILD_ASSERT(CONFIG_APP_SD_READAHEAD_DEPTH < MEM_PLAN_POOL_COUNT,
+             "CONFIG_APP_SD_READAHEAD_DEPTH must leave a pool buffer for the consumer");
+BUILD_ASSERT((MEM_PLAN_BT_RING_SIZE & (MEM_PLAN_BT_RING_SIZE - 1)) == 0,
+             "MEM_PLAN_BT_RING_SIZE must be a power of two for the SPSC ring");
+BUILD_ASSERT(MEM_PLAN_BT_RING_SIZE >= MEM_PLAN_BT_RING_MIN_BYTES,
+             "MEM_PLAN_BT_RING_SIZE must hold MEM_PLAN_BT_RING_NOTIFICATIONS notifications");
+#if defined(CONFIG_APP_AUDIO_PWM)
+BUILD_ASSERT((MEM_PLAN_PWM_RING_SIZE & (MEM_PLAN_PWM_RING_SIZE - 1)) == 0,
+             "MEM_PLAN_PWM_RING_SIZE must be a power of two for the SPSC ring");
+BUILD_ASSERT(MEM_PLAN_PWM_RING_SIZE >= 4 * MEM_PLAN_PWM_DMA_HALF_SAMPLES * sizeof(uint16_t),
+             "MEM_PLAN_PWM_RING_SIZE must hold several DMA halves");
+#endif
+#if MEM_PLAN_AUDIO_IN_SRAM2
+BUILD_ASSERT(MEM_PLAN_AUDIO_SECTION_BYTES <= MEM_PLAN_SRAM2_SIZE,
+             "Audio pools exceed SRAM2 - lower the pool size or disable CONFIG_APP_AUDIO_POOL_SRAM2");
+#endif
+
+void mem_plan_report(void)
+{
+    static const size_t stacks = APP_THREAD_STACK_BT_TX + APP_THREAD_STACK_NET_RX +
+                                 APP_THREAD_STACK_READAHEAD + APP_THREAD_STACK_CONTROL +
+                                 APP_THREAD_STACK_BACKGROUND + CONFIG_MAIN_STACK_SIZE;
+
+    LOG_INF("🧮 Memory plan (%u Hz, %uch, %u-bit, ATT MTU %u):", MEM_PLAN_SAMPLE_RATE,
+            MEM_PLAN_CHANNELS, MEM_PLAN_BYTES_PER_SAMPLE * 8, MEM_PLAN_ATT_MTU);
+    LOG_INF("  Audio pool   %2d x %4d B = %5d B, %u ms buffered (target %u ms)",
+            MEM_PLAN_POOL_COUNT, MEM_PLAN_POOL_BUFFER_SIZE, MEM_PLAN_POOL_BYTES,
+            MEM_PLAN_POOL_MS, MEM_PLAN_LATENCY_MS);
+    LOG_INF("  BT ring      %5d B, %u notifications of %u B", MEM_PLAN_BT_RING_SIZE,
+            MEM_PLAN_BT_RING_SIZE / MEM_PLAN_NOTIFY_PAYLOAD, MEM_PLAN_NOTIFY_PAYLOAD);
+#if defined(CONFIG_APP_AUDIO_PWM)
+    LOG_INF("  PWM output   %5d B, %u ms per DMA half", (int)MEM_PLAN_PWM_BYTES,
+            MEM_PLAN_PWM_DMA_HALF_SAMPLES * 1000 / MEM_PLAN_SAMPLE_RATE);
+#endif
+#if MEM_PLAN_AUDIO_IN_SRAM2
+    LOG_INF("  SRAM2        %5d of %d B used by the audio pools",
+            MEM_PLAN_AUDIO_SECTION_BYTES, (int)MEM_PLAN_SRAM2_SIZE);
+#else
+    LOG_INF("  Audio pools in main SRAM");
+#endif
+    LOG_INF("  App stacks   %5zu B, heap %d B", stacks, CONFIG_HEAP_MEM_POOL_SIZE);
+}
@@ -0,0 +1,104 @@
+/**
+ * @file mem_plan.h
+ * @brief Compile-time memory plan for the audio pipeline
+ *
+ * Every statically sized audio store is derived here from three inputs:
+ * the PCM format the pipeline carries, the latency the buffer pool must
+ * cover, and the ATT MTU the Bluetooth link notifies with. mem_plan.c
+ * checks the plan with BUILD_ASSERTs, so a Kconfig change that no longer
+ * fits fails the build with a reason instead of overflowing at run time,
+ * and mem_plan_report() logs the resulting budget at boot.
+ *
+ * The large stores - the pool's slab memory and the Bluetooth ring - go
+ * into SRAM2 (MEM_PLAN_AUDIO_SECTION) when the board has it, leaving the
+ * main SRAM to stacks, the heap and the network buffers. SRAM2 is a
+ * separate linker region that startup code neither copies nor clears,
+ * so only storage that is fully written before it is read may live there.
+ */
+
+#ifndef MEM_PLAN_H
+#define MEM_PLAN_H
+
+#include <zephyr/devicetree.h>
+#include <zephyr/linker/devicetree_regions.h>
+#include <zephyr/sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Inputs: the PCM format between the receive thread and the BLE sender */
+#define MEM_PLAN_SAMPLE_RATE         44100
+#define MEM_PLAN_CHANNELS            2
+#define MEM_PLAN_BYTES_PER_SAMPLE    2
+#define MEM_PLAN_LATENCY_MS          CONFIG_APP_AUDIO_POOL_LATENCY_MS
+
+/* Inputs: the ATT MTU negotiated for notifications */
+#if defined(CONFIG_BT_L2CAP_TX_MTU)
+#define MEM_PLAN_ATT_MTU             CONFIG_BT_L2CAP_TX_MTU
+#else
+#define MEM_PLAN_ATT_MTU             247
+#endif
+#define MEM_PLAN_NOTIFY_PAYLOAD      (MEM_PLAN_ATT_MTU - 3)
+
+#define MEM_PLAN_FRAME_BYTES         (MEM_PLAN_CHANNELS * MEM_PLAN_BYTES_PER_SAMPLE)
+#define MEM_PLAN_BYTES_PER_SEC       (MEM_PLAN_SAMPLE_RATE * MEM_PLAN_FRAME_BYTES)
+#define MEM_PLAN_MS_TO_BYTES(ms)     ((uint32_t)(ms) * MEM_PLAN_BYTES_PER_SEC / 1000)
+#define MEM_PLAN_BYTES_TO_MS(bytes)  ((uint32_t)(bytes) * 1000 / MEM_PLAN_BYTES_PER_SEC)
+
+/* Audio buffer pool (audio_buffers.c) */
+#define MEM_PLAN_POOL_COUNT          CONFIG_APP_AUDIO_BUFFER_COUNT
+#define MEM_PLAN_POOL_BUFFER_SIZE    CONFIG_APP_AUDIO_BUFFER_SIZE
+#define MEM_PLAN_POOL_BYTES          (MEM_PLAN_POOL_COUNT * MEM_PLAN_POOL_BUFFER_SIZE)
+
+/** Audio the pool can hold for the jitter buffer - one buffer stays with the producer */
+#define MEM_PLAN_POOL_MS \
+    MEM_PLAN_BYTES_TO_MS((MEM_PLAN_POOL_COUNT - 1) * MEM_PLAN_POOL_BUFFER_SIZE)
+
+/** Buffers needed to cover MEM_PLAN_LATENCY_MS at the current buffer size */
+#define MEM_PLAN_POOL_COUNT_NEEDED \
+    (DIV_ROUND_UP(MEM_PLAN_MS_TO_BYTES(MEM_PLAN_LATENCY_MS), MEM_PLAN_POOL_BUFFER_SIZE) + 1)
+
+/* Bluetooth ring for bluetooth_audio_write() (bluetooth.c) - a power of two
+ * with room for MEM_PLAN_BT_RING_NOTIFICATIONS full notifications */
+#define MEM_PLAN_BT_RING_NOTIFICATIONS 8
+#define MEM_PLAN_BT_RING_MIN_BYTES   (MEM_PLAN_BT_RING_NOTIFICATIONS * MEM_PLAN_NOTIFY_PAYLOAD)
+#define MEM_PLAN_BT_RING_SIZE        2048
+
+/* PWM output (audioplay_pwm.c): a ring of 16-bit duty values in front of
+ * a circular DMA buffer of two halves, one interrupt per half */
+#if defined(CONFIG_APP_AUDIO_PWM)
+#define MEM_PLAN_PWM_RING_SIZE       4096
+#define MEM_PLAN_PWM_DMA_HALF_SAMPLES 256
+#define MEM_PLAN_PWM_BYTES \
+    (MEM_PLAN_PWM_RING_SIZE + 2 * MEM_PLAN_PWM_DMA_HALF_SAMPLES * sizeof(uint16_t))
+#else
+#define MEM_PLAN_PWM_BYTES           0
+#endif
+
+/* Everything placed in MEM_PLAN_AUDIO_SECTION */
+#define MEM_PLAN_AUDIO_SECTION_BYTES \
+    (MEM_PLAN_POOL_BYTES + MEM_PLAN_BT_RING_SIZE + MEM_PLAN_PWM_BYTES)
+
+/* SRAM2 placement - the STM32L4 DMA controllers reach it as well */
+#if defined(CONFIG_APP_AUDIO_POOL_SRAM2) && \
+    DT_NODE_HAS_PROP(DT_NODELABEL(sram1), zephyr_memory_region)
+#define MEM_PLAN_AUDIO_IN_SRAM2      1
+#define MEM_PLAN_SRAM2_SIZE          DT_REG_SIZE(DT_NODELABEL(sram1))
+#define MEM_PLAN_AUDIO_SECTION \
+    __attribute__((section(LINKER_DT_NODE_REGION_NAME(DT_NODELABEL(sram1)))))
+#else
+#define MEM_PLAN_AUDIO_IN_SRAM2      0
+#define MEM_PLAN_AUDIO_SECTION
+#endif
+
+/**
+ * @brief Log the memory plan: pool depth and latency, ring, stacks, heap
+ */
+void mem_plan_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEM_PLAN_H */
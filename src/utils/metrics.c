@@ -0,0 +1,187 @@
+/**
+ * @file metrics.c
+ * @brief Counters and latency histograms for the audio hot path
+ *
+ * All slots are atomic_t, so recording is one atomic add (two to four for
+ * a histogram sample) from any thread or ISR. See metrics.h.
+ */
+
+#include "metrics.h"
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#include <stdio.h>
+#include <string.h>
+
+struct metrics_histogram_slots {
+    atomic_t count;
+    atomic_t sum;
+    atomic_t max;
+    atomic_t buckets[METRICS_HIST_BUCKETS];
+};
+
+static struct {
+    atomic_t counters[METRICS_COUNTER_COUNT];
+    atomic_t gauges[METRICS_GAUGE_COUNT];
+    atomic_t gauge_peaks[METRICS_GAUGE_COUNT];
+    struct metrics_histogram_slots histograms[METRICS_HISTOGRAM_COUNT];
+} metrics;
+
+/**
+ * @brief Raise a slot to value if it is lower
+ */
+static void atomic_max(atomic_t *slot, uint32_t value)
+{
+    atomic_val_t old = atomic_get(slot);
+
+    while ((uint32_t)old < value && !atomic_cas(slot, old, (atomic_val_t)value)) {
+        old = atomic_get(slot);
+    }
+}
+
+static unsigned int bucket_of(uint32_t value)
+{
+    if (value == 0) {
+        return 0;
+    }
+    return MIN(32 - __builtin_clz(value), METRICS_HIST_BUCKETS - 1);
+}
+
+void metrics_add(enum metrics_counter counter, uint32_t value)
+{
+    atomic_add(&metrics.counters[counter], (atomic_val_t)value);
+}
+
+void metrics_gauge_set(enum metrics_gauge gauge, uint32_t value)
+{
+    atomic_set(&metrics.gauges[gauge], (atomic_val_t)value);
+    atomic_max(&metrics.gauge_peaks[gauge], value);
+}
+
+void metrics_record(enum metrics_histogram histogram, uint32_t value)
+{
+    struct metrics_histogram_slots *hist = &metrics.histograms[histogram];
+
+    atomic_inc(&hist->buckets[bucket_of(value)]);
+    atomic_add(&hist->sum, (atomic_val_t)value);
+    atomic_inc(&hist->count);
+    atomic_max(&hist->max, value);
+}
+
+void metrics_snapshot(struct metrics_snapshot *snapshot)
+{
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->version = METRICS_VERSION;
+    snapshot->counter_count = METRICS_COUNTER_COUNT;
+    snapshot->gauge_count = METRICS_GAUGE_COUNT;
+    snapshot->histogram_count = METRICS_HISTOGRAM_COUNT;
+    snapshot->uptime_ms = k_uptime_get_32();
+
+    for (int i = 0; i < METRICS_COUNTER_COUNT; i++) {
+        snapshot->counters[i] = (uint32_t)atomic_get(&metrics.counters[i]);
+    }
+    for (int i = 0; i < METRICS_GAUGE_COUNT; i++) {
+        snapshot->gauges[i] = (uint32_t)atomic_get(&metrics.gauges[i]);
+        snapshot->gauge_peaks[i] = (uint32_t)atomic_get(&metrics.gauge_peaks[i]);
+    }
+    for (int i = 0; i < METRICS_HISTOGRAM_COUNT; i++) {
+        struct metrics_histogram_slots *hist = &metrics.histograms[i];
+        struct metrics_histogram_snapshot *out = &snapshot->histograms[i];
+
+        out->count = (uint32_t)atomic_get(&hist->count);
+        out->sum = (uint32_t)atomic_get(&hist->sum);
+        out->max = (uint32_t)atomic_get(&hist->max);
+        for (int b = 0; b < METRICS_HIST_BUCKETS; b++) {
+            out->buckets[b] = (uint32_t)atomic_get(&hist->buckets[b]);
+        }
+    }
+}
+
+uint32_t metrics_percentile(const struct metrics_histogram_snapshot *hist, uint32_t permille)
+{
+    uint64_t total = 0;
+    uint64_t seen = 0;
+
+    for (int b = 0; b < METRICS_HIST_BUCKETS; b++) {
+        total += hist->buckets[b];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t rank = (total * permille + 999) / 1000;
+    for (int b = 0; b < METRICS_HIST_BUCKETS; b++) {
+        seen += hist->buckets[b];
+        if (seen >= rank && seen > 0) {
+            /* No bucket bound says more than the largest sample seen */
+            if (b == 0) {
+                return 0;
+            }
+            if (b == METRICS_HIST_BUCKETS - 1) {
+                return hist->max;
+            }
+            return MIN((1U << b) - 1, hist->max);
+        }
+    }
+    return hist->max;
+}
+
+/**
+ * @brief Counter increase per second between two snapshots
+ */
+static uint32_t rate_of(const struct metrics_snapshot *now, const struct metrics_snapshot *prev,
+                        enum metrics_counter counter)
+{
+    uint32_t elapsed;
+
+    if (!prev) {
+        return 0;
+    }
+    elapsed = now->uptime_ms - prev->uptime_ms;
+    if (elapsed == 0) {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)(now->counters[counter] - prev->counters[counter]) * 1000 /
+                      elapsed);
+}
+
+int metrics_to_json(const struct metrics_snapshot *now, const struct metrics_snapshot *prev,
+                    char *buf, size_t size)
+{
+    static const char *const hist_names[METRICS_HISTOGRAM_COUNT] = {
+        [METRICS_HIST_E2E_MS] = "e2e_ms",
+        [METRICS_HIST_RX_PROCESS_US] = "rx_proc_us",
+        [METRICS_HIST_NOTIFY_US] = "notify_us",
+    };
+    int len;
+
+    len = snprintf(buf, size,
+                   "{\"v\":%u,\"up\":%u,\"rx\":%u,\"rx_bps\":%u,\"rx_buf\":%u,"
+                   "\"ntf_ok\":%u,\"ntf_enomem\":%u,\"ntf_eagain\":%u,\"ntf_err\":%u,"
+                   "\"ntf_bps\":%u,\"underruns\":%u,\"txq\":[%u,%u],\"jb_ms\":[%u,%u]",
+                   now->version, now->uptime_ms, now->counters[METRICS_RX_BYTES],
+                   rate_of(now, prev, METRICS_RX_BYTES), now->counters[METRICS_RX_BUFFERS],
+                   now->counters[METRICS_NOTIFY_OK], now->counters[METRICS_NOTIFY_ENOMEM],
+                   now->counters[METRICS_NOTIFY_EAGAIN],
+                   now->counters[METRICS_NOTIFY_ERROR], rate_of(now, prev, METRICS_NOTIFY_BYTES),
+                   now->counters[METRICS_UNDERRUNS],
+                   now->gauges[METRICS_TX_QUEUED], now->gauge_peaks[METRICS_TX_QUEUED],
+                   now->gauges[METRICS_JITTER_BUFFERED_MS],
+                   now->gauge_peaks[METRICS_JITTER_BUFFERED_MS]);
+
+    for (int i = 0; i < METRICS_HISTOGRAM_COUNT && len > 0 && (size_t)len < size; i++) {
+        const struct metrics_histogram_snapshot *hist = &now->histograms[i];
+
+        len += snprintf(&buf[len], size - len, ",\"%s\":[%u,%u,%u,%u]", hist_names[i],
+                        hist->count, metrics_percentile(hist, 500),
+                        metrics_percentile(hist, 990), hist->max);
+    }
+    if (len > 0 && (size_t)len < size) {
+        len += snprintf(&buf[len], size - len, "}");
+    }
+
+    if (len < 0 || (size_t)len >= size) {
+        return -ENOMEM;
+    }
+    return len;
+}
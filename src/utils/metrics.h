@@ -0,0 +1,147 @@
+/**
+ * @file metrics.h
+ * @brief Counters and latency histograms for the audio hot path
+ *
+ * Every stage of the pipeline records into fixed slots with single atomic
+ * operations - no locks, no logging - so the instrumentation can stay on
+ * in release builds. Readers take a snapshot, which is what the metrics
+ * GATT characteristic and the periodic HTTP push report.
+ *
+ * Histograms have METRICS_HIST_BUCKETS power-of-two buckets: bucket 0
+ * counts zeros, bucket i counts values in [2^(i-1), 2^i), and the last
+ * bucket everything above. Snapshots are little-endian and packed, so the
+ * GATT value can be decoded on the host as is.
+ *
+ * With CONFIG_APP_METRICS disabled every call compiles away.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define METRICS_VERSION 1
+#define METRICS_HIST_BUCKETS 16
+
+/**
+ * @brief Event counters
+ */
+enum metrics_counter {
+    METRICS_RX_BYTES,            ///< Stream bytes received from the server
+    METRICS_RX_BUFFERS,          ///< Pool buffers submitted by the receive thread
+    METRICS_NOTIFY_OK,           ///< GATT notifications accepted by the stack
+    METRICS_NOTIFY_ENOMEM,       ///< Notifications refused for lack of ACL buffers
+    METRICS_NOTIFY_EAGAIN,       ///< Sends that found no TX credit (or were rate limited)
+    METRICS_NOTIFY_ERROR,        ///< Notifications dropped on any other error
+    METRICS_NOTIFY_BYTES,        ///< Payload bytes accepted by the stack
+    METRICS_UNDERRUNS,           ///< Output ran dry mid-stream
+    METRICS_COUNTER_COUNT
+};
+
+/**
+ * @brief Levels, reported as current value and peak since boot
+ */
+enum metrics_gauge {
+    METRICS_TX_QUEUED,           ///< Bytes queued for the Bluetooth sender
+    METRICS_JITTER_BUFFERED_MS,  ///< Audio held by the jitter buffer
+    METRICS_GAUGE_COUNT
+};
+
+/**
+ * @brief Latency histograms
+ */
+enum metrics_histogram {
+    METRICS_HIST_E2E_MS,         ///< Buffer allocation to last byte notified, ms
+    METRICS_HIST_RX_PROCESS_US,  ///< Conversion and resampling per received buffer, us
+    METRICS_HIST_NOTIFY_US,      ///< One gatt_audio_send_data() call, us
+    METRICS_HISTOGRAM_COUNT
+};
+
+/**
+ * @brief One histogram in a snapshot
+ */
+struct metrics_histogram_snapshot {
+    uint32_t count;
+    uint32_t sum;                ///< Wraps on long runs, use deltas
+    uint32_t max;
+    uint32_t buckets[METRICS_HIST_BUCKETS];
+} __packed;
+
+/**
+ * @brief Everything at one point in time
+ */
+struct metrics_snapshot {
+    uint8_t version;             ///< METRICS_VERSION
+    uint8_t counter_count;       ///< METRICS_COUNTER_COUNT
+    uint8_t gauge_count;         ///< METRICS_GAUGE_COUNT
+    uint8_t histogram_count;     ///< METRICS_HISTOGRAM_COUNT
+    uint32_t uptime_ms;
+    uint32_t counters[METRICS_COUNTER_COUNT];
+    uint32_t gauges[METRICS_GAUGE_COUNT];
+    uint32_t gauge_peaks[METRICS_GAUGE_COUNT];
+    struct metrics_histogram_snapshot histograms[METRICS_HISTOGRAM_COUNT];
+} __packed;
+
+#if defined(CONFIG_APP_METRICS)
+
+void metrics_add(enum metrics_counter counter, uint32_t value);
+void metrics_gauge_set(enum metrics_gauge gauge, uint32_t value);
+void metrics_record(enum metrics_histogram histogram, uint32_t value);
+
+/**
+ * @brief Copy the current values
+ *
+ * Each value is read atomically, the snapshot as a whole is not - a count
+ * may be one event ahead of its histogram.
+ *
+ * @param snapshot Filled with the current values
+ */
+void metrics_snapshot(struct metrics_snapshot *snapshot);
+
+/**
+ * @brief Value below which a fraction of a histogram's samples fall
+ *
+ * @param hist Histogram from a snapshot
+ * @param permille Fraction in 1/1000 (500 = median)
+ * @return Upper bound of the bucket holding that sample, 0 if empty
+ */
+uint32_t metrics_percentile(const struct metrics_histogram_snapshot *hist, uint32_t permille);
+
+/**
+ * @brief Format a snapshot as compact JSON for the HTTP push
+ *
+ * Histograms are summarised as [count, p50, p99, max].
+ *
+ * @param now Snapshot to report
+ * @param prev Previous report for the rates, NULL for none
+ * @param buf Output buffer
+ * @param size Size of @p buf
+ * @return Length written, -ENOMEM if @p buf is too small
+ */
+int metrics_to_json(const struct metrics_snapshot *now, const struct metrics_snapshot *prev,
+                    char *buf, size_t size);
+
+#else
+
+static inline void metrics_add(enum metrics_counter counter, uint32_t value) {}
+static inline void metrics_gauge_set(enum metrics_gauge gauge, uint32_t value) {}
+static inline void metrics_record(enum metrics_histogram histogram, uint32_t value) {}
+
+#endif /* CONFIG_APP_METRICS */
+
+static inline void metrics_inc(enum metrics_counter counter)
+{
+    metrics_add(counter, 1);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METRICS_H */
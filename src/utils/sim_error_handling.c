@@ -42,6 +42,14 @@ void handle_error(error_code_t code, error_severity_t severity, const char *mess
     }
 }
 
+int error_report_async(error_code_t code, error_severity_t severity,
+                       const char *message, const char *file, int line)
+{
+    /* Single-threaded simulation - report inline */
+    handle_error(code, severity, message, file, line);
+    return 0;
+}
+
 error_stats_t error_get_stats(void)
 {
     return stats;
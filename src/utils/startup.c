@@ -0,0 +1,543 @@
+/**
+ * @file startup.c
+ * @brief Parallel bring-up of WiFi, Bluetooth and the SD card
+ *
+ * Please refer to startup.h for more documentation. Bluetooth and WiFi are
+ * work items on the startup queue that only kick their subsystem off; the
+ * Bluetooth ready callback and net_mgmt events finish them. The SD mount
+ * blocks, so it runs on a queue of its own. Every finished stage is posted
+ * as a bit on startup.done.
+ */
+
+#include "startup.h"
+#include "app_threads.h"
+#include "../audio/bluetooth.h"
+#if defined(CONFIG_FAT_FILESYSTEM_ELM)
+#include "../storage/fs.h"
+#include "../storage/media_index.h"
+#endif
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/net_event.h>
+#include <zephyr/net/net_mgmt.h>
+#include <zephyr/net/wifi_mgmt.h>
+#if defined(CONFIG_SETTINGS)
+#include <zephyr/settings/settings.h>
+#endif
+#include <string.h>
+#include <errno.h>
+
+LOG_MODULE_REGISTER(startup, LOG_LEVEL_INF);
+
+#define STARTUP_BT_TIMEOUT_MS     5000    // HCI init over SPI takes a few hundred ms
+#define STARTUP_WIFI_TIMEOUT_MS   30000   // Association and DHCP
+#define STARTUP_WIFI_RETRY_MS     500     // Connect refused while the interface comes up
+
+#define STARTUP_PENDING           (-EINPROGRESS)
+
+/* Bring-up gets its own queue rather than the system one - the Bluetooth
+ * host runs its HCI init there meanwhile */
+K_THREAD_STACK_DEFINE(startup_stack, APP_THREAD_STACK_STARTUP);
+
+/* The SD mount blocks on card I/O for up to seconds; kept off the startup
+ * queue so WiFi events and stage timeouts are handled meanwhile */
+K_THREAD_STACK_DEFINE(startup_sd_stack, APP_THREAD_STACK_STARTUP_SD);
+
+struct startup_stage_state {
+    struct k_work_delayable work;      // Kicks the stage off
+    struct k_work_delayable timeout;
+    atomic_t result;                   // STARTUP_PENDING until done
+    int64_t start_ms;                  // Uptime when the stage was kicked off
+    int64_t done_ms;
+};
+
+#if defined(CONFIG_SETTINGS)
+/* Last association, stored under "startup/wifi" */
+struct startup_wifi_cache {
+    uint8_t ssid_len;
+    char ssid[WIFI_SSID_MAX_LEN];
+    uint8_t channel;                   // 0 when nothing is cached
+};
+#endif
+
+static const char *const startup_stage_names[STARTUP_STAGE_COUNT] = {
+    [STARTUP_STAGE_BLUETOOTH] = "bluetooth",
+    [STARTUP_STAGE_WIFI] = "wifi",
+    [STARTUP_STAGE_SD] = "sd",
+};
+
+static struct {
+    bool started;
+    const struct startup_config *config;
+    struct k_work_q workq;
+    struct k_work_q sd_workq;          // SD stage only
+    struct k_event done;               // STARTUP_STAGE_BIT() of every finished stage
+    atomic_t remaining;
+    struct startup_stage_state stages[STARTUP_STAGE_COUNT];
+
+    /* WiFi stage, events are handled on the startup queue */
+    struct net_if *iface;
+    struct net_mgmt_event_callback wifi_cb;
+    struct net_mgmt_event_callback ipv4_cb;
+    struct k_work wifi_event_work;
+    atomic_t wifi_status;              // Latest connect result, STARTUP_PENDING if none
+    atomic_t wifi_addr;                // Set once an IPv4 address was added
+    bool wifi_associated;
+    uint8_t wifi_channel;              // WIFI_CHANNEL_ANY for a full scan
+#if defined(CONFIG_SETTINGS)
+    struct startup_wifi_cache wifi_cache;
+#endif
+} startup;
+
+static void startup_bt_work(struct k_work *work);
+static void startup_wifi_work(struct k_work *work);
+static void startup_sd_work(struct k_work *work);
+
+static const k_work_handler_t startup_stage_handlers[STARTUP_STAGE_COUNT] = {
+    [STARTUP_STAGE_BLUETOOTH] = startup_bt_work,
+    [STARTUP_STAGE_WIFI] = startup_wifi_work,
+    [STARTUP_STAGE_SD] = startup_sd_work,
+};
+
+#if defined(CONFIG_SETTINGS)
+static int startup_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+                                void *cb_arg)
+{
+    const char *next;
+
+    if (!settings_name_steq(name, "wifi", &next) || next) {
+        return -ENOENT;
+    }
+
+    /* A record from an older layout is dropped, the next association rewrites it */
+    if (len != sizeof(startup.wifi_cache)) {
+        return 0;
+    }
+
+    ssize_t ret = read_cb(cb_arg, &startup.wifi_cache, sizeof(startup.wifi_cache));
+    if (ret < 0) {
+        memset(&startup.wifi_cache, 0, sizeof(startup.wifi_cache));
+        return (int)ret;
+    }
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(startup, "startup", NULL, startup_settings_set, NULL, NULL);
+#endif
+
+/**
+ * @brief Record that a stage was kicked off
+ */
+static void startup_stage_started(startup_stage_t stage, uint32_t timeout_ms)
+{
+    struct startup_stage_state *st = &startup.stages[stage];
+
+    /* Retries keep the first start time */
+    if (st->start_ms != 0) {
+        return;
+    }
+
+    st->start_ms = k_uptime_get();
+    if (timeout_ms) {
+        k_work_schedule_for_queue(&startup.workq, &st->timeout, K_MSEC(timeout_ms));
+    }
+}
+
+/**
+ * @brief Finish a stage; the first result wins, late ones are ignored
+ */
+static void startup_complete(startup_stage_t stage, int result)
+{
+    struct startup_stage_state *st = &startup.stages[stage];
+    int64_t now = k_uptime_get();
+
+    if (!atomic_cas(&st->result, STARTUP_PENDING, result)) {
+        return;
+    }
+
+    st->done_ms = now;
+    if (st->start_ms == 0) {
+        st->start_ms = now;
+    }
+    k_work_cancel_delayable(&st->timeout);
+
+    if (result == 0) {
+        LOG_INF("✅ %s up at %lld ms (%lld ms)", startup_stage_names[stage], now,
+                now - st->start_ms);
+    } else if (result == -ENOTSUP) {
+        LOG_INF("%s not configured, skipped", startup_stage_names[stage]);
+    } else {
+        LOG_WRN("%s bring-up failed at %lld ms: %d", startup_stage_names[stage], now, result);
+    }
+
+    k_event_post(&startup.done, STARTUP_STAGE_BIT(stage));
+
+    if (atomic_dec(&startup.remaining) == 1) {
+        startup_report();
+    }
+}
+
+static void startup_timeout_work(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct startup_stage_state *st = CONTAINER_OF(dwork, struct startup_stage_state, timeout);
+
+    startup_complete((startup_stage_t)(st - startup.stages), -ETIMEDOUT);
+}
+
+static void startup_bt_ready(int err)
+{
+    startup_complete(STARTUP_STAGE_BLUETOOTH, err);
+}
+
+/**
+ * @brief Bluetooth stage - audio system init, finished by the ready callback
+ */
+static void startup_bt_work(struct k_work *work)
+{
+    const audio_config_t *audio = startup.config->audio;
+    int ret;
+
+    startup_stage_started(STARTUP_STAGE_BLUETOOTH, STARTUP_BT_TIMEOUT_MS);
+
+    bluetooth_audio_set_ready_callback(startup_bt_ready);
+    ret = audio_system_init(audio);
+    if (ret < 0) {
+        startup_complete(STARTUP_STAGE_BLUETOOTH, ret);
+        return;
+    }
+
+    /* Other outputs have nothing to wait for */
+    if (audio->output_type != AUDIO_OUTPUT_BLUETOOTH || bluetooth_audio_is_ready()) {
+        startup_complete(STARTUP_STAGE_BLUETOOTH, 0);
+    }
+}
+
+/**
+ * @brief Log the association and remember its channel for the next boot
+ */
+static void startup_wifi_associated(void)
+{
+    struct wifi_iface_status status = {0};
+
+    if (net_mgmt(NET_REQUEST_WIFI_IFACE_STATUS, startup.iface, &status, sizeof(status))) {
+        return;
+    }
+
+    LOG_INF("📶 WiFi associated with %.*s on channel %d, RSSI %d dBm",
+            status.ssid_len, status.ssid, status.channel, status.rssi);
+
+#if defined(CONFIG_SETTINGS)
+    struct startup_wifi_cache *cache = &startup.wifi_cache;
+
+    if (status.channel <= 0 || status.channel >= WIFI_CHANNEL_ANY ||
+        status.ssid_len > sizeof(cache->ssid)) {
+        return;
+    }
+    if (cache->channel == status.channel && cache->ssid_len == status.ssid_len &&
+        memcmp(cache->ssid, status.ssid, status.ssid_len) == 0) {
+        return;
+    }
+
+    memset(cache, 0, sizeof(*cache));
+    cache->ssid_len = status.ssid_len;
+    memcpy(cache->ssid, status.ssid, status.ssid_len);
+    cache->channel = (uint8_t)status.channel;
+
+    int ret = settings_save_one("startup/wifi", cache, sizeof(*cache));
+    if (ret) {
+        LOG_WRN("Failed to store the WiFi channel: %d", ret);
+    }
+#endif
+}
+
+/**
+ * @brief WiFi stage - connect request, finished by net_mgmt events
+ */
+static void startup_wifi_work(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    const struct startup_config *config = startup.config;
+    int ret;
+
+    startup_stage_started(STARTUP_STAGE_WIFI, STARTUP_WIFI_TIMEOUT_MS);
+    if (startup_stage_result(STARTUP_STAGE_WIFI) != STARTUP_PENDING) {
+        return;
+    }
+
+    if (!startup.iface) {
+        startup.iface = net_if_get_default();
+        if (!startup.iface) {
+            LOG_ERR("No default network interface found");
+            startup_complete(STARTUP_STAGE_WIFI, -ENODEV);
+            return;
+        }
+        if (!net_if_is_up(startup.iface)) {
+            net_if_up(startup.iface);
+        }
+    }
+
+    struct wifi_connect_req_params params = {
+        .ssid = (const uint8_t *)config->ssid,
+        .ssid_length = strlen(config->ssid),
+        .psk = (const uint8_t *)config->psk,
+        .psk_length = config->psk ? strlen(config->psk) : 0,
+        .channel = startup.wifi_channel,
+        .security = WIFI_SECURITY_TYPE_PSK,
+        .band = WIFI_FREQ_BAND_2_4_GHZ,
+        .mfp = WIFI_MFP_OPTIONAL
+    };
+
+    if (startup.wifi_channel == WIFI_CHANNEL_ANY) {
+        LOG_INF("📶 Connecting to WiFi network %s", config->ssid);
+    } else {
+        LOG_INF("📶 Connecting to WiFi network %s on channel %u", config->ssid,
+                startup.wifi_channel);
+    }
+
+    ret = net_mgmt(NET_REQUEST_WIFI_CONNECT, startup.iface, &params, sizeof(params));
+    if (ret && ret != -EALREADY) {
+        /* Bounded by the stage timeout */
+        LOG_WRN("WiFi connection request failed: %d, retrying", ret);
+        k_work_reschedule_for_queue(&startup.workq, dwork, K_MSEC(STARTUP_WIFI_RETRY_MS));
+    }
+}
+
+/**
+ * @brief net_mgmt thread - hand the event to the startup queue
+ */
+static void startup_net_event(struct net_mgmt_event_callback *cb, uint32_t mgmt_event,
+                              struct net_if *iface)
+{
+    if (mgmt_event == NET_EVENT_WIFI_CONNECT_RESULT) {
+        const struct wifi_status *status = cb->info;
+
+        atomic_set(&startup.wifi_status, status ? status->status : 0);
+    } else if (mgmt_event == NET_EVENT_IPV4_ADDR_ADD) {
+        atomic_set(&startup.wifi_addr, 1);
+    } else {
+        return;
+    }
+
+    k_work_submit_to_queue(&startup.workq, &startup.wifi_event_work);
+}
+
+static void startup_wifi_event_work(struct k_work *work)
+{
+    struct startup_stage_state *st = &startup.stages[STARTUP_STAGE_WIFI];
+    atomic_val_t status = atomic_set(&startup.wifi_status, STARTUP_PENDING);
+
+    if (startup_stage_result(STARTUP_STAGE_WIFI) != STARTUP_PENDING) {
+        return;
+    }
+
+    if (status != STARTUP_PENDING && status != 0) {
+        if (startup.wifi_channel != WIFI_CHANNEL_ANY) {
+            /* The access point may have moved, fall back to a full scan */
+            LOG_WRN("Association on channel %u failed: %ld, scanning all channels",
+                    startup.wifi_channel, (long)status);
+            startup.wifi_channel = WIFI_CHANNEL_ANY;
+            k_work_reschedule_for_queue(&startup.workq, &st->work, K_NO_WAIT);
+        } else {
+            LOG_ERR("WiFi connection failed: %ld", (long)status);
+            startup_complete(STARTUP_STAGE_WIFI, -ECONNREFUSED);
+        }
+        return;
+    }
+
+    if (status == 0 && !startup.wifi_associated) {
+        startup.wifi_associated = true;
+        startup_wifi_associated();
+    }
+    if (!startup.wifi_associated) {
+        return;
+    }
+
+    /* Offloaded drivers may set the address before the connect result */
+    struct in_addr *addr = net_if_ipv4_get_global_addr(startup.iface, NET_ADDR_PREFERRED);
+    if (!atomic_get(&startup.wifi_addr) && !addr) {
+        return;
+    }
+
+    if (addr) {
+        char buf[NET_IPV4_ADDR_LEN];
+
+        net_addr_ntop(AF_INET, addr, buf, sizeof(buf));
+        LOG_INF("🌐 IPv4 address %s", buf);
+    }
+    startup_complete(STARTUP_STAGE_WIFI, 0);
+}
+
+/**
+ * @brief SD stage - mount the card and bring the track index up to date,
+ *        blocking on the SD queue
+ */
+static void startup_sd_work(struct k_work *work)
+{
+    startup_stage_started(STARTUP_STAGE_SD, 0);
+
+#if defined(CONFIG_FAT_FILESYSTEM_ELM)
+    fs_result_t res = media_fs_init();
+
+    if (res == FS_OK) {
+        bool changed = false;
+
+        /* The saved index spares the refresh from reparsing unchanged
+         * files; without one it is rebuilt from the directory */
+        fs_result_t idx = media_index_load();
+        if (idx != FS_OK) {
+            LOG_INF("No usable track index (%s), rebuilding",
+                    media_fs_error_to_string(idx));
+        }
+        idx = media_index_refresh(&changed);
+        if (idx == FS_OK) {
+            LOG_INF("📇 %zu tracks indexed%s", media_index_count(),
+                    changed ? ", index updated" : "");
+        } else {
+            /* The card is still usable, just without listings */
+            LOG_WRN("Track index refresh failed: %s", media_fs_error_to_string(idx));
+        }
+        startup_complete(STARTUP_STAGE_SD, 0);
+    } else {
+        startup_complete(STARTUP_STAGE_SD,
+                         res == FS_ERROR_CARD_NOT_PRESENT ? -ENODEV : -EIO);
+    }
+#else
+    startup_complete(STARTUP_STAGE_SD, -ENOTSUP);
+#endif
+}
+
+int startup_begin(const struct startup_config *config)
+{
+    if (!config || !config->audio) {
+        return -EINVAL;
+    }
+    if (startup.started) {
+        return -EALREADY;
+    }
+
+    startup.started = true;
+    startup.config = config;
+    k_event_init(&startup.done);
+    atomic_set(&startup.remaining, STARTUP_STAGE_COUNT);
+
+    for (int i = 0; i < STARTUP_STAGE_COUNT; i++) {
+        struct startup_stage_state *st = &startup.stages[i];
+
+        atomic_set(&st->result, STARTUP_PENDING);
+        k_work_init_delayable(&st->work, startup_stage_handlers[i]);
+        k_work_init_delayable(&st->timeout, startup_timeout_work);
+    }
+
+    const struct k_work_queue_config cfg = {
+        .name = "startup",
+    };
+
+    k_work_queue_start(&startup.workq, startup_stack, K_THREAD_STACK_SIZEOF(startup_stack),
+                       APP_THREAD_PRIO_STARTUP, &cfg);
+
+    const struct k_work_queue_config sd_cfg = {
+        .name = "startup_sd",
+    };
+
+    k_work_queue_start(&startup.sd_workq, startup_sd_stack,
+                       K_THREAD_STACK_SIZEOF(startup_sd_stack), APP_THREAD_PRIO_STARTUP_SD,
+                       &sd_cfg);
+
+    startup.wifi_channel = WIFI_CHANNEL_ANY;
+    atomic_set(&startup.wifi_status, STARTUP_PENDING);
+    k_work_init(&startup.wifi_event_work, startup_wifi_event_work);
+
+#if defined(CONFIG_SETTINGS)
+    int ret = settings_subsys_init();
+    if (ret == 0) {
+        settings_load_subtree("startup");
+    } else {
+        LOG_WRN("Settings unavailable, nothing cached: %d", ret);
+    }
+
+    /* Skip the scan when rejoining the network of the last boot */
+    const struct startup_wifi_cache *cache = &startup.wifi_cache;
+    if (config->ssid && cache->channel != 0 && cache->ssid_len == strlen(config->ssid) &&
+        memcmp(cache->ssid, config->ssid, cache->ssid_len) == 0) {
+        startup.wifi_channel = cache->channel;
+    }
+#endif
+
+    LOG_INF("🚀 Bringing up Bluetooth, WiFi and SD card in parallel");
+
+    /* Bluetooth first, its HCI init then overlaps everything else */
+    k_work_schedule_for_queue(&startup.workq, &startup.stages[STARTUP_STAGE_BLUETOOTH].work,
+                              K_NO_WAIT);
+
+    if (config->ssid) {
+        net_mgmt_init_event_callback(&startup.wifi_cb, startup_net_event,
+                                     NET_EVENT_WIFI_CONNECT_RESULT);
+        net_mgmt_add_event_callback(&startup.wifi_cb);
+        net_mgmt_init_event_callback(&startup.ipv4_cb, startup_net_event,
+                                     NET_EVENT_IPV4_ADDR_ADD);
+        net_mgmt_add_event_callback(&startup.ipv4_cb);
+        k_work_schedule_for_queue(&startup.workq, &startup.stages[STARTUP_STAGE_WIFI].work,
+                                  K_NO_WAIT);
+    } else {
+        startup_complete(STARTUP_STAGE_WIFI, -ENOTSUP);
+    }
+
+    k_work_schedule_for_queue(&startup.sd_workq, &startup.stages[STARTUP_STAGE_SD].work,
+                              K_NO_WAIT);
+    return 0;
+}
+
+int startup_wait(uint32_t stages, k_timeout_t timeout)
+{
+    if (!startup.started) {
+        return -EINVAL;
+    }
+
+    stages &= STARTUP_STAGES_ALL;
+    if (stages == 0) {
+        return 0;
+    }
+
+    uint32_t done = k_event_wait_all(&startup.done, stages, false, timeout);
+    if ((done & stages) != stages) {
+        return -EAGAIN;
+    }
+
+    for (int i = 0; i < STARTUP_STAGE_COUNT; i++) {
+        int result = startup_stage_result((startup_stage_t)i);
+
+        if ((stages & STARTUP_STAGE_BIT(i)) && result < 0) {
+            return result;
+        }
+    }
+    return 0;
+}
+
+int startup_stage_result(startup_stage_t stage)
+{
+    if ((unsigned int)stage >= STARTUP_STAGE_COUNT || !startup.started) {
+        return -EINVAL;
+    }
+    return (int)atomic_get(&startup.stages[stage].result);
+}
+
+void startup_report(void)
+{
+    LOG_INF("⏱ Startup stages, ms since boot:");
+
+    for (int i = 0; i < STARTUP_STAGE_COUNT; i++) {
+        const struct startup_stage_state *st = &startup.stages[i];
+        int result = (int)atomic_get(&st->result);
+
+        if (result == STARTUP_PENDING) {
+            LOG_INF("   %-9s %6lld ->   running", startup_stage_names[i], st->start_ms);
+        } else {
+            LOG_INF("   %-9s %6lld -> %6lld  (%lld ms, %d)", startup_stage_names[i],
+                    st->start_ms, st->done_ms, st->done_ms - st->start_ms, result);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/**
+ * @file startup.h
+ * @brief Parallel bring-up of WiFi, Bluetooth and the SD card
+ *
+ * Boot used to pay for every subsystem in turn: WiFi association and
+ * DHCP, then the Bluetooth controller, each behind fixed sleeps. The
+ * startup orchestrator kicks all stages off at once from its own work
+ * queues and lets each one finish on its own completion event:
+ *
+ * | Stage     | Runs on                         | Done when                          |
+ * |-----------|---------------------------------|------------------------------------|
+ * | bluetooth | HCI init on the system queue    | bt_enable() ready, advertising     |
+ * | wifi      | The WiFi driver                 | Associated and an IPv4 address set |
+ * | sd        | Its own SD queue (blocking)     | The card is mounted and the track  |
+ * |           |                                 | index loaded or refreshed          |
+ *
+ * Callers wait only for the stages they depend on with startup_wait(),
+ * so Bluetooth playback can start while WiFi is still associating. Every
+ * stage records when it started and finished in ms since boot, and a
+ * summary is logged once the last stage is done.
+ *
+ * With CONFIG_SETTINGS the channel of the last association is kept in
+ * flash and tried first, which skips the scan on a reconnect to the same
+ * network; the Bluetooth host keeps its bonds there (CONFIG_BT_SETTINGS).
+ */
+
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <stdint.h>
+#include "../audio/audiosys.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Bring-up stages, in the order they are started
+ */
+typedef enum {
+    STARTUP_STAGE_BLUETOOTH,
+    STARTUP_STAGE_WIFI,
+    STARTUP_STAGE_SD,
+    STARTUP_STAGE_COUNT
+} startup_stage_t;
+
+#define STARTUP_STAGE_BIT(stage) BIT(stage)
+#define STARTUP_STAGES_ALL       BIT_MASK(STARTUP_STAGE_COUNT)
+
+/**
+ * @brief What to bring up
+ */
+struct startup_config {
+    const audio_config_t *audio;  ///< Output configuration for audio_system_init()
+    const char *ssid;             ///< WiFi network, NULL to skip the WiFi stage
+    const char *psk;              ///< WPA2 passphrase
+};
+
+/**
+ * @brief Start every stage in the background
+ *
+ * Returns as soon as the stages are queued. @p config and the strings
+ * and audio configuration it points to must stay valid until all stages
+ * are done.
+ *
+ * @param config Stage configuration
+ * @return 0 on success, -EALREADY if already started, -EINVAL on a bad config
+ */
+int startup_begin(const struct startup_config *config);
+
+/**
+ * @brief Wait for a set of stages to finish
+ *
+ * @param stages STARTUP_STAGE_BIT() mask of stages to wait for
+ * @param timeout Maximum time to wait
+ * @return 0 if all of them came up, the error of the first failed stage,
+ *         or -EAGAIN if one was still running at the timeout
+ */
+int startup_wait(uint32_t stages, k_timeout_t timeout);
+
+/**
+ * @brief Result of one stage
+ *
+ * @param stage Stage to look at
+ * @return 0 once up, -EINPROGRESS while running, negative error on failure
+ *         (-ENOTSUP when the stage isn't configured in this build)
+ */
+int startup_stage_result(startup_stage_t stage);
+
+/**
+ * @brief Log start and finish times of every stage
+ */
+void startup_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STARTUP_H */
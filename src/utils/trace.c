@@ -0,0 +1,177 @@
+/**
+ * @file trace.c
+ * @brief Deferred binary event trace for the audio hot path
+ *
+ * Rings are single-producer, single-consumer: the producer only advances
+ * head, the consumer only advances tail, and a record is complete before
+ * head moves past it. See trace.h.
+ */
+
+#include "trace.h"
+#include "app_threads.h"
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#include <stdio.h>
+
+LOG_MODULE_REGISTER(trace, LOG_LEVEL_DBG);
+
+#define TRACE_RING_MASK          (CONFIG_APP_TRACE_RING_DEPTH - 1)
+#define TRACE_FLUSH_STACK_SIZE   APP_THREAD_STACK_BACKGROUND
+#define TRACE_FLUSH_PRIORITY     APP_THREAD_PRIO_BACKGROUND
+#define TRACE_LINE_SIZE          96
+
+#define TRACE_EVENT_FORMAT(id, fmt) [id] = fmt,
+
+static const char *const event_formats[TRACE_EVENT_COUNT] = {
+    TRACE_EVENT_LIST(TRACE_EVENT_FORMAT)
+};
+
+#undef TRACE_EVENT_FORMAT
+
+/* Threads without a ring of their own share this one under the lock */
+TRACE_RING_DEFINE(shared);
+
+static struct {
+    struct trace_ring *rings;    ///< Attached rings, newest first
+    struct k_spinlock lock;      ///< Guards the list and the shared ring's producers
+    bool started;
+} trace = {
+    .rings = &shared,
+};
+
+#if CONFIG_APP_TRACE_FLUSH_INTERVAL_MS > 0
+K_THREAD_STACK_DEFINE(trace_flush_stack, TRACE_FLUSH_STACK_SIZE);
+static struct k_thread trace_flush_thread_data;
+#endif
+
+static void ring_put(struct trace_ring *ring, uint16_t event, uint32_t arg0, uint32_t arg1)
+{
+    uint32_t head = (uint32_t)atomic_get(&ring->head);
+    struct trace_record *record;
+
+    if (head - (uint32_t)atomic_get(&ring->tail) >= CONFIG_APP_TRACE_RING_DEPTH) {
+        ring->lost++;
+        return;
+    }
+
+    record = &ring->records[head & TRACE_RING_MASK];
+    record->cycles = k_cycle_get_32();
+    record->arg0 = arg0;
+    record->arg1 = arg1;
+    record->event = event;
+    record->lost = (uint16_t)MIN(ring->lost, UINT16_MAX);
+    ring->lost = 0;
+
+    /* Publish the record only once it is complete */
+    atomic_set(&ring->head, (atomic_val_t)(head + 1));
+}
+
+void trace_event(enum trace_event_id event, uint32_t arg0, uint32_t arg1)
+{
+    struct trace_ring *ring = k_is_in_isr() ? NULL : k_thread_custom_data_get();
+    k_spinlock_key_t key;
+
+    if (ring) {
+        ring_put(ring, event, arg0, arg1);
+        return;
+    }
+
+    key = k_spin_lock(&trace.lock);
+    ring_put(&shared, event, arg0, arg1);
+    k_spin_unlock(&trace.lock, key);
+}
+
+void trace_thread_attach(struct trace_ring *ring)
+{
+    k_spinlock_key_t key = k_spin_lock(&trace.lock);
+    struct trace_ring *it = trace.rings;
+
+    while (it && it != ring) {
+        it = it->next;
+    }
+    if (!it) {
+        ring->next = trace.rings;
+        trace.rings = ring;
+    }
+    k_spin_unlock(&trace.lock, key);
+
+    k_thread_custom_data_set(ring);
+}
+
+int trace_drain(trace_sink_t sink, void *user_data)
+{
+    int drained = 0;
+
+    for (struct trace_ring *ring = trace.rings; ring; ring = ring->next) {
+        uint32_t tail = (uint32_t)atomic_get(&ring->tail);
+        uint32_t head = (uint32_t)atomic_get(&ring->head);
+
+        while (tail != head) {
+            /* Copy out first - the slot is the producer's again once tail moves */
+            struct trace_record record = ring->records[tail & TRACE_RING_MASK];
+
+            atomic_set(&ring->tail, (atomic_val_t)++tail);
+            sink(ring->name, &record, user_data);
+            drained++;
+        }
+    }
+    return drained;
+}
+
+const char *trace_event_format(uint16_t event)
+{
+    return event < TRACE_EVENT_COUNT ? event_formats[event] : NULL;
+}
+
+#if CONFIG_APP_TRACE_FLUSH_INTERVAL_MS > 0
+/**
+ * @brief Format one record into the log
+ */
+static void trace_log_sink(const char *ring_name, const struct trace_record *record,
+                           void *user_data)
+{
+    const char *fmt = trace_event_format(record->event);
+    char line[TRACE_LINE_SIZE];
+
+    if (record->lost) {
+        LOG_WRN("[%s] %u trace records lost", ring_name, record->lost);
+    }
+    if (!fmt) {
+        LOG_WRN("[%s] unknown trace event %u", ring_name, record->event);
+        return;
+    }
+
+    snprintf(line, sizeof(line), fmt, record->arg0, record->arg1);
+    LOG_DBG("[%s] @%u us: %s", ring_name, k_cyc_to_us_floor32(record->cycles), line);
+}
+
+/**
+ * @brief Flush thread - drains the rings into the log at the lowest priority
+ */
+static void trace_flush_thread(void *p1, void *p2, void *p3)
+{
+    while (1) {
+        k_msleep(CONFIG_APP_TRACE_FLUSH_INTERVAL_MS);
+        trace_drain(trace_log_sink, NULL);
+    }
+}
+#endif
+
+void trace_init(void)
+{
+    if (trace.started) {
+        return;
+    }
+    trace.started = true;
+
+#if CONFIG_APP_TRACE_FLUSH_INTERVAL_MS > 0
+    k_thread_create(&trace_flush_thread_data, trace_flush_stack,
+                    K_THREAD_STACK_SIZEOF(trace_flush_stack),
+                    trace_flush_thread, NULL, NULL, NULL,
+                    TRACE_FLUSH_PRIORITY, 0, K_NO_WAIT);
+    k_thread_name_set(&trace_flush_thread_data, "trace_flush");
+#endif
+    LOG_INF("Hot-path trace ready: %d records per ring", CONFIG_APP_TRACE_RING_DEPTH);
+}
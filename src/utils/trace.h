@@ -0,0 +1,171 @@
+/**
+ * @file trace.h
+ * @brief Deferred binary event trace for the audio hot path
+ *
+ * The streaming threads record what they do as fixed-size binary records -
+ * an event ID, two 32-bit arguments and a cycle stamp - instead of calling
+ * LOG_*. Nothing is formatted on the hot path: a record is a handful of
+ * stores into a ring the thread owns, with no lock and no wait. When the
+ * ring is full the record is dropped and the gap reported with the next
+ * one that fits.
+ *
+ * A low-priority flush thread drains the rings and turns the records into
+ * log lines using the format strings in TRACE_EVENT_LIST, so the UART and
+ * the formatting cost move off the streaming threads. trace_drain() hands
+ * out the raw records for any other consumer.
+ *
+ * Each streaming thread attaches its own ring when it starts
+ * (TRACE_RING_DEFINE, trace_thread_attach()), which keeps every ring
+ * single-producer. Events from threads without a ring go to a shared ring
+ * under a spinlock.
+ *
+ * With CONFIG_APP_TRACE disabled every call compiles away.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <zephyr/kernel.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Trace events and the format their two arguments are printed with
+ */
+#define TRACE_EVENT_LIST(X)                                                              \
+    X(TRACE_BT_QUEUED,           "queued pool buffer #%u (%u bytes)")                    \
+    X(TRACE_BT_CONCEAL,          "pool queue ran dry, fading out over %u bytes")         \
+    X(TRACE_BT_WAIT_SUBSCRIBE,   "waiting for GATT client to subscribe")                 \
+    X(TRACE_BT_SENT,             "streamed %u bytes via GATT in %u us")                  \
+    X(TRACE_BT_NOT_SUBSCRIBED,   "client not subscribed, waiting")                       \
+    X(TRACE_BT_RATE_LIMITED,     "rate limited, waiting")                                \
+    X(TRACE_BT_BACKOFF,          "BLE buffer full, backing off (attempt %u)")            \
+    X(TRACE_BT_FLUSHED,          "audio queue flushed")                                  \
+    X(TRACE_GATT_NOT_READY,      "connection not ready (state %u)")                      \
+    X(TRACE_GATT_NOT_SUBSCRIBED, "client not subscribed to audio data notifications")    \
+    X(TRACE_GATT_TRUNCATED,      "truncated audio data to %u bytes (chunk limit)")       \
+    X(TRACE_GATT_NOTIFY_FAILED,  "failed to queue audio data notification: %d")          \
+    X(TRACE_GATT_QUEUED,         "queued %u bytes of audio data")                        \
+    X(TRACE_GATT_SENT,           "sent %u bytes of audio data")                          \
+    X(TRACE_RX_SUBMIT,           "submitted stream buffer #%u (%u bytes)")               \
+    X(TRACE_JB_PREFILLED,        "prefill reached %u ms (target %u ms)")                 \
+    X(TRACE_POOL_ALLOC,          "buffer %u allocated")                                  \
+    X(TRACE_POOL_ALLOC_FAILED,   "buffer allocation failed: %d")                         \
+    X(TRACE_POOL_FREE,           "buffer %u freed")
+
+#define TRACE_EVENT_ENUM(id, fmt) id,
+
+enum trace_event_id {
+    TRACE_EVENT_LIST(TRACE_EVENT_ENUM)
+    TRACE_EVENT_COUNT
+};
+
+#undef TRACE_EVENT_ENUM
+
+/**
+ * @brief One recorded event, 16 bytes
+ */
+struct trace_record {
+    uint32_t cycles;             ///< k_cycle_get_32() when recorded
+    uint32_t arg0;
+    uint32_t arg1;
+    uint16_t event;              ///< enum trace_event_id
+    uint16_t lost;               ///< Records dropped on this ring just before this one
+};
+
+#if defined(CONFIG_APP_TRACE)
+
+BUILD_ASSERT((CONFIG_APP_TRACE_RING_DEPTH & (CONFIG_APP_TRACE_RING_DEPTH - 1)) == 0,
+             "CONFIG_APP_TRACE_RING_DEPTH must be a power of two");
+
+/**
+ * @brief Ring of records written by one thread and read by the flusher
+ */
+struct trace_ring {
+    const char *name;
+    atomic_t head;               ///< Next slot to write, advanced by the producer
+    atomic_t tail;               ///< Next slot to read, advanced by the consumer
+    uint32_t lost;               ///< Drops not yet reported, producer only
+    struct trace_ring *next;     ///< Attached rings, see trace_thread_attach()
+    struct trace_record records[CONFIG_APP_TRACE_RING_DEPTH];
+};
+
+/**
+ * @brief Statically define a trace ring for one thread
+ */
+#define TRACE_RING_DEFINE(_name) static struct trace_ring _name = { .name = #_name }
+
+/**
+ * @brief Start the flush thread
+ *
+ * Events recorded before this are kept and flushed once it runs.
+ */
+void trace_init(void);
+
+/**
+ * @brief Make @p ring the calling thread's trace ring
+ *
+ * Call at the top of the thread entry. A ring must only ever belong to
+ * one running thread at a time; a thread that is recreated (a new
+ * connection, a new stream) attaches the same ring again.
+ *
+ * @param ring Ring from TRACE_RING_DEFINE
+ */
+void trace_thread_attach(struct trace_ring *ring);
+
+/**
+ * @brief Record an event on the calling thread's ring
+ *
+ * Never blocks and never formats. Safe from any thread; ISRs and threads
+ * without a ring use the shared one.
+ *
+ * @param event Event ID
+ * @param arg0 First argument of the event's format
+ * @param arg1 Second argument of the event's format
+ */
+void trace_event(enum trace_event_id event, uint32_t arg0, uint32_t arg1);
+
+/**
+ * @brief Consumer for trace_drain()
+ *
+ * @param ring_name Name the ring was defined with
+ * @param record The record; only valid during the call
+ * @param user_data As passed to trace_drain()
+ */
+typedef void (*trace_sink_t)(const char *ring_name, const struct trace_record *record,
+                             void *user_data);
+
+/**
+ * @brief Hand every pending record to @p sink, oldest first per ring
+ *
+ * Only one consumer may drain at a time. With the flush thread running
+ * (CONFIG_APP_TRACE_FLUSH_INTERVAL_MS > 0) that is the flush thread.
+ *
+ * @return Number of records drained
+ */
+int trace_drain(trace_sink_t sink, void *user_data);
+
+/**
+ * @brief printf format of an event's arguments, NULL for an unknown ID
+ */
+const char *trace_event_format(uint16_t event);
+
+#else
+
+#define TRACE_RING_DEFINE(_name)
+#define trace_thread_attach(ring) do { } while (0)
+
+static inline void trace_init(void) {}
+static inline void trace_event(enum trace_event_id event, uint32_t arg0, uint32_t arg1) {}
+
+#endif /* CONFIG_APP_TRACE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRACE_H */
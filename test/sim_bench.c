@@ -0,0 +1,781 @@
+/**
+ * @file sim_bench.c
+ * @brief Host benchmark of the streaming pipeline, decoder to GATT sink
+ *
+ * Replays WAV files from test_data/ through the same modules the board
+ * runs: the push-mode WAV decoder, the audio buffer pool, 16-bit
+ * conversion, resampling and channel mapping to the sink format, and the
+ * SPSC ring that the Bluetooth streaming thread drains one notification
+ * at a time. The Bluetooth side is a mock GATT sink thread that checksums
+ * what it "notifies", optionally paced to a link rate.
+ *
+ * For each file it reports throughput, the p50/p99 time a notification's
+ * audio spent between leaving the pool buffer and being notified, and the
+ * pool allocation counts, and can compare them to a baseline file.
+ * Allocation counts are deterministic and always have to match. Timings
+ * depend on the host, so they are only checked with --check-timing,
+ * against a baseline written on the same machine.
+ *
+ * This file is part of the simulation build (build_sim.sh); the kernel
+ * primitives come from the POSIX shims in src/sim/.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <time.h>
+#include <pthread.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include "audio/audio_buffers.h"
+#include "audio/pcm_dsp.h"
+#include "audio/resampler.h"
+#include "audio/wav_decoder.h"
+#include "utils/circular_buffers.h"
+#include "utils/mem_plan.h"
+
+#define SIM_LOG_INF(fmt, ...) printf("[SIM_INF] bench: " fmt "\n", ##__VA_ARGS__)
+#define SIM_LOG_ERR(fmt, ...) printf("[SIM_ERR] bench: " fmt "\n", ##__VA_ARGS__)
+#define SIM_LOG_WRN(fmt, ...) printf("[SIM_WRN] bench: " fmt "\n", ##__VA_ARGS__)
+
+/* Benchmark parameters - the ring and notification sizes are the board's */
+#define BENCH_DATA_DIR          "./test_data"
+#define BENCH_SEGMENT_SIZE      1460    /* TCP segment the receive thread gets */
+#define BENCH_NOTIFY_SIZE       MEM_PLAN_NOTIFY_PAYLOAD
+#define BENCH_RING_SIZE         MEM_PLAN_BT_RING_SIZE
+#define BENCH_SINK_CHANNELS     MEM_PLAN_CHANNELS
+#define BENCH_SINK_POLL_MS      10
+#define BENCH_RESAMPLER_QUALITY RESAMPLER_QUALITY_BALANCED
+#define BENCH_DEFAULT_RUNS      5
+#define BENCH_DEFAULT_TOLERANCE 30      /* percent */
+#define BENCH_MAX_FILES         32
+#define BENCH_NAME_LEN          64
+
+/* FNV-1a, to check the sink got exactly what the producer queued */
+#define BENCH_HASH_SEED         0xcbf29ce484222325ULL
+#define BENCH_HASH_PRIME        0x100000001b3ULL
+
+/**
+ * @brief Where a pool buffer ended up in the ring, and when it was ready
+ */
+struct bench_mark {
+    size_t ring_end;           ///< Ring bytes written once this buffer is in
+    uint64_t ready_ns;         ///< Time the buffer was handed to the ring
+};
+
+/**
+ * @brief Result of one file
+ */
+struct bench_result {
+    char name[BENCH_NAME_LEN];
+    size_t sink_bytes;         ///< PCM bytes notified
+    uint32_t chunks;           ///< Notifications
+    double mb_per_s;
+    double p50_us;
+    double p99_us;
+    uint32_t pool_allocs;
+    uint32_t pool_failures;
+    uint32_t pool_leaked;      ///< Still allocated after the run
+};
+
+/**
+ * @brief Baseline entry
+ */
+struct bench_baseline {
+    char name[BENCH_NAME_LEN];
+    double mb_per_s;
+    double p50_us;
+    double p99_us;
+    uint32_t pool_allocs;
+};
+
+/* Run state - the producer is the main thread, the sink its own thread */
+static struct {
+    spsc_buffer_t ring;
+    uint8_t ring_data[BENCH_RING_SIZE];
+
+    /* Producer */
+    struct wav_stream_decoder decoder;
+    struct resampler resampler;
+    struct pcm_dither dither;
+    struct audio_format_info format;
+    struct audio_buffer *buf;      ///< Pool buffer being filled
+    size_t fill_limit;             ///< Input bytes per pool buffer
+    size_t ring_written;
+    uint64_t produced_hash;
+    atomic_t producer_done;
+
+    /* Marks are published (mark_count) before their bytes reach the ring */
+    struct bench_mark *marks;
+    size_t mark_capacity;
+    atomic_t mark_count;
+
+    /* Sink */
+    uint32_t link_kbps;            ///< 0 = notify as fast as possible
+    uint64_t *latencies_ns;
+    size_t latency_count;
+    size_t latency_capacity;
+    size_t sink_bytes;
+    uint64_t sink_hash;
+    int sink_error;
+} bench;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t bench_hash(uint64_t hash, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * BENCH_HASH_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Mock GATT sink - the Bluetooth streaming thread's ring loop
+ *
+ * Peeks at most one notification payload, "sends" it and consumes it,
+ * recording how long ago the pool buffer holding its last byte was queued.
+ */
+static void *bench_sink_thread(void *arg)
+{
+    size_t mark = 0;
+    uint64_t next_send_ns = 0;
+
+    (void)arg;
+
+    while (1) {
+        const uint8_t *chunk;
+        size_t len = spsc_buffer_peek(&bench.ring, &chunk, BENCH_NOTIFY_SIZE);
+        if (len == 0) {
+            /* Checked before each wait, so the end-of-stream wake-up isn't swallowed */
+            if (atomic_get(&bench.producer_done) && spsc_buffer_is_empty(&bench.ring)) {
+                break;
+            }
+            k_sem_take(&bench.ring.data_available, K_MSEC(BENCH_SINK_POLL_MS));
+            continue;
+        }
+
+        /* Air time of the notification at the configured link rate */
+        if (bench.link_kbps > 0) {
+            uint64_t now = bench_now_ns();
+            struct timespec until;
+
+            if (next_send_ns < now) {
+                next_send_ns = now;
+            }
+            next_send_ns += (uint64_t)len * 8000000ULL / bench.link_kbps;
+            until.tv_sec = (time_t)(next_send_ns / 1000000000ULL);
+            until.tv_nsec = (long)(next_send_ns % 1000000000ULL);
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL);
+        }
+
+        bench.sink_hash = bench_hash(bench.sink_hash, chunk, len);
+        bench.sink_bytes += len;
+
+        /* The chunk is complete once the buffer with its last byte was queued.
+         * After an error keep draining so the producer can finish */
+        size_t published = (size_t)atomic_get(&bench.mark_count);
+        while (mark < published && bench.marks[mark].ring_end < bench.sink_bytes) {
+            mark++;
+        }
+        if (mark == published && bench.sink_error == 0) {
+            SIM_LOG_ERR("Sink read past the queued audio at %zu bytes", bench.sink_bytes);
+            bench.sink_error = -EIO;
+        }
+
+        if (bench.latency_count == bench.latency_capacity && bench.sink_error == 0) {
+            size_t capacity = bench.latency_capacity ? 2 * bench.latency_capacity : 4096;
+            uint64_t *grown = realloc(bench.latencies_ns, capacity * sizeof(*grown));
+            if (grown) {
+                bench.latencies_ns = grown;
+                bench.latency_capacity = capacity;
+            } else {
+                bench.sink_error = -ENOMEM;
+            }
+        }
+        if (bench.sink_error == 0) {
+            bench.latencies_ns[bench.latency_count++] = bench_now_ns() - bench.marks[mark].ready_ns;
+        }
+
+        spsc_buffer_consume(&bench.ring, len);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Convert a filled pool buffer to the sink format and queue it on the ring
+ *
+ * The same steps as submit_stream_buffer() in audio_client.c: whole frames
+ * only, 16-bit samples, resampled, mapped to the sink's channel count.
+ */
+static int bench_submit_buffer(void)
+{
+    struct audio_buffer *buf = bench.buf;
+    uint16_t channels = bench.format.channels;
+    size_t frame = channels * (bench.format.bits_per_sample / 8);
+    size_t frames, capacity;
+    int converted;
+
+    bench.buf = NULL;
+    buf->used -= buf->used % frame;
+    if (buf->used == 0) {
+        audio_buffer_free(buf);
+        return 0;
+    }
+
+    converted = pcm_convert_to_s16(buf->data, buf->used, bench.format.bits_per_sample,
+                                   &bench.dither);
+    if (converted < 0) {
+        audio_buffer_free(buf);
+        return converted;
+    }
+
+    capacity = buf->size / (MAX(channels, BENCH_SINK_CHANNELS) * sizeof(int16_t));
+    frames = (size_t)converted / (channels * sizeof(int16_t));
+    frames = resampler_process(&bench.resampler, (int16_t *)buf->data, frames, capacity);
+    if (channels == 1 && BENCH_SINK_CHANNELS == 2) {
+        pcm_upmix_mono((const int16_t *)buf->data, (int16_t *)buf->data, frames);
+    } else if (channels == 2 && BENCH_SINK_CHANNELS == 1) {
+        pcm_downmix_stereo((const int16_t *)buf->data, (int16_t *)buf->data, frames);
+    }
+    buf->used = frames * BENCH_SINK_CHANNELS * sizeof(int16_t);
+
+    /* Publish the mark first - the sink may see the bytes as soon as they're in */
+    size_t count = (size_t)atomic_get(&bench.mark_count);
+    if (count == bench.mark_capacity) {
+        audio_buffer_free(buf);
+        return -ENOMEM;
+    }
+    bench.ring_written += buf->used;
+    bench.marks[count].ring_end = bench.ring_written;
+    bench.marks[count].ready_ns = bench_now_ns();
+    atomic_set(&bench.mark_count, (atomic_val_t)(count + 1));
+
+    bench.produced_hash = bench_hash(bench.produced_hash, buf->data, buf->used);
+    for (size_t off = 0; off < buf->used;) {
+        off += spsc_buffer_write_timeout(&bench.ring, &buf->data[off], buf->used - off,
+                                         K_FOREVER);
+    }
+
+    return audio_buffer_free(buf);
+}
+
+/**
+ * @brief Decoder events - fill pool buffers with PCM, like the receive thread
+ */
+static int bench_stream_cb(const struct wav_stream_event *event, void *user_data)
+{
+    (void)user_data;
+
+    if (event->type == WAV_STREAM_EVENT_FORMAT) {
+        size_t frame = event->format->channels * (event->format->bits_per_sample / 8);
+        size_t sink_frame = BENCH_SINK_CHANNELS * sizeof(int16_t);
+
+        bench.format = *event->format;
+        if (resampler_init(&bench.resampler, bench.format.sample_rate, MEM_PLAN_SAMPLE_RATE,
+                           bench.format.channels, BENCH_RESAMPLER_QUALITY) < 0) {
+            return -ENOTSUP;
+        }
+
+        /* Input that still fits the buffer after resampling and upmixing */
+        bench.fill_limit = resampler_max_input(&bench.resampler,
+                                               CONFIG_APP_AUDIO_BUFFER_SIZE / sink_frame) * frame;
+        bench.fill_limit = MIN(bench.fill_limit, (size_t)CONFIG_APP_AUDIO_BUFFER_SIZE);
+        return bench.fill_limit >= frame ? 0 : -ENOTSUP;
+    }
+
+    if (event->type == WAV_STREAM_EVENT_END) {
+        return 0;
+    }
+
+    const uint8_t *pcm = event->pcm;
+    size_t len = event->len;
+
+    while (len > 0) {
+        if (!bench.buf) {
+            bench.buf = audio_buffer_alloc(K_FOREVER);
+            if (!bench.buf) {
+                return -ENOMEM;
+            }
+        }
+
+        size_t n = audio_buffer_write(bench.buf, pcm, MIN(len, bench.fill_limit - bench.buf->used));
+        pcm += n;
+        len -= n;
+
+        if (bench.buf->used == bench.fill_limit) {
+            int ret = bench_submit_buffer();
+            if (ret < 0) {
+                return ret;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int bench_compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static double bench_percentile_us(const uint64_t *sorted, size_t count, unsigned int pct)
+{
+    if (count == 0) {
+        return 0.0;
+    }
+    return (double)sorted[(count - 1) * pct / 100] / 1000.0;
+}
+
+/**
+ * @brief Stream one file through the pipeline once
+ *
+ * @return 0 on success, -EINVAL or -ENOTSUP if the file isn't a playable
+ *         WAV, other negative codes on pipeline errors
+ */
+static int bench_run(const uint8_t *file, size_t file_len, struct bench_result *result)
+{
+    struct audio_buffer_stats stats;
+    pthread_t sink;
+    uint64_t start_ns, elapsed_ns;
+    int ret = 0;
+
+    /* Fresh pool so the counters cover this run only */
+    audio_buffer_pool_cleanup();
+    audio_buffer_pool_init();
+    spsc_buffer_init(&bench.ring, bench.ring_data, sizeof(bench.ring_data));
+    wav_stream_init(&bench.decoder);
+    pcm_dither_init(&bench.dither, 1);
+
+    /* One mark per pool buffer. Upmixing and upsampling shrink the input
+     * a buffer takes; a sixteenth of its size is a safe floor */
+    bench.mark_capacity = file_len / (CONFIG_APP_AUDIO_BUFFER_SIZE / 16) + 16;
+    bench.marks = malloc(bench.mark_capacity * sizeof(*bench.marks));
+    if (!bench.marks) {
+        return -ENOMEM;
+    }
+    atomic_set(&bench.mark_count, 0);
+    atomic_set(&bench.producer_done, 0);
+    bench.buf = NULL;
+    bench.ring_written = 0;
+    bench.produced_hash = BENCH_HASH_SEED;
+    bench.sink_hash = BENCH_HASH_SEED;
+    bench.sink_bytes = 0;
+    bench.sink_error = 0;
+    bench.latency_count = 0;
+
+    start_ns = bench_now_ns();
+    pthread_create(&sink, NULL, bench_sink_thread, NULL);
+
+    /* The receive thread sees the file one TCP segment at a time */
+    for (size_t pos = 0; pos < file_len && ret >= 0; pos += BENCH_SEGMENT_SIZE) {
+        size_t len = MIN((size_t)BENCH_SEGMENT_SIZE, file_len - pos);
+        ret = wav_stream_feed(&bench.decoder, &file[pos], len, bench_stream_cb, NULL);
+    }
+    if (ret >= 0 && bench.buf) {
+        ret = bench_submit_buffer();
+    }
+    if (bench.buf) {
+        audio_buffer_free(bench.buf);
+        bench.buf = NULL;
+    }
+    if (ret >= 0 && !bench.decoder.have_format) {
+        ret = -EINVAL;
+    }
+
+    /* Wake the sink now rather than at its next poll, which would be timed */
+    atomic_set(&bench.producer_done, 1);
+    k_sem_give(&bench.ring.data_available);
+    pthread_join(sink, NULL);
+    elapsed_ns = bench_now_ns() - start_ns;
+    free(bench.marks);
+    bench.marks = NULL;
+
+    if (ret < 0) {
+        return ret;
+    }
+    if (bench.sink_error < 0) {
+        return bench.sink_error;
+    }
+    if (bench.sink_bytes != bench.ring_written || bench.sink_hash != bench.produced_hash) {
+        SIM_LOG_ERR("Sink got %zu bytes (hash %016llx), %zu were queued (hash %016llx)",
+                    bench.sink_bytes, (unsigned long long)bench.sink_hash, bench.ring_written,
+                    (unsigned long long)bench.produced_hash);
+        return -EIO;
+    }
+
+    qsort(bench.latencies_ns, bench.latency_count, sizeof(*bench.latencies_ns),
+          bench_compare_u64);
+    audio_buffer_pool_get_stats(&stats);
+
+    result->sink_bytes = bench.sink_bytes;
+    result->chunks = (uint32_t)bench.latency_count;
+    result->mb_per_s = (double)bench.sink_bytes * 1000.0 / (double)elapsed_ns;
+    result->p50_us = bench_percentile_us(bench.latencies_ns, bench.latency_count, 50);
+    result->p99_us = bench_percentile_us(bench.latencies_ns, bench.latency_count, 99);
+    result->pool_allocs = stats.buffers_allocated;
+    result->pool_failures = stats.allocation_failures;
+    result->pool_leaked = stats.buffers_in_use;
+    return 0;
+}
+
+static uint8_t *bench_load_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t *data = NULL;
+    long size;
+
+    if (!f) {
+        return NULL;
+    }
+    if (fseek(f, 0, SEEK_END) == 0 && (size = ftell(f)) > 0 && fseek(f, 0, SEEK_SET) == 0) {
+        data = malloc((size_t)size);
+        if (data && fread(data, 1, (size_t)size, f) != (size_t)size) {
+            free(data);
+            data = NULL;
+        }
+        *len = (size_t)size;
+    }
+    fclose(f);
+    return data;
+}
+
+/**
+ * @brief Benchmark one file, keeping the best of @p runs for each measure
+ *
+ * Host scheduling noise only ever makes a run slower, so the best value
+ * is the one that is stable between invocations.
+ *
+ * @return 0 on success, 1 if the file was skipped, negative on pipeline errors
+ */
+static int bench_file(const char *name, int runs, struct bench_result *best)
+{
+    char path[256];
+    size_t len = 0;
+    uint8_t *data;
+    int ret = 0;
+
+    snprintf(path, sizeof(path), "%s/%s", BENCH_DATA_DIR, name);
+    data = bench_load_file(path, &len);
+    if (!data) {
+        SIM_LOG_ERR("Can't read %s", path);
+        return -ENOENT;
+    }
+
+    memset(best, 0, sizeof(*best));
+    for (int i = 0; i < runs; i++) {
+        struct bench_result result = { 0 };
+
+        ret = bench_run(data, len, &result);
+        if (ret < 0) {
+            break;
+        }
+        if (i == 0) {
+            *best = result;
+            continue;
+        }
+        best->mb_per_s = MAX(best->mb_per_s, result.mb_per_s);
+        best->p50_us = MIN(best->p50_us, result.p50_us);
+        best->p99_us = MIN(best->p99_us, result.p99_us);
+    }
+    snprintf(best->name, sizeof(best->name), "%s", name);
+    free(data);
+
+    if (ret == -EINVAL || ret == -ENOTSUP) {
+        SIM_LOG_WRN("%s is not a playable WAV file, skipped", name);
+        return 1;
+    }
+    return ret;
+}
+
+static int bench_compare_names(const void *a, const void *b)
+{
+    return strcmp((const char *)a, (const char *)b);
+}
+
+/**
+ * @brief The .wav files in test_data/, sorted
+ */
+static int bench_list_files(char names[][BENCH_NAME_LEN], int max)
+{
+    DIR *dir = opendir(BENCH_DATA_DIR);
+    struct dirent *entry;
+    int count = 0;
+
+    if (!dir) {
+        SIM_LOG_ERR("Can't open %s - run from the project root", BENCH_DATA_DIR);
+        return -ENOENT;
+    }
+    while ((entry = readdir(dir)) != NULL && count < max) {
+        size_t len = strlen(entry->d_name);
+        if (len > 4 && len < BENCH_NAME_LEN && strcmp(&entry->d_name[len - 4], ".wav") == 0) {
+            memcpy(names[count++], entry->d_name, len + 1);
+        }
+    }
+    closedir(dir);
+
+    qsort(names, (size_t)count, BENCH_NAME_LEN, bench_compare_names);
+    return count;
+}
+
+static int bench_load_baseline(const char *path, struct bench_baseline *entries, int max)
+{
+    FILE *f = fopen(path, "r");
+    char line[256];
+    int count = 0;
+
+    if (!f) {
+        SIM_LOG_ERR("Can't read baseline %s", path);
+        return -ENOENT;
+    }
+    while (fgets(line, sizeof(line), f) && count < max) {
+        struct bench_baseline *e = &entries[count];
+
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        if (sscanf(line, "%63s %lf %lf %lf %u", e->name, &e->mb_per_s, &e->p50_us,
+                   &e->p99_us, &e->pool_allocs) == 5) {
+            count++;
+        }
+    }
+    fclose(f);
+    return count;
+}
+
+static int bench_write_baseline(const char *path, const struct bench_result *results, int count)
+{
+    FILE *f = fopen(path, "w");
+
+    if (!f) {
+        SIM_LOG_ERR("Can't write baseline %s", path);
+        return -EIO;
+    }
+    fprintf(f, "# sim_bench baseline: ./build_sim/mp3_rewind_bench --write-baseline %s\n", path);
+    fprintf(f, "# Pool %d x %d B, ring %d B, %d B notifications, unpaced sink\n",
+            CONFIG_APP_AUDIO_BUFFER_COUNT, CONFIG_APP_AUDIO_BUFFER_SIZE, BENCH_RING_SIZE,
+            BENCH_NOTIFY_SIZE);
+    fprintf(f, "# Timings are this host's, checked only with --check-timing\n");
+    fprintf(f, "# file mb_per_s p50_us p99_us pool_allocs\n");
+    for (int i = 0; i < count; i++) {
+        fprintf(f, "%s %.1f %.2f %.2f %u\n", results[i].name, results[i].mb_per_s,
+                results[i].p50_us, results[i].p99_us, results[i].pool_allocs);
+    }
+    fclose(f);
+    SIM_LOG_INF("Baseline written to %s", path);
+    return 0;
+}
+
+/**
+ * @brief Report a timing outside the tolerance
+ *
+ * @return 1 if it counts as a regression
+ */
+static int bench_timing_drift(bool check_timing, const char *name, const char *what,
+                              double value, double baseline)
+{
+    if (check_timing) {
+        SIM_LOG_ERR("%s: %s %.2f, baseline %.2f", name, what, value, baseline);
+        return 1;
+    }
+    SIM_LOG_INF("%s: %s %.2f, baseline %.2f (not checked)", name, what, value, baseline);
+    return 0;
+}
+
+/**
+ * @brief Check results against the baseline
+ *
+ * Pool allocations are deterministic and must match exactly. Throughput
+ * and latency may drift by @p tolerance percent, and only count with
+ * @p check_timing, as they are only comparable on the host that wrote
+ * the baseline.
+ *
+ * @return Number of regressions
+ */
+static int bench_check_baseline(const struct bench_result *results, int count,
+                                const struct bench_baseline *baseline, int baseline_count,
+                                int tolerance, bool check_timing)
+{
+    double slack = tolerance / 100.0;
+    int regressions = 0;
+
+    for (int i = 0; i < count; i++) {
+        const struct bench_result *r = &results[i];
+        const struct bench_baseline *b = NULL;
+
+        for (int j = 0; j < baseline_count; j++) {
+            if (strcmp(baseline[j].name, r->name) == 0) {
+                b = &baseline[j];
+                break;
+            }
+        }
+        if (!b) {
+            SIM_LOG_WRN("%s: not in the baseline", r->name);
+            continue;
+        }
+
+        if (r->mb_per_s < b->mb_per_s * (1.0 - slack)) {
+            regressions += bench_timing_drift(check_timing, r->name, "throughput MB/s",
+                                              r->mb_per_s, b->mb_per_s);
+        }
+        if (r->p50_us > b->p50_us * (1.0 + slack)) {
+            regressions += bench_timing_drift(check_timing, r->name, "p50 latency us",
+                                              r->p50_us, b->p50_us);
+        }
+        if (r->p99_us > b->p99_us * (1.0 + slack)) {
+            regressions += bench_timing_drift(check_timing, r->name, "p99 latency us",
+                                              r->p99_us, b->p99_us);
+        }
+        if (r->pool_allocs != b->pool_allocs) {
+            SIM_LOG_ERR("%s: %u pool allocations, baseline %u", r->name, r->pool_allocs,
+                        b->pool_allocs);
+            regressions++;
+        }
+    }
+    return regressions;
+}
+
+static void bench_usage(const char *prog)
+{
+    printf("Usage: %s [options] [file.wav ...]\n", prog);
+    printf("Streams WAV files from %s through decoder -> pool -> ring -> mock GATT sink.\n",
+           BENCH_DATA_DIR);
+    printf("  --runs N              Runs per file, the best is reported (default %d)\n",
+           BENCH_DEFAULT_RUNS);
+    printf("  --link-kbps K         Pace the sink to K kbit/s of notifications (default: unpaced)\n");
+    printf("  --baseline FILE       Fail if pool allocations differ from FILE\n");
+    printf("  --check-timing        Also fail on throughput/latency drift against FILE,\n");
+    printf("                        which must come from this machine\n");
+    printf("  --tolerance PCT       Allowed throughput/latency drift (default %d%%)\n",
+           BENCH_DEFAULT_TOLERANCE);
+    printf("  --write-baseline FILE Record the results as the new baseline\n");
+}
+
+int main(int argc, char *argv[])
+{
+    static char names[BENCH_MAX_FILES][BENCH_NAME_LEN];
+    static struct bench_result results[BENCH_MAX_FILES];
+    static struct bench_baseline baseline[BENCH_MAX_FILES];
+    const char *baseline_path = NULL;
+    const char *write_path = NULL;
+    int runs = BENCH_DEFAULT_RUNS;
+    int tolerance = BENCH_DEFAULT_TOLERANCE;
+    bool check_timing = false;
+    int file_count = 0;
+    int result_count = 0;
+    int failures = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--runs") == 0 && value) {
+            runs = MAX(atoi(value), 1);
+            i++;
+        } else if (strcmp(arg, "--link-kbps") == 0 && value) {
+            bench.link_kbps = (uint32_t)strtoul(value, NULL, 10);
+            i++;
+        } else if (strcmp(arg, "--baseline") == 0 && value) {
+            baseline_path = value;
+            i++;
+        } else if (strcmp(arg, "--check-timing") == 0) {
+            check_timing = true;
+        } else if (strcmp(arg, "--tolerance") == 0 && value) {
+            tolerance = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--write-baseline") == 0 && value) {
+            write_path = value;
+            i++;
+        } else if (arg[0] != '-' && file_count < BENCH_MAX_FILES) {
+            snprintf(names[file_count++], BENCH_NAME_LEN, "%s", arg);
+        } else {
+            bench_usage(argv[0]);
+            return arg[0] == '-' && strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    if (file_count == 0) {
+        file_count = bench_list_files(names, BENCH_MAX_FILES);
+        if (file_count <= 0) {
+            return 1;
+        }
+    }
+
+    if (audio_buffer_pool_init() < 0) {
+        SIM_LOG_ERR("Audio buffer pool init failed");
+        return 1;
+    }
+
+    SIM_LOG_INF("Pool %d x %d B, ring %d B, %d B notifications, %d run(s) per file, %s",
+                CONFIG_APP_AUDIO_BUFFER_COUNT, CONFIG_APP_AUDIO_BUFFER_SIZE, BENCH_RING_SIZE,
+                BENCH_NOTIFY_SIZE, runs, bench.link_kbps ? "paced sink" : "unpaced sink");
+    printf("%-20s %10s %8s %9s %9s %9s %7s %6s %6s\n", "file", "PCM bytes", "chunks", "MB/s",
+           "p50 us", "p99 us", "allocs", "fails", "leaked");
+
+    for (int i = 0; i < file_count; i++) {
+        struct bench_result *r = &results[result_count];
+        int ret = bench_file(names[i], runs, r);
+
+        if (ret == 1) {
+            continue;
+        }
+        if (ret < 0) {
+            SIM_LOG_ERR("%s: pipeline error %d", names[i], ret);
+            failures++;
+            continue;
+        }
+
+        printf("%-20s %10zu %8u %9.1f %9.2f %9.2f %7u %6u %6u\n", r->name, r->sink_bytes,
+               r->chunks, r->mb_per_s, r->p50_us, r->p99_us, r->pool_allocs, r->pool_failures,
+               r->pool_leaked);
+        if (r->pool_failures > 0 || r->pool_leaked > 0) {
+            SIM_LOG_ERR("%s: pool failures or leaked buffers", r->name);
+            failures++;
+        }
+        result_count++;
+    }
+
+    free(bench.latencies_ns);
+    audio_buffer_pool_cleanup();
+
+    if (baseline_path) {
+        int baseline_count = bench_load_baseline(baseline_path, baseline, BENCH_MAX_FILES);
+        if (baseline_count < 0) {
+            return 1;
+        }
+        int regressions = bench_check_baseline(results, result_count, baseline,
+                                               baseline_count, tolerance, check_timing);
+        const char *checked = check_timing ? "allocations and timing" : "allocations";
+        if (regressions > 0) {
+            SIM_LOG_ERR("%d regression(s) against %s (%s, tolerance %d%%)", regressions,
+                        baseline_path, checked, tolerance);
+            failures++;
+        } else {
+            SIM_LOG_INF("No regressions against %s (%s, tolerance %d%%)", baseline_path,
+                        checked, tolerance);
+        }
+    }
+
+    if (write_path && failures == 0) {
+        if (bench_write_baseline(write_path, results, result_count) < 0) {
+            failures++;
+        }
+    }
+
+    return failures > 0 ? 1 : 0;
+}
@@ -18,6 +18,7 @@
 #include <unistd.h>
 
 #include "storage/fs.h"
+#include "storage/media_index.h"
 #include "utils/error_handling.h"
 
 /* Application version */
@@ -27,7 +28,6 @@
 
 /* Test parameters */
 #define TEST_BUFFER_SIZE 512
-#define MAX_AUDIO_FILES 20
 
 /* Application state */
 typedef enum {
@@ -246,52 +246,66 @@ static int test_file_system(void)
 }
 
 /**
- * @brief Scan for audio files on the SD card
+ * @brief List the audio files on the SD card from the track index
  */
 static int scan_audio_files(void)
 {
     fs_result_t result;
-    char audio_files[MAX_AUDIO_FILES][256];
-    size_t file_count;
+    bool changed = false;
+    size_t track_count;
     
     printf("[SIM_INF] main: === Audio File Scan ===\n");
     
-    /* Scan root directory for audio files */
-    result = media_fs_list_audio_files(NULL, audio_files, MAX_AUDIO_FILES, &file_count);
+    /* Start from the saved index; the refresh only opens new or changed files */
+    result = media_index_load();
     if (result != FS_OK) {
-        printf("[SIM_ERR] main: Failed to scan audio files: %s\n", media_fs_error_to_string(result));
+        printf("[SIM_INF] main: No usable %s (%s), building it\n", MEDIA_INDEX_FILE,
+               media_fs_error_to_string(result));
+    }
+    result = media_index_refresh(&changed);
+    if (result != FS_OK) {
+        printf("[SIM_ERR] main: Failed to index audio files: %s\n", media_fs_error_to_string(result));
         return -1;
     }
     
-    printf("[SIM_INF] main: Found %zu audio files:\n", file_count);
+    track_count = media_index_count();
+    printf("[SIM_INF] main: Found %zu audio files (index %s):\n", track_count,
+           changed ? "updated" : "up to date");
     
-    if (file_count == 0) {
+    if (track_count == 0) {
         printf("[SIM_WRN] main: No audio files found in root directory\n");
         printf("[SIM_INF] main: Note: Check test_data directory for audio files\n");
         return 0;
     }
     
-    /* List all found audio files with details */
-    for (size_t i = 0; i < file_count; i++) {
-        size_t file_size;
+    /* List all indexed tracks with details */
+    for (size_t i = 0; i < track_count; i++) {
+        const media_index_entry_t *entry = media_index_get(i);
+        const char *path = media_index_path(i);
         
-        if (media_fs_get_size(audio_files[i], &file_size) == FS_OK) {
-            printf("[SIM_INF] main:   %zu. %s (%.1f KB)\n", 
+        if (entry->sample_rate) {
+            printf("[SIM_INF] main:   %zu. %s (%.1f KB, %u Hz, %u ch, %u-bit, %u.%03u s)\n", 
                     i + 1, 
-                    audio_files[i], 
-                    (float)file_size / 1024.0);
-            
-            /* Test reading first few bytes of audio file */
-            if (i == 0) { /* Test first file only */
-                printf("[SIM_INF] main:     Testing file read...\n");
-                if (test_file_operations(audio_files[i]) == 0) {
-                    printf("[SIM_INF] main:     Read test PASSED\n");
-                } else {
-                    printf("[SIM_WRN] main:     Read test FAILED\n");
-                }
-            }
+                    path, 
+                    (float)entry->size / 1024.0,
+                    entry->sample_rate,
+                    entry->channels,
+                    entry->bits_per_sample,
+                    entry->duration_ms / 1000,
+                    entry->duration_ms % 1000);
         } else {
-            printf("[SIM_ERR] main:   %zu. %s (size unknown)\n", i + 1, audio_files[i]);
+            printf("[SIM_INF] main:   %zu. %s (%.1f KB, not PCM WAV)\n", 
+                    i + 1, path, (float)entry->size / 1024.0);
+        }
+        
+        /* Test reading first few bytes of audio file */
+        if (i == 0) { /* Test first file only */
+            printf("[SIM_INF] main:     Testing file read...\n");
+            if (test_file_operations(path) == 0) {
+                printf("[SIM_INF] main:     Read test PASSED\n");
+            } else {
+                printf("[SIM_WRN] main:     Read test FAILED\n");
+            }
         }
     }
     
@@ -0,0 +1,263 @@
+/**
+ * @file sim_media_index_test.c
+ * @brief Host check of the cached track index
+ *
+ * Indexes test_data/ through media_index_*() on sim_fs.c, with an extra
+ * copy of a test file that is deleted halfway through. Checks:
+ *
+ * - refresh records every audio file, with the PCM layout of WAV files
+ * - a refresh with nothing changed reports no change
+ * - save followed by media_index_load() gives back the same records
+ * - a torn, corrupted or old-version TRACKS.IDX is rejected
+ * - a deleted file is swept out, in RAM and in the saved index
+ *
+ * TRACKS.IDX and the extra copy are removed again on exit. This file is
+ * part of the simulation build (build_sim.sh).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "storage/fs.h"
+#include "storage/media_index.h"
+
+#define SIM_LOG_INF(fmt, ...) printf("[SIM_INF] media_index_test: " fmt "\n", ##__VA_ARGS__)
+#define SIM_LOG_ERR(fmt, ...) printf("[SIM_ERR] media_index_test: " fmt "\n", ##__VA_ARGS__)
+
+#define IDX_TEST_DIR   "./test_data/"
+#define IDX_TEST_WAV   "tiny_test.wav"
+#define IDX_TEST_COPY  "IDXTEST.WAV"  /* Added, then deleted */
+
+#define IDX_CHECK(cond, fmt, ...)                \
+    do {                                         \
+        if (!(cond)) {                           \
+            SIM_LOG_ERR(fmt, ##__VA_ARGS__);     \
+            idx_test.failures++;                 \
+        }                                        \
+    } while (0)
+
+static struct {
+    uint8_t *saved;     ///< TRACKS.IDX as written by the first refresh
+    size_t saved_size;
+    int failures;
+} idx_test;
+
+static uint8_t *idx_test_slurp(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t *data = NULL;
+    long len;
+
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (len > 0 && (data = malloc((size_t)len)) != NULL &&
+        fread(data, 1, (size_t)len, f) != (size_t)len) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    *size = (size_t)len;
+    return data;
+}
+
+static int idx_test_spill(const char *path, const void *data, size_t size)
+{
+    FILE *f = fopen(path, "wb");
+    int ret = 0;
+
+    if (!f) {
+        return -1;
+    }
+    if (size > 0 && fwrite(data, 1, size, f) != size) {
+        ret = -1;
+    }
+    fclose(f);
+    return ret;
+}
+
+/* Number of files media_index_refresh() is expected to pick up */
+static size_t idx_test_count_audio_files(void)
+{
+    fs_dir_t dir;
+    fs_dirent_t entry;
+    size_t count = 0;
+
+    if (media_fs_opendir(&dir, NULL) != FS_OK) {
+        return 0;
+    }
+    while (media_fs_readdir(&dir, &entry) == FS_OK) {
+        if (!entry.is_directory && media_fs_is_audio_file(entry.name)) {
+            count++;
+        }
+    }
+    media_fs_closedir(&dir);
+    return count;
+}
+
+/**
+ * @brief Check a record against the file's own RIFF header
+ */
+static void idx_test_check_wav(const char *name)
+{
+    char path[256];
+    size_t size;
+    uint8_t *data;
+    int i = media_index_find(name);
+
+    IDX_CHECK(i >= 0, "%s not indexed", name);
+    if (i < 0) {
+        return;
+    }
+
+    snprintf(path, sizeof(path), IDX_TEST_DIR "%s", name);
+    data = idx_test_slurp(path, &size);
+    if (!data) {
+        IDX_CHECK(false, "Cannot read %s", path);
+        return;
+    }
+
+    const media_index_entry_t *e = media_index_get((size_t)i);
+    uint16_t channels = (uint16_t)(data[22] | data[23] << 8);
+    uint32_t rate = data[24] | data[25] << 8 | data[26] << 16 | (uint32_t)data[27] << 24;
+    uint16_t bits = (uint16_t)(data[34] | data[35] << 8);
+
+    IDX_CHECK(e->size == size, "%s: size %u, file has %zu", name, e->size, size);
+    IDX_CHECK(e->channels == channels && e->sample_rate == rate && e->bits_per_sample == bits,
+              "%s: format %u ch %u Hz %u bits, header says %u ch %u Hz %u bits", name,
+              e->channels, e->sample_rate, e->bits_per_sample, channels, rate, bits);
+    IDX_CHECK(e->data_offset >= 44 && e->data_offset + e->data_size <= size,
+              "%s: PCM %u+%u outside the %zu-byte file", name, e->data_offset,
+              e->data_size, size);
+    IDX_CHECK(memcmp(&data[e->data_offset - 8], "data", 4) == 0,
+              "%s: data_offset %u is not right after a data chunk header", name,
+              e->data_offset);
+    IDX_CHECK(e->duration_ms > 0, "%s: no duration", name);
+    free(data);
+}
+
+/**
+ * @brief Rewrite TRACKS.IDX from the saved copy with one change applied
+ *        and check that media_index_load() refuses it
+ */
+static void idx_test_reject(const char *what, size_t size, size_t flip_at)
+{
+    uint8_t *copy = malloc(idx_test.saved_size);
+
+    memcpy(copy, idx_test.saved, idx_test.saved_size);
+    if (flip_at < size) {
+        copy[flip_at] ^= 0x01;
+    }
+    idx_test_spill(IDX_TEST_DIR MEDIA_INDEX_FILE, copy, size);
+    free(copy);
+
+    fs_result_t result = media_index_load();
+    IDX_CHECK(result == FS_ERROR_UNSUPPORTED_FORMAT, "%s index loaded: %s", what,
+              media_fs_error_to_string(result));
+    IDX_CHECK(media_index_count() == 0, "%s index left %zu tracks in RAM", what,
+              media_index_count());
+}
+
+int main(void)
+{
+    size_t tracks;
+    bool changed;
+
+    remove(IDX_TEST_DIR MEDIA_INDEX_FILE);
+    remove(IDX_TEST_DIR IDX_TEST_COPY);
+
+    if (media_fs_init() != FS_OK) {
+        return 1;
+    }
+    IDX_CHECK(media_index_load() == FS_ERROR_FILE_NOT_FOUND, "Load without an index file");
+
+    /* Copy a WAV in so there is something to delete later */
+    size_t wav_size;
+    uint8_t *wav = idx_test_slurp(IDX_TEST_DIR IDX_TEST_WAV, &wav_size);
+    if (!wav || idx_test_spill(IDX_TEST_DIR IDX_TEST_COPY, wav, wav_size) < 0) {
+        SIM_LOG_ERR("Cannot copy %s", IDX_TEST_WAV);
+        return 1;
+    }
+    free(wav);
+
+    /* First refresh indexes everything */
+    tracks = idx_test_count_audio_files();
+    IDX_CHECK(media_index_refresh(&changed) == FS_OK && changed, "First refresh");
+    IDX_CHECK(media_index_count() == tracks, "%zu tracks indexed, %zu audio files",
+              media_index_count(), tracks);
+    idx_test_check_wav(IDX_TEST_WAV);
+    idx_test_check_wav(IDX_TEST_COPY);
+    idx_test_check_wav("astley.wav");
+
+    int mp3 = media_index_find("demo_track.mp3");
+    IDX_CHECK(mp3 >= 0 && media_index_get((size_t)mp3)->sample_rate == 0,
+              "demo_track.mp3 should be indexed without a PCM format");
+
+    IDX_CHECK(media_index_refresh(&changed) == FS_OK && !changed,
+              "Refresh with nothing changed reported a change");
+
+    /* Save and load round trip */
+    idx_test.saved = idx_test_slurp(IDX_TEST_DIR MEDIA_INDEX_FILE, &idx_test.saved_size);
+    if (!idx_test.saved || idx_test.saved_size < sizeof(media_index_header_t)) {
+        SIM_LOG_ERR("%s not written", MEDIA_INDEX_FILE);
+        return 1;
+    }
+    IDX_CHECK(media_index_load() == FS_OK, "Load of a freshly saved index");
+    IDX_CHECK(media_index_count() == tracks, "%zu tracks loaded, %zu saved",
+              media_index_count(), tracks);
+    idx_test_check_wav(IDX_TEST_WAV);
+    idx_test_check_wav(IDX_TEST_COPY);
+
+    /* Damaged and out of date files */
+    idx_test_reject("Torn", idx_test.saved_size - 7, SIZE_MAX);
+    idx_test_reject("Header-only", sizeof(media_index_header_t), SIZE_MAX);
+    idx_test_reject("Corrupted entry", idx_test.saved_size,
+                    sizeof(media_index_header_t) + offsetof(media_index_entry_t, duration_ms));
+    idx_test_reject("Corrupted name", idx_test.saved_size, idx_test.saved_size - 3);
+    idx_test_reject("Old version", idx_test.saved_size,
+                    offsetof(media_index_header_t, version));
+
+    /* A rejected index is rebuilt by the next refresh */
+    IDX_CHECK(media_index_refresh(&changed) == FS_OK && changed,
+              "Refresh after a rejected load");
+    IDX_CHECK(media_index_count() == tracks, "%zu tracks after the rebuild, expected %zu",
+              media_index_count(), tracks);
+
+    /* Deleted file is swept out, and the rest still resolve */
+    remove(IDX_TEST_DIR IDX_TEST_COPY);
+    IDX_CHECK(media_index_refresh(&changed) == FS_OK && changed,
+              "Refresh after a deletion reported no change");
+    IDX_CHECK(media_index_find(IDX_TEST_COPY) < 0, "%s still indexed after deletion",
+              IDX_TEST_COPY);
+    IDX_CHECK(media_index_count() == tracks - 1, "%zu tracks after the deletion, expected %zu",
+              media_index_count(), tracks - 1);
+    for (size_t i = 0; i < media_index_count(); i++) {
+        IDX_CHECK(media_index_find(media_index_path(i)) == (int)i,
+                  "Track %zu (%s) does not resolve after the sweep", i, media_index_path(i));
+    }
+    idx_test_check_wav(IDX_TEST_WAV);
+
+    IDX_CHECK(media_index_load() == FS_OK && media_index_find(IDX_TEST_COPY) < 0 &&
+              media_index_count() == tracks - 1,
+              "Saved index still lists %s", IDX_TEST_COPY);
+
+    remove(IDX_TEST_DIR MEDIA_INDEX_FILE);
+    media_fs_deinit();
+    free(idx_test.saved);
+
+    if (idx_test.failures) {
+        SIM_LOG_ERR("%d check(s) failed", idx_test.failures);
+        return 1;
+    }
+    SIM_LOG_INF("All track index checks passed (%zu tracks, %zu-byte index)",
+                tracks, idx_test.saved_size);
+    return 0;
+}
@@ -0,0 +1,279 @@
+/**
+ * @file sim_pcm_dsp_test.c
+ * @brief Host check of the PCM sample kernels
+ *
+ * Runs the plain C build of pcm_dsp.c, which the DSP extension build must
+ * match sample for sample. Checks:
+ *
+ * - volume curve end points and Q15 gain, including saturation
+ * - stereo downmix and mono upmix, in place, at full scale
+ * - 8-bit widening and 24/32-bit narrowing: rounding, clipping, the
+ *   size pcm_convert_to_s16() reports, and that the TPDF dither stays
+ *   within one LSB and averages out
+ * - fade-in and ramp-to-silence end points
+ *
+ * This file is part of the simulation build (build_sim.sh).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio/pcm_dsp.h"
+
+#define SIM_LOG_INF(fmt, ...) printf("[SIM_INF] pcm_dsp_test: " fmt "\n", ##__VA_ARGS__)
+#define SIM_LOG_ERR(fmt, ...) printf("[SIM_ERR] pcm_dsp_test: " fmt "\n", ##__VA_ARGS__)
+
+#define DSP_TEST_DITHER_SAMPLES 65536
+
+#define DSP_CHECK(cond, fmt, ...)                \
+    do {                                         \
+        if (!(cond)) {                           \
+            SIM_LOG_ERR(fmt, ##__VA_ARGS__);     \
+            dsp_test.failures++;                 \
+        }                                        \
+    } while (0)
+
+static struct {
+    int failures;
+} dsp_test;
+
+static void dsp_put24(uint8_t *p, int32_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+}
+
+static void dsp_put32(uint8_t *p, int32_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+static void dsp_test_gain(void)
+{
+    int16_t s[6] = { INT16_MAX, INT16_MIN, 1000, -1000, 1, -1 };
+
+    DSP_CHECK(pcm_volume_to_q15(0) == 0, "Volume 0 is not silent");
+    DSP_CHECK(pcm_volume_to_q15(100) == PCM_GAIN_UNITY &&
+              pcm_volume_to_q15(255) == PCM_GAIN_UNITY, "Volume 100+ is not unity");
+    for (int v = 1; v <= 100; v++) {
+        DSP_CHECK(pcm_volume_to_q15(v) > pcm_volume_to_q15(v - 1),
+                  "Volume curve not increasing at %d", v);
+    }
+
+    /* Unity leaves samples untouched, half gain halves them */
+    pcm_gain_q15(s, 6, PCM_GAIN_UNITY);
+    DSP_CHECK(s[0] == INT16_MAX && s[1] == INT16_MIN, "Unity gain changed samples");
+    pcm_gain_q15(s, 6, 16384);
+    DSP_CHECK(s[0] == 16383 && s[1] == -16384 && s[2] == 500 && s[3] == -500,
+              "Half gain: %d %d %d %d", s[0], s[1], s[2], s[3]);
+
+    /* -1.0 inverts, and INT16_MIN saturates instead of wrapping */
+    int16_t inv[3] = { INT16_MIN, INT16_MAX, 1234 };
+
+    pcm_gain_q15(inv, 3, INT16_MIN);
+    DSP_CHECK(inv[0] == INT16_MAX && inv[1] == -INT16_MAX && inv[2] == -1234,
+              "Inverting gain: %d %d %d", inv[0], inv[1], inv[2]);
+
+    /* Odd counts take the scalar tail on the SIMD build */
+    int16_t odd[3] = { 2000, 2000, 2000 };
+
+    pcm_gain_q15(odd, 3, 0);
+    DSP_CHECK(odd[0] == 0 && odd[1] == 0 && odd[2] == 0, "Zero gain left %d %d %d",
+              odd[0], odd[1], odd[2]);
+}
+
+static void dsp_test_channels(void)
+{
+    int16_t st[8] = { INT16_MAX, INT16_MAX, INT16_MIN, INT16_MIN, 1000, -1000, 301, 100 };
+
+    pcm_downmix_stereo(st, st, 4);
+    DSP_CHECK(st[0] == INT16_MAX && st[1] == INT16_MIN && st[2] == 0 && st[3] == 200,
+              "Downmix: %d %d %d %d", st[0], st[1], st[2], st[3]);
+
+    int16_t mono[8] = { 1, -2, INT16_MAX, INT16_MIN };
+
+    pcm_upmix_mono(mono, mono, 4);
+    DSP_CHECK(mono[0] == 1 && mono[1] == 1 && mono[2] == -2 && mono[3] == -2 &&
+              mono[4] == INT16_MAX && mono[5] == INT16_MAX &&
+              mono[6] == INT16_MIN && mono[7] == INT16_MIN,
+              "Upmix in place: %d %d %d %d %d %d %d %d", mono[0], mono[1], mono[2], mono[3],
+              mono[4], mono[5], mono[6], mono[7]);
+}
+
+static void dsp_test_widen(void)
+{
+    uint8_t data[8] = { 0, 128, 255, 1 };
+
+    DSP_CHECK(pcm_convert_to_s16(data, 4, 8, NULL) == 8, "8-bit: wrong output size");
+
+    int16_t s[4];
+
+    memcpy(s, data, sizeof(s));
+    DSP_CHECK(s[0] == INT16_MIN && s[1] == 0 && s[2] == 32512 && s[3] == -32512,
+              "8-bit widening: %d %d %d %d", s[0], s[1], s[2], s[3]);
+}
+
+/**
+ * @brief 24- and 32-bit narrowing without dither: round half up, clip
+ */
+static void dsp_test_narrow(void)
+{
+    static const struct {
+        int32_t in24;
+        int16_t out;
+    } cases[] = {
+        { 0x000000, 0 },
+        { 0x00007F, 0 },        /* Just below half an LSB */
+        { 0x000080, 1 },        /* Half an LSB rounds up */
+        { 0x123456, 0x1234 },
+        { -0x000081, -1 },
+        { 0x7FFF7F, INT16_MAX },
+        { 0x7FFFFF, INT16_MAX },   /* Rounds past full scale, clipped */
+        { -0x800000, INT16_MIN },
+    };
+    const size_t n = sizeof(cases) / sizeof(cases[0]);
+    uint8_t b24[sizeof(cases) / sizeof(cases[0]) * 3];
+    uint8_t b32[sizeof(cases) / sizeof(cases[0]) * 4];
+    int16_t out24[sizeof(cases) / sizeof(cases[0])];
+    int16_t out32[sizeof(cases) / sizeof(cases[0])];
+
+    for (size_t i = 0; i < n; i++) {
+        dsp_put24(&b24[3 * i], cases[i].in24);
+        dsp_put32(&b32[4 * i], (int32_t)((uint32_t)cases[i].in24 << 8) + 0x55);
+    }
+    pcm_s24_to_s16(b24, out24, n, NULL);
+    pcm_s32_to_s16(b32, out32, n, NULL);
+    for (size_t i = 0; i < n; i++) {
+        DSP_CHECK(out24[i] == cases[i].out, "24-bit 0x%06x: got %d, expected %d",
+                  (unsigned)(cases[i].in24 & 0xFFFFFF), out24[i], cases[i].out);
+        DSP_CHECK(out32[i] == cases[i].out, "32-bit 0x%06x55: got %d, expected %d",
+                  (unsigned)(cases[i].in24 & 0xFFFFFF), out32[i], cases[i].out);
+    }
+
+    /* In place through the generic entry point */
+    uint8_t buf[12];
+
+    for (int i = 0; i < 4; i++) {
+        dsp_put24(&buf[3 * i], cases[i + 3].in24);
+    }
+    DSP_CHECK(pcm_convert_to_s16(buf, 12, 24, NULL) == 8, "24-bit: wrong output size");
+    DSP_CHECK(memcmp(buf, out24 + 3, 8) == 0, "24-bit in place differs from out of place");
+
+    for (int i = 0; i < 3; i++) {
+        dsp_put32(&buf[4 * i], (int32_t)((uint32_t)cases[i + 3].in24 << 8) + 0x55);
+    }
+    DSP_CHECK(pcm_convert_to_s16(buf, 12, 32, NULL) == 6, "32-bit: wrong output size");
+    DSP_CHECK(memcmp(buf, out32 + 3, 6) == 0, "32-bit in place differs from out of place");
+
+    DSP_CHECK(pcm_convert_to_s16(buf, 12, 16, NULL) == 12, "16-bit is not passed through");
+    DSP_CHECK(pcm_convert_to_s16(buf, 12, 12, NULL) == -ENOTSUP, "12-bit accepted");
+}
+
+/**
+ * @brief TPDF dither: within one LSB of the rounded value, zero mean
+ */
+static void dsp_test_dither(void)
+{
+    const size_t n = DSP_TEST_DITHER_SAMPLES;
+    uint8_t *b24 = malloc(n * 3);
+    uint8_t *b32 = malloc(n * 4);
+    int16_t *out = malloc(n * sizeof(int16_t));
+    struct pcm_dither dither;
+
+    /* 0x1234.40 in output LSBs: a quarter LSB above a whole value */
+    const int32_t in24 = 0x123440;
+    const double exact = in24 / 256.0;
+
+    for (size_t i = 0; i < n; i++) {
+        dsp_put24(&b24[3 * i], in24);
+        dsp_put32(&b32[4 * i], in24 << 8);
+    }
+
+    for (int bits = 24; bits <= 32; bits += 8) {
+        double sum = 0;
+        int lo = INT16_MAX;
+        int hi = INT16_MIN;
+
+        pcm_dither_init(&dither, 0);
+        if (bits == 24) {
+            pcm_s24_to_s16(b24, out, n, &dither);
+        } else {
+            pcm_s32_to_s16(b32, out, n, &dither);
+        }
+        for (size_t i = 0; i < n; i++) {
+            sum += out[i];
+            lo = out[i] < lo ? out[i] : lo;
+            hi = out[i] > hi ? out[i] : hi;
+        }
+
+        double mean = sum / n;
+
+        DSP_CHECK(lo >= 0x1234 - 1 && hi <= 0x1234 + 1 && lo < hi,
+                  "%d-bit dither spans %d..%d around %d", bits, lo, hi, 0x1234);
+        DSP_CHECK(mean > exact - 0.02 && mean < exact + 0.02,
+                  "%d-bit dither mean %.4f, input %.4f", bits, mean, exact);
+    }
+
+    /* Dither near full scale clips instead of wrapping */
+    for (size_t i = 0; i < n; i++) {
+        dsp_put24(&b24[3 * i], i & 1 ? 0x7FFFFF : -0x800000);
+    }
+    pcm_dither_init(&dither, 1);
+    pcm_s24_to_s16(b24, out, n, &dither);
+    for (size_t i = 0; i < n; i++) {
+        bool ok = (i & 1) ? out[i] >= INT16_MAX - 1 : out[i] <= INT16_MIN + 1;
+
+        if (!ok) {
+            DSP_CHECK(false, "Dithered full scale sample %zu wrapped to %d", i, out[i]);
+            break;
+        }
+    }
+
+    free(b24);
+    free(b32);
+    free(out);
+}
+
+static void dsp_test_ramps(void)
+{
+    int16_t s[16];
+    const int16_t from[2] = { 20000, -20000 };
+
+    for (int i = 0; i < 16; i++) {
+        s[i] = 20000;
+    }
+    pcm_fade_in(s, 8, 2);
+    DSP_CHECK(s[0] == 0 && s[1] == 0, "Fade-in doesn't start from silence");
+    for (int i = 2; i < 16; i++) {
+        DSP_CHECK(s[i] >= s[i - 2] && s[i] < 20000, "Fade-in not rising at sample %d", i);
+    }
+
+    pcm_ramp_to_silence(from, s, 8, 2);
+    DSP_CHECK(s[14] == 0 && s[15] == 0, "Ramp doesn't end in silence");
+    DSP_CHECK(s[0] < from[0] && s[0] >= from[0] * 7 / 8 - 1 &&
+              s[1] <= -s[0] && s[1] >= -s[0] - 1,   /* >> rounds negatives down */
+              "Ramp starts at %d %d", s[0], s[1]);
+}
+
+int main(void)
+{
+    dsp_test_gain();
+    dsp_test_channels();
+    dsp_test_widen();
+    dsp_test_narrow();
+    dsp_test_dither();
+    dsp_test_ramps();
+
+    if (dsp_test.failures) {
+        SIM_LOG_ERR("%d check(s) failed", dsp_test.failures);
+        return 1;
+    }
+    SIM_LOG_INF("All PCM kernel checks passed");
+    return 0;
+}
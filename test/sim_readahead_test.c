@@ -0,0 +1,203 @@
+/**
+ * @file sim_readahead_test.c
+ * @brief Host check of the SD card read-ahead engine
+ *
+ * Reads a file from test_data/ through media_readahead_*() on sim_fs.c
+ * and compares every delivered buffer with the file's bytes. Checks:
+ *
+ * - buffers arrive in file order, with nothing lost or repeated
+ * - every buffer but the last of a range ends on a sector boundary, also
+ *   after an unaligned start and an unaligned media_readahead_seek()
+ * - a range end is honoured and flagged with END_OF_STREAM
+ * - every pool buffer is back in the pool after media_readahead_stop()
+ *
+ * This file is part of the simulation build (build_sim.sh); the kernel
+ * primitives come from the POSIX shims in src/sim/.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include "audio/audio_buffers.h"
+#include "storage/fs.h"
+#include "storage/readahead.h"
+
+#define SIM_LOG_INF(fmt, ...) printf("[SIM_INF] readahead_test: " fmt "\n", ##__VA_ARGS__)
+#define SIM_LOG_ERR(fmt, ...) printf("[SIM_ERR] readahead_test: " fmt "\n", ##__VA_ARGS__)
+
+#define RA_TEST_FILE          "tiny_test.wav"
+#define RA_TEST_PATH          "./test_data/" RA_TEST_FILE
+#define RA_TEST_GET_TIMEOUT   K_MSEC(1000)
+#define RA_TEST_SEEK_OFFSET   50037   /* Deliberately not sector aligned */
+
+#define RA_CHECK(cond, fmt, ...)                 \
+    do {                                         \
+        if (!(cond)) {                           \
+            SIM_LOG_ERR(fmt, ##__VA_ARGS__);     \
+            ra_test.failures++;                  \
+        }                                        \
+    } while (0)
+
+static struct {
+    uint8_t *ref;       ///< Whole file, read with stdio
+    size_t ref_size;
+    int failures;
+} ra_test;
+
+static int ra_test_load_reference(void)
+{
+    FILE *f = fopen(RA_TEST_PATH, "rb");
+
+    if (!f) {
+        SIM_LOG_ERR("Cannot open %s", RA_TEST_PATH);
+        return -1;
+    }
+    fseek(f, 0, SEEK_END);
+    ra_test.ref_size = (size_t)ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    ra_test.ref = malloc(ra_test.ref_size);
+    if (!ra_test.ref || fread(ra_test.ref, 1, ra_test.ref_size, f) != ra_test.ref_size) {
+        fclose(f);
+        SIM_LOG_ERR("Cannot read %s", RA_TEST_PATH);
+        return -1;
+    }
+    fclose(f);
+    return 0;
+}
+
+/**
+ * @brief Take up to @p max_buffers buffers and check them against the file
+ *
+ * @param pos File offset the next buffer must start at
+ * @param end Offset one past the last byte of the range
+ * @param max_buffers Buffers to take, 0 for the whole rest of the range
+ * @return File offset after the last buffer taken
+ */
+static size_t ra_test_consume(size_t pos, size_t end, size_t max_buffers)
+{
+    for (size_t n = 0; max_buffers == 0 || n < max_buffers; n++) {
+        struct audio_buffer *buf = media_readahead_get(RA_TEST_GET_TIMEOUT);
+
+        if (!buf) {
+            RA_CHECK(pos == end, "No buffer at offset %zu, range ends at %zu", pos, end);
+            break;
+        }
+
+        bool last = (buf->flags & AUDIO_BUFFER_FLAG_END_OF_STREAM) != 0;
+
+        RA_CHECK(buf->used > 0 && pos + buf->used <= end,
+                 "Buffer of %zu bytes at offset %zu overruns the range end %zu",
+                 buf->used, pos, end);
+        if (buf->used > 0 && pos + buf->used <= end) {
+            RA_CHECK(memcmp(buf->data, ra_test.ref + pos, buf->used) == 0,
+                     "Buffer at offset %zu doesn't match the file", pos);
+        }
+        pos += buf->used;
+
+        if (last) {
+            RA_CHECK(pos == end, "END_OF_STREAM at offset %zu, range ends at %zu", pos, end);
+        } else {
+            RA_CHECK(pos % READAHEAD_SECTOR_SIZE == 0,
+                     "Buffer ends at offset %zu, not on a sector boundary", pos);
+        }
+
+        audio_buffer_free(buf);
+        if (last) {
+            RA_CHECK(media_readahead_get(K_NO_WAIT) == NULL,
+                     "Buffer delivered after END_OF_STREAM");
+            break;
+        }
+    }
+    return pos;
+}
+
+static void ra_test_check_pool(const char *when)
+{
+    struct audio_buffer_stats stats;
+
+    audio_buffer_pool_get_stats(&stats);
+    RA_CHECK(stats.buffers_in_use == 0, "%u pool buffers still in use %s",
+             stats.buffers_in_use, when);
+}
+
+/**
+ * @brief Unaligned start, then an unaligned seek mid-file, up to EOF
+ */
+static void ra_test_seek(fs_file_t *file)
+{
+    readahead_stats_t stats;
+
+    RA_CHECK(media_readahead_start(file, 44, 0) == FS_OK, "Start failed");
+
+    size_t pos = ra_test_consume(44, ra_test.ref_size, 4);
+    RA_CHECK(pos < RA_TEST_SEEK_OFFSET, "Test file too short for the seek");
+
+    RA_CHECK(media_readahead_seek(RA_TEST_SEEK_OFFSET) == FS_OK, "Seek failed");
+    pos = ra_test_consume(RA_TEST_SEEK_OFFSET, ra_test.ref_size, 0);
+    RA_CHECK(pos == ra_test.ref_size, "Stopped at %zu of %zu bytes", pos, ra_test.ref_size);
+
+    media_readahead_get_stats(&stats);
+    RA_CHECK(stats.read_errors == 0, "%u read errors", stats.read_errors);
+    RA_CHECK(stats.buffers_consumed <= stats.buffers_filled,
+             "%u buffers consumed, only %u filled", stats.buffers_consumed,
+             stats.buffers_filled);
+
+    media_readahead_stop();
+    ra_test_check_pool("after the seek test");
+}
+
+/**
+ * @brief A bounded range, stopped while buffers are still prefetched
+ */
+static void ra_test_range(fs_file_t *file)
+{
+    const size_t start = 1000;
+    const size_t end = 9000;
+
+    RA_CHECK(media_readahead_start(file, start, end) == FS_OK, "Ranged start failed");
+    size_t pos = ra_test_consume(start, end, 0);
+    RA_CHECK(pos == end, "Range delivered up to %zu, expected %zu", pos, end);
+    media_readahead_stop();
+
+    /* Stop with the window full: the prefetched buffers are released */
+    RA_CHECK(media_readahead_start(file, 0, 0) == FS_OK, "Restart failed");
+    ra_test_consume(0, ra_test.ref_size, 1);
+    k_msleep(50);
+    media_readahead_stop();
+    ra_test_check_pool("after a stop with prefetched buffers");
+}
+
+int main(void)
+{
+    fs_file_t file;
+
+    if (ra_test_load_reference() < 0 || media_fs_init() != FS_OK ||
+        audio_buffer_pool_init() < 0) {
+        return 1;
+    }
+    if (media_fs_open(&file, RA_TEST_FILE) != FS_OK) {
+        SIM_LOG_ERR("media_fs_open(%s) failed", RA_TEST_FILE);
+        return 1;
+    }
+
+    ra_test_seek(&file);
+    ra_test_range(&file);
+
+    media_fs_close(&file);
+    media_fs_deinit();
+    free(ra_test.ref);
+
+    if (ra_test.failures) {
+        SIM_LOG_ERR("%d check(s) failed", ra_test.failures);
+        return 1;
+    }
+    SIM_LOG_INF("All read-ahead checks passed (%zu-byte file, %d-byte buffers, %d deep)",
+                ra_test.ref_size, CONFIG_APP_AUDIO_BUFFER_SIZE, CONFIG_APP_SD_READAHEAD_DEPTH);
+    return 0;
+}
@@ -0,0 +1,247 @@
+/**
+ * @file sim_resampler_test.c
+ * @brief Host check of the streaming sample-rate converter
+ *
+ * Runs resampler_process() over a pseudo-random signal at the rate pairs
+ * the client meets, for every quality tier and channel count. Checks:
+ *
+ * - a stream of n frames comes out as exactly ceil(n * out / in) frames,
+ *   so long streams don't drift
+ * - feeding resampler_max_input(capacity) frames at a time into a buffer
+ *   of that capacity never drops an output, and growing in place gives
+ *   the same samples as converting in a roomy buffer in one call
+ * - a constant signal keeps its level
+ * - matching rates pass through untouched and bad parameters are refused
+ *
+ * This file is part of the simulation build (build_sim.sh).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio/resampler.h"
+
+#define SIM_LOG_INF(fmt, ...) printf("[SIM_INF] resampler_test: " fmt "\n", ##__VA_ARGS__)
+#define SIM_LOG_ERR(fmt, ...) printf("[SIM_ERR] resampler_test: " fmt "\n", ##__VA_ARGS__)
+
+#define RS_TEST_FRAMES     4099    /* Input frames per stream, deliberately odd */
+#define RS_TEST_DC_LEVEL   10000
+
+#define RS_CHECK(cond, fmt, ...)                 \
+    do {                                         \
+        if (!(cond)) {                           \
+            SIM_LOG_ERR(fmt, ##__VA_ARGS__);     \
+            rs_test.failures++;                  \
+        }                                        \
+    } while (0)
+
+static const struct {
+    uint32_t in;
+    uint32_t out;
+} rs_test_rates[] = {
+    { 44100, 48000 },
+    { 32000, 48000 },
+    { 22050, 48000 },
+    { 8000, 48000 },
+    { 11025, 44100 },
+    { 48000, 44100 },
+    { 96000, 48000 },
+};
+
+/* Buffer sizes in frames, from barely usable up to a pool buffer */
+static const size_t rs_test_capacities[] = { 16, 37, 256, 512 };
+
+static const char *const rs_test_quality_names[] = { "fast", "balanced", "high" };
+
+static struct {
+    int16_t *signal;    ///< RS_TEST_FRAMES stereo frames
+    int16_t *expect;    ///< Output of the one-call reference run
+    int16_t *got;
+    int16_t *buf;
+    size_t runs;
+    int failures;
+} rs_test;
+
+static size_t rs_test_out_frames(uint32_t in, uint32_t out, size_t frames)
+{
+    return (size_t)(((uint64_t)frames * out + in - 1) / in);
+}
+
+/**
+ * @brief Convert the whole signal in one call into a buffer with room to spare
+ */
+static size_t rs_test_reference(struct resampler *rs, uint16_t channels, size_t room)
+{
+    memcpy(rs_test.expect, rs_test.signal, RS_TEST_FRAMES * channels * sizeof(int16_t));
+    return resampler_process(rs, rs_test.expect, RS_TEST_FRAMES, room);
+}
+
+/**
+ * @brief Convert the signal chunk by chunk, each in a buffer of @p capacity
+ *        frames filled with resampler_max_input() frames
+ */
+static size_t rs_test_chunked(struct resampler *rs, uint16_t channels, size_t capacity)
+{
+    size_t in_pos = 0;
+    size_t out_pos = 0;
+    size_t chunk = resampler_max_input(rs, capacity);
+
+    if (chunk == 0) {
+        return 0;
+    }
+    while (in_pos < RS_TEST_FRAMES) {
+        size_t frames = RS_TEST_FRAMES - in_pos < chunk ? RS_TEST_FRAMES - in_pos : chunk;
+        size_t out;
+
+        /* Poison the rest of the buffer so stale samples would show */
+        memset(rs_test.buf, 0x5A, capacity * channels * sizeof(int16_t));
+        memcpy(rs_test.buf, &rs_test.signal[in_pos * channels],
+               frames * channels * sizeof(int16_t));
+        out = resampler_process(rs, rs_test.buf, frames, capacity);
+        if (out > capacity) {
+            return SIZE_MAX;
+        }
+        memcpy(&rs_test.got[out_pos * channels], rs_test.buf, out * channels * sizeof(int16_t));
+        in_pos += frames;
+        out_pos += out;
+    }
+    return out_pos;
+}
+
+static void rs_test_stream(uint32_t in, uint32_t out, uint16_t channels,
+                           resampler_quality_t quality)
+{
+    const char *q = rs_test_quality_names[quality];
+    const size_t expected = rs_test_out_frames(in, out, RS_TEST_FRAMES);
+    const size_t room = expected > RS_TEST_FRAMES ? expected : RS_TEST_FRAMES;
+    struct resampler rs;
+    size_t total;
+
+    if (resampler_init(&rs, in, out, channels, quality) != 0) {
+        RS_CHECK(false, "%u -> %u Hz, %u ch, %s: init failed", in, out, channels, q);
+        return;
+    }
+    total = rs_test_reference(&rs, channels, room);
+    RS_CHECK(total == expected, "%u -> %u Hz, %u ch, %s: %zu frames out, expected %zu",
+             in, out, channels, q, total, expected);
+
+    for (size_t k = 0; k < sizeof(rs_test_capacities) / sizeof(rs_test_capacities[0]); k++) {
+        size_t capacity = rs_test_capacities[k];
+        size_t got;
+
+        resampler_reset(&rs);
+        got = rs_test_chunked(&rs, channels, capacity);
+        RS_CHECK(got != 0 && got != SIZE_MAX,
+                 "%u -> %u Hz, %u ch, %s: no usable input for a %zu-frame buffer%s",
+                 in, out, channels, q, capacity, got ? " (output overran it)" : "");
+        if (got == 0 || got == SIZE_MAX) {
+            continue;
+        }
+        RS_CHECK(got == total, "%u -> %u Hz, %u ch, %s, %zu-frame buffers: %zu frames out, "
+                 "%zu in one call", in, out, channels, q, capacity, got, total);
+        if (got == total) {
+            RS_CHECK(memcmp(rs_test.got, rs_test.expect,
+                            total * channels * sizeof(int16_t)) == 0,
+                     "%u -> %u Hz, %u ch, %s, %zu-frame buffers: samples differ from "
+                     "one call", in, out, channels, q, capacity);
+        }
+        rs_test.runs++;
+    }
+}
+
+/**
+ * @brief Constant full-band input comes out at the same level once the
+ *        filter history has filled
+ */
+static void rs_test_dc(uint32_t in, uint32_t out, resampler_quality_t quality)
+{
+    struct resampler rs;
+    size_t frames;
+
+    resampler_init(&rs, in, out, 1, quality);
+    for (size_t i = 0; i < RS_TEST_FRAMES; i++) {
+        rs_test.buf[i] = RS_TEST_DC_LEVEL;
+    }
+    frames = resampler_process(&rs, rs_test.buf, RS_TEST_FRAMES / 2, RS_TEST_FRAMES);
+    for (size_t i = 2 * RESAMPLER_MAX_TAPS * 6; i < frames; i++) {
+        int d = rs_test.buf[i] - RS_TEST_DC_LEVEL;
+
+        if (d < -RS_TEST_DC_LEVEL / 50 || d > RS_TEST_DC_LEVEL / 50) {
+            RS_CHECK(false, "%u -> %u Hz, %s: DC level %d at frame %zu", in, out,
+                     rs_test_quality_names[quality], rs_test.buf[i], i);
+            break;
+        }
+    }
+}
+
+static void rs_test_params(void)
+{
+    struct resampler rs;
+    int16_t samples[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    RS_CHECK(resampler_init(NULL, 44100, 48000, 2, RESAMPLER_QUALITY_FAST) == -EINVAL,
+             "NULL state accepted");
+    RS_CHECK(resampler_init(&rs, 0, 48000, 2, RESAMPLER_QUALITY_FAST) == -EINVAL,
+             "0 Hz input accepted");
+    RS_CHECK(resampler_init(&rs, 44100, 0, 2, RESAMPLER_QUALITY_FAST) == -EINVAL,
+             "0 Hz output accepted");
+    RS_CHECK(resampler_init(&rs, 44100, 48000, 0, RESAMPLER_QUALITY_FAST) == -EINVAL,
+             "0 channels accepted");
+    RS_CHECK(resampler_init(&rs, 44100, 48000, RESAMPLER_MAX_CHANNELS + 1,
+                            RESAMPLER_QUALITY_FAST) == -EINVAL, "Too many channels accepted");
+
+    RS_CHECK(resampler_init(&rs, 44100, 48000, 2, RESAMPLER_QUALITY_HIGH) == 0 &&
+             resampler_max_input(&rs, 1) == 0, "1-frame buffer given input when upsampling");
+
+    RS_CHECK(resampler_init(&rs, 48000, 48000, 2, RESAMPLER_QUALITY_HIGH) == 0 && !rs.active,
+             "Matching rates not passed through");
+    RS_CHECK(resampler_max_input(&rs, 4) == 4, "Pass-through doesn't fill the buffer");
+    RS_CHECK(resampler_process(&rs, samples, 3, 4) == 3 && samples[0] == 1 && samples[5] == 6 &&
+             samples[7] == 8, "Pass-through changed the buffer");
+}
+
+int main(void)
+{
+    const size_t samples = rs_test_out_frames(8000, 48000, RS_TEST_FRAMES) * 2;
+    uint32_t lcg = 1;
+
+    rs_test.signal = malloc(RS_TEST_FRAMES * 2 * sizeof(int16_t));
+    rs_test.expect = malloc(samples * sizeof(int16_t));
+    rs_test.got = malloc(samples * sizeof(int16_t));
+    rs_test.buf = malloc(RS_TEST_FRAMES * 2 * sizeof(int16_t));
+    if (!rs_test.signal || !rs_test.expect || !rs_test.got || !rs_test.buf) {
+        return 1;
+    }
+    for (size_t i = 0; i < RS_TEST_FRAMES * 2; i++) {
+        lcg = lcg * 1664525u + 1013904223u;
+        rs_test.signal[i] = (int16_t)(lcg >> 16);
+    }
+
+    rs_test_params();
+    for (size_t r = 0; r < sizeof(rs_test_rates) / sizeof(rs_test_rates[0]); r++) {
+        for (int q = RESAMPLER_QUALITY_FAST; q <= RESAMPLER_QUALITY_HIGH; q++) {
+            for (uint16_t ch = 1; ch <= RESAMPLER_MAX_CHANNELS; ch++) {
+                rs_test_stream(rs_test_rates[r].in, rs_test_rates[r].out, ch,
+                               (resampler_quality_t)q);
+            }
+            rs_test_dc(rs_test_rates[r].in, rs_test_rates[r].out, (resampler_quality_t)q);
+        }
+    }
+
+    free(rs_test.signal);
+    free(rs_test.expect);
+    free(rs_test.got);
+    free(rs_test.buf);
+
+    if (rs_test.failures) {
+        SIM_LOG_ERR("%d check(s) failed", rs_test.failures);
+        return 1;
+    }
+    SIM_LOG_INF("All resampler checks passed (%zu chunked streams)", rs_test.runs);
+    return 0;
+}
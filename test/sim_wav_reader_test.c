@@ -0,0 +1,581 @@
+/**
+ * @file sim_wav_reader_test.c
+ * @brief Host check of the WAV push decoder and the WAV file reader
+ *
+ * Decodes every WAV in test_data/ with wav_stream_feed() in one piece to
+ * get a reference, then compares against:
+ *
+ * - the push decoder fed in 1..200-byte steps, with and without
+ *   WAV_STREAM_PAUSE on every other PCM span
+ * - wav_file_reader_*() over sim_fs.c with 1..200-byte header windows
+ *   and reads of the same size, plus frame-aligned seeks
+ *
+ * Small synthetic files cover what test_data/ does not: fmt extensions,
+ * odd-sized chunks and their padding, bytes after the data chunk, an
+ * unbounded data chunk, 24/32-bit and WAVE_FORMAT_EXTENSIBLE PCM, and
+ * the malformed or unplayable headers that must be refused.
+ *
+ * This file is part of the simulation build (build_sim.sh).
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio/wav_decoder.h"
+#include "storage/fs.h"
+#include "storage/wav_file_reader.h"
+
+#define SIM_LOG_INF(fmt, ...) printf("[SIM_INF] wav_reader_test: " fmt "\n", ##__VA_ARGS__)
+#define SIM_LOG_ERR(fmt, ...) printf("[SIM_ERR] wav_reader_test: " fmt "\n", ##__VA_ARGS__)
+
+#define WR_TEST_DIR       "./test_data/"
+#define WR_TEST_MAX_STEP  200
+
+#define WR_CHECK(cond, fmt, ...)                 \
+    do {                                         \
+        if (!(cond)) {                           \
+            SIM_LOG_ERR(fmt, ##__VA_ARGS__);     \
+            wr_test.failures++;                  \
+        }                                        \
+    } while (0)
+
+static const char *const wr_test_files[] = {
+    "tiny_test.wav",
+    "test_stream.wav",
+    "astley.wav",
+    "test_song.wav",
+    "audio.wav",
+};
+
+static struct {
+    int failures;
+    int files_checked;
+    int files_refused;
+} wr_test;
+
+/**
+ * @brief Everything one decode produced
+ */
+struct wr_sink {
+    uint8_t *pcm;
+    size_t len;
+    size_t cap;
+    struct audio_format_info format;
+    int formats;                ///< FORMAT events
+    int ends;                   ///< END events
+    const uint8_t *base;        ///< Start of the fed file, to locate spans
+    size_t data_start;          ///< File offset of the first PCM span
+    bool pause_spans;           ///< Pause on every other DATA event
+    const uint8_t *paused;      ///< Span paused last time, must come back
+    size_t paused_len;
+    int bad_resumes;
+};
+
+static int wr_sink_cb(const struct wav_stream_event *event, void *user_data)
+{
+    struct wr_sink *sink = user_data;
+
+    switch (event->type) {
+    case WAV_STREAM_EVENT_FORMAT:
+        sink->format = *event->format;
+        sink->formats++;
+        return 0;
+
+    case WAV_STREAM_EVENT_DATA:
+        if (sink->paused) {
+            /* The paused span comes back first; wr_decode() refeeds from
+             * it, so it may now run on into the rest of the next feed */
+            if (event->pcm != sink->paused || event->len < sink->paused_len) {
+                sink->bad_resumes++;
+            }
+            sink->paused = NULL;
+        } else if (sink->pause_spans && (sink->len & 1) == 0) {
+            sink->paused = event->pcm;
+            sink->paused_len = event->len;
+            return WAV_STREAM_PAUSE;
+        }
+        if (sink->len == 0 && sink->base) {
+            sink->data_start = (size_t)(event->pcm - sink->base);
+        }
+        if (sink->len + event->len > sink->cap) {
+            sink->cap = (sink->len + event->len) * 2;
+            sink->pcm = realloc(sink->pcm, sink->cap);
+        }
+        memcpy(sink->pcm + sink->len, event->pcm, event->len);
+        sink->len += event->len;
+        return 0;
+
+    case WAV_STREAM_EVENT_END:
+        sink->ends++;
+        return 0;
+    }
+    return -EINVAL;
+}
+
+/**
+ * @brief Feed @p data to a fresh decoder in @p step-byte pieces
+ *
+ * @return 0, or the first negative feed result
+ */
+static int wr_decode(struct wr_sink *sink, const uint8_t *data, size_t len, size_t step,
+                     bool pause_spans)
+{
+    struct wav_stream_decoder decoder;
+    size_t pos = 0;
+
+    memset(sink, 0, sizeof(*sink));
+    sink->base = data;
+    sink->pause_spans = pause_spans;
+    wav_stream_init(&decoder);
+
+    while (pos < len && decoder.state != WAV_STREAM_DONE) {
+        size_t n = (len - pos < step) ? len - pos : step;
+        int ret = wav_stream_feed(&decoder, &data[pos], n, wr_sink_cb, sink);
+
+        if (ret < 0) {
+            return ret;
+        }
+        if (ret == 0 && !sink->paused) {
+            return -EIO;    /* No progress without a pause */
+        }
+        pos += (size_t)ret;
+    }
+    return 0;
+}
+
+static void wr_sink_free(struct wr_sink *sink)
+{
+    free(sink->pcm);
+    sink->pcm = NULL;
+}
+
+/* Same PCM and format as the reference */
+static void wr_compare(const char *name, const char *how, size_t step,
+                       const struct wr_sink *ref, const struct wr_sink *got)
+{
+    WR_CHECK(got->len == ref->len && memcmp(got->pcm, ref->pcm, ref->len) == 0,
+             "%s, %s in %zu-byte steps: %zu PCM bytes differ from the %zu-byte reference",
+             name, how, step, got->len, ref->len);
+    WR_CHECK(memcmp(&got->format, &ref->format, sizeof(ref->format)) == 0,
+             "%s, %s in %zu-byte steps: format differs", name, how, step);
+}
+
+static uint8_t *wr_slurp(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t *data = NULL;
+    long len;
+
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (len > 0 && (data = malloc((size_t)len)) != NULL &&
+        fread(data, 1, (size_t)len, f) != (size_t)len) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    *size = (size_t)len;
+    return data;
+}
+
+/**
+ * @brief Push decoder against itself at every step size
+ */
+static void wr_test_stream_steps(const char *name, const uint8_t *data, size_t len,
+                                 const struct wr_sink *ref)
+{
+    struct wr_sink got;
+
+    for (size_t step = 1; step <= WR_TEST_MAX_STEP; step++) {
+        for (int pause = 0; pause <= 1; pause++) {
+            int ret = wr_decode(&got, data, len, step, pause != 0);
+
+            WR_CHECK(ret == 0, "%s: feed failed with %d in %zu-byte steps", name, ret, step);
+            wr_compare(name, pause ? "paused feeds" : "feeds", step, ref, &got);
+            WR_CHECK(got.formats == 1 && got.ends == ref->ends && got.bad_resumes == 0,
+                     "%s in %zu-byte steps: %d FORMAT, %d END, %d bad resumes", name, step,
+                     got.formats, got.ends, got.bad_resumes);
+            wr_sink_free(&got);
+        }
+    }
+}
+
+/**
+ * @brief File reader against the push decoder at every window/read size
+ */
+static void wr_test_reader_steps(const char *name, fs_file_t *file, const struct wr_sink *ref)
+{
+    uint8_t window[WR_TEST_MAX_STEP];
+    uint8_t *pcm = malloc(ref->len + WR_TEST_MAX_STEP);
+
+    for (size_t step = 1; step <= WR_TEST_MAX_STEP; step++) {
+        wav_file_reader_t reader;
+        struct wr_sink got = { .pcm = pcm };
+        size_t n;
+
+        if (wav_file_reader_open(&reader, file, window, step) != FS_OK) {
+            WR_CHECK(false, "%s: reader open failed with a %zu-byte window", name, step);
+            continue;
+        }
+        WR_CHECK(reader.data_start == ref->data_start,
+                 "%s: reader data_start %zu, push decoder %zu (%zu-byte window)", name,
+                 reader.data_start, ref->data_start, step);
+
+        while (wav_file_reader_read(&reader, pcm + got.len, step, &n) == FS_OK && n > 0) {
+            got.len += n;
+        }
+        got.format = reader.format;
+        WR_CHECK(wav_file_reader_is_eof(&reader), "%s: reader not at EOF after %zu bytes",
+                 name, got.len);
+        wr_compare(name, "reader", step, ref, &got);
+        wav_file_reader_close(&reader);
+    }
+    free(pcm);
+}
+
+/**
+ * @brief Frame-aligned byte and time seeks
+ */
+static void wr_test_reader_seek(const char *name, fs_file_t *file, const struct wr_sink *ref)
+{
+    uint8_t window[WAV_FILE_READER_WINDOW_SIZE];
+    uint8_t buf[64];
+    wav_file_reader_t reader;
+    size_t n;
+
+    if (wav_file_reader_open(&reader, file, window, sizeof(window)) != FS_OK) {
+        WR_CHECK(false, "%s: reader open failed", name);
+        return;
+    }
+
+    size_t align = reader.format.block_align;
+    size_t target = (ref->len / 3) | 1;     /* Odd, so mid-frame for 16-bit */
+    size_t expect = target - target % align;
+
+    WR_CHECK(wav_file_reader_seek(&reader, target) == FS_OK && reader.position == expect,
+             "%s: seek to %zu landed on %zu, expected %zu", name, target, reader.position,
+             expect);
+    WR_CHECK(wav_file_reader_read(&reader, buf, sizeof(buf), &n) == FS_OK && n > 0 &&
+             memcmp(buf, ref->pcm + expect, n) == 0,
+             "%s: bytes after the seek to %zu don't match", name, expect);
+
+    WR_CHECK(wav_file_reader_seek(&reader, reader.data_size + align) == FS_ERROR_SEEK_FAILED,
+             "%s: seek past the end accepted", name);
+
+    size_t at_500ms = wav_time_to_offset(&reader.format, 500);
+    if (at_500ms < ref->len) {
+        WR_CHECK(wav_file_reader_seek_ms(&reader, 500) == FS_OK &&
+                 reader.position == at_500ms && at_500ms % align == 0,
+                 "%s: seek to 500 ms landed on %zu, expected %zu", name, reader.position,
+                 at_500ms);
+    }
+
+    WR_CHECK(wav_file_reader_seek_ms(&reader, UINT32_MAX / 2) == FS_OK &&
+             wav_file_reader_is_eof(&reader),
+             "%s: seek far past the end is not clamped to EOF", name);
+    WR_CHECK(wav_file_reader_read(&reader, buf, sizeof(buf), &n) == FS_OK && n == 0,
+             "%s: read at EOF returned data", name);
+    wav_file_reader_close(&reader);
+}
+
+static void wr_test_file(const char *name)
+{
+    char path[256];
+    size_t len;
+    uint8_t *data;
+    struct wr_sink ref;
+    fs_file_t file;
+
+    snprintf(path, sizeof(path), WR_TEST_DIR "%s", name);
+    data = wr_slurp(path, &len);
+    if (!data) {
+        WR_CHECK(false, "Cannot read %s", path);
+        return;
+    }
+
+    int ret = wr_decode(&ref, data, len, len, false);
+
+    if (media_fs_open(&file, name) != FS_OK) {
+        WR_CHECK(false, "media_fs_open(%s) failed", name);
+        wr_sink_free(&ref);
+        free(data);
+        return;
+    }
+
+    if (ret < 0) {
+        /* Not a PCM WAV: the reader must refuse it too, at any window */
+        for (size_t step = 1; step <= WR_TEST_MAX_STEP; step += 37) {
+            wav_file_reader_t reader;
+            uint8_t window[WR_TEST_MAX_STEP];
+
+            WR_CHECK(wav_file_reader_open(&reader, &file, window, step) ==
+                     FS_ERROR_UNSUPPORTED_FORMAT,
+                     "%s: refused by the push decoder (%d) but opened by the reader",
+                     name, ret);
+        }
+        wr_test.files_refused++;
+    } else {
+        WR_CHECK(ref.formats == 1 && ref.len > 0, "%s: %d FORMAT events, %zu PCM bytes",
+                 name, ref.formats, ref.len);
+        wr_test_stream_steps(name, data, len, &ref);
+        wr_test_reader_steps(name, &file, &ref);
+        wr_test_reader_seek(name, &file, &ref);
+        wr_test.files_checked++;
+    }
+
+    media_fs_close(&file);
+    wr_sink_free(&ref);
+    free(data);
+}
+
+/* Little-endian chunk builder for the synthetic files */
+struct wr_builder {
+    uint8_t data[256];
+    size_t len;
+};
+
+static void wr_put(struct wr_builder *b, const void *bytes, size_t n)
+{
+    memcpy(&b->data[b->len], bytes, n);
+    b->len += n;
+}
+
+static void wr_put16(struct wr_builder *b, uint16_t v)
+{
+    uint8_t le[2] = { v & 0xFF, v >> 8 };
+
+    wr_put(b, le, sizeof(le));
+}
+
+static void wr_put32(struct wr_builder *b, uint32_t v)
+{
+    uint8_t le[4] = { v & 0xFF, (v >> 8) & 0xFF, (v >> 16) & 0xFF, v >> 24 };
+
+    wr_put(b, le, sizeof(le));
+}
+
+static void wr_put_fmt(struct wr_builder *b, uint32_t chunk_size, uint16_t tag,
+                       uint16_t channels, uint16_t bits)
+{
+    uint16_t align = channels * bits / 8;
+
+    wr_put(b, "RIFF", 4);
+    wr_put32(b, 0);     /* Unused by the decoder */
+    wr_put(b, "WAVE", 4);
+    wr_put(b, "fmt ", 4);
+    wr_put32(b, chunk_size);
+    wr_put16(b, tag);
+    wr_put16(b, channels);
+    wr_put32(b, 16000);
+    wr_put32(b, 16000U * align);
+    wr_put16(b, align);
+    wr_put16(b, bits);
+    for (uint32_t i = 16; i < chunk_size + (chunk_size & 1); i++) {
+        wr_put(b, "\0", 1);
+    }
+}
+
+/* WAVE_FORMAT_EXTENSIBLE fmt chunk with a KSDATAFORMAT SubFormat code */
+static void wr_put_fmt_ext(struct wr_builder *b, uint32_t chunk_size, uint16_t subformat,
+                           uint16_t channels, uint16_t bits)
+{
+    static const uint8_t guid_tail[14] = {
+        0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71
+    };
+    size_t ext = b->len + 20 + 16;
+
+    wr_put_fmt(b, chunk_size, WAV_FORMAT_EXTENSIBLE, channels, bits);
+    if (chunk_size >= 40) {
+        uint8_t *e = &b->data[ext];
+
+        e[0] = 22;                          /* cbSize */
+        e[2] = bits & 0xFF;                 /* wValidBitsPerSample */
+        e[4] = (channels == 2) ? 0x03 : 0x04;
+        e[8] = subformat & 0xFF;
+        e[9] = subformat >> 8;
+        memcpy(&e[10], guid_tail, sizeof(guid_tail));
+    }
+}
+
+/**
+ * @brief Decode a synthetic file at every step size and check the result
+ */
+static void wr_test_synthetic(const char *what, const struct wr_builder *b,
+                              const uint8_t *pcm, size_t pcm_len, int ends)
+{
+    struct wr_sink got;
+    struct wav_decoder whole;
+    struct audio_format_info format;
+
+    /* The in-memory decoder must agree on the format */
+    if (wr_decode(&got, b->data, b->len, b->len, false) == 0) {
+        WR_CHECK(got.format.format_tag == WAV_FORMAT_PCM, "%s: format tag %u reported",
+                 what, got.format.format_tag);
+        WR_CHECK(b->len < 44 ||
+                 (wav_decoder_init(&whole, b->data, b->len) == 0 &&
+                  wav_decoder_get_format(&whole, &format) == 0 &&
+                  memcmp(&format, &got.format, sizeof(format)) == 0),
+                 "%s: wav_decoder_init() disagrees with the push decoder", what);
+    }
+    wr_sink_free(&got);
+
+    for (size_t step = 1; step <= b->len; step++) {
+        for (int pause = 0; pause <= 1; pause++) {
+            int ret = wr_decode(&got, b->data, b->len, step, pause != 0);
+
+            WR_CHECK(ret == 0 && got.formats == 1 && got.ends == ends &&
+                     got.len == pcm_len && memcmp(got.pcm, pcm, pcm_len) == 0 &&
+                     got.bad_resumes == 0,
+                     "%s in %zu-byte steps: ret %d, %d FORMAT, %d END, %zu PCM bytes", what,
+                     step, ret, got.formats, got.ends, got.len);
+            wr_sink_free(&got);
+        }
+    }
+}
+
+static void wr_test_refuse(const char *what, const struct wr_builder *b, int expect)
+{
+    struct wav_stream_decoder decoder;
+    struct wr_sink sink = { 0 };
+
+    for (size_t step = 1; step <= b->len; step++) {
+        int ret = wr_decode(&sink, b->data, b->len, step, false);
+
+        WR_CHECK(ret == expect, "%s in %zu-byte steps: feed returned %d, expected %d",
+                 what, step, ret, expect);
+        WR_CHECK(sink.len == 0, "%s: %zu PCM bytes reported", what, sink.len);
+        wr_sink_free(&sink);
+    }
+
+    /* A failed decoder stays failed until it is reset */
+    wav_stream_init(&decoder);
+    wav_stream_feed(&decoder, b->data, b->len, wr_sink_cb, &sink);
+    WR_CHECK(wav_stream_feed(&decoder, b->data, b->len, wr_sink_cb, &sink) == -EINVAL,
+             "%s: decoder accepted input after an error", what);
+    wr_sink_free(&sink);
+}
+
+static void wr_test_stream_edges(void)
+{
+    static const uint8_t pcm[10] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    struct wr_builder b;
+
+    /* fmt with a 2-byte extension, odd LIST with padding, trailer after data */
+    memset(&b, 0, sizeof(b));
+    wr_put_fmt(&b, 18, 1, 1, 16);
+    wr_put(&b, "LIST", 4);
+    wr_put32(&b, 5);
+    wr_put(&b, "INFO\0\0", 6);
+    wr_put(&b, "data", 4);
+    wr_put32(&b, sizeof(pcm));
+    wr_put(&b, pcm, sizeof(pcm));
+    wr_put(&b, "LIST\4\0\0\0junk", 12);
+    wr_test_synthetic("Padded chunks", &b, pcm, sizeof(pcm), 1);
+
+    /* Streaming encoders: data size unknown, PCM runs to the last byte */
+    memset(&b, 0, sizeof(b));
+    wr_put_fmt(&b, 16, 1, 2, 16);
+    wr_put(&b, "data", 4);
+    wr_put32(&b, WAV_STREAM_SIZE_UNKNOWN);
+    wr_put(&b, pcm, sizeof(pcm));
+    wr_test_synthetic("Unbounded data", &b, pcm, sizeof(pcm), 0);
+
+    memset(&b, 0, sizeof(b));
+    wr_put_fmt(&b, 16, 1, 1, 16);
+    memcpy(b.data, "RIFX", 4);
+    wr_test_refuse("Bad RIFF signature", &b, -EINVAL);
+
+    memset(&b, 0, sizeof(b));
+    wr_put(&b, "RIFF\0\0\0\0WAVEdata\4\0\0\0", 20);
+    wr_put(&b, pcm, 4);
+    wr_test_refuse("data before fmt", &b, -EINVAL);
+
+    memset(&b, 0, sizeof(b));
+    wr_put(&b, "RIFF\0\0\0\0WAVEfmt \x0e\0\0\0", 20);
+    wr_put(&b, pcm, 10);
+    wr_test_refuse("Short fmt chunk", &b, -EINVAL);
+
+    memset(&b, 0, sizeof(b));
+    wr_put_fmt(&b, 16, 3, 1, 32);   /* IEEE float */
+    wr_test_refuse("Float samples", &b, -ENOTSUP);
+
+    memset(&b, 0, sizeof(b));
+    wr_put_fmt(&b, 16, 1, 3, 16);
+    wr_test_refuse("Three channels", &b, -ENOTSUP);
+
+    /* Wider integer samples, plain and extensible, two frames each */
+    static const uint8_t wide_pcm[16] = {
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16
+    };
+    static const struct {
+        const char *what;
+        bool extensible;
+        uint16_t channels;
+        uint16_t bits;
+    } wide[] = {
+        { "24-bit stereo", false, 2, 24 },
+        { "32-bit mono", false, 1, 32 },
+        { "Extensible 16-bit stereo", true, 2, 16 },
+        { "Extensible 24-bit mono", true, 1, 24 },
+        { "Extensible 32-bit stereo", true, 2, 32 },
+    };
+
+    for (size_t i = 0; i < sizeof(wide) / sizeof(wide[0]); i++) {
+        size_t frame = wide[i].channels * wide[i].bits / 8;
+
+        memset(&b, 0, sizeof(b));
+        if (wide[i].extensible) {
+            wr_put_fmt_ext(&b, 40, WAV_FORMAT_PCM, wide[i].channels, wide[i].bits);
+        } else {
+            wr_put_fmt(&b, 16, WAV_FORMAT_PCM, wide[i].channels, wide[i].bits);
+        }
+        wr_put(&b, "data", 4);
+        wr_put32(&b, 2 * frame);
+        wr_put(&b, wide_pcm, 2 * frame);
+        wr_test_synthetic(wide[i].what, &b, wide_pcm, 2 * frame, 1);
+    }
+
+    memset(&b, 0, sizeof(b));
+    wr_put_fmt_ext(&b, 40, 3, 2, 32);   /* KSDATAFORMAT_SUBTYPE_IEEE_FLOAT */
+    wr_test_refuse("Extensible float", &b, -ENOTSUP);
+
+    memset(&b, 0, sizeof(b));
+    wr_put_fmt_ext(&b, 18, WAV_FORMAT_PCM, 2, 16);
+    wr_test_refuse("Extensible without its extension", &b, -EINVAL);
+
+    memset(&b, 0, sizeof(b));
+    wr_put_fmt(&b, 16, WAV_FORMAT_PCM, 2, 24);
+    b.data[32] = 8;                     /* 24 bits in 32-bit containers */
+    wr_test_refuse("Padded 24-bit frames", &b, -ENOTSUP);
+}
+
+int main(void)
+{
+    if (media_fs_init() != FS_OK) {
+        return 1;
+    }
+
+    for (size_t i = 0; i < sizeof(wr_test_files) / sizeof(wr_test_files[0]); i++) {
+        wr_test_file(wr_test_files[i]);
+    }
+    wr_test_stream_edges();
+
+    media_fs_deinit();
+
+    WR_CHECK(wr_test.files_checked >= 3, "Only %d test files decoded", wr_test.files_checked);
+    if (wr_test.failures) {
+        SIM_LOG_ERR("%d check(s) failed", wr_test.failures);
+        return 1;
+    }
+    SIM_LOG_INF("All WAV reader checks passed (%d files decoded, %d refused, steps 1..%d)",
+                wr_test.files_checked, wr_test.files_refused, WR_TEST_MAX_STEP);
+    return 0;
+}
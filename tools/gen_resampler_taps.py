@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""
+Generate the polyphase filter tables used by src/audio/resampler.c
+
+Each quality tier is a windowed-sinc low-pass sampled at RESAMPLER_PHASES+1
+fractional offsets, quantised to Q15 with every phase summing to exactly
+1.0 so DC passes through unchanged. The fast tier is plain linear
+interpolation expressed as a two-tap filter.
+
+Usage:
+    python3 tools/gen_resampler_taps.py > src/audio/resampler_taps.h
+"""
+
+import math
+
+PHASES = 64
+Q15_ONE = 1 << 15
+
+# name, taps, cutoff (fraction of the input rate), Kaiser beta
+TIERS = [
+    ("fast", 2, None, None),
+    ("balanced", 8, 0.40, 5.0),
+    ("high", 16, 0.45, 7.0),
+]
+
+
+def bessel_i0(x):
+    total, term, k = 1.0, 1.0, 1
+    while term > 1e-12 * total:
+        term *= (x / (2.0 * k)) ** 2
+        total += term
+        k += 1
+    return total
+
+
+def kaiser(t, half_width, beta):
+    r = t / half_width
+    if abs(r) >= 1.0:
+        return 0.0
+    return bessel_i0(beta * math.sqrt(1.0 - r * r)) / bessel_i0(beta)
+
+
+def windowed_sinc(t, cutoff, half_width, beta):
+    x = 2.0 * cutoff * t
+    sinc = 1.0 if x == 0.0 else math.sin(math.pi * x) / (math.pi * x)
+    return 2.0 * cutoff * sinc * kaiser(t, half_width, beta)
+
+
+def phase_taps(taps, cutoff, beta, mu):
+    # Output sits mu past the newest-but-(taps/2) sample of the window
+    centre = taps // 2 - 1 + mu
+    if cutoff is None:
+        coeffs = [1.0 - mu, mu]
+    else:
+        coeffs = [windowed_sinc(j - centre, cutoff, taps / 2.0, beta) for j in range(taps)]
+    gain = sum(coeffs)
+    q = [int(round(c / gain * Q15_ONE)) for c in coeffs]
+    # Put the rounding error on the largest tap so the phase sums to 1.0
+    big = max(range(taps), key=lambda j: abs(q[j]))
+    q[big] += Q15_ONE - sum(q)
+    return [max(-32768, min(32767, v)) for v in q]
+
+
+def main():
+    print("/**")
+    print(" * @file resampler_taps.h")
+    print(" * @brief Polyphase filter tables for the sample-rate converter")
+    print(" *")
+    print(" * Generated by tools/gen_resampler_taps.py - do not edit by hand.")
+    print(" */")
+    print()
+    print("#ifndef RESAMPLER_TAPS_H")
+    print("#define RESAMPLER_TAPS_H")
+    print()
+    print("#include <stdint.h>")
+    print()
+    print("#define RESAMPLER_PHASES %d" % PHASES)
+    for name, taps, cutoff, beta in TIERS:
+        print()
+        if cutoff is None:
+            print("/* %s: linear interpolation */" % name)
+        else:
+            print("/* %s: %d taps, cutoff %.2f fs_in, Kaiser beta %.1f */" % (name, taps, cutoff, beta))
+        print("static const int16_t resampler_taps_%s[RESAMPLER_PHASES + 1][%d] = {" % (name, taps))
+        for phase in range(PHASES + 1):
+            q = phase_taps(taps, cutoff, beta, phase / PHASES)
+            print("    { " + ", ".join("%d" % v for v in q) + " },")
+        print("};")
+    print()
+    print("#endif /* RESAMPLER_TAPS_H */")
+
+
+if __name__ == "__main__":
+    main()